@@ -0,0 +1,572 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+/*
+  Benchmark suite of the library.
+
+  Every scenario builds a system from a fixed seed, so that two builds
+  simulate exactly the same sequence of events, and then runs it for a
+  fixed number of events. The results are printed as JSON, to be
+  compared between builds:
+
+      rtlib_bench [-n events] [-o file.json] [scenario-prefix ...]
+*/
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <metasim.hpp>
+#include <kernel.hpp>
+#include <mrtkernel.hpp>
+#include <apamrtkernel.hpp>
+#include <apasched.hpp>
+#include <edfsched.hpp>
+#include <fpsched.hpp>
+#include <srpsched.hpp>
+#include <srpresman.hpp>
+#include <cbserver.hpp>
+#include <grubserver.hpp>
+#include <sporadicserver.hpp>
+#include <schedpoints.hpp>
+#include <schedrta.hpp>
+#include <rttask.hpp>
+#include <texttrace.hpp>
+#include <json_trace.hpp>
+#include <timer.hpp>
+#include <SchedulerFactory.hpp>
+
+using namespace MetaSim;
+using namespace RTSim;
+using namespace std;
+
+namespace {
+
+    const unsigned long _SEED = 12345;
+
+    /**
+       Portable pseudo-random generator (Park-Miller), so that the
+       task sets do not depend on the standard library in use.
+    */
+    class Rand {
+        unsigned long long _s;
+    public:
+        Rand(unsigned long s) : _s(s % 2147483647UL) { if (!_s) _s = 1; }
+        double get() {
+            _s = (_s * 48271ULL) % 2147483647ULL;
+            return double(_s) / 2147483647.0;
+        }
+        // uniform integer in [a, b]
+        long range(long a, long b) {
+            return a + long(get() * (b - a + 1)) % (b - a + 1);
+        }
+    };
+
+    struct TaskParam {
+        Tick C, T, ph;
+    };
+
+    /**
+       UUniFast utilizations, log-uniform periods between pmin and
+       pmax, random phases.
+    */
+    vector<TaskParam> genTaskSet(Rand &r, int n, double u,
+                                 Tick pmin, Tick pmax, Tick cmin = 1)
+    {
+        vector<TaskParam> ts(n);
+        double sum = u;
+        for (int i = 0; i < n; ++i) {
+            double next = (i == n - 1) ? 0 :
+                sum * pow(r.get(), 1.0 / (n - i - 1));
+            double ui = sum - next;
+            sum = next;
+
+            double lp = log(double(pmin)) +
+                r.get() * (log(double(pmax)) - log(double(pmin)));
+            ts[i].T = Tick::floor(exp(lp));
+            ts[i].C = Tick::floor(ui * double(ts[i].T));
+            if (ts[i].C < cmin) ts[i].C = cmin;
+            ts[i].ph = Tick::floor(r.get() * double(ts[i].T));
+        }
+        return ts;
+    }
+
+    string num(long v)
+    {
+        stringstream ss;
+        ss << v;
+        return ss.str();
+    }
+
+    string fixedCode(Tick c)
+    {
+        return "fixed(" + num(long(c)) + ");";
+    }
+
+    /**
+       Owns the objects created by a scenario. They are deleted in
+       reverse order of creation, before the kernel and the scheduler
+       that were declared before the Pool.
+    */
+    template<class T>
+    class Pool : public vector<T *> {
+    public:
+        ~Pool() {
+            while (!this->empty()) {
+                delete this->back();
+                this->pop_back();
+            }
+        }
+    };
+
+    vector<PeriodicTask *> makeTasks(Pool<PeriodicTask> &pool,
+                                     const vector<TaskParam> &ts,
+                                     const string &prefix)
+    {
+        vector<PeriodicTask *> v;
+        for (unsigned i = 0; i < ts.size(); ++i) {
+            PeriodicTask *t = new PeriodicTask(ts[i].T, ts[i].T, ts[i].ph,
+                                               prefix + num(i));
+            t->insertCode(fixedCode(ts[i].C));
+            t->setAbort(false);
+            pool.push_back(t);
+            v.push_back(t);
+        }
+        return v;
+    }
+
+    typedef chrono::steady_clock Clock;
+
+    /// True if the peak RSS has been reset for the current scenario
+    bool _peakReset = false;
+
+    /**
+       Resets the peak RSS of the process to its current RSS, by
+       writing 5 to /proc/self/clear_refs (Linux 4.0 or later).
+    */
+    void resetPeakRSS()
+    {
+        _peakReset = false;
+#ifndef _WIN32
+        ofstream f("/proc/self/clear_refs");
+        f << "5" << flush;
+        _peakReset = bool(f);
+#endif
+    }
+
+    /**
+       Peak resident set size in KB since the last resetPeakRSS(),
+       from VmHWM in /proc/self/status (-1 where it is not
+       available, or it could not be reset).
+    */
+    long peakRSS()
+    {
+        if (!_peakReset) return -1;
+        ifstream status("/proc/self/status");
+        string line;
+        while (getline(status, line))
+            if (line.compare(0, 6, "VmHWM:") == 0)
+                return atol(line.c_str() + 6);
+        return -1;
+    }
+
+    /// Starts the setup of a scenario
+    Clock::time_point startSetup()
+    {
+        resetPeakRSS();
+        return Clock::now();
+    }
+
+    struct Result {
+        string name;
+        int tasks;
+        int cpus;
+        unsigned long long events;
+        Tick simTime;
+        double setup;
+        double wall;
+        /// peak RSS from the setup to the end of the run
+        long peakRss;
+    };
+
+    double seconds(Clock::time_point a, Clock::time_point b)
+    {
+        return chrono::duration_cast<chrono::nanoseconds>(b - a).count() / 1e9;
+    }
+
+    unsigned long long _maxEvents = 200000;
+
+    /**
+       Runs the simulation of the system built so far for _maxEvents
+       events, and fills the measures of the result.
+    */
+    void measure(Result &r, Clock::time_point setupStart)
+    {
+        Clock::time_point start = Clock::now();
+        r.setup = seconds(setupStart, start);
+
+        SIMUL.initSingleRun();
+        unsigned long long n = 0;
+        while (n < _maxEvents) {
+            SIMUL.sim_step();
+            ++n;
+        }
+        Clock::time_point stop = Clock::now();
+        r.simTime = SIMUL.getTime();
+        SIMUL.endSingleRun();
+
+        r.events = n;
+        r.wall = seconds(start, stop);
+        r.peakRss = peakRSS();
+    }
+
+    /// Periodically asks the supervisor for a budget change
+    class BudgetChanger : public PeriodicTimer {
+        Supervisor *_super;
+        vector<Server *> &_servers;
+        Rand _rand;
+    public:
+        BudgetChanger(Tick p, Supervisor *s, vector<Server *> &v) :
+            PeriodicTimer(p, "BudgetChanger"), _super(s), _servers(v),
+            _rand(_SEED) {}
+        void action() {
+            Server *s = _servers[_rand.range(0, _servers.size() - 1)];
+            _super->changeBudget(s, _rand.get() < 0.5 ? -1 : 1);
+        }
+    };
+
+    // ------------------------------------------------------------ scenarios
+
+    Result uniproc(const string &name, Scheduler &sched, int n, bool fp,
+                   bool trace = false)
+    {
+        Result r = { name, n, 1 };
+        Clock::time_point setup = startSetup();
+        Rand rnd(_SEED + n);
+
+        vector<TaskParam> ts = genTaskSet(rnd, n, 0.9, 10 * n, 100 * n);
+        RTKernel kern(&sched);
+        JSONTrace *jtrace = 0;
+        TextTrace *ttrace = 0;
+        if (trace) {
+            jtrace = new JSONTrace("bench_trace.json");
+            ttrace = new TextTrace("bench_trace.txt");
+        }
+        {
+            Pool<PeriodicTask> pool;
+            vector<PeriodicTask *> tasks = makeTasks(pool, ts, "T");
+            for (int i = 0; i < n; ++i) {
+                // rate monotonic priorities for FP
+                string p = fp ? num(long(ts[i].T)) : "";
+                kern.addTask(*tasks[i], p);
+                if (trace) {
+                    jtrace->attachToTask(tasks[i]);
+                    ttrace->attachToTask(tasks[i]);
+                }
+            }
+            measure(r, setup);
+        }
+        if (trace) {
+            delete jtrace;
+            delete ttrace;
+            remove("bench_trace.json");
+            remove("bench_trace.txt");
+        }
+        return r;
+    }
+
+    Result globalEDF(int m)
+    {
+        int n = 4 * m;
+        Result r = { "gedf_" + num(m) + "cpu", n, m };
+        Clock::time_point setup = startSetup();
+        Rand rnd(_SEED + m);
+
+        vector<TaskParam> ts = genTaskSet(rnd, n, 0.8 * m, 100, 10000);
+        EDFScheduler sched;
+        MRTKernel kern(&sched, m);
+        Pool<PeriodicTask> pool;
+        vector<PeriodicTask *> tasks = makeTasks(pool, ts, "T");
+        for (int i = 0; i < n; ++i)
+            kern.addTask(*tasks[i]);
+        measure(r, setup);
+        return r;
+    }
+
+    Result apa(int m)
+    {
+        int n = 4 * m;
+        Result r = { "apa_" + num(m) + "cpu", n, m };
+        Clock::time_point setup = startSetup();
+        Rand rnd(_SEED + 100 + m);
+
+        vector<TaskParam> ts = genTaskSet(rnd, n, 0.7 * m, 100, 10000);
+        APAScheduler sched(new EDFSchedulerFactory());
+        APAMRTKernel kern(&sched, m, "APAMRTKernel");
+        Pool<PeriodicTask> pool;
+        vector<PeriodicTask *> tasks = makeTasks(pool, ts, "T");
+        for (int i = 0; i < n; ++i) {
+            // every task can run on a random half of the processors
+            unsigned long mask = 0;
+            while (!mask)
+                for (int c = 0; c < m; ++c)
+                    if (rnd.get() < 0.5) mask |= 1UL << c;
+            stringstream ss;
+            ss << "0x" << hex << mask;
+            kern.addTask(*tasks[i], ss.str());
+        }
+        measure(r, setup);
+        return r;
+    }
+
+    Result cbs(int n)
+    {
+        Result r = { "cbs_" + num(n) + "srv", n, 1 };
+        Clock::time_point setup = startSetup();
+        Rand rnd(_SEED + 200 + n);
+
+        vector<TaskParam> ts = genTaskSet(rnd, n, 0.9, 10 * n, 100 * n);
+        EDFScheduler sched;
+        RTKernel kern(&sched);
+        Pool<PeriodicTask> pool;
+        Pool<CBServer> servers;
+        vector<PeriodicTask *> tasks = makeTasks(pool, ts, "T");
+        for (int i = 0; i < n; ++i) {
+            CBServer *s = new CBServer(ts[i].C, ts[i].T, ts[i].T, false,
+                                       "S" + num(i), "FIFOSched");
+            s->addTask(*tasks[i]);
+            kern.addTask(*s, "");
+            servers.push_back(s);
+        }
+        measure(r, setup);
+        return r;
+    }
+
+    Result grub(int n)
+    {
+        Result r = { "grub_" + num(n) + "srv", n, 1 };
+        Clock::time_point setup = startSetup();
+        Rand rnd(_SEED + 300 + n);
+
+        vector<TaskParam> ts = genTaskSet(rnd, n, 0.9, 10 * n, 100 * n);
+        EDFScheduler sched;
+        RTKernel kern(&sched);
+        GrubSupervisor super;
+        Pool<PeriodicTask> pool;
+        Pool<Grub> servers;
+        vector<PeriodicTask *> tasks = makeTasks(pool, ts, "T");
+        for (int i = 0; i < n; ++i) {
+            Grub *s = new Grub(ts[i].C, ts[i].T, "S" + num(i), "FIFOSched");
+            s->addTask(*tasks[i]);
+            kern.addTask(*s, "");
+            super.addGrub(s);
+            servers.push_back(s);
+        }
+        measure(r, setup);
+        return r;
+    }
+
+    Result srp(int n, int nres)
+    {
+        Result r = { "srp_" + num(n) + "tasks_" + num(nres) + "res", n, 1 };
+        Clock::time_point setup = startSetup();
+        Rand rnd(_SEED + 400 + n);
+
+        vector<TaskParam> ts = genTaskSet(rnd, n, 0.8, 100, 10000, 4);
+        EDF_SRPScheduler sched;
+        RTKernel kern(&sched);
+        SRPResManager resman;
+        kern.setResManager(&resman);
+        sched.setResManager(&resman);
+        for (int i = 0; i < nres; ++i)
+            resman.addResource("R" + num(i));
+
+        Pool<PeriodicTask> pool;
+        for (int i = 0; i < n; ++i) {
+            PeriodicTask *t = new PeriodicTask(ts[i].T, ts[i].T, ts[i].ph,
+                                               "T" + num(i));
+            // two nested critical sections in the middle of the job
+            Tick c = ts[i].C;
+            string r1 = "R" + num(rnd.range(0, nres - 1));
+            string r2 = "R" + num(rnd.range(0, nres - 1));
+            t->insertCode(fixedCode(c - 3));
+            t->insertCode("wait(" + r1 + ");fixed(1);");
+            if (r2 != r1)
+                t->insertCode("wait(" + r2 + ");fixed(1);signal(" + r2 + ");");
+            else
+                t->insertCode("fixed(1);");
+            t->insertCode("signal(" + r1 + ");fixed(1);");
+            t->setAbort(false);
+            pool.push_back(t);
+            // preemption levels are inversely proportional to the
+            // relative deadlines
+            kern.addTask(*t, num(long(1e8 / double(ts[i].T))));
+        }
+        for (int i = 0; i < n; ++i)
+            resman.ceilingsFromTask(pool[i]);
+        measure(r, setup);
+        return r;
+    }
+
+    Result supervisor(bool rta, int n)
+    {
+        Result r = { string(rta ? "schedrta_" : "schedpoint_") +
+                     num(n) + "srv", n, 1 };
+        Clock::time_point setup = startSetup();
+        Rand rnd(_SEED + 500 + n);
+
+        vector<TaskParam> ts = genTaskSet(rnd, n, 0.6, 100, 1000, 2);
+        FPScheduler sched;
+        RTKernel kern(&sched);
+        Pool<PeriodicTask> pool;
+        Pool<SporadicServer> servers;
+        vector<PeriodicTask *> tasks = makeTasks(pool, ts, "T");
+
+        // servers are added to the supervisor in decreasing priority order
+        vector<int> order(n);
+        for (int i = 0; i < n; ++i) order[i] = i;
+        for (int i = 1; i < n; ++i)
+            for (int j = i; j > 0 && ts[order[j]].T < ts[order[j - 1]].T; --j)
+                swap(order[j], order[j - 1]);
+
+        SchedPoint *sp = 0;
+        SchedRTA *sr = 0;
+        Supervisor *super;
+        if (rta) super = sr = new SchedRTA("SchedRTA");
+        else super = sp = new SchedPoint("SchedPoint");
+
+        vector<Server *> v;
+        for (int k = 0; k < n; ++k) {
+            int i = order[k];
+            SporadicServer *s = new SporadicServer(ts[i].C, ts[i].T,
+                                                   "S" + num(i), "FIFOSched");
+            s->addTask(*tasks[i]);
+            kern.addTask(*s, num(k));
+            super->addServer(s);
+            servers.push_back(s);
+            v.push_back(s);
+        }
+        if (sp) sp->buildconstraints();
+
+        BudgetChanger changer(50, super, v);
+        measure(r, setup);
+
+        delete sp;
+        delete sr;
+        return r;
+    }
+
+    void print(ostream &os, const vector<Result> &res)
+    {
+        os << "{" << endl;
+        os << "  \"seed\": " << _SEED << "," << endl;
+        os << "  \"events_per_scenario\": " << _maxEvents << "," << endl;
+        os << "  \"scenarios\": [" << endl;
+        for (unsigned i = 0; i < res.size(); ++i) {
+            const Result &r = res[i];
+            double ns = r.events ? r.wall * 1e9 / r.events : 0;
+            double eps = r.wall > 0 ? r.events / r.wall : 0;
+            os << "    {\"name\": \"" << r.name << "\", "
+               << "\"tasks\": " << r.tasks << ", "
+               << "\"cpus\": " << r.cpus << ", "
+               << "\"events\": " << r.events << ", "
+               << "\"sim_time\": " << r.simTime << ", "
+               << "\"setup_s\": " << r.setup << ", "
+               << "\"run_s\": " << r.wall << ", "
+               << "\"ns_per_event\": " << ns << ", "
+               << "\"events_per_s\": " << eps << ", "
+               << "\"peak_rss_kb\": " << r.peakRss << "}"
+               << (i + 1 < res.size() ? "," : "") << endl;
+        }
+        os << "  ]" << endl;
+        os << "}" << endl;
+    }
+
+    bool selected(const vector<string> &filters, const string &name)
+    {
+        if (filters.empty()) return true;
+        for (unsigned i = 0; i < filters.size(); ++i)
+            if (name.compare(0, filters[i].size(), filters[i]) == 0)
+                return true;
+        return false;
+    }
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    string out;
+    vector<string> filters;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            _maxEvents = strtoull(argv[++i], 0, 10);
+        else if (!strcmp(argv[i], "-o") && i + 1 < argc)
+            out = argv[++i];
+        else
+            filters.push_back(argv[i]);
+    }
+
+    vector<Result> res;
+    try {
+        const int sizes[] = { 10, 1000, 100000 };
+        for (int i = 0; i < 3; ++i) {
+            string n = num(sizes[i]);
+            if (selected(filters, "edf_" + n)) {
+                EDFScheduler s;
+                res.push_back(uniproc("edf_" + n + "tasks", s, sizes[i], false));
+            }
+            if (selected(filters, "fp_" + n)) {
+                FPScheduler s;
+                res.push_back(uniproc("fp_" + n + "tasks", s, sizes[i], true));
+            }
+        }
+
+        for (int m = 4; m <= 128; m *= 2)
+            if (selected(filters, "gedf_" + num(m)))
+                res.push_back(globalEDF(m));
+
+        if (selected(filters, "apa")) res.push_back(apa(8));
+        if (selected(filters, "cbs")) res.push_back(cbs(1000));
+        if (selected(filters, "grub")) res.push_back(grub(1000));
+        if (selected(filters, "srp")) res.push_back(srp(100, 8));
+
+        if (selected(filters, "trace_off")) {
+            EDFScheduler s;
+            res.push_back(uniproc("trace_off_1000tasks", s, 1000, false));
+        }
+        if (selected(filters, "trace_on")) {
+            EDFScheduler s;
+            res.push_back(uniproc("trace_on_1000tasks", s, 1000, false, true));
+        }
+
+        if (selected(filters, "schedpoint")) res.push_back(supervisor(false, 10));
+        if (selected(filters, "schedrta")) res.push_back(supervisor(true, 10));
+    } catch (BaseExc &e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+
+    if (out.empty()) print(cout, res);
+    else {
+        ofstream os(out.c_str());
+        print(os, res);
+    }
+    return 0;
+}
@@ -21,7 +21,9 @@
 #include <rttask.hpp>
 #include <cbserver.hpp>
 #include <kernevt.hpp>
+#include <hetero.hpp>
 #include <iostream>
+#include <algorithm>
 
 
 
@@ -143,6 +145,40 @@ CPU* WorstFitTaskAllocation::findCPU(map<CPU *, Scheduler*> &cpuSchedulerMap,
     return largestEmptySpaceCPU;
 }
 
+static bool slowerFirst(const pair<double, unsigned int> &a,
+                        const pair<double, unsigned int> &b){
+    return a.first > b.first;
+}
+
+CPU* HeteroFitTaskAllocation::findCPU(map<CPU *, Scheduler*> &cpuSchedulerMap,
+                                      AbsRTTask *task, double taskUtilization,
+                                      unsigned int nCPU){
+
+    // (factor, index) of every CPU, slowest first
+    vector< pair<double, unsigned int> > order;
+    vector<CPU *> cpus;
+
+    CPUSCHED_ITER cpuIter = cpuSchedulerMap.begin();
+    for(unsigned int i=0; i<nCPU; i++, cpuIter++){
+        cpus.push_back(cpuIter->first);
+        order.push_back(make_pair(getScaling(task, cpuIter->first), i));
+    }
+    std::stable_sort(order.begin(), order.end(), slowerFirst);
+
+    for(unsigned int k=0; k<order.size(); k++){
+        unsigned int i = order[k].second;
+        double u = taskUtilization * order[k].first;
+
+        if((cpuUtilization[i] + u) <= 1){
+            cpuUtilization[i] += u;
+            cpus[i]->setIndex(i);
+            return cpus[i];
+        }
+    }
+
+    throw NotAllocableTaskSetException("TaskSet not allocable with the given number of CPUs");
+}
+
 void AbsTaskAllocation::allocate(PartionedMRTKernel *kern){
 
     allocatedTasks.clear();
@@ -162,7 +198,7 @@ void AbsTaskAllocation::allocateTask(AbsRTTask *task, PartionedMRTKernel *kern){
     period = AbsTaskAllocation::getPeriod(task);
 
     try{
-         selectedCPU = findCPU(kern->_cpuSchedulerMap, (wcet/period), kern->_nCPU);
+         selectedCPU = findCPU(kern->_cpuSchedulerMap, task, (wcet/period), kern->_nCPU);
     }
     catch(NotAllocableTaskSetException e){
         throw;
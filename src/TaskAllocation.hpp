@@ -137,6 +137,17 @@ protected:
     */
     virtual CPU* findCPU(std::map<CPU *, Scheduler*> &cpuSchedulerMap,
                             double taskUtilization, unsigned int nCPU) = 0;
+
+    /**
+       Finds the CPU for the given task; by default it only depends on
+       the utilization of the task
+    */
+    virtual CPU* findCPU(std::map<CPU *, Scheduler*> &cpuSchedulerMap,
+                            AbsRTTask *task, double taskUtilization,
+                            unsigned int nCPU)
+    {
+        return findCPU(cpuSchedulerMap, taskUtilization, nCPU);
+    }
 private:
     /**
         Allocates a task in the kernel
@@ -266,5 +277,26 @@ public:
 
 };
 
+/**
+    Task Allocation class for heterogeneous platforms (see
+    HeteroPlatform). The utilization of a task on a CPU is scaled
+    by its execution time factor on the core type of the CPU (see
+    Task::setScaling()), and the CPUs are tried First Fit from the
+    one on which the task is slowest: the tasks fill the LITTLE
+    cores first, and the big cores are left to the tasks that do
+    not fit elsewhere.
+    @see PartionedMRTKernel, HeteroPlatform
+*/
+class HeteroFitTaskAllocation : public FirstFitTaskAllocation
+{
+protected:
+    CPU* findCPU(   map<CPU *, Scheduler*> &cpuSchedulerMap,
+                    AbsRTTask *task, double taskUtilization,
+                    unsigned int nCPU);
+public:
+    HeteroFitTaskAllocation() : FirstFitTaskAllocation() {}
+
+};
+
 }
 #endif
@@ -75,8 +75,8 @@ namespace RTSim {
                 _isContextSwitching[c] = true;
                 _m_currExe[c] = newExe;
                 _m_dispatched[newExe] = c;
-                // TODO: account for _migrationDelay
                 Tick overhead (_contextSwitchDelay);
+                overhead += migrationCost(newExe, c);
                 _endEvt[c]->setTask(newExe);
                 _endEvt[c]->post(SIMUL.getTime() + overhead);
             }
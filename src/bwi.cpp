@@ -1,74 +1,262 @@
 #include "bwi.hpp"
 #include "resource.hpp"
+#include "task.hpp"
 
 namespace RTSim {
+
+    BWIModel::BWIModel(AbsRTTask *owner, const std::vector<TaskModel *> &donors) :
+        TaskModel(owner), _donors(donors)
+    {
+    }
+
+    TaskModel *BWIModel::best()
+    {
+        TaskModel::TaskModelCmp cmp;
+        TaskModel *b = _donors[0];
+        for (unsigned i = 1; i < _donors.size(); ++i)
+            if (cmp(_donors[i], b)) b = _donors[i];
+        return b;
+    }
+
+    Tick BWIModel::getPriority()
+    {
+        return best()->getPriority();
+    }
+
+    void BWIModel::changePriority(Tick p)
+    {
+        throw BWIExc("Cannot change the priority of an inherited task");
+    }
+
+    Tick BWIModel::getInsertTime()
+    {
+        return best()->getInsertTime();
+    }
+
+    /*----------------------------------------------------*/
+
     BWI::BWI(const string &n) :
-        ResManager(n)
+        ResManager(n), _servers(), _waiting(), _blocked(), _guests(),
+        _leaving()
     {
     }
-    
+
     BWI::~BWI() {}
 
-    void BWI::addServer(Server *serv, Scheduler *sched)
+    void BWI::addServer(Server *serv)
     {
-        schedulers[serv] = sched;
+        _servers.insert(serv);
     }
 
-    bool BWI::request(AbsRTTask *t, Resource *r, int n)
+    Server *BWI::homeOf(AbsRTTask *t)
     {
-        bool ret;
-        
-        if (r->isLocked()) {
-            ret = false;
-            // find the server that holds the task. 
-            AbsKernel *k = t->getKernel();
-            // we now assume that it is a server. If it is not, 
-            // raise an exception.
-            Server *s = dynamic_cast<Server *>(k);
-            if (!s) 
-                throw BaseExc("BWI operating on something that it is not a server");
-            
-            if (schedulers.find(s) == schedulers.end()) 
-                throw BaseExc("BWI: Can't find server/scheduler correspondence");
-
-            Scheduler *sched = schedulers[s];
-
-            // remove the task from the server scheduler queue
-            s->suspend(t);
-
-            // now let's find the lock owner
-            AbsRTTask *absowner = r->getOwner();
-            // Should be a task! 
-            Task *owner = dynamic_cast<Task *>(absowner);
-            if (!owner) 
-                throw BaseExc("BWI lock holder is not a task!");
-            // remove the owner from its own queue
-            AbsKernel *k_owner = owner->getKernel();
-            k_owner->suspend(owner);
-            
-            // insert the owner in the server
-            // this is difficult! It depends on the scheduler inside the server,
-            // which I do not know. 
-            // I should call the function with the parameters set to "MAX_PRIO"
-            // which has a specific meaning. Then, change all schedulers 
-
-            // 1) Introduce the removeTask() from the scheduler interface
-            // 2) Add a specific parameter MAX_PRIO to all schedulers, to mean 
-            //    that the task is activated (and equeued) at maximum possible priority
-            // 3) Modify the task to store its "scheduling" parameters, so that 
-            //    it can bring such parameters when moving from one scheduler to the other.
+        Server *s = dynamic_cast<Server *>(t->getKernel());
+        if (!s)
+            throw BWIExc("BWI operating on something that it is not a server");
+        if (_servers.find(s) == _servers.end())
+            throw BWIExc("BWI: server " + s->getName() + " not registered");
+        return s;
+    }
+
+    AbsRTTask *BWI::chainEnd(AbsRTTask *t)
+    {
+        std::map<AbsRTTask *, Resource *>::iterator i;
+        while ((i = _waiting.find(t)) != _waiting.end())
+            t = i->second->getOwner();
+        return t;
+    }
+
+    Server *BWI::getHost(const AbsRTTask *t) const
+    {
+        std::map<Guest, BWIModel *>::const_iterator i;
+        for (i = _guests.begin(); i != _guests.end(); ++i)
+            if (i->first.second == t && i->first.first->currExe_ == t)
+                return i->first.first;
+        for (i = _leaving.begin(); i != _leaving.end(); ++i)
+            if (i->first.second == t && i->first.first->currExe_ == t)
+                return i->first.first;
+        return NULL;
+    }
+
+    void BWI::leave(Server *s, AbsRTTask *t)
+    {
+        TaskModel *m = s->sched_->find(t);
+        if (m != NULL && m->isActive()) s->sched_->extract(t);
+
+        if (s->currExe_ == t) {
+            t->deschedule();
+            s->currExe_ = NULL;
+            s->sched_->notify(NULL);
+            s->dispatch();
+        }
+    }
+
+    void BWI::onGuestEnd(Server *host, AbsRTTask *t)
+    {
+        TaskModel *m = host->sched_->find(t);
+        if (m != NULL && m->isActive()) host->sched_->extract(t);
+        host->currExe_ = NULL;
+        host->sched_->notify(NULL);
+        host->dispatch();
+    }
+
+    void BWI::addGuest(const Guest &g, const std::vector<TaskModel *> &donors)
+    {
+        DBGPRINT_4("Inheriting server ", g.first->getName(), " to ",
+                   taskname(g.second));
+
+        // back in a server it is still executing in
+        std::map<Guest, BWIModel *>::iterator l = _leaving.find(g);
+        if (l != _leaving.end()) {
+            l->second->setDonors(donors);
+            _guests[g] = l->second;
+            _leaving.erase(l);
         }
         else {
+            BWIModel *m = new BWIModel(g.second, donors);
+            _guests[g] = m;
+            g.first->sched_->enqueueModel(m);
+        }
+        g.first->onArrival(g.second);
+    }
+
+    void BWI::removeGuest(const Guest &g)
+    {
+        DBGPRINT_4("Removing ", taskname(g.second), " from server ",
+                   g.first->getName());
+
+        Server *s = g.first;
+        BWIModel *m = _guests[g];
+        _guests.erase(g);
+
+        // a blocked task leaves at once, while it can still find
+        // its host; any other one at the next dispatch of the host
+        if (s->currExe_ == g.second && !isBlocked(g.second)) {
+            if (m->isActive()) s->sched_->extract(g.second);
+            _leaving[g] = m;
+            s->dispatch();
+            return;
+        }
+        leave(s, g.second);
+        s->sched_->_tasks.erase(g.second);
+        delete m;
+    }
+
+    void BWI::purge(bool all)
+    {
+        std::map<Guest, BWIModel *>::iterator l = _leaving.begin();
+        while (l != _leaving.end()) {
+            Server *s = l->first.first;
+            if (!all && s->currExe_ == l->first.second) {
+                ++l;
+                continue;
+            }
+            if (l->second->isActive()) s->sched_->extract(l->first.second);
+            s->sched_->_tasks.erase(l->first.second);
+            delete l->second;
+            _leaving.erase(l++);
+        }
+    }
+
+    void BWI::updateGuests()
+    {
+        purge();
+
+        // every blocked task lends its server to the end of its chain
+        std::map<Guest, std::vector<TaskModel *> > want;
+        std::map<AbsRTTask *, Resource *>::iterator w;
+        for (w = _waiting.begin(); w != _waiting.end(); ++w) {
+            Server *s = homeOf(w->first);
+            AbsRTTask *e = chainEnd(w->first);
+            if (homeOf(e) == s) continue;
+            want[Guest(s, e)].push_back(s->sched_->find(w->first));
+        }
+
+        // a guest whose donors changed is inserted again, so that
+        // its priority never changes while in the queue
+        std::vector<Guest> stale;
+        std::map<Guest, BWIModel *>::iterator g;
+        for (g = _guests.begin(); g != _guests.end(); ++g) {
+            std::map<Guest, std::vector<TaskModel *> >::iterator i =
+                want.find(g->first);
+            if (i == want.end() || i->second != g->second->getDonors())
+                stale.push_back(g->first);
+        }
+        for (unsigned k = 0; k < stale.size(); ++k) removeGuest(stale[k]);
+
+        std::map<Guest, std::vector<TaskModel *> >::iterator i;
+        for (i = want.begin(); i != want.end(); ++i)
+            if (_guests.find(i->first) == _guests.end())
+                addGuest(i->first, i->second);
+    }
+
+    bool BWI::request(AbsRTTask *t, Resource *r, int n)
+    {
+        DBGENTER(_RESMAN_DBG_LEV);
+
+        if (!r->isLocked()) {
             r->lock(t);
-            ret = true;
+            return true;
         }
 
-        return ret;
+        // follow the wait-for chain from the owner: a cycle back
+        // to t is a deadlock
+        string cycle = taskname(t) + " -> " + r->getName();
+        AbsRTTask *o = r->getOwner();
+        while (o != t) {
+            std::map<AbsRTTask *, Resource *>::iterator i = _waiting.find(o);
+            if (i == _waiting.end()) break;
+            cycle += " -> " + taskname(o) + " -> " + i->second->getName();
+            o = i->second->getOwner();
+        }
+        if (o == t) throw BWIExc("Deadlock: " + cycle + " -> " + taskname(t));
+
+        DBGPRINT_2("Blocking ", taskname(t));
+
+        Server *s = homeOf(t);
+        _waiting[t] = r;
+        _blocked[r].push_back(t);
+
+        leave(s, t);
+        updateGuests();
+
+        return false;
     }
 
     void BWI::release(AbsRTTask *t, Resource *r, int n)
     {
-        return;
+        DBGENTER(_RESMAN_DBG_LEV);
+
+        r->unlock();
+
+        std::deque<AbsRTTask *> &q = _blocked[r];
+        if (!q.empty()) {
+            AbsRTTask *w = q.front();
+            q.pop_front();
+            _waiting.erase(w);
+
+            DBGPRINT_2("Relocking resource for ", taskname(w));
+
+            r->lock(w);
+            homeOf(w)->onArrival(w);
+        }
+
+        // the owner leaves the servers of the tasks it no longer
+        // blocks, the new owner inherits the remaining ones
+        updateGuests();
+    }
+
+    void BWI::newRun()
+    {
+        _waiting.clear();
+        _blocked.clear();
+        _leaving.insert(_guests.begin(), _guests.end());
+        _guests.clear();
+        purge(true);
+    }
+
+    void BWI::endRun()
+    {
     }
 
 }
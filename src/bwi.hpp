@@ -4,22 +4,124 @@
 #include "resmanager.hpp"
 #include "server.hpp"
 #include "scheduler.hpp"
+#include <deque>
 #include <string>
 #include <map>
+#include <set>
+#include <vector>
 
 namespace RTSim {
 
+    class BWIExc : public BaseExc {
+    public:
+        BWIExc(const string &msg) : BaseExc(msg, "BWI", "bwi.cpp") {}
+    };
+
+    /**
+       The model of a lock owner that executes inside a server on
+       behalf of the tasks of that server it blocks (the donors): it
+       takes the place in the queue of the donor with the highest
+       priority.
+    */
+    class BWIModel : public TaskModel {
+        std::vector<TaskModel *> _donors;
+
+        TaskModel *best();
+
+    public:
+        BWIModel(AbsRTTask *owner, const std::vector<TaskModel *> &donors);
+
+        const std::vector<TaskModel *> &getDonors() const { return _donors; }
+        /// Only while the model is not in the queue
+        void setDonors(const std::vector<TaskModel *> &d) { _donors = d; }
+
+        virtual Tick getPriority();
+        virtual void changePriority(Tick p);
+        virtual Tick getInsertTime();
+    };
+
+    /**
+       \ingroup resman
+
+       BandWidth Inheritance (Lamastra, Lipari and Abeni, 2001) for
+       the tasks of reservation servers sharing resources. When a
+       task blocks, the owner of the lock is added to the scheduler
+       of the server of the blocked task, and executes there with
+       the priority of the blocked task, consuming the budget of that
+       server. Inheritance is transitive: if the owner is blocked in
+       turn, the task at the end of the chain executes in the servers
+       of all the tasks blocked behind it. When the lock is released,
+       the owner leaves the servers it inherited, and the lock goes
+       to the first waiter (in FIFO order), which inherits the
+       servers of the remaining waiters.
+
+       A request that closes a cycle in the wait-for graph (a
+       deadlock) throws a BWIExc that describes the cycle.
+
+       The manager is installed with Server::setGlobalResManager() on
+       every server whose tasks use the resources; tasks must not
+       be scheduled directly by a kernel. Inheritance between tasks
+       of the same server is left to the server scheduler, and only
+       one server executes at a time (single processor).
+    */
     class BWI : public ResManager {
         friend class Server;
+
+        typedef std::pair<Server *, AbsRTTask *> Guest;
+
+        std::set<Server *> _servers;
+
+        /// the resource each blocked task waits for
+        std::map<AbsRTTask *, Resource *> _waiting;
+        std::map<Resource *, std::deque<AbsRTTask *> > _blocked;
+
+        /// the owners executing in servers other than their own
+        std::map<Guest, BWIModel *> _guests;
+
+        /**
+           The guests removed while executing, which stay on the
+           processor until the host dispatches again (as a task
+           releasing a resource in its last instruction must end
+           there)
+        */
+        std::map<Guest, BWIModel *> _leaving;
+
+        Server *homeOf(AbsRTTask *t);
+
+        /// The running task at the end of the wait-for chain of t
+        AbsRTTask *chainEnd(AbsRTTask *t);
+
+        /// Removes t from the queue of s, and from its CPU if executing
+        void leave(Server *s, AbsRTTask *t);
+
+        void addGuest(const Guest &g, const std::vector<TaskModel *> &donors);
+        void removeGuest(const Guest &g);
+
+        /// Deletes the models of the guests that left their hosts
+        void purge(bool all = false);
+
+        /// Makes the guests match the current wait-for chains
+        void updateGuests();
+
     public:
-        BWI(const string &n);
+        BWI(const string &n = "");
         ~BWI();
 
+        /// The server executing t, if not its own one
+        Server *getHost(const AbsRTTask *t) const;
+
+        /// Returns true if t is blocked on a resource
+        bool isBlocked(AbsRTTask *t) const { return _waiting.count(t) > 0; }
+
+        void newRun();
+        void endRun();
+
     protected:
 
-        std::map<Server *, Scheduler *> schedulers;
+        void addServer(Server *serv);
 
-        void addServer(Server *serv, Scheduler *sched);
+        /// Called by the server of t, when t ends in the host
+        void onGuestEnd(Server *host, AbsRTTask *t);
 
         virtual bool request(AbsRTTask *t, Resource *r, int n=1);
         virtual void release(AbsRTTask *t, Resource *r, int n=1);
@@ -29,4 +131,3 @@ namespace RTSim {
 
 
 #endif
-
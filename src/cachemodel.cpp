@@ -0,0 +1,155 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <algorithm>
+
+#include <simul.hpp>
+
+#include <cachemodel.hpp>
+#include <task.hpp>
+
+namespace RTSim {
+
+    using namespace std;
+    using namespace MetaSim;
+
+    CacheDelayModel::CacheDelayModel(Topology *topo, Tick decay,
+                                     const string &name) :
+        Entity(name), _topo(topo), _decay(decay), _tasks(), _load()
+    {
+    }
+
+    void CacheDelayModel::addTask(Task *t, double reload, double footprint)
+    {
+        TaskState &s = _tasks[t];
+        s.reload = reload;
+        s.footprint = footprint;
+        s.warm = false;
+        s.last = 0;
+        s.left = 0;
+        s.load = 0;
+        s.crpd = s.crmd = 0;
+        s.preemptions = s.migrations = 0;
+        t->setCacheModel(this);
+    }
+
+    int CacheDelayModel::cache(CPU *c) const
+    {
+        if (_topo) return _topo->getDomain(c, Topology::SHARED_L2);
+        return c->getIndex();
+    }
+
+    double CacheDelayModel::onSchedule(Task *t, CPU *c)
+    {
+        map<const Task *, TaskState>::iterator i = _tasks.find(t);
+        if (i == _tasks.end()) return 0;
+
+        TaskState &s = i->second;
+        int k = cache(c);
+        double delay = 0;
+        double loaded = 1;
+
+        if (s.warm && cache(s.last) == k) {
+            loaded = _load[k] - s.load;
+            if (_decay > 0)
+                loaded += double(SIMUL.getTime() - s.left) / double(_decay);
+            loaded = min(loaded, 1.0);
+            delay = s.reload * loaded;
+            if (delay > 0) {
+                s.crpd += delay;
+                s.preemptions++;
+            }
+        }
+        else if (s.warm) {
+            double f = 1;
+            if (_topo) f = _topo->getReloadFactor(_topo->getLevel(s.last, c));
+            delay = s.reload * f;
+            s.crmd += delay;
+            s.migrations++;
+        }
+
+        // what this task reloads evicts the others
+        _load[k] += s.footprint * loaded;
+        return delay;
+    }
+
+    void CacheDelayModel::onDeschedule(Task *t, CPU *c)
+    {
+        map<const Task *, TaskState>::iterator i = _tasks.find(t);
+        if (i == _tasks.end() || !c) return;
+
+        TaskState &s = i->second;
+        s.warm = true;
+        s.last = c;
+        s.left = SIMUL.getTime();
+        s.load = _load[cache(c)];
+    }
+
+    const CacheDelayModel::TaskState *
+    CacheDelayModel::state(const Task *t) const
+    {
+        map<const Task *, TaskState>::const_iterator i = _tasks.find(t);
+        return i != _tasks.end() ? &i->second : 0;
+    }
+
+    double CacheDelayModel::getPreemptionDelay(const Task *t) const
+    {
+        const TaskState *s = state(t);
+        return s ? s->crpd : 0;
+    }
+
+    double CacheDelayModel::getMigrationDelay(const Task *t) const
+    {
+        const TaskState *s = state(t);
+        return s ? s->crmd : 0;
+    }
+
+    unsigned CacheDelayModel::getPreemptions(const Task *t) const
+    {
+        const TaskState *s = state(t);
+        return s ? s->preemptions : 0;
+    }
+
+    unsigned CacheDelayModel::getMigrations(const Task *t) const
+    {
+        const TaskState *s = state(t);
+        return s ? s->migrations : 0;
+    }
+
+    void CacheDelayModel::print(ostream &os) const
+    {
+        os << "Cache-related delays (preemption / migration):" << endl;
+        for (map<const Task *, TaskState>::const_iterator i = _tasks.begin();
+             i != _tasks.end(); ++i)
+            os << "  task " << i->first->getName() << ": "
+               << i->second.crpd << " (" << i->second.preemptions << ") / "
+               << i->second.crmd << " (" << i->second.migrations << ")"
+               << endl;
+    }
+
+    void CacheDelayModel::newRun()
+    {
+        for (map<const Task *, TaskState>::iterator i = _tasks.begin();
+             i != _tasks.end(); ++i) {
+            TaskState &s = i->second;
+            s.warm = false;
+            s.last = 0;
+            s.left = 0;
+            s.load = 0;
+            s.crpd = s.crmd = 0;
+            s.preemptions = s.migrations = 0;
+        }
+        _load.clear();
+    }
+
+} // namespace RTSim
@@ -0,0 +1,128 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __CACHEMODEL_HPP__
+#define __CACHEMODEL_HPP__
+
+#include <iostream>
+#include <map>
+#include <string>
+
+#include <entity.hpp>
+
+#include <cpu.hpp>
+#include <topology.hpp>
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    class Task;
+
+    /**
+       \ingroup stat
+
+       Cache-related preemption and migration delays (CRPD and CRMD).
+       Every task has a working set, whose reload from memory costs
+       reload ticks at the maximum speed, and which occupies a
+       fraction footprint of the cache it runs on (the L2 of the
+       Topology, or the CPU without a topology).
+
+       When a task is scheduled again on the same cache, the part of
+       its working set that has been evicted is the sum of what the
+       tasks executed in between have loaded in that cache, plus the
+       elapsed time divided by the decay time (if any), up to 1; the
+       task pays reload times this fraction (CRPD). When it is
+       scheduled on a CPU with another cache, it pays reload times the
+       reload factor of the level shared with the previous CPU (CRMD).
+       The first execution of a task is never charged: the cold start
+       is in the WCET.
+
+       The delay is added to the remaining execution of the ExecInstr
+       that resumes (see Task::setCacheModel()), so it is scaled by the
+       speed of the CPU like the rest of the work.
+
+       \code
+       CacheDelayModel cache(&topo);
+       cache.addTask(&t1, 3, 0.4);
+       cache.addTask(&t2, 2, 0.7);
+       ...
+       cache.print(cout);
+       \endcode
+    */
+    class CacheDelayModel : public Entity {
+    public:
+        /**
+           @param topo the topology of the platform, or NULL if every
+                  CPU has its own cache and the migrations reload
+                  the whole working set
+           @param decay time after which a working set is completely
+                  evicted in any case (0 for never)
+        */
+        CacheDelayModel(Topology *topo = NULL, Tick decay = 0,
+                        const std::string &name = "CacheDelayModel");
+
+        /// Models the cache of t (it calls t->setCacheModel(this))
+        void addTask(Task *t, double reload, double footprint);
+
+        /// Called when t starts executing on c; returns the delay
+        double onSchedule(Task *t, CPU *c);
+
+        /// Called when t stops executing on c
+        void onDeschedule(Task *t, CPU *c);
+
+        /// Total preemption delay of t
+        double getPreemptionDelay(const Task *t) const;
+
+        /// Total migration delay of t
+        double getMigrationDelay(const Task *t) const;
+
+        double getOverhead(const Task *t) const
+        { return getPreemptionDelay(t) + getMigrationDelay(t); }
+
+        unsigned getPreemptions(const Task *t) const;
+        unsigned getMigrations(const Task *t) const;
+
+        void print(std::ostream &os) const;
+
+        void newRun();
+        void endRun() {}
+
+    private:
+        struct TaskState {
+            double reload;
+            double footprint;
+            bool warm;
+            CPU *last;
+            Tick left;
+            double load;
+            double crpd;
+            double crmd;
+            unsigned preemptions;
+            unsigned migrations;
+        };
+
+        Topology *_topo;
+        Tick _decay;
+        std::map<const Task *, TaskState> _tasks;
+
+        /// Footprint loaded so far in each cache
+        std::map<int, double> _load;
+
+        int cache(CPU *c) const;
+        const TaskState *state(const Task *t) const;
+    };
+
+} // namespace RTSim
+
+#endif
@@ -0,0 +1,307 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <algorithm>
+#include <cmath>
+
+#include <particle.hpp>
+#include <simul.hpp>
+
+#include <chain.hpp>
+#include <profiler.hpp>
+
+namespace RTSim {
+
+    using namespace std;
+    using namespace MetaSim;
+
+    //  CHAIN  *************************************************
+    CauseEffectChain::CauseEffectChain(const string &name,
+                                       const vector<Task *> &tasks) :
+        _name(name), _tasks(tasks), _job(tasks.size()),
+        _label(tasks.size()), _reacted(), _ages(), _reactions(),
+        _ageStats(), _reactionStats()
+    {
+        reset();
+    }
+
+    void CauseEffectChain::reset()
+    {
+        for (unsigned k = 0; k < _tasks.size(); ++k)
+            _job[k].valid = _label[k].valid = false;
+        _reacted.valid = false;
+        _ages.clear();
+        _reactions.clear();
+    }
+
+    void CauseEffectChain::output(const Stamp &s)
+    {
+        if (!s.valid) return;
+
+        Tick now = SIMUL.getTime();
+        double age = double(now - s.t);
+        _ages.push_back(age);
+        for (unsigned i = 0; i < _ageStats.size(); ++i)
+            _ageStats[i]->record(age);
+
+        if (_reacted.valid && s.t <= _reacted.t) return;
+        if (_reacted.valid) {
+            double r = double(now - _reacted.t);
+            _reactions.push_back(r);
+            for (unsigned i = 0; i < _reactionStats.size(); ++i)
+                _reactionStats[i]->record(r);
+        }
+        _reacted = s;
+    }
+
+    double CauseEffectChain::percentile(vector<double> v, double p)
+    {
+        if (v.empty()) return 0;
+        // nearest rank
+        long k = long(ceil(p / 100 * v.size())) - 1;
+        k = max(0L, min(k, long(v.size()) - 1));
+        nth_element(v.begin(), v.begin() + k, v.end());
+        return v[k];
+    }
+
+    static double maxOf(const vector<double> &v)
+    {
+        return v.empty() ? 0 : *max_element(v.begin(), v.end());
+    }
+
+    static double meanOf(const vector<double> &v)
+    {
+        double s = 0;
+        for (unsigned i = 0; i < v.size(); ++i) s += v[i];
+        return v.empty() ? 0 : s / v.size();
+    }
+
+    double CauseEffectChain::getMaxDataAge() const { return maxOf(_ages); }
+    double CauseEffectChain::getMeanDataAge() const { return meanOf(_ages); }
+    double CauseEffectChain::getDataAgePercentile(double p) const
+    {
+        return percentile(_ages, p);
+    }
+
+    double CauseEffectChain::getMaxReactionTime() const
+    {
+        return maxOf(_reactions);
+    }
+
+    double CauseEffectChain::getMeanReactionTime() const
+    {
+        return meanOf(_reactions);
+    }
+
+    double CauseEffectChain::getReactionTimePercentile(double p) const
+    {
+        return percentile(_reactions, p);
+    }
+
+    void CauseEffectChain::print(ostream &os) const
+    {
+        os << "Chain " << _name << ": " << getOutputs() << " outputs" << endl
+           << "  data age: max " << getMaxDataAge()
+           << " mean " << getMeanDataAge()
+           << " p99 " << getDataAgePercentile(99) << endl
+           << "  reaction time: max " << getMaxReactionTime()
+           << " mean " << getMeanReactionTime()
+           << " p99 " << getReactionTimePercentile(99) << endl;
+    }
+
+    void LETPublishEvt::doit()
+    {
+        _m->onPublish(_task);
+    }
+
+    //  MANAGER  ***********************************************
+    ChainManager::ChainManager(const string &name) :
+        Entity(name), _comm(), _chains()
+    {
+    }
+
+    ChainManager::~ChainManager()
+    {
+        for (map<Task *, Comm>::iterator i = _comm.begin();
+             i != _comm.end(); ++i)
+            delete i->second.evt;
+        for (unsigned i = 0; i < _chains.size(); ++i)
+            delete _chains[i];
+    }
+
+    ChainManager::Comm &ChainManager::comm(Task *t)
+    {
+        map<Task *, Comm>::iterator i = _comm.find(t);
+        if (i != _comm.end()) return i->second;
+
+        Comm &c = _comm[t];
+        c.sem = IMPLICIT;
+        c.let = 0;
+        c.started = false;
+        c.evt = new LETPublishEvt(this, t);
+        new Particle<ArrEvt, ChainManager>(&t->arrEvt, this);
+        new Particle<SchedEvt, ChainManager>(&t->schedEvt, this);
+        new Particle<EndEvt, ChainManager>(&t->endEvt, this);
+        new Particle<KillEvt, ChainManager>(&t->killEvt, this);
+        return c;
+    }
+
+    void ChainManager::setSemantics(Task *t, Semantics s, Tick let)
+    {
+        Comm &c = comm(t);
+        c.sem = s;
+        c.let = let;
+    }
+
+    void ChainManager::addRead(Task *t, const string &label)
+    {
+        comm(t).reads.insert(label);
+    }
+
+    void ChainManager::addWrite(Task *t, const string &label)
+    {
+        comm(t).writes.insert(label);
+    }
+
+    CauseEffectChain *ChainManager::addChain(const string &name,
+                                             const vector<Task *> &tasks)
+    {
+        if (tasks.empty()) throw ChainExc("Empty chain " + name);
+
+        for (unsigned k = 0; k + 1 < tasks.size(); ++k) {
+            const set<string> &w = comm(tasks[k]).writes;
+            const set<string> &r = comm(tasks[k + 1]).reads;
+            bool shared = false;
+            for (set<string>::const_iterator i = w.begin();
+                 i != w.end() && !shared; ++i)
+                shared = r.count(*i) > 0;
+            if (!shared)
+                throw ChainExc("In chain " + name + ", " +
+                               tasks[k + 1]->getName() + " reads nothing "
+                               "written by " + tasks[k]->getName());
+        }
+
+        CauseEffectChain *c = new CauseEffectChain(name, tasks);
+        _chains.push_back(c);
+        for (unsigned k = 0; k < tasks.size(); ++k)
+            comm(tasks[k]).pos.push_back(make_pair(c, k));
+        return c;
+    }
+
+    void ChainManager::read(Comm &c)
+    {
+        for (unsigned i = 0; i < c.pos.size(); ++i) {
+            CauseEffectChain *ch = c.pos[i].first;
+            unsigned k = c.pos[i].second;
+            if (k == 0) {
+                // the first task samples the input
+                ch->_job[k].t = SIMUL.getTime();
+                ch->_job[k].valid = true;
+            }
+            else ch->_job[k] = ch->_label[k - 1];
+        }
+    }
+
+    vector<CauseEffectChain::Stamp> ChainManager::current(const Comm &c) const
+    {
+        vector<CauseEffectChain::Stamp> s;
+        for (unsigned i = 0; i < c.pos.size(); ++i)
+            s.push_back(c.pos[i].first->_job[c.pos[i].second]);
+        return s;
+    }
+
+    void ChainManager::write(Comm &c,
+                             const vector<CauseEffectChain::Stamp> &s)
+    {
+        for (unsigned i = 0; i < c.pos.size(); ++i) {
+            CauseEffectChain *ch = c.pos[i].first;
+            unsigned k = c.pos[i].second;
+            if (k + 1 < ch->_tasks.size()) ch->_label[k] = s[i];
+            else ch->output(s[i]);
+        }
+    }
+
+    void ChainManager::probe(ArrEvt &e)
+    {
+        PROFILE_SCOPE("ChainManager::probe");
+        Task *t = e.getTask();
+        Comm &c = comm(t);
+        if (c.sem != LET) return;
+
+        read(c);
+        Pending p;
+        p.time = SIMUL.getTime() + (c.let > 0 ? c.let : t->getRelDline());
+        p.stamps = current(c);
+        c.pending.push_back(p);
+        if (c.pending.size() == 1) c.evt->post(p.time);
+    }
+
+    void ChainManager::probe(SchedEvt &e)
+    {
+        PROFILE_SCOPE("ChainManager::probe");
+        Comm &c = comm(e.getTask());
+        if (c.sem != IMPLICIT || c.started) return;
+        c.started = true;
+        read(c);
+    }
+
+    void ChainManager::probe(EndEvt &e)
+    {
+        PROFILE_SCOPE("ChainManager::probe");
+        Comm &c = comm(e.getTask());
+        c.started = false;
+        if (c.sem != IMPLICIT) return;
+        write(c, current(c));
+    }
+
+    void ChainManager::probe(KillEvt &e)
+    {
+        PROFILE_SCOPE("ChainManager::probe");
+        comm(e.getTask()).started = false;
+    }
+
+    void ChainManager::onPublish(Task *t)
+    {
+        Comm &c = comm(t);
+        if (c.pending.empty()) return;
+
+        write(c, c.pending.front().stamps);
+        c.pending.pop_front();
+        if (!c.pending.empty()) c.evt->post(c.pending.front().time);
+    }
+
+    void ChainManager::print(ostream &os) const
+    {
+        for (unsigned i = 0; i < _chains.size(); ++i)
+            _chains[i]->print(os);
+    }
+
+    void ChainManager::newRun()
+    {
+        for (map<Task *, Comm>::iterator i = _comm.begin();
+             i != _comm.end(); ++i) {
+            i->second.started = false;
+            i->second.pending.clear();
+        }
+        for (unsigned i = 0; i < _chains.size(); ++i)
+            _chains[i]->reset();
+    }
+
+    void ChainManager::endRun()
+    {
+        for (map<Task *, Comm>::iterator i = _comm.begin();
+             i != _comm.end(); ++i)
+            i->second.evt->drop();
+    }
+
+} // namespace RTSim
@@ -0,0 +1,220 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __CHAIN_HPP__
+#define __CHAIN_HPP__
+
+#include <deque>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <baseexc.hpp>
+#include <basestat.hpp>
+#include <entity.hpp>
+#include <event.hpp>
+
+#include <task.hpp>
+#include <taskevt.hpp>
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    class ChainManager;
+
+    class ChainExc : public BaseExc {
+    public:
+        ChainExc(const std::string &msg) :
+            BaseExc(msg, "ChainManager", "chain.cpp") {}
+    };
+
+    /**
+       \ingroup stat
+
+       A cause-effect chain: a sequence of tasks, each one reading a
+       label written by the previous one. The first task samples the
+       input of the chain when it reads, the last one produces the
+       output when it writes. For every output the chain measures:
+
+       - the data age: the time from the sample the output is based
+         on to the output;
+       - the reaction time, when the output is based on a newer
+         sample than the previous outputs: the time from the previous
+         such sample (an input change just after it is seen for the
+         first time by this output) to the output.
+
+       The samples are kept for the percentiles, and can also be
+       recorded on MetaSim statistics.
+    */
+    class CauseEffectChain {
+        friend class ChainManager;
+
+        struct Stamp {
+            Tick t;
+            bool valid;
+        };
+
+        std::string _name;
+        std::vector<Task *> _tasks;
+
+        /// Sample read by the current job of every task
+        std::vector<Stamp> _job;
+        /// Sample in the label written by every task
+        std::vector<Stamp> _label;
+
+        Stamp _reacted;
+        std::vector<double> _ages;
+        std::vector<double> _reactions;
+        std::vector<BaseStat *> _ageStats;
+        std::vector<BaseStat *> _reactionStats;
+
+        CauseEffectChain(const std::string &name,
+                         const std::vector<Task *> &tasks);
+
+        void output(const Stamp &s);
+        void reset();
+
+        static double percentile(std::vector<double> v, double p);
+
+    public:
+        const std::string &getName() const { return _name; }
+        const std::vector<Task *> &getTasks() const { return _tasks; }
+
+        /// Records every data age also on s
+        void addDataAgeStat(BaseStat *s) { _ageStats.push_back(s); }
+        /// Records every reaction time also on s
+        void addReactionStat(BaseStat *s) { _reactionStats.push_back(s); }
+
+        unsigned long getOutputs() const { return _ages.size(); }
+
+        double getMaxDataAge() const;
+        double getMeanDataAge() const;
+        /// p-th percentile (0 < p <= 100) of the data age
+        double getDataAgePercentile(double p) const;
+
+        double getMaxReactionTime() const;
+        double getMeanReactionTime() const;
+        double getReactionTimePercentile(double p) const;
+
+        void print(std::ostream &os) const;
+    };
+
+    /// Publishes the outputs of a LET job at the end of its interval
+    class LETPublishEvt : public Event {
+        ChainManager *_m;
+        Task *_task;
+    public:
+        LETPublishEvt(ChainManager *m, Task *t) :
+            Event(_DEFAULT_PRIORITY - 3), _m(m), _task(t) {}
+        virtual void doit();
+    };
+
+    /**
+       \ingroup stat
+
+       Communication of the tasks through labels, and measure of the
+       cause-effect chains. Every task declares the labels it reads
+       and writes, and its semantics:
+
+       - IMPLICIT: a job reads its labels when it starts executing and
+         writes them when it ends;
+       - LET (logical execution time): a job reads its labels at its
+         release and publishes them at the end of its LET (the
+         relative deadline of the task by default), whenever it
+         completes; publishing happens before the releases of the same
+         instant.
+
+       Only the task events are probed, so the tasks can be on any
+       kernel (also on different CPUs of multiprocessor and
+       partitioned kernels).
+
+       \code
+       ChainManager cm;
+       cm.addWrite(&sensor, "raw");
+       cm.addRead(&filter, "raw");
+       cm.addWrite(&filter, "filtered");
+       cm.addRead(&control, "filtered");
+       cm.setSemantics(&control, ChainManager::LET);
+       vector<Task *> tasks = {&sensor, &filter, &control};
+       CauseEffectChain *c = cm.addChain("control", tasks);
+       ...
+       cout << c->getDataAgePercentile(99) << endl;
+       \endcode
+    */
+    class ChainManager : public Entity {
+    public:
+        typedef enum { IMPLICIT, LET } Semantics;
+
+        ChainManager(const std::string &name = "ChainManager");
+        ~ChainManager();
+
+        /// @param let the LET of the task; 0 for its relative deadline
+        void setSemantics(Task *t, Semantics s, Tick let = 0);
+
+        void addRead(Task *t, const std::string &label);
+        void addWrite(Task *t, const std::string &label);
+
+        /**
+           Adds a chain; every task must write a label read by the
+           next one, otherwise a ChainExc is thrown.
+        */
+        CauseEffectChain *addChain(const std::string &name,
+                                   const std::vector<Task *> &tasks);
+
+        void print(std::ostream &os) const;
+
+        void probe(ArrEvt &e);
+        void probe(SchedEvt &e);
+        void probe(EndEvt &e);
+        void probe(KillEvt &e);
+
+        void onPublish(Task *t);
+
+        void newRun();
+        void endRun();
+
+    private:
+        typedef std::pair<CauseEffectChain *, unsigned> Position;
+
+        struct Pending {
+            Tick time;
+            std::vector<CauseEffectChain::Stamp> stamps;
+        };
+
+        struct Comm {
+            Semantics sem;
+            Tick let;
+            std::set<std::string> reads;
+            std::set<std::string> writes;
+            std::vector<Position> pos;
+            bool started;
+            std::deque<Pending> pending;
+            LETPublishEvt *evt;
+        };
+
+        std::map<Task *, Comm> _comm;
+        std::vector<CauseEffectChain *> _chains;
+
+        Comm &comm(Task *t);
+        void read(Comm &c);
+        std::vector<CauseEffectChain::Stamp> current(const Comm &c) const;
+        void write(Comm &c, const std::vector<CauseEffectChain::Stamp> &s);
+    };
+
+} // namespace RTSim
+
+#endif
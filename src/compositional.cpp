@@ -0,0 +1,278 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <algorithm>
+
+#include <rttask.hpp>
+#include <partionedmrtkernel.hpp>
+#include <SchedulerFactory.hpp>
+#include <periodicservervm.hpp>
+
+#include "compositional.hpp"
+
+namespace RTSim {
+
+    using namespace std;
+
+    static const double EPS = 1e-9;
+
+    static long long gcd(long long a, long long b)
+    {
+        while (b) {
+            long long r = a % b;
+            a = b;
+            b = r;
+        }
+        return a;
+    }
+
+    CompositionalAnalysis::CompositionalAnalysis(Policy p) :
+        _policy(p), _tasks()
+    {
+    }
+
+    CompositionalAnalysis::CompositionalAnalysis(AbsSchedulerFactory *f) :
+        _policy(EDF), _tasks()
+    {
+        if (dynamic_cast<EDFSchedulerFactory *>(f)) _policy = EDF;
+        else if (dynamic_cast<RMSchedulerFactory *>(f)) _policy = RM;
+        else throw CompositionalExc("Unknown scheduler factory");
+    }
+
+    void CompositionalAnalysis::addTask(Tick wcet, Tick period, Tick deadline)
+    {
+        if (wcet <= 0 || period <= 0 || deadline < 0)
+            throw CompositionalExc("Wrong task parameters");
+        TaskParams p = {wcet, period, deadline == 0 ? period : deadline};
+        _tasks.push_back(p);
+    }
+
+    void CompositionalAnalysis::addTask(PeriodicTask &t)
+    {
+        addTask(t.getWCET(), t.getPeriod(), t.getRelDline());
+    }
+
+    vector<CompositionalAnalysis::TaskParams>
+    CompositionalAnalysis::byPriority() const
+    {
+        vector<TaskParams> ts(_tasks);
+        if (_policy == RM) {
+            // stable insertion sort: equal periods keep their order
+            for (unsigned i = 1; i < ts.size(); ++i)
+                for (unsigned k = i; k > 0 && ts[k].period < ts[k - 1].period; --k)
+                    swap(ts[k], ts[k - 1]);
+        }
+        return ts;
+    }
+
+    Tick CompositionalAnalysis::hyperperiod() const
+    {
+        long long h = 1;
+        for (unsigned i = 0; i < _tasks.size(); ++i) {
+            long long p = (long long)_tasks[i].period;
+            h = h / gcd(h, p) * p;
+        }
+        return Tick(h);
+    }
+
+    vector<Tick> CompositionalAnalysis::edfPoints() const
+    {
+        Tick maxd = 0;
+        for (unsigned i = 0; i < _tasks.size(); ++i)
+            maxd = max(maxd, _tasks[i].deadline);
+        Tick l = hyperperiod() * 2 + maxd;
+
+        vector<Tick> pts;
+        for (unsigned i = 0; i < _tasks.size(); ++i)
+            for (Tick d = _tasks[i].deadline; d <= l; d += _tasks[i].period)
+                pts.push_back(d);
+        sort(pts.begin(), pts.end());
+        pts.erase(unique(pts.begin(), pts.end()), pts.end());
+        return pts;
+    }
+
+    vector<Tick> CompositionalAnalysis::fpPoints(const vector<TaskParams> &ts,
+                                                 unsigned i) const
+    {
+        vector<Tick> pts(1, ts[i].deadline);
+        for (unsigned j = 0; j < i; ++j)
+            for (Tick t = ts[j].period; t < ts[i].deadline; t += ts[j].period)
+                pts.push_back(t);
+        sort(pts.begin(), pts.end());
+        pts.erase(unique(pts.begin(), pts.end()), pts.end());
+        return pts;
+    }
+
+    double CompositionalAnalysis::dbf(Tick t) const
+    {
+        double d = 0;
+        for (unsigned i = 0; i < _tasks.size(); ++i) {
+            const TaskParams &p = _tasks[i];
+            if (t < p.deadline) continue;
+            long long n = ((long long)(t - p.deadline)) / (long long)p.period + 1;
+            d += n * double(p.wcet);
+        }
+        return d;
+    }
+
+    double CompositionalAnalysis::rbf(unsigned i, Tick t) const
+    {
+        vector<TaskParams> ts = byPriority();
+        double r = double(ts[i].wcet);
+        for (unsigned j = 0; j < i; ++j) {
+            long long T = (long long)ts[j].period;
+            r += ((long long)t + T - 1) / T * double(ts[j].wcet);
+        }
+        return r;
+    }
+
+    double CompositionalAnalysis::sbf(Tick budget, Tick period, Tick t)
+    {
+        long long q = (long long)budget;
+        long long p = (long long)period;
+        long long x = (long long)t;
+
+        if (q <= 0 || x <= 0) return 0;
+
+        long long k = 1;
+        if (x - (p - q) > 0) k = max((x - (p - q) + p - 1) / p, 1LL);
+
+        if (x >= (k + 1) * p - 2 * q && x <= (k + 1) * p - q)
+            return double(x - (k + 1) * (p - q));
+        return double((k - 1) * q);
+    }
+
+    double CompositionalAnalysis::lsbf(double alpha, double delta, Tick t)
+    {
+        return max(0.0, alpha * (double(t) - delta));
+    }
+
+    bool CompositionalAnalysis::isSchedulable(Tick budget, Tick period) const
+    {
+        if (_policy == EDF) {
+            vector<Tick> pts = edfPoints();
+            for (unsigned k = 0; k < pts.size(); ++k)
+                if (dbf(pts[k]) > sbf(budget, period, pts[k]) + EPS)
+                    return false;
+            return true;
+        }
+
+        vector<TaskParams> ts = byPriority();
+        for (unsigned i = 0; i < ts.size(); ++i) {
+            vector<Tick> pts = fpPoints(ts, i);
+            bool ok = false;
+            for (unsigned k = 0; k < pts.size() && !ok; ++k)
+                if (rbf(i, pts[k]) <= sbf(budget, period, pts[k]) + EPS)
+                    ok = true;
+            if (!ok) return false;
+        }
+        return true;
+    }
+
+    Tick CompositionalAnalysis::minBudget(Tick period) const
+    {
+        if (_tasks.empty()) throw CompositionalExc("No tasks");
+        if (!isSchedulable(period, period))
+            throw CompositionalExc("Not schedulable even on the full processor");
+
+        // smallest schedulable budget in (lo, hi]
+        Tick lo = 0, hi = period;
+        while (hi - lo > 1) {
+            Tick mid = lo + (hi - lo) / 2;
+            if (isSchedulable(mid, period)) hi = mid;
+            else lo = mid;
+        }
+        return hi;
+    }
+
+    CompositionalAnalysis::Interface
+    CompositionalAnalysis::minInterface(Tick period) const
+    {
+        Interface i = {minBudget(period), period};
+        return i;
+    }
+
+    CompositionalAnalysis::Interface
+    CompositionalAnalysis::sweepPeriod(Tick pmin, Tick pmax, Tick overhead,
+                                       Tick step) const
+    {
+        if (pmin <= 0 || pmax < pmin || step <= 0)
+            throw CompositionalExc("Wrong period range");
+
+        Interface best = {0, 0};
+        double cost = 0;
+        for (Tick p = pmin; p <= pmax; p += step) {
+            Tick q;
+            try {
+                q = minBudget(p);
+            }
+            catch (CompositionalExc &e) {
+                continue;
+            }
+            if (q + overhead > p) continue;
+
+            double c = double(q + overhead) / double(p);
+            if (best.period == 0 || c < cost - EPS) {
+                best.budget = q;
+                best.period = p;
+                cost = c;
+            }
+        }
+        if (best.period == 0)
+            throw CompositionalExc("No period in the range is feasible");
+        return best;
+    }
+
+    double CompositionalAnalysis::minAlpha(double delta) const
+    {
+        if (_tasks.empty()) throw CompositionalExc("No tasks");
+
+        double alpha = 0;
+        if (_policy == EDF) {
+            vector<Tick> pts = edfPoints();
+            for (unsigned k = 0; k < pts.size(); ++k) {
+                double d = dbf(pts[k]);
+                if (d <= 0) continue;
+                if (double(pts[k]) <= delta)
+                    throw CompositionalExc("Delay longer than a deadline");
+                alpha = max(alpha, d / (double(pts[k]) - delta));
+            }
+        }
+        else {
+            vector<TaskParams> ts = byPriority();
+            for (unsigned i = 0; i < ts.size(); ++i) {
+                vector<Tick> pts = fpPoints(ts, i);
+                double a = -1;
+                for (unsigned k = 0; k < pts.size(); ++k) {
+                    if (double(pts[k]) <= delta) continue;
+                    double x = rbf(i, pts[k]) / (double(pts[k]) - delta);
+                    if (a < 0 || x < a) a = x;
+                }
+                if (a < 0)
+                    throw CompositionalExc("Delay longer than a deadline");
+                alpha = max(alpha, a);
+            }
+        }
+
+        if (alpha > 1 + EPS)
+            throw CompositionalExc("No bandwidth is enough for the delay");
+        return alpha;
+    }
+
+    void CompositionalAnalysis::instantiate(PeriodicServerVM &vm,
+                                            const std::string &name,
+                                            const Interface &i)
+    {
+        vm.createFromQP(name, i.budget, i.period);
+    }
+}
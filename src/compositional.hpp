@@ -0,0 +1,154 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __COMPOSITIONAL_HPP__
+#define __COMPOSITIONAL_HPP__
+
+#include <string>
+#include <vector>
+
+#include <baseexc.hpp>
+#include <simul.hpp>
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    class AbsSchedulerFactory;
+    class PeriodicServerVM;
+    class PeriodicTask;
+
+    /**
+       Exception thrown when no interface can make the tasks of a VM
+       schedulable.
+    */
+    class CompositionalExc : public BaseExc {
+    public:
+        CompositionalExc(const string &msg) :
+            BaseExc(msg, "CompositionalAnalysis", "compositional.cpp") {}
+    };
+
+    /**
+       Compositional analysis of a VM (Shin and Lee, 2003): derives
+       the periodic resource model (Q, P), or the bounded-delay
+       interface (alpha, Delta), of minimum bandwidth that keeps the
+       tasks of the VM schedulable by its inner scheduler.
+
+       The tasks are schedulable on (Q, P) if their demand never
+       exceeds the supply bound function of the resource,
+
+           sbf(t) = t - (k+1)(P-Q)   if t in [(k+1)P - 2Q, (k+1)P - Q]
+                    (k-1)Q           otherwise
+
+       with k = max(ceil((t - (P-Q)) / P), 1). The demand is the
+       demand bound function under EDF (checked at the deadlines up
+       to 2H + max D, with H the hyperperiod), and the request bound
+       function of every task under FP (checked at the scheduling
+       points of the task).
+
+       The minimum budget for a period is found by bisection, since
+       the supply grows with the budget; sweepPeriod() then chooses
+       the period that minimizes the bandwidth plus the overhead of
+       one server context switch per period.
+    */
+    class CompositionalAnalysis {
+    public:
+        /// Inner scheduler: FP uses the order in which tasks are added
+        typedef enum {EDF, RM, FP} Policy;
+
+        /// A periodic resource model
+        struct Interface {
+            Tick budget;
+            Tick period;
+
+            double bandwidth() const { return double(budget) / double(period); }
+            /// The bounded-delay interface of the resource
+            double alpha() const { return bandwidth(); }
+            double delta() const { return 2.0 * double(period - budget); }
+        };
+
+    private:
+        struct TaskParams {
+            Tick wcet;
+            Tick period;
+            Tick deadline;
+        };
+
+        Policy _policy;
+        std::vector<TaskParams> _tasks;
+
+        /// Tasks in priority order (for FP and RM)
+        std::vector<TaskParams> byPriority() const;
+
+        Tick hyperperiod() const;
+
+        /// Instants where the demand has to be checked, per task for FP
+        std::vector<Tick> edfPoints() const;
+        std::vector<Tick> fpPoints(const std::vector<TaskParams> &ts,
+                                   unsigned i) const;
+
+    public:
+        CompositionalAnalysis(Policy p = EDF);
+
+        /// The policy of the schedulers made by the factory
+        CompositionalAnalysis(AbsSchedulerFactory *f);
+
+        /// Deadline 0 means equal to the period
+        void addTask(Tick wcet, Tick period, Tick deadline = 0);
+        void addTask(PeriodicTask &t);
+
+        Policy getPolicy() const { return _policy; }
+
+        /// Demand bound function of the tasks (EDF)
+        double dbf(Tick t) const;
+
+        /// Request bound function of the i-th task in priority order
+        double rbf(unsigned i, Tick t) const;
+
+        static double sbf(Tick budget, Tick period, Tick t);
+
+        /// Linear lower bound of the supply of an (alpha, Delta) interface
+        static double lsbf(double alpha, double delta, Tick t);
+
+        bool isSchedulable(Tick budget, Tick period) const;
+
+        /**
+           Minimum budget for the period; throws CompositionalExc if
+           not even the full processor (Q = P) is enough.
+        */
+        Tick minBudget(Tick period) const;
+
+        Interface minInterface(Tick period) const;
+
+        /**
+           Tries every period in [pmin, pmax] with the given step,
+           and returns the interface of minimum bandwidth plus
+           overhead / P, where overhead is the cost of a server
+           switch.
+        */
+        Interface sweepPeriod(Tick pmin, Tick pmax, Tick overhead = 0,
+                              Tick step = 1) const;
+
+        /**
+           Minimum alpha of a bounded-delay interface with delay
+           delta; throws CompositionalExc if no alpha <= 1 is enough.
+        */
+        double minAlpha(double delta) const;
+
+        /// Creates the VM with the parameters of the interface
+        static void instantiate(PeriodicServerVM &vm, const std::string &name,
+                                const Interface &i);
+    };
+}
+
+#endif
@@ -18,14 +18,16 @@ namespace RTSim {
     int CPU::instances = 0;
   
     CPU::CPU(const std::string &name): Entity(name), frequencySwitching(0),
-                                       index(0)
+                                       index(0), coreType(), scaling(1),
+                                       powerFactor(1)
     {
         cpuName = name;
         PowerSaving = false;
     }
 
     CPU::CPU(const std::string &name, int cpuIndex): Entity(name), frequencySwitching(0),
-                                       index(cpuIndex)
+                                       index(cpuIndex), coreType(),
+                                       scaling(1), powerFactor(1)
     {
         cpuName = name;
         PowerSaving = false;
@@ -33,7 +35,8 @@ namespace RTSim {
   
   
     CPU::CPU(const std::string &name, int num_levels, double V[], int F[]) : 
-        Entity(name), frequencySwitching(0), index(instances++)
+        Entity(name), frequencySwitching(0), index(instances++), coreType(),
+        scaling(1), powerFactor(1)
     {
         cpuName = name;
     
@@ -74,7 +77,7 @@ namespace RTSim {
     {
         int numlevels = steps.size();
         if (PowerSaving) 
-            return (steps[numlevels-1].frequency)*(steps[numlevels-1].voltage)*(steps[numlevels-1].voltage);
+            return powerFactor*(steps[numlevels-1].frequency)*(steps[numlevels-1].voltage)*(steps[numlevels-1].voltage);
         else
             return 0;
     } 
@@ -82,7 +85,7 @@ namespace RTSim {
     double CPU::getCurrentPowerConsumption()
     {
         if (PowerSaving) 
-            return (steps[currentLevel].frequency)*(steps[currentLevel].voltage)*(steps[currentLevel].voltage);
+            return powerFactor*(steps[currentLevel].frequency)*(steps[currentLevel].voltage)*(steps[currentLevel].voltage);
         else
             return 0;
     }
@@ -109,10 +112,16 @@ namespace RTSim {
             DBGPRINT("pwr: currentLevel=" << currentLevel);
             for (int i=0; i < (int) steps.size(); i++) 
                 if (steps[i].speed >= newLoad) {
+                    int oldLevel = currentLevel;
                     if (i != currentLevel) 
                         frequencySwitching++;
                     currentLevel = i;
                     DBGPRINT("pwr: New Level=" << currentLevel <<" New Speed=" << steps[currentLevel].speed);
+                    if (i != oldLevel)
+                        for (unsigned j = 0; j < observers.size(); j++)
+                            observers[j]->onSpeedChange(this,
+                                                        steps[oldLevel].speed,
+                                                        steps[i].speed);
                     
                     return steps[i].speed; //It returns the new speed
                 }
@@ -40,6 +40,23 @@ namespace RTSim {
         double speed;
     };
 
+    class CPU;
+
+    /**
+       \ingroup kernels
+
+       Interface of the objects that want to know when the speed of a
+       CPU changes (see CPU::addObserver()).
+    */
+    class CPUObserver {
+    public:
+        /// Called by CPU::setSpeed() after the level has changed
+        virtual void onSpeedChange(CPU *c, double oldSpeed,
+                                   double newSpeed) = 0;
+
+        virtual ~CPUObserver() {}
+    };
+
     /** 
         \ingroup kernels
       
@@ -71,6 +88,17 @@ namespace RTSim {
 
         static int instances;
 
+        vector<CPUObserver *> observers;
+
+        /// Type of core, for the heterogeneous platforms
+        string coreType;
+
+        /// Default execution time factor of the core type
+        double scaling;
+
+        /// Scales the power consumption of every level
+        double powerFactor;
+
     public:
         /// Constructor for CPUs without Power Saving
         CPU(const std::string &name = "");
@@ -89,6 +117,25 @@ namespace RTSim {
         /// get the processor index
         int getIndex() { return index; }
 
+        /**
+           Sets the type of the core (e.g. "big" or "LITTLE") and the
+           factor by which the execution times are multiplied on it
+           when the task has no factor for this type (see
+           Task::setScaling()).
+        */
+        void setType(const std::string &t, double s = 1)
+        {
+            coreType = t;
+            scaling = s;
+        }
+
+        const std::string &getType() const { return coreType; }
+
+        double getScaling() const { return scaling; }
+
+        /// Multiplies the power f * V^2 of every level by k
+        void setPowerFactor(double k) { powerFactor = k; }
+
         /// Useful for debug
         virtual int getCurrentLevel();
     
@@ -116,6 +163,9 @@ namespace RTSim {
         virtual double getSpeed(int level);
     
         virtual unsigned long int getFrequencySwitching();
+
+        /// Registers an observer of the speed changes
+        void addObserver(CPUObserver *o) { observers.push_back(o); }
     
         virtual void newRun() {}
         virtual void endRun() {}
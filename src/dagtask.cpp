@@ -0,0 +1,326 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include <particle.hpp>
+#include <simul.hpp>
+
+#include <dagtask.hpp>
+#include <edfsched.hpp>
+#include <load.hpp>
+
+namespace RTSim {
+
+    using namespace std;
+    using namespace MetaSim;
+
+    DAGTask::DAGTask(RandomVar *iat, Tick rdl, Tick ph, const string &name) :
+        Entity(name), _iat(iat), _rdl(rdl), _phase(ph), _nodes(), _index(),
+        _succ(), _npred(), _waiting(), _done(0), _releases(), _jobs(0),
+        _misses(0), _lastRT(0), _maxRT(0), _sumRT(0),
+        releaseEvt(this, &DAGTask::onRelease)
+    {
+    }
+
+    DAGTask::~DAGTask()
+    {
+        delete _iat;
+        for (unsigned i = 0; i < _nodes.size(); ++i)
+            delete _nodes[i];
+    }
+
+    Task *DAGTask::addNode(const string &code, const string &name)
+    {
+        unsigned i = _nodes.size();
+        string n = name;
+        if (n == "") {
+            ostringstream os;
+            os << getName() << "_" << i;
+            n = os.str();
+        }
+
+        Task *t = new Task(NULL, _rdl, 0, n);
+        t->setAbort(false);
+        t->insertCode(code);
+        new Particle<EndEvt, DAGTask>(&t->endEvt, this);
+        new Particle<KillEvt, DAGTask>(&t->killEvt, this);
+
+        _nodes.push_back(t);
+        _index[t] = i;
+        _succ.push_back(vector<unsigned>());
+        _npred.push_back(0);
+        return t;
+    }
+
+    void DAGTask::addEdge(Task *from, Task *to)
+    {
+        map<const Task *, unsigned>::iterator f = _index.find(from);
+        map<const Task *, unsigned>::iterator t = _index.find(to);
+        if (f == _index.end() || t == _index.end())
+            throw DAGExc("Edge between nodes of another DAG");
+        if (f->second >= t->second)
+            throw DAGExc("Edges must go from a node to a later one");
+
+        _succ[f->second].push_back(t->second);
+        _npred[t->second]++;
+    }
+
+    void DAGTask::addTo(MRTKernel *k, const string &param)
+    {
+        for (unsigned i = 0; i < _nodes.size(); ++i)
+            k->addTask(*_nodes[i], param);
+    }
+
+    Tick DAGTask::getWCET() const
+    {
+        Tick c = 0;
+        for (unsigned i = 0; i < _nodes.size(); ++i)
+            c += _nodes[i]->getWCET();
+        return c;
+    }
+
+    Tick DAGTask::getCriticalPath() const
+    {
+        // the nodes are in topological order
+        vector<Tick> f(_nodes.size(), Tick(0));
+        Tick l = 0;
+        for (unsigned i = 0; i < _nodes.size(); ++i) {
+            f[i] += _nodes[i]->getWCET();
+            l = max(l, f[i]);
+            for (unsigned j = 0; j < _succ[i].size(); ++j)
+                f[_succ[i][j]] = max(f[_succ[i][j]], f[i]);
+        }
+        return l;
+    }
+
+    Tick DAGTask::getPeriod() const
+    {
+        if (_iat) return Tick(_iat->getMinimum());
+        return _rdl;
+    }
+
+    void DAGTask::activate()
+    {
+        if (_nodes.empty()) throw DAGExc("Empty DAG " + getName());
+
+        _releases.push_back(SIMUL.getTime());
+        if (_releases.size() == 1) startJob();
+    }
+
+    void DAGTask::onRelease(Event *e)
+    {
+        activate();
+        releaseEvt.post(SIMUL.getTime() + Tick(_iat->get()));
+    }
+
+    void DAGTask::startJob()
+    {
+        _done = 0;
+        _waiting = _npred;
+        for (unsigned i = 0; i < _nodes.size(); ++i)
+            if (_npred[i] == 0) activate(i);
+    }
+
+    void DAGTask::activate(unsigned n)
+    {
+        // the node has the absolute deadline of the job
+        Tick dl = _releases.front() + _rdl;
+        _nodes[n]->setRelDline(dl - SIMUL.getTime());
+        _nodes[n]->activate();
+    }
+
+    void DAGTask::onNodeEnd(const Task *t)
+    {
+        unsigned i = _index[t];
+        for (unsigned j = 0; j < _succ[i].size(); ++j)
+            if (--_waiting[_succ[i][j]] == 0) activate(_succ[i][j]);
+
+        if (++_done < _nodes.size()) return;
+
+        Tick now = SIMUL.getTime();
+        Tick r = _releases.front();
+        _releases.pop_front();
+
+        _lastRT = now - r;
+        _maxRT = max(_maxRT, _lastRT);
+        _sumRT += double(_lastRT);
+        _jobs++;
+        if (now > r + _rdl) _misses++;
+
+        if (!_releases.empty()) startJob();
+    }
+
+    void DAGTask::probe(EndEvt &e)
+    {
+        onNodeEnd(e.getTask());
+    }
+
+    void DAGTask::probe(KillEvt &e)
+    {
+        onNodeEnd(e.getTask());
+    }
+
+    double DAGTask::getMeanResponseTime() const
+    {
+        return _jobs ? _sumRT / _jobs : 0;
+    }
+
+    void DAGTask::newRun()
+    {
+        _releases.clear();
+        _done = 0;
+        _jobs = _misses = 0;
+        _lastRT = _maxRT = 0;
+        _sumRT = 0;
+        if (_iat) releaseEvt.post(_phase);
+    }
+
+    void DAGTask::endRun()
+    {
+        releaseEvt.drop();
+    }
+
+    //  FEDERATED SCHEDULING  **********************************
+    FederatedScheduling::FederatedScheduling(int nCPU) :
+        _nCPU(nCPU), _tasks(), _kernels(), _scheds(), _kernelOf()
+    {
+    }
+
+    FederatedScheduling::~FederatedScheduling()
+    {
+        for (unsigned i = 0; i < _kernels.size(); ++i) {
+            delete _kernels[i];
+            delete _scheds[i];
+        }
+    }
+
+    void FederatedScheduling::addTask(DAGTask *t)
+    {
+        _tasks.push_back(t);
+    }
+
+    void FederatedScheduling::allocate()
+    {
+        int left = _nCPU;
+        vector<DAGTask *> light;
+
+        for (unsigned i = 0; i < _tasks.size(); ++i) {
+            DAGTask *t = _tasks[i];
+            double C = double(t->getWCET());
+            double L = double(t->getCriticalPath());
+            double D = double(t->getRelDline());
+
+            if (C <= D) {
+                light.push_back(t);
+                continue;
+            }
+            if (L >= D)
+                throw DAGExc("Critical path of " + t->getName() +
+                             " longer than its deadline");
+
+            int n = int(ceil((C - L) / (D - L)));
+            if (n > left)
+                throw DAGExc("Not enough processors for " + t->getName());
+            left -= n;
+
+            Scheduler *s = new EDFScheduler;
+            MRTKernel *k = new MRTKernel(s, n, t->getName() + "_kern");
+            t->addTo(k);
+            _scheds.push_back(s);
+            _kernels.push_back(k);
+            _kernelOf[t] = k;
+        }
+
+        if (light.empty()) return;
+        if (left <= 0)
+            throw DAGExc("No processors left for the light DAGs");
+
+        Scheduler *s = new EDFScheduler;
+        MRTKernel *k = new MRTKernel(s, left, "shared_kern");
+        for (unsigned i = 0; i < light.size(); ++i) {
+            light[i]->addTo(k);
+            _kernelOf[light[i]] = k;
+        }
+        _scheds.push_back(s);
+        _kernels.push_back(k);
+    }
+
+    MRTKernel *FederatedScheduling::getKernel(const DAGTask *t) const
+    {
+        map<const DAGTask *, MRTKernel *>::const_iterator i =
+            _kernelOf.find(t);
+        return i != _kernelOf.end() ? i->second : 0;
+    }
+
+    //  GENERATOR  *********************************************
+    RandomDAGGen::RandomDAGGen(int minNodes, int maxNodes, double edgeProb) :
+        _minNodes(minNodes), _maxNodes(maxNodes), _edgeProb(edgeProb)
+    {
+    }
+
+    DAGTask *RandomDAGGen::generate(const RandomTaskSetFactory &ts, int i)
+    {
+        UniformVar r(0, 1);
+
+        int n = _minNodes + int(r.get() * (_maxNodes - _minNodes + 1));
+        n = min(n, _maxNodes);
+        long long C = (long long)ts.getAvgCT(i);
+        if (C < n) n = max(1, int(C));
+
+        // random WCETs of at least 1 that sum to C
+        vector<double> w(n);
+        double sum = 0;
+        for (int k = 0; k < n; ++k) {
+            w[k] = r.get();
+            sum += w[k];
+        }
+        vector<long long> c(n);
+        long long left = C;
+        for (int k = 0; k < n; ++k) {
+            c[k] = 1;
+            if (sum > 0) c[k] += (long long)floor((C - n) * w[k] / sum);
+            left -= c[k];
+        }
+        c[n - 1] += max(0LL, left);
+
+        ostringstream name;
+        name << "dag" << i;
+        DAGTask *d = new DAGTask(new DeltaVar(double(ts.getAvgIAT(i))),
+                                 ts.getDeadline(i), ts.getOffset(i),
+                                 name.str());
+
+        vector<Task *> nodes;
+        for (int k = 0; k < n; ++k) {
+            ostringstream code;
+            code << "fixed(" << c[k] << ");";
+            nodes.push_back(d->addNode(code.str()));
+        }
+        for (int a = 0; a < n; ++a)
+            for (int b = a + 1; b < n; ++b)
+                if (r.get() < _edgeProb) d->addEdge(nodes[a], nodes[b]);
+
+        return d;
+    }
+
+    vector<DAGTask *> RandomDAGGen::generate(const RandomTaskSetFactory &ts)
+    {
+        vector<DAGTask *> v;
+        for (int i = 0; i < ts.size(); ++i)
+            v.push_back(generate(ts, i));
+        return v;
+    }
+
+} // namespace RTSim
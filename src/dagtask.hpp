@@ -0,0 +1,220 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __DAGTASK_HPP__
+#define __DAGTASK_HPP__
+
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <baseexc.hpp>
+#include <entity.hpp>
+#include <gevent.hpp>
+#include <randomvar.hpp>
+
+#include <mrtkernel.hpp>
+#include <task.hpp>
+#include <taskevt.hpp>
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    class RandomTaskSetFactory;
+
+    class DAGExc : public BaseExc {
+    public:
+        DAGExc(const std::string &msg) :
+            BaseExc(msg, "DAGTask", "dagtask.cpp") {}
+    };
+
+    /**
+       \ingroup tasks
+
+       A parallel task whose jobs are directed acyclic graphs of
+       sub-jobs (fork-join and OpenMP-like tasks). Every node of the
+       graph is a Task, with its own code (see Task::insertCode()),
+       that is activated as soon as all its predecessors have
+       completed; the nodes are added to a multiprocessor kernel like
+       any other task, so the ready nodes execute in parallel on its
+       CPUs.
+
+       All the nodes of a job have the absolute deadline of the job
+       (its release plus the relative deadline of the DAG), so under
+       global EDF they are scheduled by the deadline of the job; under
+       fixed priorities they have the priority given in addTo().
+
+       The response time of a job goes from its release to the
+       completion of its last node. A job released while the previous
+       one is still executing starts when the previous one completes.
+
+       \code
+       DAGTask dag(new DeltaVar(20), 20, 0, "dag");
+       Task *a = dag.addNode("fixed(2);");
+       Task *b = dag.addNode("fixed(4);");
+       Task *c = dag.addNode("fixed(3);");
+       Task *d = dag.addNode("fixed(1);");
+       dag.addEdge(a, b);
+       dag.addEdge(a, c);
+       dag.addEdge(b, d);
+       dag.addEdge(c, d);
+       dag.addTo(&kern);
+       \endcode
+    */
+    class DAGTask : public Entity {
+        RandomVar *_iat;
+        Tick _rdl;
+        Tick _phase;
+
+        std::vector<Task *> _nodes;
+        std::map<const Task *, unsigned> _index;
+        std::vector<std::vector<unsigned> > _succ;
+        std::vector<unsigned> _npred;
+
+        /// Predecessors still to complete, in the current job
+        std::vector<unsigned> _waiting;
+        unsigned _done;
+
+        /// Releases of the current and of the pending jobs
+        std::deque<Tick> _releases;
+
+        unsigned long _jobs;
+        unsigned long _misses;
+        Tick _lastRT;
+        Tick _maxRT;
+        double _sumRT;
+
+        void startJob();
+        void activate(unsigned n);
+        void onNodeEnd(const Task *t);
+
+    public:
+        GEvent<DAGTask> releaseEvt;
+
+        /**
+           @param iat interarrival time of the jobs (the DAGTask is
+                  the owner); if NULL, the jobs are only released by
+                  activate()
+           @param rdl relative deadline
+           @param ph offset of the first job
+        */
+        DAGTask(RandomVar *iat, Tick rdl, Tick ph = 0,
+                const std::string &name = "");
+        ~DAGTask();
+
+        /// Adds a node with the given code; returns its task
+        Task *addNode(const std::string &code, const std::string &name = "");
+
+        /// Adds an edge; from must have been added before to
+        void addEdge(Task *from, Task *to);
+
+        const std::vector<Task *> &getNodes() const { return _nodes; }
+
+        /// Adds all the nodes to the kernel, with the given parameter
+        void addTo(MRTKernel *k, const std::string &param = "");
+
+        /// Sum of the WCETs of the nodes
+        Tick getWCET() const;
+
+        /// WCET of the longest path
+        Tick getCriticalPath() const;
+
+        Tick getRelDline() const { return _rdl; }
+
+        /// Minimum interarrival time (the relative deadline if the
+        /// jobs are only released by activate())
+        Tick getPeriod() const;
+
+        /// Releases a job now
+        void activate();
+
+        void onRelease(Event *e);
+
+        void probe(EndEvt &e);
+        void probe(KillEvt &e);
+
+        unsigned long getJobs() const { return _jobs; }
+        unsigned long getDeadlineMisses() const { return _misses; }
+        Tick getLastResponseTime() const { return _lastRT; }
+        Tick getMaxResponseTime() const { return _maxRT; }
+        double getMeanResponseTime() const;
+
+        void newRun();
+        void endRun();
+    };
+
+    /**
+       \ingroup kernels
+
+       Federated scheduling (Li et al., 2014): every DAGTask whose
+       density C / D is greater than 1 has ceil((C - L) / (D - L))
+       dedicated processors, where C is its WCET and L its critical
+       path, and its nodes are scheduled greedily (by EDF) on them; the
+       other DAGTasks share the remaining processors under global EDF.
+
+       The kernels are created by allocate(), which throws a DAGExc
+       if the processors are not enough, and deleted with this
+       object.
+    */
+    class FederatedScheduling {
+        int _nCPU;
+        std::vector<DAGTask *> _tasks;
+        std::vector<MRTKernel *> _kernels;
+        std::vector<Scheduler *> _scheds;
+        std::map<const DAGTask *, MRTKernel *> _kernelOf;
+
+    public:
+        FederatedScheduling(int nCPU);
+        ~FederatedScheduling();
+
+        void addTask(DAGTask *t);
+
+        void allocate();
+
+        const std::vector<MRTKernel *> &getKernels() const
+        { return _kernels; }
+
+        MRTKernel *getKernel(const DAGTask *t) const;
+    };
+
+    /**
+       \ingroup util
+
+       Generates DAGTasks with the periods, deadlines and
+       utilizations of a RandomTaskSetFactory: every DAG has a random
+       number of nodes between minNodes and maxNodes, an edge from
+       every node to every following one with probability edgeProb,
+       and random node WCETs that sum to the computation time of the
+       corresponding task of the factory.
+    */
+    class RandomDAGGen {
+        int _minNodes;
+        int _maxNodes;
+        double _edgeProb;
+
+    public:
+        RandomDAGGen(int minNodes = 3, int maxNodes = 10,
+                     double edgeProb = 0.3);
+
+        /// Generates the DAG of the i-th task of ts
+        DAGTask *generate(const RandomTaskSetFactory &ts, int i);
+
+        /// Generates a DAG for every task of ts
+        std::vector<DAGTask *> generate(const RandomTaskSetFactory &ts);
+    };
+
+} // namespace RTSim
+
+#endif
@@ -0,0 +1,160 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <cassert>
+
+#include <strtoken.hpp>
+
+#include "deferrableserver.hpp"
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    DeferrableServer::DeferrableServer(Tick q, Tick p, const std::string &name,
+                                       const std::string &s) :
+        Server(name, s),
+        Q(q),
+        P(p),
+        cap(q),
+        last_time(0),
+        _replEvt(this, &DeferrableServer::onReplenishment)
+    {
+        DBGENTER(_SERVER_DBG_LEV);
+        dline = p;
+    }
+
+    DeferrableServer *DeferrableServer::createInstance(vector<string> &par)
+    {
+        if (par.size() < 3)
+            throw parse_util::ParseExc("DeferrableServer::createInstance",
+                                       "Wrong number of arguments");
+        Tick q = Tick(par[0]);
+        Tick p = Tick(par[1]);
+        if (par.size() > 3) return new DeferrableServer(q, p, par[2], par[3]);
+        return new DeferrableServer(q, p, par[2]);
+    }
+
+    void DeferrableServer::newRun()
+    {
+        Server::newRun();
+        cap = Q;
+        last_time = 0;
+        setAbsDead(P);
+        _replEvt.drop();
+        _replEvt.post(P);
+    }
+
+    void DeferrableServer::endRun()
+    {
+        _replEvt.drop();
+    }
+
+    Tick DeferrableServer::get_remaining_budget() const
+    {
+        if (status == EXECUTING) return cap - (SIMUL.getTime() - last_time);
+        return cap;
+    }
+
+    Tick DeferrableServer::changeBudget(const Tick &n)
+    {
+        Q = n;
+        return abs_dline;
+    }
+
+    void DeferrableServer::account()
+    {
+        cap -= SIMUL.getTime() - last_time;
+        last_time = SIMUL.getTime();
+        _bandExEvt.drop();
+    }
+
+    void DeferrableServer::onReplenishment(Event *e)
+    {
+        DBGENTER(_SERVER_DBG_LEV);
+
+        Tick now = SIMUL.getTime();
+
+        // the budget is not accumulated over the periods
+        cap = Q;
+        setAbsDead(now + P);
+        _replEvt.post(now + P);
+
+        if (status == EXECUTING) {
+            last_time = now;
+            _bandExEvt.drop();
+            _bandExEvt.post(now + cap);
+        }
+        else if (status == RECHARGING) _rechargingEvt.process();
+        DBGPRINT_2("Status is now ", status_string[status]);
+    }
+
+    void DeferrableServer::idle_ready()
+    {
+        DBGENTER(_SERVER_DBG_LEV);
+        assert(status == IDLE);
+        status = READY;
+    }
+
+    void DeferrableServer::releasing_ready()
+    {
+        assert(false); // never releasing: no lag to wait for
+    }
+
+    void DeferrableServer::ready_executing()
+    {
+        DBGENTER(_SERVER_DBG_LEV);
+        status = EXECUTING;
+        last_time = SIMUL.getTime();
+        _bandExEvt.post(last_time + cap);
+    }
+
+    void DeferrableServer::executing_ready()
+    {
+        DBGENTER(_SERVER_DBG_LEV);
+        account();
+        status = READY;
+    }
+
+    void DeferrableServer::executing_releasing()
+    {
+        DBGENTER(_SERVER_DBG_LEV);
+        // the budget left is kept for the rest of the period
+        account();
+        status = cap > 0 ? IDLE : RECHARGING;
+    }
+
+    void DeferrableServer::releasing_idle()
+    {
+        assert(false); // never releasing: no lag to wait for
+    }
+
+    void DeferrableServer::executing_recharging()
+    {
+        DBGENTER(_SERVER_DBG_LEV);
+        cap = 0;
+        _bandExEvt.drop();
+        status = RECHARGING;
+    }
+
+    void DeferrableServer::recharging_ready()
+    {
+        status = READY;
+    }
+
+    void DeferrableServer::recharging_idle()
+    {
+        status = IDLE;
+    }
+
+}
@@ -0,0 +1,103 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __DEFERRABLESERVER_HPP__
+#define __DEFERRABLESERVER_HPP__
+
+#include <gevent.hpp>
+
+#include <server.hpp>
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    /**
+        @ingroup server
+
+        Deferrable Server (Strosnider, Lehoczky and Sha, 1995): the
+        budget is preserved while the server has nothing to do, and
+        it is fully replenished (not incremented) at every multiple
+        of the period, whether it was used or not. When the budget is
+        exhausted, the server waits for the next period.
+
+        The deadline of the server is the end of the current period,
+        so it can be used also under EDF; it is meant for fixed
+        priorities, though.
+    */
+    class DeferrableServer : public Server {
+        Tick Q, P;
+        Tick cap;
+        Tick last_time;
+
+        /// Consumes the budget used since last_time
+        void account();
+
+    public:
+        /// Replenishment at the end of every period
+        GEvent<DeferrableServer> _replEvt;
+
+        DeferrableServer(Tick q, Tick p, const std::string &name,
+                         const std::string &sched = "FIFOSched");
+
+        /// Parameters: budget, period, name[, scheduler]
+        static DeferrableServer *createInstance(vector<string> &par);
+
+        void newRun();
+        void endRun();
+
+        virtual Tick getBudget() const { return Q; }
+        virtual Tick getPeriod() const { return P; }
+
+        Tick get_remaining_budget() const;
+
+        /// The new budget is enforced from the next replenishment
+        Tick changeBudget(const Tick &n);
+
+        /// The DS has no virtual time: returns the current time
+        virtual double getVirtualTime() { return double(SIMUL.getTime()); }
+
+        void onReplenishment(Event *e);
+
+    protected:
+
+        /// from idle to active contending (new work to do)
+        virtual void idle_ready();
+
+        /// from active non contending to active contending (more work)
+        virtual void releasing_ready();
+
+        /// from active contending to executing (dispatching)
+        virtual void ready_executing();
+
+        /// from executing to active contenting (preemption)
+        virtual void executing_ready();
+
+        /// from executing to active non contending (no more work)
+        virtual void executing_releasing();
+
+        /// from active non contending to idle (no lag)
+        virtual void releasing_idle();
+
+        /// from executing to recharging (budget exhausted)
+        virtual void executing_recharging();
+
+        /// from recharging to active contending (budget recharged)
+        virtual void recharging_ready();
+
+        /// from recharging to idle (nothing remains to be done)
+        virtual void recharging_idle();
+    };
+}
+
+#endif
@@ -0,0 +1,295 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <simul.hpp>
+
+#include <energy.hpp>
+#include <mrtkernel.hpp>
+#include <profiler.hpp>
+
+namespace RTSim {
+
+    using namespace std;
+    using namespace MetaSim;
+
+    EnergyMeter::EnergyMeter(const string &name) :
+        Entity(name), _cpus(), _taskCPU(), _serverCPU(), _tasks(), _servers()
+    {
+    }
+
+    void EnergyMeter::addCPU(CPU *c, double idlePower, double busyPower)
+    {
+        CPUState &s = _cpus[c];
+        s.idlePower = idlePower;
+        s.busyPower = busyPower;
+        s.power = idlePower;
+        s.last = 0;
+        s.energy = 0;
+        s.task = 0;
+        s.server = 0;
+        c->addObserver(this);
+    }
+
+    void EnergyMeter::attachToTask(Task *t)
+    {
+        new Particle<SchedEvt, EnergyMeter>(&t->schedEvt, this);
+        new Particle<DeschedEvt, EnergyMeter>(&t->deschedEvt, this);
+        new Particle<EndEvt, EnergyMeter>(&t->endEvt, this);
+        new Particle<KillEvt, EnergyMeter>(&t->killEvt, this);
+        _tasks[t] = 0;
+    }
+
+    void EnergyMeter::attachToServer(Server *s)
+    {
+        new Particle<ServerScheduledEvt, EnergyMeter>(&s->_schedEvt, this);
+        new Particle<ServerDescheduledEvt, EnergyMeter>(&s->_deschedEvt, this);
+        _servers[s] = 0;
+    }
+
+    void EnergyMeter::attachToKernel(RTKernel *k)
+    {
+        for (unsigned i = 0; i < k->_handled.size(); ++i)
+            attach(k->_handled[i]);
+
+        MRTKernel *mk = dynamic_cast<MRTKernel *>(k);
+        if (mk == NULL)
+            new Particle<EndDispatchEvt, EnergyMeter>(&k->endDispatchEvt, this);
+        else {
+            map<CPU *, EndDispatchMultiEvt *>::iterator i;
+            for (i = mk->_endEvt.begin(); i != mk->_endEvt.end(); ++i)
+                new Particle<EndDispatchMultiEvt, EnergyMeter>(i->second, this);
+        }
+    }
+
+    void EnergyMeter::attach(AbsRTTask *t)
+    {
+        Task *tt = dynamic_cast<Task *>(t);
+        Server *s = dynamic_cast<Server *>(t);
+        if (tt && _tasks.find(tt) == _tasks.end()) attachToTask(tt);
+        if (s && _servers.find(s) == _servers.end()) {
+            attachToServer(s);
+            for (unsigned i = 0; i < s->tasks.size(); ++i)
+                attach(s->tasks[i]);
+        }
+    }
+
+    void EnergyMeter::check(AbsRTTask *t, CPU *c)
+    {
+        if (t == NULL || _cpus.find(c) == _cpus.end()) return;
+
+        Task *tt = dynamic_cast<Task *>(t);
+        Server *s = dynamic_cast<Server *>(t);
+        if ((tt && _tasks.count(tt)) || (s && _servers.count(s))) return;
+        throw EnergyMeterExc("A task that is not attached runs on " +
+                             c->getName());
+    }
+
+    void EnergyMeter::account(CPU *c)
+    {
+        CPUState &s = _cpus[c];
+        Tick now = SIMUL.getTime();
+        double e = s.power * double(now - s.last);
+        s.last = now;
+        if (e == 0) return;
+
+        s.energy += e;
+        if (s.task) _tasks[s.task] += e;
+        if (s.server) _servers[s.server] += e;
+    }
+
+    void EnergyMeter::update(CPU *c)
+    {
+        CPUState &s = _cpus[c];
+        if (!s.task) s.power = s.idlePower;
+        else if (s.busyPower >= 0) s.power = s.busyPower;
+        else s.power = c->getCurrentPowerConsumption();
+    }
+
+    void EnergyMeter::stop(const Task *t)
+    {
+        map<const Task *, CPU *>::iterator i = _taskCPU.find(t);
+        if (i == _taskCPU.end()) return;
+
+        CPU *c = i->second;
+        _taskCPU.erase(i);
+        CPUState &s = _cpus[c];
+        if (s.task != t) return;
+        account(c);
+        s.task = 0;
+        update(c);
+    }
+
+    void EnergyMeter::stop(const Server *srv)
+    {
+        map<const Server *, CPU *>::iterator i = _serverCPU.find(srv);
+        if (i == _serverCPU.end()) return;
+
+        CPU *c = i->second;
+        _serverCPU.erase(i);
+        CPUState &s = _cpus[c];
+        if (s.server != srv) return;
+        account(c);
+        s.server = 0;
+    }
+
+    /*
+      The schedule of the next task can be probed before the end (or
+      the descheduling) of the previous one on the same CPU, so the
+      owner of the CPU is simply replaced.
+    */
+    void EnergyMeter::probe(SchedEvt &e)
+    {
+        PROFILE_SCOPE("EnergyMeter::probe");
+        Task *t = e.getTask();
+        CPU *c = t->getCPU();
+        if (!c || _cpus.find(c) == _cpus.end()) return;
+
+        stop(t);
+        account(c);
+        CPUState &s = _cpus[c];
+        if (s.task) _taskCPU.erase(s.task);
+        s.task = t;
+        _taskCPU[t] = c;
+        update(c);
+    }
+
+    void EnergyMeter::probe(DeschedEvt &e)
+    {
+        PROFILE_SCOPE("EnergyMeter::probe");
+        stop(e.getTask());
+    }
+
+    void EnergyMeter::probe(EndEvt &e)
+    {
+        PROFILE_SCOPE("EnergyMeter::probe");
+        stop(e.getTask());
+    }
+
+    void EnergyMeter::probe(KillEvt &e)
+    {
+        PROFILE_SCOPE("EnergyMeter::probe");
+        stop(e.getTask());
+    }
+
+    void EnergyMeter::probe(ServerScheduledEvt &e)
+    {
+        PROFILE_SCOPE("EnergyMeter::probe");
+        Server *srv = e.getServer();
+        CPU *c = srv->getProcessor(srv);
+        if (!c || _cpus.find(c) == _cpus.end()) return;
+
+        stop(srv);
+        account(c);
+        CPUState &s = _cpus[c];
+        if (s.server) _serverCPU.erase(s.server);
+        s.server = srv;
+        _serverCPU[srv] = c;
+    }
+
+    void EnergyMeter::probe(ServerDescheduledEvt &e)
+    {
+        PROFILE_SCOPE("EnergyMeter::probe");
+        stop(e.getServer());
+    }
+
+    void EnergyMeter::probe(EndDispatchEvt &e)
+    {
+        RTKernel *k = e.getKernel();
+        check(k->getCurrExe(), k->getProcessors()[0]);
+    }
+
+    void EnergyMeter::probe(EndDispatchMultiEvt &e)
+    {
+        check(e.getTask(), e.getCPU());
+    }
+
+    void EnergyMeter::onSpeedChange(CPU *c, double, double)
+    {
+        if (_cpus.find(c) == _cpus.end()) return;
+        account(c);
+        update(c);
+    }
+
+    double EnergyMeter::getCPUEnergy(CPU *c) const
+    {
+        map<CPU *, CPUState>::const_iterator i = _cpus.find(c);
+        return i != _cpus.end() ? i->second.energy : 0;
+    }
+
+    double EnergyMeter::getTaskEnergy(const Task *t) const
+    {
+        map<const Task *, double>::const_iterator i = _tasks.find(t);
+        return i != _tasks.end() ? i->second : 0;
+    }
+
+    double EnergyMeter::getServerEnergy(const Server *s) const
+    {
+        map<const Server *, double>::const_iterator i = _servers.find(s);
+        return i != _servers.end() ? i->second : 0;
+    }
+
+    double EnergyMeter::getTotalEnergy() const
+    {
+        double e = 0;
+        for (map<CPU *, CPUState>::const_iterator i = _cpus.begin();
+             i != _cpus.end(); ++i)
+            e += i->second.energy;
+        return e;
+    }
+
+    void EnergyMeter::print(ostream &os) const
+    {
+        os << "Energy: " << getTotalEnergy() << endl;
+        for (map<CPU *, CPUState>::const_iterator i = _cpus.begin();
+             i != _cpus.end(); ++i)
+            os << "  CPU " << i->first->getName() << ": "
+               << i->second.energy << endl;
+        for (map<const Task *, double>::const_iterator i = _tasks.begin();
+             i != _tasks.end(); ++i)
+            os << "  task " << i->first->getName() << ": "
+               << i->second << endl;
+        for (map<const Server *, double>::const_iterator i = _servers.begin();
+             i != _servers.end(); ++i)
+            os << "  server " << i->first->getName() << ": "
+               << i->second << endl;
+    }
+
+    void EnergyMeter::newRun()
+    {
+        for (map<CPU *, CPUState>::iterator i = _cpus.begin();
+             i != _cpus.end(); ++i) {
+            i->second.last = 0;
+            i->second.energy = 0;
+            i->second.task = 0;
+            i->second.server = 0;
+            update(i->first);
+        }
+        for (map<const Task *, double>::iterator i = _tasks.begin();
+             i != _tasks.end(); ++i)
+            i->second = 0;
+        for (map<const Server *, double>::iterator i = _servers.begin();
+             i != _servers.end(); ++i)
+            i->second = 0;
+        _taskCPU.clear();
+        _serverCPU.clear();
+    }
+
+    /// Accounts the energy up to the end of the run
+    void EnergyMeter::endRun()
+    {
+        for (map<CPU *, CPUState>::iterator i = _cpus.begin();
+             i != _cpus.end(); ++i)
+            account(i->first);
+    }
+
+} // namespace RTSim
@@ -0,0 +1,155 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __ENERGY_HPP__
+#define __ENERGY_HPP__
+
+#include <iostream>
+#include <map>
+#include <string>
+
+#include <baseexc.hpp>
+#include <entity.hpp>
+#include <particle.hpp>
+
+#include <cpu.hpp>
+#include <kernel.hpp>
+#include <server.hpp>
+#include <serverevt.hpp>
+#include <task.hpp>
+#include <taskevt.hpp>
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    class EndDispatchMultiEvt;
+
+    class EnergyMeterExc : public BaseExc {
+    public:
+        EnergyMeterExc(const string &msg) :
+            BaseExc(msg, "EnergyMeter", "energy.cpp") {}
+    };
+
+    /**
+       \ingroup stat
+
+       Exact energy accounting. The power of every CPU is piecewise
+       constant: it changes only when a task is dispatched or
+       descheduled on the CPU (busy/idle) and when the speed of the CPU
+       changes. The meter integrates the power at each of these
+       transitions, so the result is exact and no event is ever
+       posted (unlike TracePowerConsumption, which samples the power
+       periodically).
+
+       The busy power of a CPU is its getCurrentPowerConsumption()
+       (f * V^2 of the current level), or a constant for the CPUs
+       without power saving; the idle power is a constant. Energy is
+       measured in power units times ticks.
+
+       The energy of a busy CPU is also charged to the task running on
+       it and to the server (if any) that is scheduled on it.
+
+       A CPU is busy only while a task attached to the meter runs on
+       it, so every task of the kernel must be attached: use
+       attachToKernel() once the tasks have been added. The meter
+       then checks every context switch of the kernel, and throws
+       EnergyMeterExc if a task that is not attached gets a CPU.
+
+       \code
+       EnergyMeter meter;
+       meter.addCPU(cpu, 0.1);
+       meter.attachToKernel(&kern);
+       ...
+       SIMUL.run(100000);
+       meter.print(cout);
+       \endcode
+    */
+    class EnergyMeter : public Entity, public CPUObserver {
+    public:
+        EnergyMeter(const std::string &name = "EnergyMeter");
+
+        /**
+           Meters a CPU.
+
+           @param idlePower power consumed when no task runs
+           @param busyPower power consumed when a task runs; if
+                  negative, the one of the current level of the CPU
+        */
+        void addCPU(CPU *c, double idlePower = 0, double busyPower = -1);
+
+        void attachToTask(Task *t);
+        void attachToServer(Server *s);
+
+        /**
+           Attaches every task of the kernel, the servers and the
+           tasks they serve, and checks the CPUs of the kernel (see
+           above).
+        */
+        void attachToKernel(RTKernel *k);
+
+        double getCPUEnergy(CPU *c) const;
+        double getTaskEnergy(const Task *t) const;
+        double getServerEnergy(const Server *s) const;
+        double getTotalEnergy() const;
+
+        void print(std::ostream &os) const;
+
+        void probe(SchedEvt &e);
+        void probe(DeschedEvt &e);
+        void probe(EndEvt &e);
+        void probe(KillEvt &e);
+        void probe(ServerScheduledEvt &e);
+        void probe(ServerDescheduledEvt &e);
+        void probe(EndDispatchEvt &e);
+        void probe(EndDispatchMultiEvt &e);
+
+        void onSpeedChange(CPU *c, double oldSpeed, double newSpeed);
+
+        void newRun();
+        void endRun();
+
+    private:
+        struct CPUState {
+            double idlePower;
+            double busyPower;
+            double power;
+            Tick last;
+            double energy;
+            const Task *task;
+            const Server *server;
+        };
+
+        std::map<CPU *, CPUState> _cpus;
+        std::map<const Task *, CPU *> _taskCPU;
+        std::map<const Server *, CPU *> _serverCPU;
+        std::map<const Task *, double> _tasks;
+        std::map<const Server *, double> _servers;
+
+        /// Integrates the power of c up to now
+        void account(CPU *c);
+        /// Recomputes the power of c after a transition
+        void update(CPU *c);
+
+        void stop(const Task *t);
+        void stop(const Server *s);
+
+        /// Attaches a task of a kernel, and the tasks of a server
+        void attach(AbsRTTask *t);
+        /// Throws if t is not attached
+        void check(AbsRTTask *t, CPU *c);
+    };
+
+} // namespace RTSim
+
+#endif
@@ -11,6 +11,7 @@
  *   (at your option) any later version.                                   *
  *                                                                         *
  ***************************************************************************/
+#include <algorithm>
 #include <cctype>
 #include <cmath>
 #include <cstdlib>
@@ -20,6 +21,7 @@
 #include <factory.hpp>
 #include <simul.hpp>
 #include <strtoken.hpp>
+#include <profiler.hpp>
 
 #include <cpu.hpp>
 #include <exeinstr.hpp>
@@ -32,13 +34,13 @@ namespace RTSim {
     using namespace parse_util;
 
     ExecInstr::ExecInstr(Task *f, RandomVar *c, char *n) : 
-        Instr(f, n), cost(c), _endEvt(this) 
+        Instr(f, n), cost(c), drawn(false), _endEvt(this) 
     {
         DBGTAG(_INSTR_DBG_LEV,"ExecInstr");
     }
 
     ExecInstr::ExecInstr(Task *f, auto_ptr<RandomVar> &c, char *n) : 
-        Instr(f, n), cost(c), _endEvt(this) 
+        Instr(f, n), cost(c), drawn(false), _endEvt(this) 
     {
         DBGTAG(_INSTR_DBG_LEV,"ExecInstr");
     }
@@ -69,6 +71,7 @@ namespace RTSim {
     {
         actTime = lastTime = 0;
         flag = true;
+        drawn = false;
         execdTime = 0;
         executing = false;
     }
@@ -85,6 +88,33 @@ namespace RTSim {
         else return execdTime;
     }
 
+    Tick ExecInstr::getCurrentCost()
+    {
+        if (flag && !drawn) {
+            currentCost = Tick(cost->get());
+            drawn = true;
+        }
+        return currentCost;
+    }
+
+    Tick ExecInstr::getRemainingCost()
+    {
+        if (flag) return getCurrentCost();
+        Tick done = getExecTime();
+        return currentCost > done ? currentCost - done : Tick(0);
+    }
+
+    double ExecInstr::getExecCycles() const
+    {
+        double c = actTime;
+        if (executing) {
+            CPU *p = _father->getCPU();
+            double t = double(SIMUL.getTime() - lastTime);
+            c += t * effectiveSpeed(p, p->getSpeed());
+        }
+        return max(0.0, c);
+    }
+
     Tick ExecInstr::getDuration() const 
     { 
         return (Tick)cost->get();
@@ -114,7 +144,8 @@ namespace RTSim {
             execdTime = 0; 
             actTime = 0;
             flag = false;
-            currentCost = Tick(cost->get());
+            if (!drawn) currentCost = Tick(cost->get());
+            drawn = false;
 
             DBGPRINT_2("Time to execute for this instance: ",
                        currentCost);
@@ -124,7 +155,10 @@ namespace RTSim {
         if (!dynamic_cast<CPU *>(p)) 
             throw InstrExc("No CPU!", "ExeInstr::schedule()");
 
-        double currentSpeed = p->getSpeed();
+        // the reload of the cache is work to do again
+        actTime -= _father->takeCacheDelay();
+
+        double currentSpeed = effectiveSpeed(p, p->getSpeed());
   
         Tick tmp = 0;
         if (((double)currentCost) > actTime)
@@ -151,7 +185,7 @@ namespace RTSim {
                 throw InstrExc("No CPU!", 
                                "ExeInstr::deschedule()");
     
-            double currentSpeed = p->getSpeed();
+            double currentSpeed = effectiveSpeed(p, p->getSpeed());
 
             actTime += ((double)(t - lastTime))*currentSpeed;// number of cycles
             execdTime += (t - lastTime);// number of ticks
@@ -169,6 +203,7 @@ namespace RTSim {
 
     void ExecInstr::onEnd() 
     {
+        PROFILE_SCOPE("ExecInstr::onEnd");
         DBGENTER(_INSTR_DBG_LEV);
         DBGPRINT("Ending ExecInstr named: " << getName());
 
@@ -177,7 +212,8 @@ namespace RTSim {
         flag = true;
         executing = false;
         lastTime = t;
-        actTime = 0;
+        // the whole cost has been executed (see getExecCycles())
+        actTime = double(currentCost);
         _endEvt.drop();
 
         DBGPRINT("internal data set... now calling the _father->onInstrEnd()");
@@ -194,6 +230,7 @@ namespace RTSim {
 
         actTime = lastTime = 0;
         flag = true;
+        drawn = false;
         execdTime = 0;
         _endEvt.drop();
 
@@ -210,7 +247,19 @@ namespace RTSim {
     }
 
 
+    double ExecInstr::effectiveSpeed(CPU *p, double speed) const
+    {
+        return speed / _father->getScaling(p) * _father->getContention();
+    }
+
     void ExecInstr::refreshExec(double oldSpeed, double newSpeed){
+        // the end is posted at the next schedule()
+        if (!executing) return;
+
+        CPU *p = _father->getCPU();
+        oldSpeed = effectiveSpeed(p, oldSpeed);
+        newSpeed = effectiveSpeed(p, newSpeed);
+
         Tick t = SIMUL.getTime();
         _endEvt.drop();
         actTime += ((double)(t - lastTime))*oldSpeed;
@@ -44,6 +44,8 @@ namespace RTSim {
   using namespace std;
   using namespace MetaSim;
 
+  class CPU;
+
   /** 
       \ingroup instr
 
@@ -71,6 +73,14 @@ namespace RTSim {
     Tick lastTime;     
     /// True if the instruction is currently executing
     bool executing;    
+    /// True if currentCost has been drawn before the first schedule
+    bool drawn;
+
+    /** Rate at which the instruction executes on p at the given
+	speed: the speed divided by the execution time factor of
+	the task on p (see Task::getScaling()), slowed down by the
+	memory contention (see Task::getContention()). */
+    double effectiveSpeed(CPU *p, double speed) const;
   public:
 
     EndInstrEvt _endEvt;
@@ -95,6 +105,19 @@ namespace RTSim {
     virtual Tick getExecTime() const;
     virtual void setTrace(Trace *t);
 
+    /** Duration of the current instance of the instruction; if it
+	has not started yet, the duration is drawn now, and it is
+	kept when the instruction is scheduled. */
+    Tick getCurrentCost();
+
+    /// Duration still to execute in the current instance
+    Tick getRemainingCost();
+
+    /** Work done by the current (or last) instance, in ticks at
+	full speed: the cycles of the past runs plus the ones of the
+	run in progress, whatever the speed of each run. */
+    double getExecCycles() const;
+
     //From Entity...
     virtual void newRun();
     virtual void endRun();
@@ -0,0 +1,408 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <sstream>
+
+#include <fairsched.hpp>
+#include <task.hpp>
+
+namespace RTSim {
+
+    using namespace std;
+    using namespace MetaSim;
+
+    static const unsigned long NICE_0_WEIGHT = 1024;
+
+    /// tolerance in the comparisons with V
+    static const double EPS = 1e-9;
+
+    /// The weights of nice -20 ... 19, from the Linux kernel
+    static const unsigned long prioToWeight[40] = {
+        /* -20 */ 88761, 71755, 56483, 46273, 36291,
+        /* -15 */ 29154, 23254, 18705, 14949, 11916,
+        /* -10 */  9548,  7620,  6100,  4904,  3906,
+        /*  -5 */  3121,  2501,  1991,  1586,  1277,
+        /*   0 */  1024,   820,   655,   526,   423,
+        /*   5 */   335,   272,   215,   172,   137,
+        /*  10 */   110,    87,    70,    56,    45,
+        /*  15 */    36,    29,    23,    18,    15,
+    };
+
+    unsigned long FairScheduler::niceToWeight(int nice)
+    {
+        if (nice < -20 || nice > 19)
+            throw FairSchedExc("Nice value out of range");
+        return prioToWeight[nice + 20];
+    }
+
+    FairScheduler::FairModel::FairModel(AbsRTTask *t, int nice) :
+        TaskModel(t), _nice(0), _weight(NICE_0_WEIGHT), _node()
+    {
+        changePriority(nice);
+        reset();
+    }
+
+    void FairScheduler::FairModel::changePriority(Tick p)
+    {
+        _weight = niceToWeight(int(p));
+        _nice = int(p);
+    }
+
+    void FairScheduler::FairModel::reset()
+    {
+        _vruntime = _deadline = _lag = 0;
+        _sumExec = 0;
+        _placed = false;
+    }
+
+    FairScheduler::FairScheduler(Tick latency, Tick minGranularity,
+                                 Tick wakeupGranularity, bool eevdf) :
+        Scheduler(), _latency(latency), _minGranularity(minGranularity),
+        _wakeupGranularity(wakeupGranularity), _eevdf(eevdf), _tree(),
+        _sumW(0), _sumWV(0), _minVruntime(0), _curr(NULL), _execStart(0),
+        _resched(false), _sliceEvt(this, &FairScheduler::onSliceEnd)
+    {
+        if (latency <= 0 || minGranularity <= 0)
+            throw FairSchedExc("Latency and granularity must be positive");
+    }
+
+    FairScheduler::~FairScheduler()
+    {
+    }
+
+    FairScheduler::FairModel *FairScheduler::model(AbsRTTask *t)
+    {
+        TaskModel *m = find(t);
+        if (m == NULL) throw FairSchedExc("Cannot find task");
+        return static_cast<FairModel *>(m);
+    }
+
+    void FairScheduler::addTask(AbsRTTask *t, const std::string &p)
+    {
+        DBGENTER(_FAIR_SCHED_DBG_LEV);
+
+        int nice = 0;
+        if (p != "") {
+            stringstream ss(p);
+            ss >> nice;
+        }
+        DBGPRINT_2("Nice value: ", nice);
+
+        if (find(t) != NULL)
+            throw FairSchedExc("Element already present");
+        enqueueModel(new FairModel(t, nice));
+    }
+
+    void FairScheduler::treeInsert(FairModel *m)
+    {
+        m->_node = _tree.insert(make_pair(m->_vruntime, m));
+        _sumW += m->_weight;
+        _sumWV += m->_weight * m->_vruntime;
+    }
+
+    void FairScheduler::treeErase(FairModel *m)
+    {
+        _tree.erase(m->_node);
+        if (_tree.empty()) _sumW = _sumWV = 0;
+        else {
+            _sumW -= m->_weight;
+            _sumWV -= m->_weight * m->_vruntime;
+        }
+    }
+
+    double FairScheduler::avgVruntime() const
+    {
+        return _sumW > 0 ? _sumWV / _sumW : _minVruntime;
+    }
+
+    bool FairScheduler::isEligible(FairModel *m) const
+    {
+        return m->_vruntime <= avgVruntime() + EPS;
+    }
+
+    double FairScheduler::vslice(FairModel *m) const
+    {
+        return double(_minGranularity) * NICE_0_WEIGHT / m->_weight;
+    }
+
+    Tick FairScheduler::timeSlice(FairModel *m) const
+    {
+        if (_eevdf) {
+            // the rest of the current request
+            double r = (m->_deadline - m->_vruntime) * m->_weight / NICE_0_WEIGHT;
+            Tick s = Tick::ceil(r - EPS);
+            return s > 0 ? s : Tick(1);
+        }
+
+        // the latency grows to give every task the minimum granularity
+        double period = double(_latency);
+        double n = double(_tree.size());
+        if (n * double(_minGranularity) > period)
+            period = n * double(_minGranularity);
+
+        double share = _sumW > 0 ? period * m->_weight / _sumW : period;
+        Tick s = Tick::ceil(share - EPS);
+        return s > _minGranularity ? s : _minGranularity;
+    }
+
+    void FairScheduler::updateCurr()
+    {
+        Tick now = SIMUL.getTime();
+        if (_curr == NULL || !_curr->isActive() || now <= _execStart) {
+            _execStart = now;
+            return;
+        }
+
+        Tick delta = now - _execStart;
+        _execStart = now;
+
+        // the key changes: the node is moved
+        treeErase(_curr);
+        _curr->_sumExec += delta;
+        _curr->_vruntime += double(delta) * NICE_0_WEIGHT / _curr->_weight;
+        treeInsert(_curr);
+
+        if (_eevdf && _curr->_vruntime >= _curr->_deadline - EPS) {
+            // a new request
+            _curr->_deadline = _curr->_vruntime + vslice(_curr);
+            _resched = true;
+        }
+
+        if (_tree.begin()->first > _minVruntime)
+            _minVruntime = _tree.begin()->first;
+    }
+
+    FairScheduler::FairModel *FairScheduler::pick()
+    {
+        if (_tree.empty()) return NULL;
+        if (!_eevdf) return _tree.begin()->second;
+
+        // the eligible tasks are a prefix of the tree (the first one
+        // always is): the earliest virtual deadline among them
+        double v = avgVruntime() + EPS;
+        FairModel *best = _tree.begin()->second;
+        Tree::iterator i;
+        for (i = _tree.begin(); i != _tree.end() && i->first <= v; ++i)
+            if (i->second->_deadline < best->_deadline) best = i->second;
+        return best;
+    }
+
+    bool FairScheduler::preempts(FairModel *m)
+    {
+        if (_eevdf) return m->_deadline < _curr->_deadline;
+
+        double gran = double(_wakeupGranularity) * NICE_0_WEIGHT / m->_weight;
+        return _curr->_vruntime - m->_vruntime > gran;
+    }
+
+    void FairScheduler::insert(AbsRTTask *t) throw(RTSchedExc, BaseExc)
+    {
+        DBGENTER(_FAIR_SCHED_DBG_LEV);
+
+        FairModel *m = model(t);
+        if (m->isActive()) return;
+
+        updateCurr();
+
+        if (_eevdf) {
+            // the lag is restored, scaled as the task adds its weight
+            double lag = m->_placed ? m->_lag : 0;
+            if (_sumW > 0) lag = lag * (_sumW + m->_weight) / _sumW;
+            m->_vruntime = avgVruntime() - lag;
+            m->_deadline = m->_vruntime + vslice(m);
+        }
+        else {
+            // a sleeper gets at most half the latency of credit
+            double v = _minVruntime;
+            if (m->_placed) v -= double(_latency) / 2;
+            if (!m->_placed || m->_vruntime < v) m->_vruntime = v;
+        }
+        m->_placed = true;
+
+        DBGPRINT_4("Inserting ", taskname(t), " with vruntime ", m->_vruntime);
+
+        m->setInsertTime(SIMUL.getTime());
+        m->setActive();
+        treeInsert(m);
+    }
+
+    void FairScheduler::extract(AbsRTTask *t) throw(RTSchedExc, BaseExc)
+    {
+        DBGENTER(_FAIR_SCHED_DBG_LEV);
+
+        FairModel *m = model(t);
+        if (!m->isActive()) return;
+
+        if (m == _curr) updateCurr();
+
+        if (_eevdf) {
+            double limit = 2 * vslice(m);
+            double lag = avgVruntime() - m->_vruntime;
+            m->_lag = lag > limit ? limit : (lag < -limit ? -limit : lag);
+        }
+
+        treeErase(m);
+        m->setInactive();
+        if (_currExe == t) _currExe = NULL;
+
+        if (!_tree.empty() && _tree.begin()->first > _minVruntime)
+            _minVruntime = _tree.begin()->first;
+    }
+
+    AbsRTTask *FairScheduler::getFirst()
+    {
+        updateCurr();
+
+        FairModel *best = pick();
+        if (best == NULL) return NULL;
+
+        // the current task completes its slice, unless a waking
+        // task preempts it
+        if (_curr != NULL && _curr->isActive() && best != _curr &&
+            !_resched && !preempts(best))
+            return _curr->getTask();
+
+        return best->getTask();
+    }
+
+    AbsRTTask *FairScheduler::getTaskN(unsigned int n)
+    {
+        AbsRTTask *first = getFirst();
+        if (n == 0 || first == NULL) return first;
+
+        Tree::iterator i;
+        for (i = _tree.begin(); i != _tree.end(); ++i) {
+            if (i->second->getTask() == first) continue;
+            if (--n == 0) return i->second->getTask();
+        }
+        return NULL;
+    }
+
+    void FairScheduler::notify(AbsRTTask *t)
+    {
+        DBGENTER(_FAIR_SCHED_DBG_LEV);
+
+        updateCurr();
+        Scheduler::notify(t);
+
+        FairModel *m = t != NULL ? model(t) : NULL;
+
+        // the kernel notifies again a task that keeps executing
+        if (m != NULL && m == _curr && !_resched && _sliceEvt.isInQueue())
+            return;
+
+        _sliceEvt.drop();
+        _resched = false;
+        _curr = m;
+        _execStart = SIMUL.getTime();
+
+        if (_curr != NULL) {
+            Tick s = timeSlice(_curr);
+            DBGPRINT_4("Slice of ", taskname(t), ": ", s);
+            _sliceEvt.post(SIMUL.getTime() + s);
+        }
+    }
+
+    void FairScheduler::onSliceEnd(Event *)
+    {
+        DBGENTER(_FAIR_SCHED_DBG_LEV);
+
+        updateCurr();
+        _resched = true;
+
+        // nobody else to execute: a new slice
+        if (_curr != NULL && _curr->isActive() &&
+            getFirst() == _curr->getTask()) {
+            _resched = false;
+            _sliceEvt.post(SIMUL.getTime() + timeSlice(_curr));
+            return;
+        }
+
+        if (_kernel) {
+            DBGPRINT("informing the kernel");
+            _kernel->dispatch();
+        }
+    }
+
+    double FairScheduler::getVruntime(AbsRTTask *t)
+    {
+        FairModel *m = model(t);
+        updateCurr();
+        return m->_vruntime;
+    }
+
+    unsigned long FairScheduler::getWeight(AbsRTTask *t)
+    {
+        return model(t)->_weight;
+    }
+
+    double FairScheduler::getLag(AbsRTTask *t)
+    {
+        FairModel *m = model(t);
+        updateCurr();
+        return m->isActive() ? avgVruntime() - m->_vruntime : m->_lag;
+    }
+
+    void FairScheduler::discardTasks(bool f)
+    {
+        _tree.clear();
+        _sumW = _sumWV = 0;
+        _curr = NULL;
+        Scheduler::discardTasks(f);
+    }
+
+    void FairScheduler::newRun()
+    {
+        Scheduler::newRun();
+
+        _tree.clear();
+        _sumW = _sumWV = 0;
+        _minVruntime = 0;
+        _curr = NULL;
+        _execStart = 0;
+        _resched = false;
+
+        map<AbsRTTask *, TaskModel *>::iterator i;
+        for (i = _tasks.begin(); i != _tasks.end(); ++i)
+            static_cast<FairModel *>(i->second)->reset();
+    }
+
+    void FairScheduler::endRun()
+    {
+        _sliceEvt.drop();
+    }
+
+    void FairScheduler::print()
+    {
+        DBGPRINT("Ready tree: ");
+        Tree::iterator i;
+        for (i = _tree.begin(); i != _tree.end(); ++i)
+            DBGPRINT_4(taskname(i->second->getTask()), " (", i->first, ") -> ");
+    }
+
+    FairScheduler *FairScheduler::createInstance(vector<string> &par)
+    {
+        int v[3] = {24, 3, 4};
+        bool eevdf = false;
+        unsigned k = 0;
+
+        for (unsigned i = 0; i < par.size(); ++i) {
+            if (par[i] == "eevdf") eevdf = true;
+            else if (par[i] != "" && k < 3) {
+                stringstream ss(par[i]);
+                ss >> v[k++];
+            }
+        }
+        return new FairScheduler(v[0], v[1], v[2], eevdf);
+    }
+}
@@ -0,0 +1,221 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __FAIRSCHED_HPP__
+#define __FAIRSCHED_HPP__
+
+#include <map>
+
+#include <baseexc.hpp>
+#include <gevent.hpp>
+#include <simul.hpp>
+
+#include <scheduler.hpp>
+
+#define _FAIR_SCHED_DBG_LEV "FairSched"
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    /**
+       \ingroup sched
+
+       A fair share scheduler in the style of the Linux Completely
+       Fair Scheduler. Every task has a weight, from its nice value
+       (-20 to 19, as in Linux: every step is about 10% of CPU time),
+       and a virtual runtime, which advances with its execution time
+       divided by its weight. The ready tasks are kept in a balanced
+       tree ordered by virtual runtime, and the task with the
+       smallest one executes:
+
+       - for a slice of the target latency proportional to its
+         weight, but not shorter than the minimum granularity (with
+         many tasks, the latency grows to keep this minimum);
+       - a task that wakes up starts from the smallest virtual
+         runtime of the queue, minus half the latency (so a sleeper
+         gets some credit, but not for all its sleep), and it
+         preempts the running task if its virtual runtime is smaller
+         by more than the wakeup granularity.
+
+       With EEVDF enabled, the choice follows Linux 6.6 instead:
+       every task has a lag (how much CPU it is owed, with respect to
+       the weighted average virtual runtime V), it is eligible if its
+       lag is not negative, and the eligible task with the earliest
+       virtual deadline (the virtual runtime at the end of a request
+       of minimum granularity) executes. The lag of a sleeping task
+       is kept, and restored when it wakes up.
+
+       The scheduler is usually installed in a Server, for instance
+       with the lowest priority in a fixed priority kernel, so that
+       it receives the time left by the real-time tasks:
+
+       \code
+       CBServer serv(1000, 1000, 1000, true, "fair", "FairSched(24,3,4)");
+       serv.addTask(task, "0");   // nice 0
+       kern.addTask(serv, "100");
+       \endcode
+
+       The parameters of FairSched are the target latency, the
+       minimum granularity, the wakeup granularity and, optionally,
+       "eevdf". The parameter of a task is its nice value.
+
+       The execution is accounted from the notify() of the kernel, so
+       the scheduler is meant for a single processor.
+    */
+    class FairScheduler : public Scheduler {
+    protected:
+
+        class FairSchedExc : public BaseExc {
+        public:
+            FairSchedExc(string msg) :
+                BaseExc(msg, "FairScheduler", "fairsched.cpp") {}
+        };
+
+        class FairModel;
+        typedef std::multimap<double, FairModel *> Tree;
+
+        class FairModel : public TaskModel {
+        public:
+            int _nice;
+            unsigned long _weight;
+            double _vruntime;
+            double _deadline;
+            double _lag;
+            Tick _sumExec;
+            /// false until the first activation of the run
+            bool _placed;
+            /// the position in the tree (if active)
+            Tree::iterator _node;
+
+            FairModel(AbsRTTask *t, int nice);
+
+            /// Returns the nice value
+            virtual Tick getPriority() { return _nice; }
+
+            /// Sets the nice value
+            virtual void changePriority(Tick p);
+
+            void reset();
+        };
+
+        Tick _latency;
+        Tick _minGranularity;
+        Tick _wakeupGranularity;
+        bool _eevdf;
+
+        Tree _tree;
+
+        /// sums of weight and weight * vruntime of the tree
+        double _sumW;
+        double _sumWV;
+
+        double _minVruntime;
+
+        /// the task notified as executing, and since when
+        FairModel *_curr;
+        Tick _execStart;
+
+        /// true when the current task consumed its slice
+        bool _resched;
+
+        GEvent<FairScheduler> _sliceEvt;
+
+        FairModel *model(AbsRTTask *t);
+
+        void treeInsert(FairModel *m);
+        void treeErase(FairModel *m);
+
+        /// Accounts the execution of the current task until now
+        void updateCurr();
+
+        /// Weighted average virtual runtime (V)
+        double avgVruntime() const;
+
+        bool isEligible(FairModel *m) const;
+
+        /// The virtual time of a request of minimum granularity
+        double vslice(FairModel *m) const;
+
+        /// The slice of the current task, in real time
+        Tick timeSlice(FairModel *m) const;
+
+        /// The best task in the tree
+        FairModel *pick();
+
+        /// Returns true if m, waking up, preempts the current task
+        bool preempts(FairModel *m);
+
+    public:
+
+        /**
+           @param latency target latency, the period in which every
+                  ready task executes once
+           @param minGranularity minimum slice (and EEVDF request)
+           @param wakeupGranularity the advantage in virtual
+                  runtime that a waking task needs to preempt
+           @param eevdf uses EEVDF instead of CFS
+        */
+        FairScheduler(Tick latency = 24, Tick minGranularity = 3,
+                      Tick wakeupGranularity = 4, bool eevdf = false);
+        ~FairScheduler();
+
+        /**
+           Adds a task with its nice value (0 if the string is empty)
+        */
+        void addTask(AbsRTTask *t, const std::string &p);
+
+        void removeTask(AbsRTTask *t) {}
+
+        virtual void insert(AbsRTTask *t) throw(RTSchedExc, BaseExc);
+        virtual void extract(AbsRTTask *t) throw(RTSchedExc, BaseExc);
+
+        virtual AbsRTTask *getFirst();
+        using Scheduler::getFirst;
+        virtual AbsRTTask *getTaskN(unsigned int n);
+        virtual int getSize() { return _tree.size(); }
+
+        /**
+           Accounts the execution of the previous task, and starts
+           the slice of the new one.
+        */
+        virtual void notify(AbsRTTask *t);
+
+        /// Called at the end of a slice
+        void onSliceEnd(Event *);
+
+        /// @name Inspection
+        /// @{
+        double getVruntime(AbsRTTask *t);
+        unsigned long getWeight(AbsRTTask *t);
+        /// The lag, with respect to V (EEVDF only)
+        double getLag(AbsRTTask *t);
+        double getMinVruntime() const { return _minVruntime; }
+        bool isEEVDF() const { return _eevdf; }
+        /// @}
+
+        /// The weight of a nice value
+        static unsigned long niceToWeight(int nice);
+
+        virtual void discardTasks(bool f);
+
+        virtual void newRun();
+        virtual void endRun();
+        virtual void print();
+
+        static FairScheduler *createInstance(vector<string> &par);
+    };
+
+} // namespace RTSim
+
+#endif
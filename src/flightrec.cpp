@@ -0,0 +1,167 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <csignal>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+
+#include <flightrec.hpp>
+
+namespace RTSim {
+
+    using namespace std;
+    using namespace MetaSim;
+
+    static const size_t _DEFAULT_SIZE = 4096;
+
+    // The default buffer is statically allocated, so that records can
+    // be stored even before the recorder has been constructed
+    static FlightRecord _defaultBuf[_DEFAULT_SIZE];
+
+    FlightRecord *FlightRecorder::_buf = _defaultBuf;
+    size_t FlightRecorder::_mask = _DEFAULT_SIZE - 1;
+    unsigned long long FlightRecorder::_head = 0;
+
+    static bool _dumped = false;
+    static bool _installed = false;
+    static void (*_oldAbort)(int) = SIG_DFL;
+    static terminate_handler _oldTerminate = 0;
+
+    FlightRecorder &FlightRecorder::instance()
+    {
+        static FlightRecorder *fr = new FlightRecorder();
+        return *fr;
+    }
+
+    FlightRecorder::FlightRecorder() :
+        Entity("FlightRecorder"), _names(), _os(&cerr),
+        _missTrigger(0), _missCount(0)
+    {
+    }
+
+    void FlightRecorder::installHandlers()
+    {
+        if (_installed) return;
+        _installed = true;
+
+        _oldAbort = signal(SIGABRT, onAbort);
+        if (_oldAbort == SIG_ERR) _oldAbort = SIG_DFL;
+        _oldTerminate = set_terminate(onTerminate);
+    }
+
+    void FlightRecorder::setSize(size_t n)
+    {
+        size_t size = 1;
+        while (size < n) size <<= 1;
+
+        FlightRecord *old = _buf;
+        _buf = new FlightRecord[size];
+        _mask = size - 1;
+        _head = 0;
+        if (old != _defaultBuf) delete [] old;
+    }
+
+    void FlightRecorder::setName(int entity, const string &name)
+    {
+        _names[entity] = name;
+    }
+
+    void FlightRecorder::onDeadlineMiss(bool abort)
+    {
+        if (abort)
+            dump("deadline miss, simulation aborted");
+        else if (_missCount < _missTrigger) {
+            _missCount++;
+            dump("deadline miss");
+        }
+    }
+
+    const char *FlightRecorder::codeName(int code)
+    {
+        static const char *names[] = {
+            "?", "arrival", "end_instance", "kill", "scheduled",
+            "descheduled", "fake_arrival", "dline_miss",
+            "begin_dispatch", "end_dispatch", "end_instr",
+            "srv_budget_exhausted", "srv_dline_miss", "srv_recharging",
+            "srv_scheduled", "srv_descheduled", "srv_dispatch",
+            "srv_idle", "srv_replenishment", "budget_change"
+        };
+        if (code >= FR_USER) return "user";
+        if (code < 0 || code > FR_BUDGET_CHANGE) return "?";
+        return names[code];
+    }
+
+    void FlightRecorder::dump(ostream &os, const string &reason) const
+    {
+        unsigned long long n = _head > _mask + 1 ? _mask + 1 : _head;
+
+        os << "==== Flight recorder: " << reason << " at time "
+           << SIMUL.getTime() << ", last " << n << " of " << _head
+           << " records ====" << endl;
+        for (unsigned long long i = _head - n; i < _head; ++i) {
+            const FlightRecord &r = _buf[i & _mask];
+            map<int, string>::const_iterator it = _names.find(r.entity);
+
+            os << setw(12) << r.time << "  ";
+            if (it != _names.end()) os << left << setw(20) << it->second;
+            else os << left << setw(20) << r.entity;
+            os << setw(22) << codeName(r.code);
+            if (r.code >= FR_USER) os << "(" << r.code << ") ";
+            os << right << setw(10) << r.arg1
+               << setw(10) << r.arg2 << endl;
+        }
+        os << "==== end of flight recorder dump ====" << endl;
+    }
+
+    void FlightRecorder::dumpBinary(ostream &os) const
+    {
+        unsigned long long n = _head > _mask + 1 ? _mask + 1 : _head;
+        for (unsigned long long i = _head - n; i < _head; ++i)
+            os.write(reinterpret_cast<const char *>(&_buf[i & _mask]),
+                     sizeof(FlightRecord));
+    }
+
+    void FlightRecorder::onAbort(int sig)
+    {
+        // not async-signal safe, but the process is going down anyway
+        if (!_dumped) {
+            _dumped = true;
+            instance().dump("assertion failure");
+        }
+        signal(SIGABRT, _oldAbort);
+        raise(sig);
+    }
+
+    void FlightRecorder::onTerminate()
+    {
+        if (!_dumped) {
+            _dumped = true;
+            instance().dump("uncaught exception");
+        }
+        if (_oldTerminate) _oldTerminate();
+        abort();
+    }
+
+    void FlightRecorder::newRun()
+    {
+        _head = 0;
+        _missCount = 0;
+        _dumped = false;
+    }
+
+    void FlightRecorder::endRun()
+    {
+    }
+
+} // namespace RTSim
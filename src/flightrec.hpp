@@ -0,0 +1,178 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __FLIGHTREC_HPP__
+#define __FLIGHTREC_HPP__
+
+#include <iostream>
+#include <map>
+#include <string>
+
+#include <entity.hpp>
+#include <simul.hpp>
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    /**
+       Codes of the records of the flight recorder. FR_USER and above
+       are free for the user.
+    */
+    typedef enum {
+        FR_ARRIVAL = 1,
+        FR_END,               ///< arg1: arrival time
+        FR_KILL,
+        FR_SCHED,             ///< arg1: cpu
+        FR_DESCHED,           ///< arg1: cpu
+        FR_FAKE_ARRIVAL,
+        FR_DLINE_MISS,        ///< arg1: deadline, arg2: arrival time
+        FR_BEGIN_DISPATCH,    ///< arg1: cpu (-1 on single processor)
+        FR_END_DISPATCH,      ///< arg1: cpu (-1 on single processor)
+        FR_END_INSTR,
+        FR_SRV_EXHAUSTED,
+        FR_SRV_DMISS,
+        FR_SRV_RECHARGING,
+        FR_SRV_SCHED,         ///< arg1: cpu
+        FR_SRV_DESCHED,       ///< arg1: cpu
+        FR_SRV_DISPATCH,
+        FR_SRV_IDLE,
+        FR_SRV_REPLENISH,
+        FR_BUDGET_CHANGE,     ///< arg1: new budget
+        FR_USER = 100
+    } flight_code_t;
+
+    /**
+       A record of the flight recorder: fixed size, binary.
+    */
+    struct FlightRecord {
+        Tick time;
+        int entity;
+        int code;
+        long long arg1;
+        long long arg2;
+    };
+
+    /**
+       \ingroup debug
+
+       Always-on flight recorder. The main events of the simulation
+       (the ones in the FR_* codes) are stored in a fixed-size ring
+       buffer, which is cleared at the beginning of every run and
+       dumped when something goes wrong:
+
+       - a task misses its deadline and the simulation is aborted
+         (see Task::setAbort()), or the miss trigger is set (see
+         setMissTrigger());
+       - an assertion fails (SIGABRT), or an exception is not caught
+         (std::terminate()), if installHandlers() has been called.
+
+       The recorder does not touch the handlers of the process by
+       itself, since it is created with the first task or server.
+
+       Recording an event costs a handful of stores, so it stays
+       enabled in release builds. It can be compiled out altogether
+       by defining RTSIM_NO_FLIGHTREC.
+
+       The verbose debug output (DBGENTER, DBGPRINT, ...) is instead
+       compiled in only when the library is configured with
+       -DRTSIM_VERBOSE_DEBUG=ON.
+    */
+    class FlightRecorder : public Entity {
+    public:
+        static FlightRecorder &instance();
+
+        /// Appends a record to the ring buffer
+        static inline void record(int code, int entity,
+                                  long long a1 = 0, long long a2 = 0)
+        {
+            FlightRecord &r = _buf[_head & _mask];
+            r.time = SIMUL.getTime();
+            r.entity = entity;
+            r.code = code;
+            r.arg1 = a1;
+            r.arg2 = a2;
+            _head++;
+        }
+
+        /**
+           Sets the number of records kept (rounded up to a power of
+           two, default 4096). The buffer is cleared.
+        */
+        void setSize(size_t n);
+
+        /**
+           The recorder is dumped at the first n deadline misses of
+           every run (default 0: only when the simulation is
+           aborted).
+        */
+        void setMissTrigger(int n) { _missTrigger = n; }
+
+        /// Called on a deadline miss
+        void onDeadlineMiss(bool abort);
+
+        /// Associates a name to an entity id, used by the dumps
+        void setName(int entity, const std::string &name);
+
+        /// Sets the stream of the automatic dumps (default cerr)
+        void setOutput(std::ostream &os) { _os = &os; }
+
+        /// Human-readable dump of the content of the buffer
+        void dump(std::ostream &os, const std::string &reason) const;
+
+        /// Dumps the content of the buffer on the output stream
+        void dump(const std::string &reason) const { dump(*_os, reason); }
+
+        /// Writes the records, oldest first, as raw FlightRecord structs
+        void dumpBinary(std::ostream &os) const;
+
+        /**
+           Dumps the buffer when an assertion fails or an exception
+           is not caught: installs a SIGABRT handler and a
+           std::terminate() handler, which call the previous ones
+           after the dump. Calling it again has no effect.
+        */
+        static void installHandlers();
+
+        void newRun();
+        void endRun();
+
+    private:
+        FlightRecorder();
+
+        static const char *codeName(int code);
+        static void onAbort(int sig);
+        static void onTerminate();
+
+        static FlightRecord *_buf;
+        static size_t _mask;
+        static unsigned long long _head;
+
+        std::map<int, std::string> _names;
+        std::ostream *_os;
+        int _missTrigger;
+        int _missCount;
+    };
+
+} // namespace RTSim
+
+#ifdef RTSIM_NO_FLIGHTREC
+#define FLIGHTREC(code, entity, a1, a2)
+#else
+/// Records an event of the given entity in the flight recorder
+#define FLIGHTREC(code, entity, a1, a2)                                 \
+    RTSim::FlightRecorder::record(RTSim::code, (entity)->getID(),        \
+                                  (long long)(a1), (long long)(a2))
+#endif
+
+#endif
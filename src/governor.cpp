@@ -0,0 +1,209 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <algorithm>
+#include <cmath>
+
+#include <simul.hpp>
+
+#include <governor.hpp>
+#include <grubserver.hpp>
+#include <kernel.hpp>
+#include <rttask.hpp>
+
+namespace RTSim {
+
+    using namespace std;
+    using namespace MetaSim;
+
+    Governor::Governor() : _kernel(0)
+    {
+    }
+
+    void Governor::setLoad(double load)
+    {
+        // CPU::setSpeed() does nothing if no level is fast enough
+        load = max(0.0, min(load, 1.0));
+
+        vector<CPU *> cpus = _kernel->getProcessors();
+        for (unsigned i = 0; i < cpus.size(); ++i)
+            cpus[i]->setSpeed(load);
+    }
+
+    double Governor::getSpeed() const
+    {
+        vector<CPU *> cpus = _kernel->getProcessors();
+        return cpus.empty() ? 1 : cpus[0]->getSpeed();
+    }
+
+    const deque<AbsRTTask *> &Governor::tasks() const
+    {
+        return _kernel->_handled;
+    }
+
+    double Governor::wcet(const AbsRTTask *t)
+    {
+        const Task *tt = dynamic_cast<const Task *>(t);
+        if (tt) return double(tt->getWCET());
+        return double(t->getMaxExecutionTime());
+    }
+
+    double Governor::period(AbsRTTask *t)
+    {
+        PeriodicTask *pt = dynamic_cast<PeriodicTask *>(t);
+        if (pt) return double(pt->getPeriod());
+        return double(t->getRelDline());
+    }
+
+    double Governor::executed(AbsRTTask *t) const
+    {
+        // the speed may have changed during the job
+        Task *tt = dynamic_cast<Task *>(t);
+        if (!tt) return wcet(t);
+        return tt->getExecCycles();
+    }
+
+    //  CYCLE-CONSERVING EDF  **********************************
+    CCEDFGovernor::CCEDFGovernor() : Governor(), _util(), _total(0)
+    {
+    }
+
+    void CCEDFGovernor::newRun()
+    {
+        _util.clear();
+        _total = 0;
+    }
+
+    void CCEDFGovernor::onArrival(AbsRTTask *t)
+    {
+        double u = wcet(t) / period(t);
+        _total += u - _util[t];
+        _util[t] = u;
+        refresh();
+    }
+
+    void CCEDFGovernor::onEnd(AbsRTTask *t)
+    {
+        double u = executed(t) / period(t);
+        _total += u - _util[t];
+        _util[t] = u;
+        refresh();
+    }
+
+    void CCEDFGovernor::refresh()
+    {
+        setLoad(_total);
+    }
+
+    //  LOOK-AHEAD EDF  ****************************************
+    static bool laterDeadline(const AbsRTTask *a, const AbsRTTask *b)
+    {
+        return a->getDeadline() > b->getDeadline();
+    }
+
+    void LAEDFGovernor::refresh()
+    {
+        vector<AbsRTTask *> ts(tasks().begin(), tasks().end());
+        Tick now = SIMUL.getTime();
+
+        // earliest deadline of the active jobs
+        bool active = false;
+        Tick dn = 0;
+        double U = 0;
+        for (unsigned i = 0; i < ts.size(); ++i) {
+            U += wcet(ts[i]) / period(ts[i]);
+            if (ts[i]->isActive() && (!active || ts[i]->getDeadline() < dn)) {
+                dn = ts[i]->getDeadline();
+                active = true;
+            }
+        }
+        if (!active || dn <= now) {
+            setLoad(active ? 1 : 0);
+            return;
+        }
+
+        // work that cannot be deferred after dn
+        sort(ts.begin(), ts.end(), laterDeadline);
+        double s = 0;
+        for (unsigned i = 0; i < ts.size(); ++i) {
+            AbsRTTask *t = ts[i];
+            U -= wcet(t) / period(t);
+            double left = 0;
+            if (t->isActive()) left = max(0.0, wcet(t) - executed(t));
+            double span = max(0.0, double(t->getDeadline() - dn));
+            double x = max(0.0, left - (1 - U) * span);
+            if (span > 0) U += (left - x) / span;
+            s += x;
+        }
+        setLoad(s / double(dn - now));
+    }
+
+    //  GRUB-PA  ***********************************************
+    GrubPAGovernor::GrubPAGovernor(GrubSupervisor *s) : Governor(), _sup(s)
+    {
+        s->setGovernor(this);
+    }
+
+    void GrubPAGovernor::refresh()
+    {
+        if (_kernel) setLoad(_sup->getActiveUtilization());
+    }
+
+    //  SCHEDUTIL  *********************************************
+    SchedutilGovernor::SchedutilGovernor(Tick rateLimit, Tick halfLife) :
+        Governor(), _rateLimit(rateLimit), _halfLife(halfLife),
+        _lastChange(0), _changed(false), _util(), _last()
+    {
+    }
+
+    void SchedutilGovernor::onArrival(AbsRTTask *t)
+    {
+        if (_last.find(t) == _last.end()) {
+            _last[t] = SIMUL.getTime();
+            _util[t] = wcet(t) / period(t);
+        }
+        refresh();
+    }
+
+    void SchedutilGovernor::onEnd(AbsRTTask *t)
+    {
+        Tick now = SIMUL.getTime();
+        Tick delta = now - _last[t];
+        if (delta > 0) {
+            double r = min(1.0, executed(t) / double(delta));
+            double decay = pow(0.5, double(delta) / double(_halfLife));
+            _util[t] = r + (_util[t] - r) * decay;
+        }
+        _last[t] = now;
+        refresh();
+    }
+
+    void SchedutilGovernor::refresh()
+    {
+        Tick now = SIMUL.getTime();
+        if (_changed && now - _lastChange < _rateLimit) return;
+
+        double sum = 0;
+        for (map<AbsRTTask *, double>::iterator i = _util.begin();
+             i != _util.end(); ++i)
+            sum += i->second;
+
+        double old = getSpeed();
+        setLoad(1.25 * sum);
+        if (getSpeed() != old) {
+            _lastChange = now;
+            _changed = true;
+        }
+    }
+
+} // namespace RTSim
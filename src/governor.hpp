@@ -0,0 +1,167 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __GOVERNOR_HPP__
+#define __GOVERNOR_HPP__
+
+#include <deque>
+#include <map>
+
+#include <basetype.hpp>
+
+#include <abstask.hpp>
+#include <cpu.hpp>
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    class RTKernel;
+    class GrubSupervisor;
+
+    /**
+       \ingroup kernels
+
+       Base class of the DVFS governors. A governor is attached to a
+       kernel (RTKernel::setGovernor()), which calls onArrival() and
+       onEnd() for every job; the governor then selects the speed of
+       the processors of the kernel with setLoad(), i.e. with
+       CPU::setSpeed(). On a multiprocessor kernel all the processors
+       are in the same frequency domain.
+
+       When the speed changes, the kernel rescales the end of the
+       instruction that is executing (see RTKernel::onSpeedChange()).
+
+       Utilizations are computed from Task::getWCET() (or
+       AbsTask::getMaxExecutionTime()) and from the period of the
+       PeriodicTask's (the relative deadline for the other tasks), at
+       the maximum speed.
+    */
+    class Governor {
+    public:
+        Governor();
+        virtual ~Governor() {}
+
+        virtual void setKernel(RTKernel *k) { _kernel = k; }
+
+        /// Called when a job arrives, before the dispatch
+        virtual void onArrival(AbsRTTask *t) {}
+
+        /// Called when a job ends, before the dispatch
+        virtual void onEnd(AbsRTTask *t) {}
+
+        /// Selects the speed again
+        virtual void refresh() {}
+
+        /// Called by the kernel at the beginning of every run
+        virtual void newRun() {}
+
+    protected:
+        RTKernel *_kernel;
+
+        /// Sets the lowest speed >= load on all the processors
+        void setLoad(double load);
+
+        /// Current speed of the (first) processor
+        double getSpeed() const;
+
+        /// Tasks of the kernel
+        const std::deque<AbsRTTask *> &tasks() const;
+
+        static double wcet(const AbsRTTask *t);
+        static double period(AbsRTTask *t);
+        /// Work done by the current job, in ticks at the maximum speed
+        double executed(AbsRTTask *t) const;
+    };
+
+    /**
+       Static cycle-conserving EDF (Pillai and Shin, 2001): at every
+       arrival the utilization of the task is set to its worst case,
+       at every end to the actual execution of the job, and the
+       speed is the total utilization. A task that has not arrived
+       yet does not count.
+    */
+    class CCEDFGovernor : public Governor {
+        std::map<AbsRTTask *, double> _util;
+        double _total;
+
+    public:
+        CCEDFGovernor();
+
+        void onArrival(AbsRTTask *t);
+        void onEnd(AbsRTTask *t);
+        void refresh();
+        void newRun();
+    };
+
+    /**
+       Look-ahead EDF (Pillai and Shin, 2001): the work of the active
+       jobs is deferred as much as possible after the earliest
+       deadline, and the speed is the minimum one that completes the
+       rest before it. Costs O(n log n) per arrival and end.
+    */
+    class LAEDFGovernor : public Governor {
+    public:
+        void onArrival(AbsRTTask *t) { refresh(); }
+        void onEnd(AbsRTTask *t) { refresh(); }
+        void refresh();
+    };
+
+    /**
+       GRUB-PA (Scordino and Lipari, 2006): the speed follows the
+       active utilization U^act of a GrubSupervisor, which refreshes
+       the governor at every change. The budgets of the servers are
+       still accounted in time.
+    */
+    class GrubPAGovernor : public Governor {
+        GrubSupervisor *_sup;
+
+    public:
+        GrubPAGovernor(GrubSupervisor *s);
+
+        void refresh();
+    };
+
+    /**
+       A policy similar to the schedutil governor of Linux: the
+       utilization of every task is a decaying average of the
+       fraction of time it executes (similar to PELT), and the speed
+       requested is 1.25 times the sum of the utilizations. The
+       speed changes at most once every rate limit ticks: the
+       requests that come earlier are applied at the first arrival
+       or end after the limit.
+    */
+    class SchedutilGovernor : public Governor {
+        Tick _rateLimit;
+        Tick _halfLife;
+        Tick _lastChange;
+        bool _changed;
+        std::map<AbsRTTask *, double> _util;
+        std::map<AbsRTTask *, Tick> _last;
+
+    public:
+        /**
+           @param rateLimit minimum time between two speed changes
+           @param halfLife time after which the history of a task
+                  weighs one half
+        */
+        SchedutilGovernor(Tick rateLimit = 10, Tick halfLife = 32);
+
+        void onArrival(AbsRTTask *t);
+        void onEnd(AbsRTTask *t);
+        void refresh();
+    };
+
+} // namespace RTSim
+
+#endif
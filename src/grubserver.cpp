@@ -1,23 +1,37 @@
 #include <assert.h>
+#include <algorithm>
+#include <cpu.hpp>
+#include <governor.hpp>
 #include <grubserver.hpp>
 #include <iostream>
+#include <partionedmrtkernel.hpp>
+#include <sstream>
 
 using namespace std;
 
 namespace RTSim {
     
-    GrubSupervisor::GrubSupervisor(const std::string &name) : 
+    GrubSupervisor::GrubSupervisor(const std::string &name, int m) : 
 	Entity(name),
 	servers(),
+	executing(),
 	total_u(0),
 	residual_capacity(0),
-	active_u(0) {}
+	active_u(0),
+	governor(0),
+	ncpu(m),
+	cpu_u(),
+	last_cpu(),
+	migrations(0)
+    {
+	if (m < 1) throw GrubExc("GrubSupervisor needs at least one CPU");
+    }
 
     GrubSupervisor::~GrubSupervisor() {}
 
     bool GrubSupervisor::addGrub(Grub *g) 
     {
-	if ( (total_u + g->getUtil()) > 1) 
+	if ( (total_u + g->getUtil()) > ncpu) 
 	    return false;
 	servers.push_back(g);
 	g->set_supervisor(this);
@@ -25,34 +39,74 @@ namespace RTSim {
 	return true;
     }
 
-    void GrubSupervisor::set_active(Grub *g) 
+    void GrubSupervisor::change_active_u(double delta)
     {
-	for (auto sp = servers.begin();
-	        sp != servers.end();
+	// the other servers are not charged: they read U^act when
+	// they start executing
+	for (auto sp = executing.begin();
+	        sp != executing.end();
 	            ++sp) 
 	    (*sp)->updateBudget();
 
-	active_u += g->getUtil();
+	active_u += delta;
 
-	for (auto sp = servers.begin();
-	        sp != servers.end();
+	for (auto sp = executing.begin();
+	        sp != executing.end();
 	            ++sp) 
 	    (*sp)->startAccounting();
+
+	if (governor) governor->refresh();
+    }
+
+    void GrubSupervisor::set_active(Grub *g) 
+    {
+	// accounted on a CPU when it starts executing
+	change_active_u(g->getUtil());
     }
 
     void GrubSupervisor::set_idle(Grub *g) 
     {
-	for (auto sp = servers.begin();
-	        sp != servers.end();
-	            ++sp) 
-	    (*sp)->updateBudget();
+	auto l = last_cpu.find(g);
+	if (l != last_cpu.end()) {
+	    cpu_u[l->second] -= g->getUtil();
+	    last_cpu.erase(l);
+	}
+	change_active_u(-g->getUtil());
+    }
 
-	active_u -= g->getUtil();
+    void GrubSupervisor::set_executing(Grub *g, CPU *c)
+    {
+	executing.insert(g);
+	if (c == NULL) return;
 
-	for (auto sp = servers.begin();
-	        sp != servers.end();
-	            ++sp) 
-	    (*sp)->startAccounting();
+	auto l = last_cpu.find(g);
+	if (l == last_cpu.end()) {
+	    cpu_u[c] += g->getUtil();
+	    last_cpu[g] = c;
+	}
+	else if (l->second != c) {
+	    // the server migrates with its bandwidth
+	    cpu_u[l->second] -= g->getUtil();
+	    cpu_u[c] += g->getUtil();
+	    l->second = c;
+	    migrations++;
+	}
+    }
+
+    double GrubSupervisor::getActiveUtilization(CPU *c) const
+    {
+	auto i = cpu_u.find(c);
+	return i == cpu_u.end() ? 0 : i->second;
+    }
+
+    double GrubSupervisor::get_rate(const Grub *g) const
+    {
+	return max(g->getUtil(), active_u / ncpu);
+    }
+
+    void GrubSupervisor::set_descheduled(Grub *g)
+    {
+	executing.erase(g);
     }
 
     Tick GrubSupervisor::get_capacity()
@@ -66,6 +120,10 @@ namespace RTSim {
     {
 	active_u = 0;
 	residual_capacity=0;
+	executing.clear();
+	cpu_u.clear();
+	last_cpu.clear();
+	migrations = 0;
 	//cout << "NEW RUN" << endl;
     }
 
@@ -75,6 +133,42 @@ namespace RTSim {
 
     /*----------------------------------------------------*/
 
+    PartitionedGrubSupervisor::PartitionedGrubSupervisor(PartionedMRTKernel *k,
+							 const std::string &n) :
+	name(n),
+	kernel(k),
+	sups()
+    {
+    }
+
+    PartitionedGrubSupervisor::~PartitionedGrubSupervisor()
+    {
+	for (auto i = sups.begin(); i != sups.end(); ++i)
+	    delete i->second;
+    }
+
+    bool PartitionedGrubSupervisor::addGrub(Grub *g, CPU *c,
+					    const std::string &param)
+    {
+	GrubSupervisor *s = getSupervisor(c);
+	if (s == NULL) {
+	    stringstream ss;
+	    ss << name << "_" << c->getIndex();
+	    s = sups[c] = new GrubSupervisor(ss.str());
+	}
+	if (!s->addGrub(g)) return false;
+	kernel->addTask(*g, param, c);
+	return true;
+    }
+
+    GrubSupervisor *PartitionedGrubSupervisor::getSupervisor(CPU *c) const
+    {
+	auto i = sups.find(c);
+	return i == sups.end() ? NULL : i->second;
+    }
+
+    /*----------------------------------------------------*/
+
     Grub::Grub(Tick q, Tick p, const std::string &name, const std::string &sched) :
 	Server(name, sched),
 	Q(q),
@@ -108,8 +202,9 @@ namespace RTSim {
     void Grub::startAccounting()
     {
 	if (status == EXECUTING) {
-	    vtime.start(supervisor->getActiveUtilization()/getUtil());
-	    cap.start(-supervisor->getActiveUtilization());
+	    double rate = supervisor->get_rate(this);
+	    vtime.start(rate/getUtil());
+	    cap.start(-rate);
 	    Tick delta = cap.get_intercept(0);
 	    if (delta < 0) {
 		cout << "Task: " << dynamic_cast<Task *>(tasks[0])->getName() << endl;
@@ -157,6 +252,7 @@ namespace RTSim {
     {
 	DBGENTER(_SERVER_DBG_LEV);
         status = EXECUTING;
+	supervisor->set_executing(this, getCPU());
 	Tick extra = supervisor->get_capacity();
 	//cout << "Extra: " << extra << endl;
 	cap.set_value(cap.get_value() + double(extra));
@@ -167,6 +263,7 @@ namespace RTSim {
     {
 	DBGENTER(_SERVER_DBG_LEV);
 	updateBudget();
+	supervisor->set_descheduled(this);
 	status = READY;
     }
     
@@ -174,6 +271,7 @@ namespace RTSim {
     {
 	DBGENTER(_SERVER_DBG_LEV);
 	updateBudget();
+	supervisor->set_descheduled(this);
 	status = RELEASING;
 	if (SIMUL.getTime() < Tick(vtime.get_value())) 
 	    _idleEvt.post(Tick(vtime.get_value()));
@@ -195,6 +293,7 @@ namespace RTSim {
     {
 	DBGENTER(_SERVER_DBG_LEV);
 	updateBudget();
+	supervisor->set_descheduled(this);
 	status = RECHARGING;
 	if (getDeadline() < SIMUL.getTime()) 
 	    _rechargingEvt.post(SIMUL.getTime()); 
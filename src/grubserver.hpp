@@ -14,6 +14,9 @@
 #ifndef __GRUB_HPP__
 #define __GRUB_HPP__
 
+#include <map>
+#include <set>
+
 #include <server.hpp>
 #include <capacitytimer.hpp>
 
@@ -23,6 +26,8 @@ namespace RTSim {
     using namespace MetaSim;
 
     class Grub;
+    class Governor;
+    class PartionedMRTKernel;
 
     class GrubExc : public ServerExc {
     public:
@@ -31,25 +36,88 @@ namespace RTSim {
     };
 
     /** This supervisor stores the status of all registered servers, 
-	so to be able to compute U^act */
+	so to be able to compute U^act.
+
+	Only the executing servers consume budget and virtual time,
+	so only their timers are armed: the other servers read U^act
+	when they are dispatched. A change of U^act then costs
+	O(log n), regardless of the number of servers.
+
+	With M > 1 CPUs the servers are global (on a MRTKernel), and
+	the budget is consumed with the M-GRUB rule:
+	dq = -max(U_i, 1 - (U_inact + U_extra) / M) dt, where
+	U_inact + U_extra = M - U^act is the bandwidth left by the
+	inactive servers and not reserved at all; with M = 1 it is
+	the GRUB rule dq = -U^act dt.
+
+	The active utilization is also accounted on the CPU where
+	every server executed last, and it follows the server when it
+	migrates, as the per-runqueue bandwidth of SCHED_DEADLINE. */
     class GrubSupervisor : public Entity {
         std::vector<Grub *> servers;
+        std::set<Grub *> executing;
         double total_u;
         Tick residual_capacity;
         double active_u;
+        Governor *governor;
+        int ncpu;
+        std::map<CPU *, double> cpu_u;
+        std::map<const Grub *, CPU *> last_cpu;
+        unsigned long migrations;
     public:
-        GrubSupervisor(const std::string &name = "");
+        GrubSupervisor(const std::string &name = "", int m = 1);
         ~GrubSupervisor();
         bool addGrub(Grub *g);
         void set_active(Grub *g);
         void set_idle(Grub *g);
+        void set_executing(Grub *g, CPU *c);
+        void set_descheduled(Grub *g);
         void set_capacity(Tick cap) { residual_capacity = cap; }
         Tick get_capacity();
        
         double getActiveUtilization() { return active_u; }
+
+        /// Active utilization of the servers that executed last on c
+        double getActiveUtilization(CPU *c) const;
+
+        /// Rate at which the budget of g is consumed (M-GRUB rule)
+        double get_rate(const Grub *g) const;
+
+        int getNumCPUs() const { return ncpu; }
+
+        /// Times a server started executing on a different CPU
+        unsigned long getMigrations() const { return migrations; }
+
+        /// The governor is refreshed at every change of U^act
+        void setGovernor(Governor *g) { governor = g; }
  
         void newRun();
         void endRun();
+
+    private:
+        /// Adds delta to U^act, re-arming the executing servers
+        void change_active_u(double delta);
+    };
+    
+    /** Partitioned GRUB: one uniprocessor supervisor per CPU of a
+	PartionedMRTKernel, and every server reclaims only the
+	bandwidth of its own CPU. The supervisors are created as the
+	servers are added, and deleted with this object. */
+    class PartitionedGrubSupervisor {
+        std::string name;
+        PartionedMRTKernel *kernel;
+        std::map<CPU *, GrubSupervisor *> sups;
+    public:
+        PartitionedGrubSupervisor(PartionedMRTKernel *k,
+                                  const std::string &name = "");
+        ~PartitionedGrubSupervisor();
+
+        /** Adds g to the supervisor of c, and to the kernel on c;
+	    returns false if c has not enough bandwidth left. */
+        bool addGrub(Grub *g, CPU *c, const std::string &param = "");
+
+        /// The supervisor of c, or NULL
+        GrubSupervisor *getSupervisor(CPU *c) const;
     };
     
     class Grub : public Server {
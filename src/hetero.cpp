@@ -0,0 +1,146 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <sstream>
+
+#include <hetero.hpp>
+#include <task.hpp>
+
+namespace RTSim {
+
+    using namespace std;
+    using namespace MetaSim;
+
+    Cluster::Cluster(const string &type) : _type(type), _cpus(),
+                                           _changing(false)
+    {
+    }
+
+    void Cluster::addCPU(CPU *c)
+    {
+        _cpus.push_back(c);
+        c->addObserver(this);
+    }
+
+    void Cluster::setSpeed(double load)
+    {
+        if (!_cpus.empty()) _cpus[0]->setSpeed(load);
+    }
+
+    void Cluster::onSpeedChange(CPU *c, double oldSpeed, double newSpeed)
+    {
+        // the CPUs of a cluster have the same levels
+        if (_changing) return;
+        _changing = true;
+        for (unsigned i = 0; i < _cpus.size(); ++i)
+            if (_cpus[i] != c) _cpus[i]->setSpeed(newSpeed);
+        _changing = false;
+    }
+
+    HeteroPlatform::HeteroPlatform() : _clusters(), _specs(), _cluster(0),
+                                       _created(0), _index(0)
+    {
+    }
+
+    HeteroPlatform::~HeteroPlatform()
+    {
+        for (unsigned i = 0; i < _clusters.size(); ++i)
+            delete _clusters[i];
+    }
+
+    Cluster *HeteroPlatform::addCluster(const string &type, int nCPU,
+                                        int num_levels, double V[], int F[],
+                                        double scaling, double powerFactor)
+    {
+        if (nCPU <= 0 || num_levels <= 0)
+            throw HeteroPlatformExc("Empty cluster " + type);
+
+        ClusterSpec s;
+        s.nCPU = nCPU;
+        if (num_levels > 1) {
+            s.V.assign(V, V + num_levels);
+            s.F.assign(F, F + num_levels);
+        }
+        s.scaling = scaling;
+        s.powerFactor = powerFactor;
+        _specs.push_back(s);
+
+        Cluster *c = new Cluster(type);
+        _clusters.push_back(c);
+        return c;
+    }
+
+    int HeteroPlatform::getNumCPUs() const
+    {
+        int n = 0;
+        for (unsigned i = 0; i < _specs.size(); ++i)
+            n += _specs[i].nCPU;
+        return n;
+    }
+
+    Cluster *HeteroPlatform::getCluster(CPU *c) const
+    {
+        for (unsigned i = 0; i < _clusters.size(); ++i) {
+            const vector<CPU *> &cpus = _clusters[i]->getCPUs();
+            for (unsigned j = 0; j < cpus.size(); ++j)
+                if (cpus[j] == c) return _clusters[i];
+        }
+        return NULL;
+    }
+
+    CPU *HeteroPlatform::createCPU(const string &name, int, double[], int[])
+    {
+        while (_cluster < _specs.size() &&
+               _created == _specs[_cluster].nCPU) {
+            _cluster++;
+            _created = 0;
+        }
+        if (_cluster == _specs.size())
+            throw HeteroPlatformExc("No more CPUs in the platform");
+
+        ClusterSpec &s = _specs[_cluster];
+        Cluster *cl = _clusters[_cluster];
+
+        string n = name;
+        if (n == "") {
+            ostringstream os;
+            os << cl->getType() << _created;
+            n = os.str();
+        }
+
+        CPU *c;
+        if (s.F.empty())
+            c = new CPU(n);
+        else
+            c = new CPU(n, s.F.size(), &s.V[0], &s.F[0]);
+        c->setIndex(_index++);
+        c->setType(cl->getType(), s.scaling);
+        c->setPowerFactor(s.powerFactor);
+        cl->addCPU(c);
+        _created++;
+        return c;
+    }
+
+    double getScaling(const AbsRTTask *t, CPU *c)
+    {
+        const Task *tt = dynamic_cast<const Task *>(t);
+        if (tt) return tt->getScaling(c);
+        return c->getScaling();
+    }
+
+    double getRate(const AbsRTTask *t, CPU *c)
+    {
+        return c->getSpeed() / getScaling(t, c);
+    }
+
+} // namespace RTSim
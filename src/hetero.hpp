@@ -0,0 +1,150 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __HETERO_HPP__
+#define __HETERO_HPP__
+
+#include <string>
+#include <vector>
+
+#include <baseexc.hpp>
+
+#include <abstask.hpp>
+#include <cpu.hpp>
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    class HeteroPlatformExc : public BaseExc {
+    public:
+        HeteroPlatformExc(const std::string &msg) :
+            BaseExc(msg, "HeteroPlatform", "hetero.cpp") {}
+    };
+
+    /**
+       \ingroup kernels
+
+       A cluster of cores of the same type that share a frequency
+       domain: when the speed of one of its CPUs changes (for example
+       from a Governor), the cluster sets the same speed on all the
+       others.
+    */
+    class Cluster : public CPUObserver {
+        std::string _type;
+        std::vector<CPU *> _cpus;
+        bool _changing;
+
+    public:
+        Cluster(const std::string &type);
+
+        void addCPU(CPU *c);
+
+        const std::string &getType() const { return _type; }
+        const std::vector<CPU *> &getCPUs() const { return _cpus; }
+
+        /// Sets the lowest speed >= load on all the CPUs of the cluster
+        void setSpeed(double load);
+
+        void onSpeedChange(CPU *c, double oldSpeed, double newSpeed);
+    };
+
+    /**
+       \ingroup kernels
+
+       Heterogeneous multicore platform, e.g. ARM big.LITTLE: a set of
+       clusters, each one with its core type, its voltage/frequency
+       table, its power factor (the effective capacitance with respect
+       to the other clusters) and the default factor by which the
+       execution times are multiplied on its cores. The factors of the
+       single tasks are set with Task::setScaling().
+
+       The platform is a CPU factory that creates the CPUs of the
+       clusters, in order; as with the other factories, the kernel
+       takes its ownership.
+
+       \code
+       double V[] = {0.9, 1.1};
+       int bigF[] = {1000, 2000};
+       int littleF[] = {500, 1000};
+
+       HeteroPlatform *plat = new HeteroPlatform();
+       plat->addCluster("big", 2, 2, V, bigF, 1, 2.5);
+       plat->addCluster("LITTLE", 4, 2, V, littleF, 1.8);
+       HeteroMRTKernel kern(&sched, plat, plat->getNumCPUs());
+
+       t1.setScaling("LITTLE", 2.1);
+       \endcode
+    */
+    class HeteroPlatform : public absCPUFactory {
+        struct ClusterSpec {
+            int nCPU;
+            std::vector<double> V;
+            std::vector<int> F;
+            double scaling;
+            double powerFactor;
+        };
+
+        std::vector<Cluster *> _clusters;
+        std::vector<ClusterSpec> _specs;
+        unsigned _cluster;
+        int _created;
+        int _index;
+
+    public:
+        HeteroPlatform();
+        ~HeteroPlatform();
+
+        /**
+           Adds a cluster of nCPU cores of the given type.
+
+           @param num_levels, V, F voltage and frequency table, as in
+                  the CPU constructor; with one level, the CPUs have
+                  no power saving
+           @param scaling default execution time factor of the cores
+           @param powerFactor factor of the power f * V^2 of the cores
+        */
+        Cluster *addCluster(const std::string &type, int nCPU,
+                            int num_levels, double V[], int F[],
+                            double scaling = 1, double powerFactor = 1);
+
+        int getNumCPUs() const;
+
+        const std::vector<Cluster *> &getClusters() const
+        { return _clusters; }
+
+        /// The cluster of c, or NULL
+        Cluster *getCluster(CPU *c) const;
+
+        /**
+           Creates the next CPU of the platform; the voltage and
+           frequency parameters are ignored, the table is the one of
+           the cluster.
+        */
+        CPU *createCPU(const std::string &name = "", int num_levels = 1,
+                       double V[] = NULL, int F[] = NULL);
+    };
+
+    /**
+       Execution time factor of t on c: Task::getScaling() for the
+       tasks, the default factor of the CPU for the other entities
+       (e.g. the servers).
+    */
+    double getScaling(const AbsRTTask *t, CPU *c);
+
+    /// Rate at which t executes on c at the current speed of c
+    double getRate(const AbsRTTask *t, CPU *c);
+
+} // namespace RTSim
+
+#endif
@@ -0,0 +1,101 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <vector>
+
+#include <hetero.hpp>
+#include <heteromrtkernel.hpp>
+#include <profiler.hpp>
+#include <scheduler.hpp>
+#include <task.hpp>
+
+namespace RTSim {
+
+    using namespace std;
+    using namespace MetaSim;
+
+    void HeteroMRTKernel::dispatch()
+    {
+        PROFILE_SCOPE("HeteroMRTKernel::dispatch");
+        DBGENTER(_KERNEL_DBG_LEV);
+
+        int ncpu = _m_currExe.size();
+        vector<AbsRTTask *> fresh;
+        int i;
+
+        for (i = 0; i < ncpu; ++i) {
+            AbsRTTask *t = _sched->getTaskN(i);
+            if (t == NULL) break;
+            else if (getProcessor(t) == NULL && _m_dispatched[t] == NULL)
+                fresh.push_back(t);
+        }
+        if (fresh.empty()) return;
+
+        vector<CPU *> idle;
+        for (ITCPU f = _m_currExe.begin(); f != _m_currExe.end(); ++f)
+            if (f->second == NULL && !isDispatched(f->first))
+                idle.push_back(f->first);
+
+        for (unsigned k = 0; k < fresh.size(); ++k) {
+            CPU *c = NULL;
+            if (!idle.empty()) {
+                unsigned best = 0;
+                for (unsigned j = 1; j < idle.size(); ++j)
+                    if (getRate(fresh[k], idle[j]) >
+                        getRate(fresh[k], idle[best]))
+                        best = j;
+                c = idle[best];
+                idle.erase(idle.begin() + best);
+            }
+            else {
+                // as in MRTKernel, the lowest priority dispatched
+                // tasks are descheduled
+                while (c == NULL) {
+                    AbsRTTask *t = _sched->getTaskN(i++);
+                    if (t == NULL)
+                        throw RTKernelExc("Can't find enough tasks to deschedule!");
+                    c = _m_dispatched[t];
+                }
+            }
+            DBGPRINT_4("Dispatching ", taskname(fresh[k]), " on processor ",
+                       c);
+            _planned[c] = fresh[k];
+            dispatch(c);
+        }
+    }
+
+    AbsRTTask *HeteroMRTKernel::selectTask(CPU *p)
+    {
+        map<CPU *, AbsRTTask *>::iterator j = _planned.find(p);
+        if (j == _planned.end()) return MRTKernel::selectTask(p);
+
+        AbsRTTask *st = j->second;
+        _planned.erase(j);
+
+        // the planned task must still be among the ones to execute
+        int ncpu = _m_currExe.size();
+        for (int i = 0; i < ncpu; ++i) {
+            AbsRTTask *t = _sched->getTaskN(i);
+            if (t == NULL) break;
+            if (t == st && _m_dispatched[t] == NULL) return st;
+        }
+        return MRTKernel::selectTask(p);
+    }
+
+    void HeteroMRTKernel::newRun()
+    {
+        MRTKernel::newRun();
+        _planned.clear();
+    }
+
+} // namespace RTSim
@@ -0,0 +1,57 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __HETEROMRTKERNEL_HPP__
+#define __HETEROMRTKERNEL_HPP__
+
+#include <map>
+
+#include <mrtkernel.hpp>
+
+namespace RTSim {
+
+    /**
+        \ingroup kernels
+
+        Global multiprocessor kernel for heterogeneous platforms (see
+        HeteroPlatform). It selects the tasks as MRTKernel, but every
+        new task, in priority order, is dispatched on the free CPU on
+        which it executes faster (the speed of the CPU divided by the
+        execution time factor of the task on its core type). When no
+        CPU is free, the task preempts as in MRTKernel.
+
+        A CPU that becomes free at the end (or suspension) of a task
+        takes the first ready task, as in MRTKernel: the tasks are not
+        migrated to faster cores while they execute.
+
+        @see MRTKernel, HeteroPlatform, Task::setScaling()
+    */
+    class HeteroMRTKernel : public MRTKernel {
+        /// Task selected by dispatch() for each CPU
+        std::map<CPU *, AbsRTTask *> _planned;
+
+    protected:
+        AbsRTTask *selectTask(CPU *p);
+
+    public:
+        using MRTKernel::MRTKernel;
+        using MRTKernel::dispatch;
+
+        virtual void dispatch();
+
+        virtual void newRun();
+    };
+
+} // namespace RTSim
+
+#endif
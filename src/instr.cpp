@@ -1,10 +1,15 @@
+#include <flightrec.hpp>
 #include <instr.hpp>
+#include <task.hpp>
+#include <profiler.hpp>
 
 namespace RTSim
 {
 
     void EndInstrEvt::doit()
     {
+        PROFILE_SCOPE("EndInstrEvt");
+        FLIGHTREC(FR_END_INSTR, _instr->getTask(), 0, 0);
         _instr->onEnd();
     }
 
@@ -89,6 +89,15 @@ namespace RTSim {
     /// add a task to the interrupt activation list
     void addTask(Task *t);
 
+    /// interarrival time between bursts
+    RandomVar *getInterarrival() const { return int_time; }
+
+    /// minimum interval between consecutive interrupts in a burst
+    int getBurstPeriod() const { return bp; }
+
+    /// number of consecutive interrupts in a burst
+    RandomVar *getBurstLength() const { return burst_lenght; }
+
     /**
        Called by the trigger event. Activates the tasks and posts the
        trigger event again.
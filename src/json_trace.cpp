@@ -1,5 +1,6 @@
 #include <simul.hpp>
 #include <json_trace.hpp>
+#include <profiler.hpp>
 #include <periodicservervm.hpp>
 #include <replenishmentserver.hpp>
 
@@ -29,7 +30,7 @@ namespace RTSim {
     using namespace MetaSim;
     
 
-    JSONTrace::JSONTrace(const string& name)
+    JSONTrace::JSONTrace(const string& name) : _filter(0)
     {
         fd.clear();
         fd.open(name.c_str());
@@ -71,201 +72,251 @@ namespace RTSim {
         fd << ", ";
     }
 
-    void JSONTrace::_time() {
-        _pair("time", SIMUL.getTime());
+    void JSONTrace::_time(const TraceRecord &r) {
+        _pair("time", r.time);
+    }
+
+    static const char *eventName(int code)
+    {
+        switch (code) {
+        case FR_ARRIVAL: return "arrival";
+        case FR_END: return "end_instance";
+        case FR_SCHED: return "scheduled";
+        case FR_DESCHED: return "descheduled";
+        case FR_DLINE_MISS: return "dline_miss";
+        case FR_SRV_EXHAUSTED: return "budget_exhausted";
+        case FR_SRV_DMISS: return "dline_miss";
+        case FR_SRV_RECHARGING: return "recharging";
+        case FR_SRV_SCHED: return "scheduled";
+        case FR_SRV_DESCHED: return "descheduled";
+        case FR_SRV_REPLENISH: return "replenishment";
+        default: return "UNKNOWN";
+        }
     }
 
     void JSONTrace::writeTaskEvent(
-            TaskEvt& e,
+            const TraceRecord &r,
+            const Task &tt,
             const std::string &evt_name,
             const std::string &resource,
             const std::string &cl_name)
     {
-        const Task &tt = *(e.getTask());
+        PROFILE_SCOPE("JSONTrace::probe");
         _start();
-        _time(); _sep();
+        _time(r); _sep();
         _pair("event_type", evt_name); _sep();
-        _cpu_num(e.getCPU()); _sep();
-        _task_info(tt);
+        _cpu_num(r.cpu); _sep();
+        _task_info(tt, r.arg1);
         if (! resource.empty()) {
             _sep(); _pair("resource", resource);
         }
         if (! cl_name.empty()) {
-            _sep(); _pair("event_class", resource);
+            _sep(); _pair("event_class", cl_name);
         }
         _end();
     }
 
-    void JSONTrace::_task_info(const Task &t) {
+    void JSONTrace::_task_info(const Task &t, const Tick &arrival) {
         _pair("task_name", t.getName());
         _sep();
-        _pair("arrival_time", t.getArrival());
+        _pair("arrival_time", arrival);
     }
     void JSONTrace::_cpu_num(int cpu) {
         _pair("cpu_num", ((cpu >= 0) ? to_string(cpu) : "any"));
     }
 
-    void JSONTrace::writeServerEvent(const Server &s, const string &evt_name)
+    /*
+      The CPU is written for the deadline misses and the
+      (de)scheduling, the current budget of a ReplenishmentServer for
+      the (de)scheduling and the replenishments.
+    */
+    void JSONTrace::writeServerEvent(const TraceRecord &r)
     {
+        PROFILE_SCOPE("JSONTrace::probe");
+        const Server &s = *static_cast<const Server *>(r.obj);
+        bool cpu = r.code == FR_SRV_DMISS || r.code == FR_SRV_SCHED ||
+            r.code == FR_SRV_DESCHED;
+        bool current = r.code != FR_SRV_DMISS && r.code != FR_SRV_EXHAUSTED &&
+            r.code != FR_SRV_RECHARGING &&
+            dynamic_cast<const ReplenishmentServer *>(&s) != NULL;
+
         _start();
-        fd << "\"time\" : \"" << SIMUL.getTime() << "\", ";
-        fd << "\"event_type\" : \"" << evt_name << "\", ";
+        fd << "\"time\" : \"" << r.time << "\", ";
+        fd << "\"event_type\" : \"" << eventName(r.code) << "\", ";
+        if (cpu)
+            fd << "\"cpu_num\" : \"" << ((r.cpu >= 0) ? to_string(r.cpu) : "any") << "\", ";
         fd << "\"server_name\" : \"" <<  s.getName() << "\", ";
         fd << "\"period\" : \"" <<  s.getPeriod() << "\", ";
-        fd << "\"budget\" : \"" << s.getBudget();
+        if (current)
+            fd << "\"current_budget\" : \"" <<  r.arg2 << "\", ";
+        fd << "\"budget\" : \"" << r.arg1;
         _end();
     }
 
-    void JSONTrace::writeServerEventCPU(const Server &s, const std::string &evt_name, ServerEvt& e)
+    void JSONTrace::writeTask(const TraceRecord &r)
     {
-        _start();
-        fd << "\"time\" : \"" << SIMUL.getTime() << "\", ";
-        fd << "\"event_type\" : \"" << evt_name << "\", ";
-        fd << "\"cpu_num\" : \"" << ((e.getCPU() >= 0) ? to_string(e.getCPU()) : "any") << "\", ";
-        fd << "\"server_name\" : \"" <<  s.getName() << "\", ";
-        fd << "\"period\" : \"" <<  s.getPeriod() << "\", ";
-        fd << "\"budget\" : \"" << s.getBudget();
-        _end();
+        writeTaskEvent(r, *static_cast<const Task *>(r.obj),
+                       eventName(r.code));
     }
 
-    void JSONTrace::writeServerEventCPU(const ReplenishmentServer &s, const std::string &evt_name, ServerEvt& e)
+    void JSONTrace::writeUnknownTask(const TraceRecord &r)
     {
-        _start();
-        fd << "\"time\" : \"" << SIMUL.getTime() << "\", ";
-        fd << "\"event_type\" : \"" << evt_name << "\", ";
-        fd << "\"cpu_num\" : \"" << ((e.getCPU() >= 0) ? to_string(e.getCPU()) : "any") << "\", ";
-        fd << "\"server_name\" : \"" <<  s.getName() << "\", ";
-        fd << "\"period\" : \"" <<  s.getPeriod() << "\", ";
-        fd << "\"current_budget\" : \"" <<  s.getCurrentBudget() << "\", ";
-        fd << "\"budget\" : \"" << s.getBudget();
-        _end();
+        writeTaskEvent(r, *static_cast<const Task *>(r.obj),
+                       "UNKNOWN-TaskEvt", "", demangle(r.type->name()));
     }
 
-    void JSONTrace::writeServerEvent(const ReplenishmentServer &s, const std::string &evt_name)
+    void JSONTrace::writeResource(const TraceRecord &r)
     {
-        _start();
-        fd << "\"time\" : \"" << SIMUL.getTime() << "\", ";
-        fd << "\"event_type\" : \"" << evt_name << "\", ";
-        fd << "\"server_name\" : \"" <<  s.getName() << "\", ";
-        fd << "\"period\" : \"" <<  s.getPeriod() << "\", ";
-        fd << "\"current_budget\" : \"" <<  s.getCurrentBudget() << "\", ";
-        fd << "\"budget\" : \"" << s.getBudget();
-        _end();
+        const Instr *i = static_cast<const Instr *>(r.obj);
+        if (const WaitInstr *w = dynamic_cast<const WaitInstr *>(i))
+            writeTaskEvent(r, *i->getTask(), "wait", w->getResource());
+        else if (const SignalInstr *s = dynamic_cast<const SignalInstr *>(i))
+            writeTaskEvent(r, *i->getTask(), "signal", s->getResource());
+    }
+
+    template<class E>
+    static TraceRecord serverRecord(int code, E &e)
+    {
+        Server *s = e.getServer();
+        ReplenishmentServer *rs = dynamic_cast<ReplenishmentServer *>(s);
+        return traceRecord(code, s, e.getCPU(), s->getBudget(),
+                           rs ? (long long)rs->getCurrentBudget() : 0);
+    }
+
+    static TraceRecord taskRecord(int code, TaskEvt &e)
+    {
+        Task *t = e.getTask();
+        return traceRecord(code, t, e.getCPU(), t->getArrival());
     }
 
     //  GENERIC EVENT ***************************************
     void JSONTrace::probe(Event &e)
+    {
+        PROFILE_SCOPE("JSONTrace::probe");
+        TraceRecord r = {SIMUL.getTime(), -1, 0, -1, 0, 0, NULL, &typeid(e)};
+        TRACE_WRITE(JSONTrace, writeUnknown, r);
+    }
+
+    void JSONTrace::writeUnknown(const TraceRecord &r)
     {
         _start();
-        _time();
+        _time(r);
         _pair("event_type", "UNKNOWN"); _sep();
-        _pair("event_class", demangle(typeid(e).name()));
+        _pair("event_class", demangle(r.type->name()));
         _end();
     }
 
     //  TASK EVENTS ***************************************
     void JSONTrace::probe(TaskEvt& e)
     {
-        writeTaskEvent(e, "UNKNOWN-TaskEvt", "", demangle(typeid(e).name()));
+        TraceRecord r = taskRecord(0, e);
+        r.type = &typeid(e);
+        TRACE_WRITE(JSONTrace, writeUnknownTask, r);
     }
     void JSONTrace::probe(ArrEvt& e)
     {
-        writeTaskEvent(e, "arrival");
+        TraceRecord r = taskRecord(FR_ARRIVAL, e);
+        TRACE_WRITE(JSONTrace, writeTask, r);
     }
     void JSONTrace::probe(EndEvt& e)
     {
-        writeTaskEvent(e, "end_instance");
+        TraceRecord r = taskRecord(FR_END, e);
+        TRACE_WRITE(JSONTrace, writeTask, r);
     }
     void JSONTrace::probe(SchedEvt& e)
     {
-        writeTaskEvent(e, "scheduled");
+        TraceRecord r = taskRecord(FR_SCHED, e);
+        TRACE_WRITE(JSONTrace, writeTask, r);
     }
     void JSONTrace::probe(DeschedEvt& e)
     {
-        writeTaskEvent(e, "descheduled");
+        TraceRecord r = taskRecord(FR_DESCHED, e);
+        TRACE_WRITE(JSONTrace, writeTask, r);
     }
     void JSONTrace::probe(DeadEvt& e)
     {
-        writeTaskEvent(e, "dline_miss");
+        TraceRecord r = taskRecord(FR_DLINE_MISS, e);
+        TRACE_WRITE(JSONTrace, writeTask, r);
     }
     void JSONTrace::probe(WaitEvt& e)
     {
-        writeTaskEvent(e, "wait", e.getInstr()->getResource());
+        TraceRecord r = traceRecord(0, e.getInstr(), e.getCPU(),
+                                    e.getTask()->getArrival());
+        TRACE_WRITE(JSONTrace, writeResource, r);
     }
     void JSONTrace::probe(SignalEvt& e)
     {
-        writeTaskEvent(e, "signal", e.getInstr()->getResource());
+        TraceRecord r = traceRecord(0, e.getInstr(), e.getCPU(),
+                                    e.getTask()->getArrival());
+        TRACE_WRITE(JSONTrace, writeResource, r);
     }
 
     //  SERVER EVENTS ***************************************
     void JSONTrace::probe(ServerBudgetExhaustedEvt &e)
     {
-        Server& s = *(e.getServer());
-        writeServerEvent(s, "budget_exhausted");
+        TraceRecord r = serverRecord(FR_SRV_EXHAUSTED, e);
+        TRACE_WRITE(JSONTrace, writeServerEvent, r);
     }
     void JSONTrace::probe(ServerDMissEvt &e)
     {
-        Server& s = *(e.getServer());
-        writeServerEventCPU(s, "dline_miss", e);
+        TraceRecord r = serverRecord(FR_SRV_DMISS, e);
+        TRACE_WRITE(JSONTrace, writeServerEvent, r);
     }
     void JSONTrace::probe(ServerRechargingEvt &e)
     {
-        Server& s = *(e.getServer());
-        writeServerEvent(s, "recharging");
+        TraceRecord r = serverRecord(FR_SRV_RECHARGING, e);
+        TRACE_WRITE(JSONTrace, writeServerEvent, r);
     }
     void JSONTrace::probe(ServerScheduledEvt &e)
     {
-        Server *s = e.getServer();
-        if(ReplenishmentServer *rServ = dynamic_cast<ReplenishmentServer *> (s)){
-            writeServerEventCPU(*rServ, "scheduled", e);
-        }
-        else
-            writeServerEventCPU(*s, "scheduled", e);
+        TraceRecord r = serverRecord(FR_SRV_SCHED, e);
+        TRACE_WRITE(JSONTrace, writeServerEvent, r);
     }
     void JSONTrace::probe(ServerDescheduledEvt &e)
     {
-        Server *s = e.getServer();
-        if(ReplenishmentServer *rServ = dynamic_cast<ReplenishmentServer *> (s)){
-            writeServerEventCPU(*rServ, "descheduled", e);
-        }
-        else
-            writeServerEventCPU(*s, "descheduled", e);
-        //writeServerEventCPU(%s, "descheduled", e);
+        TraceRecord r = serverRecord(FR_SRV_DESCHED, e);
+        TRACE_WRITE(JSONTrace, writeServerEvent, r);
     }
     void JSONTrace::probe(ServerReplenishmentEvt &e)
     {
-        ReplenishmentServer *s = e.getServer();
-        /*if(ReplenishmentServer *rServ = dynamic_cast<ReplenishmentServer *> (s)){
-          writeServerEvent(*rServ, "replenishment");
-          }
-          else*/
-        writeServerEvent(*s, "replenishment");
+        TraceRecord r = serverRecord(FR_SRV_REPLENISH, e);
+        TRACE_WRITE(JSONTrace, writeServerEvent, r);
     }
 
     //  OTHER EVENTS ***************************************
     void JSONTrace::probe(EndInstrEvt &e)
+    {
+        PROFILE_SCOPE("JSONTrace::probe");
+        Instr *i = e.getInstruction();
+        TraceRecord r = traceRecord(FR_END_INSTR, i, -1,
+                                    i->getTask()->getArrival());
+        TRACE_WRITE(JSONTrace, writeEndInstr, r);
+    }
+
+    void JSONTrace::writeEndInstr(const TraceRecord &r)
     {
         const char *instr_type = "";
         string resource;
         string instr_cl;
 
-        Task &task = *(e.getInstruction()->getTask());
-        if (WaitInstr *i =
-                dynamic_cast<WaitInstr *>(e.getInstruction())) {
+        const Instr *instr = static_cast<const Instr *>(r.obj);
+        const Task &task = *(instr->getTask());
+        if (const WaitInstr *i =
+                dynamic_cast<const WaitInstr *>(instr)) {
             resource = i->getResource();
             instr_type = "wait";
-        } else if (SignalInstr *i =
-                dynamic_cast<SignalInstr *>(e.getInstruction())) {
+        } else if (const SignalInstr *i =
+                dynamic_cast<const SignalInstr *>(instr)) {
             resource = i->getResource();
             instr_type = "signal";
         } else {
-            instr_cl = demangle(typeid(*e.getInstruction()).name());
+            instr_cl = demangle(typeid(*instr).name());
         }
 
         _start();
-        _time(); _sep();
+        _time(r); _sep();
         _pair("event_type", "end_instr"); _sep();
-        _task_info(task); _sep();
+        _task_info(task, r.arg1); _sep();
         _pair("instr_type", instr_type);
         if (! resource.empty()) {
             _sep(); _pair("resource", resource);
@@ -277,11 +328,19 @@ namespace RTSim {
     }
 
     void JSONTrace::probe(SystemCeilingChangedEvt &e)
+    {
+        PROFILE_SCOPE("JSONTrace::probe");
+        TraceRecord r = {SIMUL.getTime(), -1, 0, -1, e.systemCeiling(), 0,
+                         NULL, NULL};
+        TRACE_WRITE(JSONTrace, writeCeiling, r);
+    }
+
+    void JSONTrace::writeCeiling(const TraceRecord &r)
     {
         _start();
-        _time(); _sep();
+        _time(r); _sep();
         _pair("event_type", "system_ceiling_changed"); _sep();
-        _pair("ceiling", e.systemCeiling());
+        _pair("ceiling", Tick(r.arg1));
         _end();
     }
 
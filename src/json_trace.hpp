@@ -23,6 +23,7 @@
 #include <event.hpp>
 #include <particle.hpp>
 #include <trace.hpp>
+#include <tracefilter.hpp>
 
 #include <task.hpp>
 #include <rttask.hpp>
@@ -44,28 +45,35 @@ namespace RTSim {
     protected:
         std::ofstream fd;
         bool first_event;
+        TraceFilter *_filter;
 
-        void writeTaskEvent(TaskEvt& e, const std::string &evt_name, const std::string &resource="", const std::string &cl_name="");
+        void writeTaskEvent(const TraceRecord &r, const Task &t, const std::string &evt_name, const std::string &resource="", const std::string &cl_name="");
 
-        void writeServerEvent(const Server &s, const std::string &evt_name);
-        void writeServerEvent(const ReplenishmentServer &s, const std::string &evt_name);
-        void writeServerEventCPU(const Server &s, const std::string &evt_name, ServerEvt& e);
-        void writeServerEventCPU(const ReplenishmentServer &s, const std::string &evt_name, ServerEvt& e);
+        void writeServerEvent(const TraceRecord &r);
+
+        void writeUnknown(const TraceRecord &r);
+        void writeUnknownTask(const TraceRecord &r);
+        void writeTask(const TraceRecord &r);
+        void writeResource(const TraceRecord &r);
+        void writeEndInstr(const TraceRecord &r);
+        void writeCeiling(const TraceRecord &r);
 
         void _start();
         void _end();
         void _sep();
         void _pair(const std::string &key, const std::string &val);
         void _pair(const std::string &key, const MetaSim::Tick &val);
-        void _time();
+        void _time(const TraceRecord &r);
 
-        void _task_info(const Task &t);
+        void _task_info(const Task &t, const MetaSim::Tick &arrival);
         void _cpu_num(int cpu);
     public:
         JSONTrace(const std::string& name);
         
         ~JSONTrace();
-        
+
+        /// Filters the traced events (null: no filter)
+        void setFilter(TraceFilter *f) { _filter = f; }
 
         void probe(Event &e);
 
@@ -32,7 +32,7 @@ namespace RTSim {
   string JavaTrace::version = "1.2";
 
   JavaTrace::JavaTrace(const char *name, bool tof, unsigned long int limit)
-    :Trace(name, Trace::BINARY, tof), taskList(10)
+    :Trace(name, Trace::BINARY, tof), taskList(10), _filter(0)
   {
     if (endianess == TRACE_UNKNOWN_ENDIAN) probeEndianess();
     const char cver[] = "version 1.2";
@@ -85,80 +85,37 @@ namespace RTSim {
       return;
     }
 
-    Task* task = ee->getTask();
-    if (task != NULL) {
-      vector<int>::const_iterator p = find(taskList.begin(), taskList.end(),
-					   task->getID());
-      if (p == taskList.end()) {
-	TraceNameEvent* a = new TraceNameEvent(ee->getLastTime(),
-					       task->getID(), task->getName());
-	if (toFile) a->write(_os);
-	else data.push_back(a);
-	taskList.push_back(task->getID());
-      }
-    }
- 
     // at this point we have to see what kind of event it is...
+    // the values are copied in a record, written now or later by
+    // the filter
+
+    Task* task = ee->getTask();
+    int cpu = ee->getCPU();
 
     if (dynamic_cast<ArrEvt*>(e) != NULL) {
       DBGPRINT("ArrEvt");
-      ArrEvt* tae = dynamic_cast<ArrEvt*>(e);
-      TraceArrEvent* a = new TraceArrEvent(e->getLastTime(), task->getID());
-      if (toFile) a->write(_os);
-      else data.push_back(a);
-      Task* rttask = dynamic_cast<Task*>(task);
-      if (rttask) {
-	TraceDlineSetEvent* b = new TraceDlineSetEvent(tae->getLastTime(),
-						       rttask->getID(),
-						       rttask->getDeadline());
-	if (toFile) b->write(_os);
-	else data.push_back(b);
-      }
+      TraceRecord r = traceRecord(FR_ARRIVAL, task, cpu, task->getDeadline());
+      TRACE_WRITE(JavaTrace, writeArrival, r);
     } else if (dynamic_cast<EndEvt*>(e) != NULL) {
       DBGPRINT("EndEvt");
-      EndEvt* tee = dynamic_cast<EndEvt*>(e);
-
-      TraceEndEvent* a = new TraceEndEvent(tee->getLastTime(), task->getID(),
-					   tee->getCPU());
-      if (toFile) a->write(_os);
-      else data.push_back(a);
+      TraceRecord r = traceRecord(FR_END, task, cpu);
+      TRACE_WRITE(JavaTrace, writeEnd, r);
     } else if (dynamic_cast<DeschedEvt*>(e) != NULL) {
       DBGPRINT("DeschedEvt");
-      DeschedEvt *tde = dynamic_cast<DeschedEvt *>(e);
-
-      TraceDeschedEvent* a = new TraceDeschedEvent(tde->getLastTime(),
-						   task->getID(),
-						   tde->getCPU());
-      if (toFile) a->write(_os);
-      else data.push_back(a);
-    } else if (dynamic_cast<WaitEvt*>(e) != NULL) {
+      TraceRecord r = traceRecord(FR_DESCHED, task, cpu);
+      TRACE_WRITE(JavaTrace, writeDesched, r);
+    } else if (WaitEvt* we = dynamic_cast<WaitEvt*>(e)) {
       DBGPRINT("WaitEvt");
-      WaitEvt* we = dynamic_cast<WaitEvt*>(e);
-      //WaitInstr* instr = dynamic_cast<WaitInstr*>(we->getInstr());
-      WaitInstr* instr = we->getInstr();
-      string res = instr->getResource();
-      TraceWaitEvent* a = new TraceWaitEvent(we->getLastTime(),
-					     task->getID(), res);
-      if (toFile) a->write(_os);
-      else data.push_back(a);
-    } else if (dynamic_cast<SignalEvt*>(e) != NULL) {
+      TraceRecord r = traceRecord(0, we->getInstr(), cpu);
+      TRACE_WRITE(JavaTrace, writeWait, r);
+    } else if (SignalEvt* se = dynamic_cast<SignalEvt*>(e)) {
       DBGPRINT("SignalEvt");
-      SignalEvt* se = dynamic_cast<SignalEvt*>(e);
-      //SignalInstr* instr = dynamic_cast<SignalInstr*>(se->getInstr());
-      SignalInstr* instr = se->getInstr();
-      string res = instr->getResource();
-      TraceSignalEvent* a = new TraceSignalEvent(se->getLastTime(),
-						 task->getID(), res);
-      if (toFile) a->write(_os);
-      else data.push_back(a);
+      TraceRecord r = traceRecord(0, se->getInstr(), cpu);
+      TRACE_WRITE(JavaTrace, writeSignal, r);
     } else if (dynamic_cast<SchedEvt*>(e) != NULL) {
       DBGPRINT("SchedEvt");
-      SchedEvt* tse = dynamic_cast<SchedEvt*>(e);
-
-      TraceSchedEvent* a = new TraceSchedEvent(tse->getLastTime(),
-					       task->getID(), tse->getCPU());
-      if (toFile) a->write(_os);
-      else data.push_back(a);
+      TraceRecord r = traceRecord(FR_SCHED, task, cpu);
+      TRACE_WRITE(JavaTrace, writeSched, r);
 //     } else if (dynamic_cast<DlinePostEvt*>(e) != NULL) {
 //       DBGPRINT("DlinePostEvt");
 //       DlinePostEvt* dpe = dynamic_cast<DlinePostEvt*>(e);
@@ -170,15 +127,78 @@ namespace RTSim {
 //       else data.push_back(a);
     } else if (dynamic_cast<DeadEvt*>(e) != NULL) {
       DBGPRINT("DlineMissEvt");
-      DeadEvt* de = dynamic_cast<DeadEvt*>(e);
-      TraceDlineMissEvent* a = new TraceDlineMissEvent(de->getLastTime(),
-						       task->getID());
-      if (toFile) a->write(_os);
-      else data.push_back(a);
+      TraceRecord r = traceRecord(FR_DLINE_MISS, task, cpu);
+      TRACE_WRITE(JavaTrace, writeDeadline, r);
     }
-
-    if (toFile) _os.flush();
-    
   }         
 
+  void JavaTrace::store(TraceEvent *a)
+  {
+    if (toFile) {
+      a->write(_os);
+      _os.flush();
+    }
+    else data.push_back(a);
+  }
+
+  void JavaTrace::writeName(Tick time, const Task *task)
+  {
+    vector<int>::const_iterator p = find(taskList.begin(), taskList.end(),
+					 task->getID());
+    if (p == taskList.end()) {
+      store(new TraceNameEvent(time, task->getID(), task->getName()));
+      taskList.push_back(task->getID());
+    }
+  }
+
+  void JavaTrace::writeArrival(const TraceRecord &r)
+  {
+    const Task* task = static_cast<const Task*>(r.obj);
+    writeName(r.time, task);
+    store(new TraceArrEvent(r.time, task->getID()));
+    store(new TraceDlineSetEvent(r.time, task->getID(), Tick(r.arg1)));
+  }
+
+  void JavaTrace::writeEnd(const TraceRecord &r)
+  {
+    const Task* task = static_cast<const Task*>(r.obj);
+    writeName(r.time, task);
+    store(new TraceEndEvent(r.time, task->getID(), r.cpu));
+  }
+
+  void JavaTrace::writeSched(const TraceRecord &r)
+  {
+    const Task* task = static_cast<const Task*>(r.obj);
+    writeName(r.time, task);
+    store(new TraceSchedEvent(r.time, task->getID(), r.cpu));
+  }
+
+  void JavaTrace::writeDesched(const TraceRecord &r)
+  {
+    const Task* task = static_cast<const Task*>(r.obj);
+    writeName(r.time, task);
+    store(new TraceDeschedEvent(r.time, task->getID(), r.cpu));
+  }
+
+  void JavaTrace::writeDeadline(const TraceRecord &r)
+  {
+    const Task* task = static_cast<const Task*>(r.obj);
+    writeName(r.time, task);
+    store(new TraceDlineMissEvent(r.time, task->getID()));
+  }
+
+  void JavaTrace::writeWait(const TraceRecord &r)
+  {
+    const WaitInstr* instr = static_cast<const WaitInstr*>(r.obj);
+    writeName(r.time, instr->getTask());
+    store(new TraceWaitEvent(r.time, r.entity, instr->getResource()));
+  }
+
+  void JavaTrace::writeSignal(const TraceRecord &r)
+  {
+    const SignalInstr* instr = static_cast<const SignalInstr*>(r.obj);
+    writeName(r.time, instr->getTask());
+    store(new TraceSignalEvent(r.time, r.entity, instr->getResource()));
+  }
+
 }
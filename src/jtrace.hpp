@@ -24,6 +24,7 @@
 #include <trace.hpp>
 
 #include <traceevent.hpp>
+#include <tracefilter.hpp>
  
 #define _JTRACE_DBG_LEV "JavaTracer"
 
@@ -63,6 +64,22 @@ namespace RTSim {
 
     vector<int> taskList;
 
+    TraceFilter *_filter;
+
+    /// Writes the event to the file, or stores it in data
+    void store(TraceEvent *a);
+
+    /// Writes the name of the task, the first time it is traced
+    void writeName(Tick time, const Task *task);
+
+    void writeArrival(const TraceRecord &r);
+    void writeEnd(const TraceRecord &r);
+    void writeSched(const TraceRecord &r);
+    void writeDesched(const TraceRecord &r);
+    void writeDeadline(const TraceRecord &r);
+    void writeWait(const TraceRecord &r);
+    void writeSignal(const TraceRecord &r);
+
   public:
     JavaTrace(const char *name, bool tof = true,
 	      unsigned long int limit = 1000000);
@@ -72,6 +89,9 @@ namespace RTSim {
 
     vector<TraceEvent*> getData() {return data;}
 
+    /// Filters the traced events (null: no filter)
+    void setFilter(TraceFilter *f) { _filter = f; }
+
     // The Little/Big Endian coding functions!
     virtual void record(Event *e);
   };
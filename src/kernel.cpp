@@ -16,7 +16,9 @@
 #include <simul.hpp>
 
 #include <cpu.hpp>
+#include <governor.hpp>
 #include <kernel.hpp>
+#include <profiler.hpp>
 #include <resmanager.hpp>
 #include <edfsched.hpp>
 #include <rmsched.hpp>
@@ -25,6 +27,7 @@
 #include <task.hpp>
 #include <reginstr.hpp>
 #include <periodicservervm.hpp>
+#include <timepartitionvm.hpp>
 
 namespace RTSim {
 
@@ -36,6 +39,7 @@ namespace RTSim {
 	  _resMng(0),
 	  _cpu(),
 	  internalCpu(true),
+	  _governor(0),
 	  beginDispatchEvt(this),
 	  endDispatchEvt(this),
 	  _isContextSwitching(false),
@@ -44,6 +48,7 @@ namespace RTSim {
         __reginstr_init();
         __regsched_init();
         __regtask_init();
+        __regserver_init();
 
         _currExe = NULL;
 
@@ -66,6 +71,7 @@ namespace RTSim {
             // Creates a CPU without power saving:
             _cpu = new CPU;
         }
+        _cpu->addObserver(this);
           
 		if(s)
 			s->setKernel(this);
@@ -100,6 +106,23 @@ namespace RTSim {
         return _cpu;
     }
 
+    vector<CPU*> RTKernel::getProcessors() const
+    {
+        return vector<CPU*>(1, _cpu);
+    }
+
+    void RTKernel::setGovernor(Governor *g)
+    {
+        _governor = g;
+        if (g) g->setKernel(this);
+    }
+
+    void RTKernel::onSpeedChange(CPU *c, double oldSpeed, double newSpeed)
+    {
+        if (_currExe != NULL)
+            _currExe->refreshExec(oldSpeed, newSpeed);
+    }
+
     void RTKernel::activate(AbsRTTask *task)
     { 
         DBGENTER(_KERNEL_DBG_LEV);
@@ -137,6 +160,7 @@ namespace RTSim {
                    taskname(task));
 	
 	_sched->insert(task);
+        if (_governor) _governor->onArrival(task);
 
 	if(!_isContextSwitching){
 	    dispatch();
@@ -153,6 +177,7 @@ namespace RTSim {
         if (getProcessor(task) == NULL) {
             throw RTKernelExc("Received a onEnd of a non executing task");
         }
+        if (_governor) _governor->onEnd(task);
         _sched->extract(task);
         _currExe = NULL;
         
@@ -161,6 +186,7 @@ namespace RTSim {
 
     void RTKernel::dispatch()
     {
+        PROFILE_SCOPE("RTKernel::dispatch");
         DBGENTER(_KERNEL_DBG_LEV);
 
 	// we have only to post an Dispatch event (low priority)
@@ -275,6 +301,7 @@ namespace RTSim {
     void RTKernel::newRun()
     {
         _currExe = NULL;
+        if (_governor) _governor->newRun();
     }
 
     void RTKernel::endRun()
@@ -312,4 +339,19 @@ namespace RTSim {
         Server *implementation = VM.getImplementation();
         addTask(*implementation, "");
     }
+
+    void RTKernel::addVM(TimePartitionVM &VM)
+    {
+        VM.validate();
+
+        const map<string, PartitionServer *> &parts = VM.getPartitions();
+        map<string, PartitionServer *>::const_iterator i;
+        for (i = parts.begin(); i != parts.end(); ++i) {
+            if (VM.getCPU(i->first) != 0)
+                throw TimePartitionExc("Partition " + i->first +
+                                       " is not on CPU 0");
+            // the windows do not overlap: one partition is ready at a time
+            addTask(*i->second, "0");
+        }
+    }
 }
@@ -17,6 +17,7 @@
 #include <deque>
 #include <set>
 #include <string>
+#include <vector>
 
 #include <baseexc.hpp>
 #include <entity.hpp>
@@ -36,6 +37,8 @@ namespace RTSim {
     class Scheduler;
     class ResManager;
     class PeriodicServerVM;
+    class TimePartitionVM;
+    class Governor;
 
     /**
        \ingroup kernels
@@ -79,7 +82,8 @@ namespace RTSim {
  
         @sa absCPUFactory, Scheduler, ResManager, AbsRTTask
     */
-    class RTKernel : public Entity, public virtual AbsKernel {
+    class RTKernel : public Entity, public virtual AbsKernel,
+                     public CPUObserver {
     protected:
 
         /// The real-time scheduler
@@ -109,9 +113,14 @@ namespace RTSim {
         */
         bool internalCpu;
 
+        /// The DVFS governor (null: the speed is never changed)
+        Governor *_governor;
+
 	friend class DispatchEvt;
 	friend class BeginDispatchEvt;
 	friend class EndDispatchEvt;
+        friend class Governor;
+        friend class EnergyMeter;
 
     public:
 
@@ -272,6 +281,9 @@ namespace RTSim {
         */
         virtual CPU* getOldProcessor(const AbsRTTask* t) const;
 
+        /// Returns the processors of the kernel
+        virtual std::vector<CPU*> getProcessors() const;
+
         AbsRTTask* getCurrExe() const;
 
         /**
@@ -336,6 +348,20 @@ namespace RTSim {
         double setSpeed(double newLoad) 
             {return (_cpu->setSpeed(newLoad));}
 
+        /**
+           Sets the governor that changes the speed of the
+           processors at the arrivals and at the ends of the tasks.
+        */
+        void setGovernor(Governor *g);
+
+        Governor *getGovernor() const { return _governor; }
+
+        /**
+           Called when the speed of one of the processors changes:
+           the end of the task executing on it is rescaled.
+        */
+        virtual void onSpeedChange(CPU *c, double oldSpeed, double newSpeed);
+
         /**
            Function inherited from AbsKernel. It says if the 
 	   kernel is currently in context switch mode.
@@ -364,6 +390,13 @@ namespace RTSim {
          It adds a PeriodicServerVM to the kernel
          */
         virtual void addVM(PeriodicServerVM &VM);
+
+        /**
+         It adds the partitions of a TimePartitionVM to the kernel,
+         after validating its schedule table. All the windows must
+         be on CPU 0.
+         */
+        virtual void addVM(TimePartitionVM &VM);
     };
   
 } // namespace RTSim 
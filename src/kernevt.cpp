@@ -1,6 +1,8 @@
 
 #include <kernel.hpp>
 #include <kernevt.hpp>
+#include <profiler.hpp>
+#include <flightrec.hpp>
 
 namespace RTSim {
 /*	
@@ -9,10 +11,14 @@ namespace RTSim {
     }
 */
     void BeginDispatchEvt::doit(){
+        PROFILE_SCOPE("BeginDispatchEvt");
+        FLIGHTREC(FR_BEGIN_DISPATCH, _kernel, -1, 0);
         _kernel->onBeginDispatch(this);
     }
 
     void EndDispatchEvt::doit(){
+        PROFILE_SCOPE("EndDispatchEvt");
+        FLIGHTREC(FR_END_DISPATCH, _kernel, -1, 0);
         _kernel->onEndDispatch(this);
     }
 
@@ -0,0 +1,130 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <simul.hpp>
+
+#include <membus.hpp>
+#include <profiler.hpp>
+#include <task.hpp>
+
+namespace RTSim {
+
+    using namespace std;
+    using namespace MetaSim;
+
+    MemoryBus::MemoryBus(double bandwidth, const string &name) :
+        Entity(name), _bandwidth(bandwidth), _intensity(), _delay(),
+        _running(), _cpus()
+    {
+    }
+
+    void MemoryBus::addTask(Task *t, double intensity)
+    {
+        _intensity[t] = intensity;
+        _delay[t] = 0;
+        t->setMemoryBus(this);
+    }
+
+    double MemoryBus::getDemand() const
+    {
+        double d = 0;
+        for (map<Task *, Running>::const_iterator i = _running.begin();
+             i != _running.end(); ++i)
+            d += _intensity.find(i->first)->second * i->second.cpu->getSpeed();
+        return d;
+    }
+
+    void MemoryBus::account()
+    {
+        Tick now = SIMUL.getTime();
+        for (map<Task *, Running>::iterator i = _running.begin();
+             i != _running.end(); ++i) {
+            double f = i->first->getContention();
+            _delay[i->first] += double(now - i->second.since) * (1 - f);
+            i->second.since = now;
+        }
+    }
+
+    void MemoryBus::update()
+    {
+        PROFILE_SCOPE("MemoryBus::update");
+        double d = getDemand();
+        double slow = d > _bandwidth ? d / _bandwidth : 1;
+
+        for (map<Task *, Running>::iterator i = _running.begin();
+             i != _running.end(); ++i) {
+            double m = _intensity[i->first];
+            i->first->setContention(1 / ((1 - m) + m * slow));
+        }
+    }
+
+    void MemoryBus::onSchedule(Task *t, CPU *c)
+    {
+        if (_intensity.find(t) == _intensity.end() || !c) return;
+
+        if (_cpus.insert(c).second) c->addObserver(this);
+
+        account();
+        Running &r = _running[t];
+        r.cpu = c;
+        r.since = SIMUL.getTime();
+        update();
+    }
+
+    void MemoryBus::onDeschedule(Task *t)
+    {
+        map<Task *, Running>::iterator i = _running.find(t);
+        if (i == _running.end()) return;
+
+        account();
+        _running.erase(i);
+        t->setContention(1);
+        update();
+    }
+
+    void MemoryBus::onSpeedChange(CPU *c, double, double)
+    {
+        account();
+        update();
+    }
+
+    double MemoryBus::getInterference(const Task *t) const
+    {
+        map<const Task *, double>::const_iterator i = _delay.find(t);
+        return i != _delay.end() ? i->second : 0;
+    }
+
+    void MemoryBus::print(ostream &os) const
+    {
+        os << "Memory bus interference:" << endl;
+        for (map<const Task *, double>::const_iterator i = _delay.begin();
+             i != _delay.end(); ++i)
+            os << "  task " << i->first->getName() << ": "
+               << i->second << endl;
+    }
+
+    void MemoryBus::newRun()
+    {
+        _running.clear();
+        for (map<const Task *, double>::iterator i = _delay.begin();
+             i != _delay.end(); ++i)
+            i->second = 0;
+    }
+
+    /// Accounts the delay up to the end of the run
+    void MemoryBus::endRun()
+    {
+        account();
+    }
+
+} // namespace RTSim
@@ -0,0 +1,111 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __MEMBUS_HPP__
+#define __MEMBUS_HPP__
+
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+
+#include <entity.hpp>
+
+#include <cpu.hpp>
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    class Task;
+
+    /**
+       \ingroup kernels
+
+       Contention on a memory bus shared by the CPUs. Every task
+       spends a fraction m of its execution (at the maximum speed, in
+       isolation) accessing memory, and so demands m times the speed
+       of its CPU of bandwidth; the bus serves a total bandwidth B (in
+       the same unit: 1 is the demand of a task that only accesses
+       memory at the maximum speed).
+
+       When the total demand D of the running tasks exceeds B, the
+       memory accesses are slowed down by D / B, and every task
+       progresses at the rate 1 / ((1 - m) + m * D / B) of its
+       speed. The rates are computed again whenever a task starts or
+       stops executing, or the speed of one of the CPUs changes, and
+       the end of the running instructions is moved accordingly (see
+       Task::setContention()).
+
+       The interference delay of a task is the time it has executed
+       more than in isolation.
+
+       \code
+       MemoryBus bus(1.5);
+       bus.addTask(&t1, 0.6);
+       bus.addTask(&t2, 0.3);
+       ...
+       cout << bus.getInterference(&t1) << endl;
+       \endcode
+    */
+    class MemoryBus : public Entity, public CPUObserver {
+    public:
+        MemoryBus(double bandwidth, const std::string &name = "MemoryBus");
+
+        /// The task spends the fraction intensity of its execution on
+        /// memory accesses (it calls t->setMemoryBus(this))
+        void addTask(Task *t, double intensity);
+
+        /// Called when t starts executing on c
+        void onSchedule(Task *t, CPU *c);
+
+        /// Called when t stops executing
+        void onDeschedule(Task *t);
+
+        void onSpeedChange(CPU *c, double oldSpeed, double newSpeed);
+
+        double getBandwidth() const { return _bandwidth; }
+
+        /// Total demand of the running tasks
+        double getDemand() const;
+
+        /// Total interference delay of t
+        double getInterference(const Task *t) const;
+
+        void print(std::ostream &os) const;
+
+        void newRun();
+        void endRun();
+
+    private:
+        struct Running {
+            CPU *cpu;
+            Tick since;
+        };
+
+        double _bandwidth;
+        std::map<Task *, double> _intensity;
+        std::map<const Task *, double> _delay;
+        std::map<Task *, Running> _running;
+        std::set<CPU *> _cpus;
+
+        /// Accounts the delay of the running tasks up to now
+        void account();
+
+        /// Sets the rates of the running tasks
+        void update();
+    };
+
+} // namespace RTSim
+
+#endif
@@ -0,0 +1,296 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <algorithm>
+#include <cmath>
+
+#include <particle.hpp>
+#include <randomvar.hpp>
+
+#include <compositional.hpp>
+#include <cpu.hpp>
+#include <interrupt.hpp>
+#include <rttask.hpp>
+#include <server.hpp>
+#include <task.hpp>
+
+#include "minplus.hpp"
+
+namespace RTSim {
+
+    using namespace std;
+
+    static const double EPS = 1e-9;
+
+    Curve::Curve(Tick horizon) : _v(), _rate(0)
+    {
+        if (horizon < 0) throw CurveExc("Negative horizon");
+        _v.assign((long long)horizon + 1, 0.0);
+    }
+
+    double Curve::operator()(Tick t) const
+    {
+        long long x = (long long)t;
+        long long h = _v.size() - 1;
+        if (x < 0) return 0;
+        if (x <= h) return _v[x];
+        return _v[h] + _rate * (x - h);
+    }
+
+    void Curve::set(Tick t, double v)
+    {
+        if (t < 0 || t > getHorizon()) throw CurveExc("Out of the horizon");
+        _v[(long long)t] = v;
+    }
+
+    vector<Tick> Curve::breakpoints() const
+    {
+        long long h = _v.size() - 1;
+        vector<Tick> b(1, Tick(0));
+        for (long long x = 1; x < h; ++x)
+            if (fabs((_v[x + 1] - _v[x]) - (_v[x] - _v[x - 1])) > EPS)
+                b.push_back(Tick(x));
+        if (h > 0) b.push_back(Tick(h));
+        return b;
+    }
+
+    Curve Curve::affine(double rate, double burst, Tick horizon)
+    {
+        Curve c(horizon);
+        for (Tick t = 1; t <= horizon; ++t)
+            c.set(t, burst + rate * double(t));
+        c.setRate(rate);
+        return c;
+    }
+
+    Curve Curve::rateLatency(double rate, Tick latency, Tick horizon)
+    {
+        Curve c(horizon);
+        for (Tick t = latency + 1; t <= horizon; ++t)
+            c.set(t, rate * double(t - latency));
+        c.setRate(rate);
+        return c;
+    }
+
+    Curve Curve::staircase(Tick period, double v, Tick horizon, Tick jitter)
+    {
+        if (period <= 0) throw CurveExc("Non positive period");
+        long long p = (long long)period;
+        Curve c(horizon);
+        for (Tick t = 1; t <= horizon; ++t)
+            c.set(t, v * (((long long)(t + jitter) + p - 1) / p));
+        c.setRate(v / p);
+        return c;
+    }
+
+    Curve Curve::fromPeriodicTask(PeriodicTask &t, Tick horizon)
+    {
+        return staircase(t.getPeriod(), double(t.getWCET()), horizon);
+    }
+
+    Curve Curve::fromInterrupt(Interrupt &i, Tick horizon, double v)
+    {
+        long long len, gap;
+        try {
+            len = (long long)i.getBurstLength()->getMaximum();
+            gap = (long long)i.getInterarrival()->getMinimum();
+        }
+        catch (RandomVar::MaxException &e) {
+            throw CurveExc("Unbounded burst length or interarrival");
+        }
+        long long bp = i.getBurstPeriod();
+        long long cycle = (len - 1) * bp + gap;
+        if (len < 1 || cycle <= 0)
+            throw CurveExc("The interrupt has no minimum distance");
+
+        // the densest sequence: bursts as long and close as possible
+        vector<Tick> arr;
+        for (long long s = 0; s <= (long long)horizon + cycle; s += cycle)
+            for (long long k = 0; k < len; ++k)
+                arr.push_back(Tick(s + k * bp));
+
+        Curve c = fromTrace(arr, horizon, v);
+        c.setRate(v * len / cycle);
+        return c;
+    }
+
+    Curve Curve::fromTrace(const vector<Tick> &arrivals, Tick horizon, double v)
+    {
+        vector<Tick> a(arrivals);
+        sort(a.begin(), a.end());
+        unsigned n = a.size();
+
+        // span[k]: the shortest interval that contains k + 1 arrivals
+        vector<Tick> span(n, Tick(0));
+        for (unsigned k = 1; k < n; ++k) {
+            span[k] = a[k] - a[0];
+            for (unsigned i = 1; i + k < n; ++i)
+                span[k] = min(span[k], a[i + k] - a[i]);
+        }
+
+        // k + 1 arrivals fit in the windows longer than span[k]
+        Curve c(horizon);
+        unsigned k = 0;
+        for (Tick t = 1; t <= horizon && n > 0; ++t) {
+            while (k + 1 < n && span[k + 1] < t) ++k;
+            c.set(t, v * (k + 1));
+        }
+        if (horizon > 0) c.setRate(c(horizon) / double(horizon));
+        return c;
+    }
+
+    Curve Curve::cpuService(double speed, Tick horizon)
+    {
+        return affine(speed, 0, horizon);
+    }
+
+    Curve Curve::cpuService(CPU *cpu, Tick horizon)
+    {
+        return cpuService(cpu->getSpeed(), horizon);
+    }
+
+    Curve Curve::serverService(Tick budget, Tick period, Tick horizon)
+    {
+        Curve c(horizon);
+        for (Tick t = 1; t <= horizon; ++t)
+            c.set(t, CompositionalAnalysis::sbf(budget, period, t));
+        c.setRate(double(budget) / double(period));
+        return c;
+    }
+
+    Curve Curve::serverService(const Server &s, Tick horizon)
+    {
+        return serverService(s.getBudget(), s.getPeriod(), horizon);
+    }
+
+    Curve Curve::convolve(const Curve &f, const Curve &g)
+    {
+        // f(s) + g(t - s) is linear in s between the breakpoints of f
+        // and the ones of g (reflected): the minimum is at one of them
+        vector<Tick> bf = f.breakpoints(), bg = g.breakpoints();
+        Tick h = max(f.getHorizon(), g.getHorizon());
+        Curve c(h);
+        for (Tick t = 0; t <= h; ++t) {
+            double m = f(t) + g(0);
+            for (unsigned i = 0; i < bf.size() && bf[i] <= t; ++i)
+                m = min(m, f(bf[i]) + g(t - bf[i]));
+            for (unsigned i = 0; i < bg.size() && bg[i] <= t; ++i)
+                m = min(m, f(t - bg[i]) + g(bg[i]));
+            c.set(t, m);
+        }
+        c.setRate(min(f.getRate(), g.getRate()));
+        return c;
+    }
+
+    Curve Curve::deconvolve(const Curve &f, const Curve &g)
+    {
+        if (f.getRate() > g.getRate() + EPS)
+            throw CurveExc("Deconvolution unbounded: the rate of f is larger");
+
+        // f(t + u) - g(u) is linear in u between the breakpoints of g
+        // and the ones of f (shifted), and does not increase after
+        // the last one: the maximum is at one of them
+        vector<Tick> bf = f.breakpoints(), bg = g.breakpoints();
+        Tick h = max(f.getHorizon(), g.getHorizon());
+        Curve c(h);
+        for (Tick t = 0; t <= h; ++t) {
+            double m = f(t) - g(0);
+            for (unsigned i = 0; i < bg.size(); ++i)
+                m = max(m, f(t + bg[i]) - g(bg[i]));
+            for (unsigned i = 0; i < bf.size(); ++i)
+                if (bf[i] >= t) m = max(m, f(bf[i]) - g(bf[i] - t));
+            c.set(t, m);
+        }
+        c.setRate(f.getRate());
+        return c;
+    }
+
+    double Curve::vDeviation(const Curve &f, const Curve &g)
+    {
+        if (f.getRate() > g.getRate() + EPS)
+            throw CurveExc("Unbounded backlog: the rate of f is larger");
+
+        // the demand arrived in [0, t - 1] is f(t); after both
+        // horizons, the difference does not increase
+        Tick h = max(f.getHorizon(), g.getHorizon() + 1);
+        double m = 0;
+        for (Tick t = 1; t <= h; ++t)
+            m = max(m, f(t) - g(t - 1));
+        return m;
+    }
+
+    Tick Curve::hDeviation(const Curve &f, const Curve &g)
+    {
+        if (f.getRate() > g.getRate() + EPS || g.getRate() <= 0)
+            throw CurveExc("Unbounded delay: the rate of f is larger");
+
+        // the demand arrived in [0, t - 1] is served by t - 1 + d,
+        // the first tick from t - 1 where g (increasing) reaches it
+        Tick h = max(f.getHorizon(), g.getHorizon() + 1);
+        long long gh = g.getHorizon();
+        Tick m = 0;
+        for (Tick t = 1; t <= h; ++t) {
+            double a = f(t);
+            long long s = (long long)t - 1;
+            long long x = lower_bound(g._v.begin() + min(s, gh + 1),
+                                      g._v.end(), a - EPS) - g._v.begin();
+            if (x > gh) {
+                double left = a - g(gh);
+                x = max(s, gh + (long long)Tick::ceil(left / g.getRate() - EPS));
+            }
+            m = max(m, Tick(x - s));
+        }
+        return m;
+    }
+
+    Curve Curve::minimum(const Curve &f, const Curve &g)
+    {
+        Tick h = min(f.getHorizon(), g.getHorizon());
+        Curve c(h);
+        for (Tick t = 0; t <= h; ++t)
+            c.set(t, min(f(t), g(t)));
+        c.setRate(min(f.getRate(), g.getRate()));
+        return c;
+    }
+
+    Curve Curve::sum(const Curve &f, const Curve &g)
+    {
+        Tick h = min(f.getHorizon(), g.getHorizon());
+        Curve c(h);
+        for (Tick t = 0; t <= h; ++t)
+            c.set(t, f(t) + g(t));
+        c.setRate(f.getRate() + g.getRate());
+        return c;
+    }
+
+    /*----------------------------------------------------*/
+
+    CurveBoundCheck::CurveBoundCheck(Task *t, Tick bound, const string &name) :
+        Entity(name), _task(t), _bound(bound), _max(0), _violations(0)
+    {
+        new Particle<EndEvt, CurveBoundCheck>(&t->endEvt, this);
+    }
+
+    void CurveBoundCheck::probe(EndEvt &e)
+    {
+        Tick r = SIMUL.getTime() - _task->getArrival();
+        if (r > _max) _max = r;
+        if (r > _bound) _violations++;
+    }
+
+    void CurveBoundCheck::newRun()
+    {
+        _max = 0;
+        _violations = 0;
+    }
+}
@@ -0,0 +1,170 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __MINPLUS_HPP__
+#define __MINPLUS_HPP__
+
+#include <string>
+#include <vector>
+
+#include <baseexc.hpp>
+#include <entity.hpp>
+#include <simul.hpp>
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    class CPU;
+    class EndEvt;
+    class Interrupt;
+    class PeriodicTask;
+    class Server;
+    class Task;
+
+    class CurveExc : public BaseExc {
+    public:
+        CurveExc(const string &msg) : BaseExc(msg, "Curve", "minplus.cpp") {}
+    };
+
+    /**
+       A wide-sense increasing curve of the min-plus algebra (network
+       calculus), over the discrete time of the simulator: the curve
+       is defined only at the ticks, stored as its value at every
+       tick of [0, H], and continues with a constant rate after the
+       horizon H. It is piecewise linear: the ticks where the slope
+       changes are its breakpoints, and a staircase has two of them
+       per step. The operations visit only the breakpoints, so they
+       cost the horizon times the number of breakpoints. They are
+       exact over the larger horizon of the operands; choose H of at
+       least a few hyperperiods of the tasks involved, beyond the
+       busy periods of interest.
+
+       Arrival curves bound the demand in any window [t, t + d) of
+       length d; service curves bound from below the supply in any
+       window. For a demand alpha served by beta, the response times
+       are bounded by hDeviation(alpha, beta), the backlog by
+       vDeviation(alpha, beta), and the demand that leaves the
+       service by deconvolve(alpha, beta).
+    */
+    class Curve {
+        std::vector<double> _v;
+        double _rate;
+
+        /// The ticks where the slope changes, with 0 and the horizon
+        std::vector<Tick> breakpoints() const;
+
+    public:
+        /// The zero curve
+        Curve(Tick horizon = 0);
+
+        Tick getHorizon() const { return _v.size() - 1; }
+        /// Rate after the horizon
+        double getRate() const { return _rate; }
+
+        double operator()(Tick t) const;
+
+        /// Sets the value at t (within the horizon)
+        void set(Tick t, double v);
+        void setRate(double r) { _rate = r; }
+
+        /// @name Common curves
+        /// @{
+
+        /// b + r t for t > 0 (token bucket)
+        static Curve affine(double rate, double burst, Tick horizon);
+
+        /// R max(0, t - T)
+        static Curve rateLatency(double rate, Tick latency, Tick horizon);
+
+        /// c ceil((t + jitter) / period) for t > 0
+        static Curve staircase(Tick period, double c, Tick horizon,
+                               Tick jitter = 0);
+
+        /// Demand of a periodic task: WCET ceil(t / period)
+        static Curve fromPeriodicTask(PeriodicTask &t, Tick horizon);
+
+        /**
+           Activations of a (bursty) interrupt: bursts of at most the
+           maximum burst length, one activation every burst period,
+           and at least the minimum interarrival time between the
+           end of a burst and the next one.
+        */
+        static Curve fromInterrupt(Interrupt &i, Tick horizon, double c = 1);
+
+        /**
+           Arrival curve of a measured trace: the largest number of
+           arrivals (times c) in a window of each length. The rate
+           after the horizon is the one of the trace.
+        */
+        static Curve fromTrace(const std::vector<Tick> &arrivals, Tick horizon,
+                               double c = 1);
+
+        /// Full processor at the given speed
+        static Curve cpuService(double speed, Tick horizon);
+        static Curve cpuService(CPU *c, Tick horizon);
+
+        /// Supply bound function of a periodic or CBS server (Q, P)
+        static Curve serverService(Tick budget, Tick period, Tick horizon);
+        static Curve serverService(const Server &s, Tick horizon);
+
+        /// @}
+
+        /// @name Min-plus operations
+        /// @{
+
+        /// inf over s in [0, t] of f(s) + g(t - s)
+        static Curve convolve(const Curve &f, const Curve &g);
+
+        /// sup over u >= 0 of f(t + u) - g(u)
+        static Curve deconvolve(const Curve &f, const Curve &g);
+
+        /// Largest vertical distance between f and g (backlog bound)
+        static double vDeviation(const Curve &f, const Curve &g);
+
+        /// Largest horizontal distance between f and g (delay bound)
+        static Tick hDeviation(const Curve &f, const Curve &g);
+
+        static Curve minimum(const Curve &f, const Curve &g);
+        static Curve sum(const Curve &f, const Curve &g);
+
+        /// @}
+    };
+
+    /**
+       Checks that the response times of a task in the simulation
+       never exceed an analytic bound (for instance, the horizontal
+       deviation between its arrival curve and its service curve).
+    */
+    class CurveBoundCheck : public Entity {
+        Task *_task;
+        Tick _bound;
+        Tick _max;
+        unsigned long _violations;
+
+    public:
+        CurveBoundCheck(Task *t, Tick bound, const std::string &name = "");
+
+        Tick getBound() const { return _bound; }
+        Tick getMaxResponseTime() const { return _max; }
+        unsigned long getViolations() const { return _violations; }
+        bool holds() const { return _violations == 0; }
+
+        void probe(EndEvt &e);
+
+        void newRun();
+        void endRun() {}
+    };
+}
+
+#endif
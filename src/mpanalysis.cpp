@@ -0,0 +1,189 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <climits>
+
+#include <mpanalysis.hpp>
+
+namespace RTSim {
+
+    using namespace std;
+
+    MPBlockingAnalysis::MPBlockingAnalysis(Protocol p) :
+        _protocol(p), _tasks()
+    {
+    }
+
+    int MPBlockingAnalysis::addTask(int cpu, Tick prio, Tick wcet,
+                                    Tick period, Tick deadline)
+    {
+        if (wcet <= 0 || period <= 0)
+            throw MPAnalysisExc("WCET and period must be positive");
+
+        TaskInfo t;
+        t.cpu = cpu;
+        t.prio = prio;
+        t.wcet = wcet;
+        t.period = period;
+        t.deadline = deadline > 0 ? deadline : period;
+        _tasks.push_back(t);
+        return _tasks.size() - 1;
+    }
+
+    void MPBlockingAnalysis::addCriticalSection(int i, const string &res,
+                                                Tick length, int count)
+    {
+        if (i < 0 || i >= int(_tasks.size()))
+            throw MPAnalysisExc("Task index out of range");
+        if (length > _tasks[i].wcet)
+            throw MPAnalysisExc("Critical section longer than the WCET");
+
+        CriticalSection c = {res, length, count};
+        _tasks[i].cs.push_back(c);
+    }
+
+    const MPBlockingAnalysis::TaskInfo &MPBlockingAnalysis::task(int i) const
+    {
+        if (i < 0 || i >= int(_tasks.size()))
+            throw MPAnalysisExc("Task index out of range");
+        return _tasks[i];
+    }
+
+    Tick MPBlockingAnalysis::longest(int i, const string &res) const
+    {
+        Tick l = 0;
+        for (unsigned k = 0; k < _tasks[i].cs.size(); ++k)
+            if (_tasks[i].cs[k].res == res && _tasks[i].cs[k].length > l)
+                l = _tasks[i].cs[k].length;
+        return l;
+    }
+
+    Tick MPBlockingAnalysis::ceiling(const string &res, int cpu) const
+    {
+        Tick c = INT_MAX;
+        for (unsigned j = 0; j < _tasks.size(); ++j)
+            if (_tasks[j].cpu == cpu && longest(j, res) > 0 &&
+                _tasks[j].prio < c)
+                c = _tasks[j].prio;
+        return c;
+    }
+
+    Tick MPBlockingAnalysis::getRequestBound(int i, const string &res) const
+    {
+        const TaskInfo &t = task(i);
+
+        if (_protocol == FMLPP) {
+            // one section of every other task
+            Tick w = 0;
+            for (unsigned j = 0; j < _tasks.size(); ++j)
+                if (int(j) != i) w += longest(j, res);
+            return w;
+        }
+
+        // the longest section of every other processor
+        map<int, Tick> perCPU;
+        for (unsigned j = 0; j < _tasks.size(); ++j) {
+            Tick l = longest(j, res);
+            if (l > perCPU[_tasks[j].cpu]) perCPU[_tasks[j].cpu] = l;
+        }
+
+        Tick w = 0, max = 0;
+        int users = 0;
+        map<int, Tick>::iterator c;
+        for (c = perCPU.begin(); c != perCPU.end(); ++c) {
+            if (c->second == 0) continue;
+            users++;
+            if (c->second > max) max = c->second;
+            if (c->first != t.cpu) w += c->second;
+        }
+
+        if (_protocol == MSRP) return w;
+
+        // MrsP: the spinner may also execute the section of every
+        // other processor, in place of the owner
+        return max * (users > 0 ? users - 1 : 0);
+    }
+
+    Tick MPBlockingAnalysis::getWaitBound(int i) const
+    {
+        const TaskInfo &t = task(i);
+        Tick w = 0;
+        for (unsigned k = 0; k < t.cs.size(); ++k)
+            w += getRequestBound(i, t.cs[k].res) * t.cs[k].count;
+        return w;
+    }
+
+    Tick MPBlockingAnalysis::getLocalBlocking(int i) const
+    {
+        const TaskInfo &t = task(i);
+        Tick b = 0;
+
+        for (unsigned j = 0; j < _tasks.size(); ++j) {
+            const TaskInfo &l = _tasks[j];
+            if (int(j) == i || l.cpu != t.cpu || l.prio <= t.prio) continue;
+
+            for (unsigned k = 0; k < l.cs.size(); ++k) {
+                const string &r = l.cs[k].res;
+                Tick x = l.cs[k].length;
+
+                if (_protocol == MRSP) {
+                    if (ceiling(r, t.cpu) > t.prio) continue;
+                    x += getRequestBound(j, r);
+                }
+                else if (_protocol == MSRP)
+                    x += getRequestBound(j, r);
+
+                if (x > b) b = x;
+            }
+        }
+
+        if (_protocol == FMLPP) {
+            // once at the release, and once after every suspension
+            int n = 1;
+            for (unsigned k = 0; k < t.cs.size(); ++k) n += t.cs[k].count;
+            b = b * n;
+        }
+        return b;
+    }
+
+    Tick MPBlockingAnalysis::inflated(int i) const
+    {
+        return _tasks[i].wcet + getWaitBound(i);
+    }
+
+    Tick MPBlockingAnalysis::getResponseTime(int i) const
+    {
+        const TaskInfo &t = task(i);
+        Tick base = inflated(i) + getLocalBlocking(i);
+
+        Tick r = base, old = 0;
+        while (r != old && r <= t.deadline) {
+            old = r;
+            r = base;
+            for (unsigned j = 0; j < _tasks.size(); ++j) {
+                const TaskInfo &h = _tasks[j];
+                if (int(j) == i || h.cpu != t.cpu || h.prio > t.prio) continue;
+                // This is a ceil()
+                r += (old + h.period - 1) / int(h.period) * inflated(j);
+            }
+        }
+        return r;
+    }
+
+    bool MPBlockingAnalysis::isSchedulable() const
+    {
+        for (unsigned i = 0; i < _tasks.size(); ++i)
+            if (getResponseTime(i) > _tasks[i].deadline) return false;
+        return true;
+    }
+}
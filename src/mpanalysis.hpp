@@ -0,0 +1,127 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __MPANALYSIS_HPP__
+#define __MPANALYSIS_HPP__
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <baseexc.hpp>
+#include <simul.hpp>
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    class MPAnalysisExc : public BaseExc {
+    public:
+        MPAnalysisExc(const std::string &msg) :
+            BaseExc(msg, "MPBlockingAnalysis", "mpanalysis.cpp") {}
+    };
+
+    /**
+       \ingroup resman
+
+       Blocking bounds and response time analysis for partitioned
+       fixed priority scheduling with the multiprocessor locking
+       protocols of mpresman.hpp. The task set is described
+       offline: the processor, priority (lower numbers mean higher
+       priorities), WCET (including the critical sections) and period
+       of every task, and the critical sections of every job (resource,
+       maximum length and number of accesses).
+
+       - MSRP: every access to r spins at most for the longest
+         critical section on r of every other processor; the spin is
+         added to the WCET, and a task is blocked once by a non
+         preemptive section (with its spin) of a local lower priority
+         task.
+       - MrsP: every access to r costs at most the longest critical
+         section on r times the number of processors using r (the
+         owner can execute the sections of all the spinners); a task
+         is blocked once by a lower priority local task using a
+         resource whose ceiling is at least its priority.
+       - FMLP+: every access to r waits (suspended) at most for one
+         section on r of every other task; every job is delayed at
+         most once per request, plus once, by a boosted local
+         section. The analysis is suspension oblivious: the waiting
+         time of every task is counted as execution.
+
+       The bounds of a simulation (MPResManager::getMaxWaitTime() of
+       a task, divided by its number of accesses) must not exceed the
+       spin or wait bounds of this class.
+    */
+    class MPBlockingAnalysis {
+    public:
+        typedef enum {MSRP, MRSP, FMLPP} Protocol;
+
+        MPBlockingAnalysis(Protocol p);
+
+        /// Returns the index of the task
+        int addTask(int cpu, Tick prio, Tick wcet, Tick period,
+                    Tick deadline = 0);
+
+        void addCriticalSection(int task, const std::string &res,
+                                Tick length, int count = 1);
+
+        /// Maximum spin (or suspension) of one access of task to res
+        Tick getRequestBound(int task, const std::string &res) const;
+
+        /// Maximum total spin (or suspension) of a job of task
+        Tick getWaitBound(int task) const;
+
+        /// Maximum blocking of a job of task by lower priority tasks
+        Tick getLocalBlocking(int task) const;
+
+        /**
+           Response time of task, or a value larger than its deadline
+           if it is not schedulable.
+        */
+        Tick getResponseTime(int task) const;
+
+        bool isSchedulable() const;
+
+    private:
+        struct CriticalSection {
+            std::string res;
+            Tick length;
+            int count;
+        };
+
+        struct TaskInfo {
+            int cpu;
+            Tick prio;
+            Tick wcet;
+            Tick period;
+            Tick deadline;
+            std::vector<CriticalSection> cs;
+        };
+
+        Protocol _protocol;
+        std::vector<TaskInfo> _tasks;
+
+        const TaskInfo &task(int i) const;
+
+        /// The longest critical section of task i on res (0 if none)
+        Tick longest(int i, const std::string &res) const;
+
+        /// The ceiling of res on the processor (INT_MAX if unused)
+        Tick ceiling(const std::string &res, int cpu) const;
+
+        /// The WCET of task, with its spin (or suspension) time
+        Tick inflated(int i) const;
+    };
+}
+
+#endif
@@ -0,0 +1,512 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <climits>
+#include <limits>
+
+#include <simul.hpp>
+
+#include <mpresman.hpp>
+#include <mrtkernel.hpp>
+#include <partionedmrtkernel.hpp>
+#include <resource.hpp>
+#include <task.hpp>
+#include <waitinstr.hpp>
+
+namespace RTSim {
+
+    using namespace std;
+    using namespace MetaSim;
+
+    static const Tick::impl_t MAX_PRIO =
+        std::numeric_limits<Tick::impl_t>::max();
+
+    /// higher than the priority of any task
+    static const Tick NON_PREEMPTIVE = -MAX_PRIO;
+
+    /**
+       The boosted priorities start here, and grow with the request
+       time: they stay higher than the priority of any task, and
+       lower than NON_PREEMPTIVE, for request times up to MAX_PRIO / 2
+       (about 4.6e18 ticks).
+    */
+    static const Tick BOOSTED = -(MAX_PRIO / 2);
+
+    MPResManager::MPResManager(const string &n) :
+        ResManager(n), _taskStates(), _lockStates()
+    {
+    }
+
+    MPResManager::~MPResManager()
+    {
+    }
+
+    void MPResManager::addResource(const string &name, int n)
+    {
+        ResManager::addResource(name, n);
+        Resource *r = _res.back();
+        if (r->total() != 1)
+            throw MPResManagerExc("Only single unit resources are supported");
+
+        _lockStates[r].owner = NULL;
+    }
+
+    MRTKernel *MPResManager::kernel()
+    {
+        MRTKernel *k = dynamic_cast<MRTKernel *>(_kernel);
+        if (k == NULL)
+            throw MPResManagerExc(getName() + " needs a multiprocessor kernel");
+        return k;
+    }
+
+    MPResManager::TaskState &MPResManager::state(AbsRTTask *t)
+    {
+        map<AbsRTTask *, TaskState>::iterator i = _taskStates.find(t);
+        if (i != _taskStates.end()) return i->second;
+
+        TaskModel *m = findModel(kernel()->getTaskScheduler(t), t);
+        if (m == NULL) throw MPResManagerExc("Cannot find task model!");
+
+        TaskState s = {m, m->getPriority(), NULL, NULL, 0, 0, 0, 0};
+        return _taskStates[t] = s;
+    }
+
+    MPResManager::LockState &MPResManager::lockState(Resource *r)
+    {
+        map<Resource *, LockState>::iterator i = _lockStates.find(r);
+        if (i == _lockStates.end())
+            throw MPResManagerExc("Resource not managed by " + getName());
+        return i->second;
+    }
+
+    AbsRTTask *MPResManager::getOwner(const string &res)
+    {
+        return lockState(dynamic_cast<Resource *>(Entity::_find(res))).owner;
+    }
+
+    bool MPResManager::isWaiting(AbsRTTask *t) const
+    {
+        map<AbsRTTask *, TaskState>::const_iterator i = _taskStates.find(t);
+        return i != _taskStates.end() && i->second.waitingFor != NULL;
+    }
+
+    Tick MPResManager::getWaitTime(AbsRTTask *t) const
+    {
+        map<AbsRTTask *, TaskState>::const_iterator i = _taskStates.find(t);
+        return i == _taskStates.end() ? Tick(0) : i->second.waitTotal;
+    }
+
+    Tick MPResManager::getMaxWaitTime(AbsRTTask *t) const
+    {
+        map<AbsRTTask *, TaskState>::const_iterator i = _taskStates.find(t);
+        return i == _taskStates.end() ? Tick(0) : i->second.waitMax;
+    }
+
+    unsigned long MPResManager::getWaitCount(AbsRTTask *t) const
+    {
+        map<AbsRTTask *, TaskState>::const_iterator i = _taskStates.find(t);
+        return i == _taskStates.end() ? 0 : i->second.waitCount;
+    }
+
+    TaskModel *MPResManager::findModel(Scheduler *s, AbsRTTask *t)
+    {
+        return s->find(t);
+    }
+
+    void MPResManager::addModel(Scheduler *s, TaskModel *m)
+    {
+        s->enqueueModel(m);
+    }
+
+    void MPResManager::removeModel(Scheduler *s, AbsRTTask *t)
+    {
+        TaskModel *m = s->find(t);
+        if (m == NULL) return;
+        if (m->isActive()) s->extract(t);
+        s->_tasks.erase(t);
+        delete m;
+    }
+
+    void MPResManager::setPriority(AbsRTTask *t, Tick p)
+    {
+        DBGPRINT_4("Priority of ", taskname(t), " is now ", p);
+
+        TaskState &s = state(t);
+        Scheduler *sc = kernel()->getTaskScheduler(t);
+
+        // the model is not in this queue while the task is away
+        // (see MrsPResManager), and not in any queue while it is
+        // suspended. A queued task keeps its insertion time, so it
+        // is not preempted by the tasks of the same priority.
+        bool queued = sc->find(t) == s.model && s.model->isActive();
+        AbsRTTask *exe = sc->_currExe;
+        if (queued) sc->extract(t);
+        s.model->changePriority(p);
+        if (queued) {
+            s.model->setActive();
+            sc->_queue.insert(s.model);
+        }
+        sc->_currExe = exe;
+    }
+
+    void MPResManager::restorePriority(AbsRTTask *t)
+    {
+        TaskState &s = state(t);
+        if (s.model->getPriority() != s.base) setPriority(t, s.base);
+    }
+
+    void MPResManager::grant(AbsRTTask *t, Resource *r)
+    {
+        DBGPRINT(taskname(t) << " locks " << r->getName());
+
+        lockState(r).owner = t;
+        state(t).holding = r;
+        r->lock(t);
+        onGrant(t, r);
+    }
+
+    bool MPResManager::request(AbsRTTask *t, Resource *r, int n)
+    {
+        DBGENTER(_MPRESMAN_DBG_LEV);
+
+        TaskState &s = state(t);
+        if (s.holding != NULL)
+            throw MPResManagerExc(taskname(t) + " requests " + r->getName() +
+                                  " while holding " + s.holding->getName() +
+                                  ": nested critical sections are not supported");
+
+        LockState &l = lockState(r);
+        s.base = s.model->getPriority();
+        s.requestTime = SIMUL.getTime();
+        onRequest(t, r);
+
+        if (l.owner == NULL) {
+            grant(t, r);
+            return true;
+        }
+
+        DBGPRINT(taskname(t) << " waits for " << r->getName());
+
+        s.waitingFor = r;
+        s.waitCount++;
+        l.waiters.push_back(t);
+        onBlock(t, r);
+        return false;
+    }
+
+    void MPResManager::release(AbsRTTask *t, Resource *r, int n)
+    {
+        DBGENTER(_MPRESMAN_DBG_LEV);
+
+        TaskState &s = state(t);
+        LockState &l = lockState(r);
+        if (l.owner != t)
+            throw MPResManagerExc("Resource " + r->getName() +
+                                  " released by a task that does not hold it");
+
+        l.owner = NULL;
+        s.holding = NULL;
+        r->unlock();
+        onRelease(t, r);
+
+        if (l.waiters.empty()) return;
+
+        AbsRTTask *w = l.waiters.front();
+        l.waiters.pop_front();
+
+        TaskState &ws = state(w);
+        Tick d = SIMUL.getTime() - ws.requestTime;
+        ws.waitTotal += d;
+        if (d > ws.waitMax) ws.waitMax = d;
+        ws.waitingFor = NULL;
+
+        grant(w, r);
+        onWakeUp(w, r);
+    }
+
+    void MPResManager::newRun()
+    {
+        map<AbsRTTask *, TaskState>::iterator i;
+        for (i = _taskStates.begin(); i != _taskStates.end(); ++i) {
+            TaskState &s = i->second;
+            if (s.holding != NULL || s.waitingFor != NULL)
+                s.model->changePriority(s.base);
+            s.holding = s.waitingFor = NULL;
+            s.requestTime = s.waitTotal = s.waitMax = 0;
+            s.waitCount = 0;
+        }
+
+        map<Resource *, LockState>::iterator j;
+        for (j = _lockStates.begin(); j != _lockStates.end(); ++j) {
+            j->second.owner = NULL;
+            j->second.waiters.clear();
+        }
+    }
+
+    void MPResManager::endRun()
+    {
+    }
+
+    /*----------------------------------------------------------------*/
+
+    MSRPResManager::MSRPResManager(const string &n) : MPResManager(n)
+    {
+    }
+
+    void MSRPResManager::onRequest(AbsRTTask *t, Resource *r)
+    {
+        setPriority(t, NON_PREEMPTIVE);
+    }
+
+    void MSRPResManager::onBlock(AbsRTTask *t, Resource *r)
+    {
+        kernel()->startSpin(t);
+    }
+
+    void MSRPResManager::onWakeUp(AbsRTTask *t, Resource *r)
+    {
+        kernel()->endSpin(t);
+    }
+
+    void MSRPResManager::onRelease(AbsRTTask *t, Resource *r)
+    {
+        restorePriority(t);
+    }
+
+    /*----------------------------------------------------------------*/
+
+    MrsPModel::MrsPModel(AbsRTTask *owner, Tick prio, Tick insert) :
+        TaskModel(owner), _prio(prio), _insert(insert)
+    {
+    }
+
+    MrsPResManager::MrsPResManager(const string &n) :
+        MPResManager(n), _ceilings(), _home(), _migrations(), _returning(),
+        _returnEvt(this, &MrsPResManager::onReturn)
+    {
+    }
+
+    MrsPResManager::~MrsPResManager()
+    {
+    }
+
+    PartionedMRTKernel *MrsPResManager::partKernel()
+    {
+        PartionedMRTKernel *k = dynamic_cast<PartionedMRTKernel *>(_kernel);
+        if (k == NULL)
+            throw MPResManagerExc(getName() + " needs a PartionedMRTKernel");
+        return k;
+    }
+
+    void MrsPResManager::ceilingsFromTask(AbsRTTask *t)
+    {
+        Task *task = dynamic_cast<Task *>(t);
+        if (task == NULL)
+            throw MPResManagerExc("ceilingsFromTask argument must be a Task");
+
+        CPU *c = partKernel()->getProcessor(t);
+        Tick p = state(t).base;
+
+        const vector<Instr *> &instrs = task->getInstrQueue();
+        for (unsigned i = 0; i < instrs.size(); ++i) {
+            WaitInstr *w = dynamic_cast<WaitInstr *>(instrs[i]);
+            if (w == NULL) continue;
+            Resource *r = dynamic_cast<Resource *>(Entity::_find(w->getResource()));
+            lockState(r);
+
+            map<CPU *, Tick> &ceil = _ceilings[r];
+            if (!ceil.count(c) || p < ceil[c]) ceil[c] = p;
+        }
+    }
+
+    void MrsPResManager::setCeiling(const string &res, CPU *c, Tick prio)
+    {
+        Resource *r = dynamic_cast<Resource *>(Entity::_find(res));
+        lockState(r);
+        _ceilings[r][c] = prio;
+    }
+
+    Tick MrsPResManager::getCeiling(const string &res, CPU *c)
+    {
+        Resource *r = dynamic_cast<Resource *>(Entity::_find(res));
+        lockState(r);
+        map<CPU *, Tick> &ceil = _ceilings[r];
+        return ceil.count(c) ? ceil[c] : Tick(INT_MAX);
+    }
+
+    unsigned long MrsPResManager::getMigrationCount(AbsRTTask *t) const
+    {
+        map<AbsRTTask *, unsigned long>::const_iterator i = _migrations.find(t);
+        return i == _migrations.end() ? 0 : i->second;
+    }
+
+    bool MrsPResManager::isRunning(AbsRTTask *t)
+    {
+        MRTKernel *k = kernel();
+        CPU *c = k->getProcessor(t);
+        return c != NULL && k->getTask(c) == t;
+    }
+
+    void MrsPResManager::onRequest(AbsRTTask *t, Resource *r)
+    {
+        map<CPU *, Tick> &ceil = _ceilings[r];
+        CPU *c = partKernel()->getProcessor(t);
+        if (ceil.count(c) && ceil[c] < state(t).base) setPriority(t, ceil[c]);
+    }
+
+    void MrsPResManager::onBlock(AbsRTTask *t, Resource *r)
+    {
+        kernel()->startSpin(t);
+        help(r);
+    }
+
+    void MrsPResManager::onWakeUp(AbsRTTask *t, Resource *r)
+    {
+        kernel()->endSpin(t);
+
+        // the new owner may have been preempted while spinning
+        help(r);
+    }
+
+    void MrsPResManager::onRelease(AbsRTTask *t, Resource *r)
+    {
+        restorePriority(t);
+
+        // the task may end with this release: it goes back after
+        // the end of the task has been processed
+        if (_home.count(t)) {
+            _returning.push_back(t);
+            if (!_returnEvt.isInQueue()) _returnEvt.post(SIMUL.getTime());
+        }
+    }
+
+    void MrsPResManager::help(Resource *r)
+    {
+        LockState &l = lockState(r);
+        AbsRTTask *o = l.owner;
+        if (o == NULL || isRunning(o)) return;
+
+        PartionedMRTKernel *k = partKernel();
+        deque<AbsRTTask *>::iterator i;
+        AbsRTTask *spinner = NULL;
+        for (i = l.waiters.begin(); i != l.waiters.end(); ++i) {
+            if (!isRunning(*i)) continue;
+            // already helping there, waiting for the context switch
+            if (k->getProcessor(*i) == k->getProcessor(o)) return;
+            if (spinner == NULL) spinner = *i;
+        }
+        if (spinner != NULL) moveTo(o, spinner);
+    }
+
+    void MrsPResManager::moveTo(AbsRTTask *t, AbsRTTask *s)
+    {
+        DBGPRINT(taskname(t) << " helped by " << taskname(s));
+
+        PartionedMRTKernel *k = partKernel();
+        CPU *from = k->getProcessor(t);
+        CPU *to = k->getProcessor(s);
+        if (!_home.count(t)) _home[t] = from;
+        CPU *home = _home[t];
+
+        if (to != home) {
+            Scheduler *sc = k->getTaskScheduler(s);
+            TaskModel *m = findModel(sc, s);
+            addModel(sc, new MrsPModel(t, m->getPriority(),
+                                       m->getInsertTime() - 1));
+        }
+
+        Scheduler *old = k->getTaskScheduler(t);
+        k->migrate(t, to);
+        if (from != home) removeModel(old, t);
+        if (to == home) _home.erase(t);
+        _migrations[t]++;
+    }
+
+    void MrsPResManager::goHome(AbsRTTask *t)
+    {
+        map<AbsRTTask *, CPU *>::iterator i = _home.find(t);
+        if (i == _home.end()) return;
+
+        PartionedMRTKernel *k = partKernel();
+        Scheduler *old = k->getTaskScheduler(t);
+        k->migrate(t, i->second);
+        removeModel(old, t);
+        _home.erase(i);
+    }
+
+    void MrsPResManager::onReturn(Event *e)
+    {
+        DBGENTER(_MPRESMAN_DBG_LEV);
+
+        vector<AbsRTTask *> r;
+        r.swap(_returning);
+        for (unsigned i = 0; i < r.size(); ++i)
+            if (state(r[i]).holding == NULL) goHome(r[i]);
+    }
+
+    void MrsPResManager::onContextSwitch(CPU *c, AbsRTTask *prev,
+                                         AbsRTTask *next)
+    {
+        map<AbsRTTask *, TaskState>::iterator i;
+
+        // a preempted owner, or a spinner back on its processor
+        if (prev != NULL && (i = _taskStates.find(prev)) != _taskStates.end()
+            && i->second.holding != NULL)
+            help(i->second.holding);
+        if (next != NULL && (i = _taskStates.find(next)) != _taskStates.end()
+            && i->second.waitingFor != NULL)
+            help(i->second.waitingFor);
+    }
+
+    void MrsPResManager::newRun()
+    {
+        MPResManager::newRun();
+
+        while (!_home.empty()) goHome(_home.begin()->first);
+        _returning.clear();
+        _migrations.clear();
+    }
+
+    void MrsPResManager::endRun()
+    {
+        _returnEvt.drop();
+        MPResManager::endRun();
+    }
+
+    /*----------------------------------------------------------------*/
+
+    FMLPPlusResManager::FMLPPlusResManager(const string &n) :
+        MPResManager(n)
+    {
+    }
+
+    void FMLPPlusResManager::onGrant(AbsRTTask *t, Resource *r)
+    {
+        setPriority(t, BOOSTED + state(t).requestTime);
+    }
+
+    void FMLPPlusResManager::onBlock(AbsRTTask *t, Resource *r)
+    {
+        kernel()->suspend(t);
+    }
+
+    void FMLPPlusResManager::onWakeUp(AbsRTTask *t, Resource *r)
+    {
+        kernel()->activate(t);
+    }
+
+    void FMLPPlusResManager::onRelease(AbsRTTask *t, Resource *r)
+    {
+        restorePriority(t);
+    }
+}
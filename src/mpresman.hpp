@@ -0,0 +1,279 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __MPRESMAN_HPP__
+#define __MPRESMAN_HPP__
+
+#include <deque>
+#include <map>
+#include <vector>
+
+#include <gevent.hpp>
+#include <resmanager.hpp>
+
+#define _MPRESMAN_DBG_LEV  "mpresman"
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    class MRTKernel;
+    class PartionedMRTKernel;
+
+    class MPResManagerExc : public BaseExc {
+    public:
+        MPResManagerExc(const string &msg) :
+            BaseExc(msg, "MPResManager", "mpresman.cpp") {}
+    };
+
+    /**
+       \ingroup resman
+
+       Base class of the multiprocessor locking protocols, for the
+       tasks of a MRTKernel or of a PartionedMRTKernel. Every
+       resource has a single unit and a FIFO queue of waiters: when
+       the owner releases it, the first waiter gets it. The derived
+       classes decide what a task does while it waits (spin or
+       suspend) and which priority it has before and during the
+       critical section.
+
+       Nested critical sections are not supported: a task that
+       requests a resource while holding another one gets an
+       exception.
+
+       For every task, the manager records the time spent waiting
+       for resources (spinning or suspended), which can be checked
+       against the bounds of MPBlockingAnalysis.
+    */
+    class MPResManager : public ResManager {
+    public:
+        MPResManager(const std::string &n = "");
+        ~MPResManager();
+
+        virtual void addResource(const std::string &name, int n=1);
+
+        /// The task holding the resource, or NULL
+        AbsRTTask *getOwner(const std::string &res);
+
+        /// Returns true if t is waiting for a resource
+        bool isWaiting(AbsRTTask *t) const;
+
+        /// @name Waiting statistics
+        /// @{
+        Tick getWaitTime(AbsRTTask *t) const;
+        Tick getMaxWaitTime(AbsRTTask *t) const;
+        unsigned long getWaitCount(AbsRTTask *t) const;
+        /// @}
+
+        void newRun();
+        void endRun();
+
+    protected:
+        struct TaskState {
+            /// the model in the scheduler of the task
+            TaskModel *model;
+            /// the priority before the request
+            Tick base;
+            Resource *holding;
+            Resource *waitingFor;
+            Tick requestTime;
+
+            Tick waitTotal;
+            Tick waitMax;
+            unsigned long waitCount;
+        };
+
+        struct LockState {
+            AbsRTTask *owner;
+            std::deque<AbsRTTask *> waiters;
+        };
+
+        std::map<AbsRTTask *, TaskState> _taskStates;
+        std::map<Resource *, LockState> _lockStates;
+
+        MRTKernel *kernel();
+
+        TaskState &state(AbsRTTask *t);
+        LockState &lockState(Resource *r);
+
+        /// Moves the task in the queue of its scheduler
+        void setPriority(AbsRTTask *t, Tick p);
+        void restorePriority(AbsRTTask *t);
+
+        /// @name Access to the schedulers, for the derived classes
+        /// @{
+        static TaskModel *findModel(Scheduler *s, AbsRTTask *t);
+        static void addModel(Scheduler *s, TaskModel *m);
+        static void removeModel(Scheduler *s, AbsRTTask *t);
+        /// @}
+
+        /// @name Protocol hooks
+        /// @{
+        /// Before the task tries to lock r
+        virtual void onRequest(AbsRTTask *t, Resource *r) {}
+        /// The task gets r
+        virtual void onGrant(AbsRTTask *t, Resource *r) {}
+        /// The task must wait for r
+        virtual void onBlock(AbsRTTask *t, Resource *r) = 0;
+        /// The task, which was waiting, got r
+        virtual void onWakeUp(AbsRTTask *t, Resource *r) = 0;
+        /// The task released r
+        virtual void onRelease(AbsRTTask *t, Resource *r) {}
+        /// @}
+
+        virtual bool request(AbsRTTask *t, Resource *r, int n=1);
+        virtual void release(AbsRTTask *t, Resource *r, int n=1);
+
+    private:
+        void grant(AbsRTTask *t, Resource *r);
+    };
+
+    /**
+       \ingroup resman
+
+       Multiprocessor Stack Resource Policy (Gai, Lipari and Di
+       Natale, 2001): a task that requests a resource becomes non
+       preemptive, and busy waits in FIFO order until the resource
+       is free; it becomes preemptive again when it releases it.
+       The spinning task keeps its processor busy (see
+       MRTKernel::startSpin()).
+
+       All the resources are handled as global: a local resource
+       (used only by the tasks of one processor) is never contended
+       by a remote task, so it never spins, but it is accessed non
+       preemptively instead of with the SRP ceiling.
+    */
+    class MSRPResManager : public MPResManager {
+    public:
+        MSRPResManager(const std::string &n = "");
+
+    protected:
+        virtual void onRequest(AbsRTTask *t, Resource *r);
+        virtual void onBlock(AbsRTTask *t, Resource *r);
+        virtual void onWakeUp(AbsRTTask *t, Resource *r);
+        virtual void onRelease(AbsRTTask *t, Resource *r);
+    };
+
+    /**
+       The model of a lock owner that executes on the processor of a
+       spinning task, in its place: it has the priority of the
+       spinner, and it is ahead of it in the queue.
+    */
+    class MrsPModel : public TaskModel {
+        Tick _prio;
+        Tick _insert;
+
+    public:
+        MrsPModel(AbsRTTask *owner, Tick prio, Tick insert);
+
+        virtual Tick getPriority() { return _prio; }
+        virtual void changePriority(Tick p) { _prio = p; }
+        virtual void setInsertTime(Tick t) {}
+        virtual Tick getInsertTime() { return _insert; }
+    };
+
+    /**
+       \ingroup resman
+
+       Multiprocessor resource sharing Protocol (Burns and Wellings,
+       2013) for a PartionedMRTKernel with fixed priority
+       schedulers. A task that requests a resource raises its
+       priority to the ceiling of the resource on its processor (the
+       highest priority among the local users, see
+       ceilingsFromTask()), and busy waits in FIFO order.
+
+       When the owner of a resource is preempted, and a task waiting
+       for it is spinning on another processor, the owner migrates
+       there and executes in place of the spinner (helping); it goes
+       back to its processor when it releases the resource.
+    */
+    class MrsPResManager : public MPResManager {
+    public:
+        MrsPResManager(const std::string &n = "");
+        ~MrsPResManager();
+
+        /**
+           Raises the ceilings, on the processor of the task, of the
+           resources it uses (from its wait instructions). The task
+           must be already in the kernel.
+        */
+        void ceilingsFromTask(AbsRTTask *t);
+
+        void setCeiling(const std::string &res, CPU *c, Tick prio);
+        Tick getCeiling(const std::string &res, CPU *c);
+
+        /// Number of migrations of t for helping
+        unsigned long getMigrationCount(AbsRTTask *t) const;
+
+        virtual void onContextSwitch(CPU *c, AbsRTTask *prev, AbsRTTask *next);
+
+        void newRun();
+        void endRun();
+
+    protected:
+        virtual void onRequest(AbsRTTask *t, Resource *r);
+        virtual void onBlock(AbsRTTask *t, Resource *r);
+        virtual void onWakeUp(AbsRTTask *t, Resource *r);
+        virtual void onRelease(AbsRTTask *t, Resource *r);
+
+    private:
+        std::map<Resource *, std::map<CPU *, Tick> > _ceilings;
+
+        /// the processor of every task that migrated
+        std::map<AbsRTTask *, CPU *> _home;
+        std::map<AbsRTTask *, unsigned long> _migrations;
+
+        /// the owners that released their resource away from home
+        std::vector<AbsRTTask *> _returning;
+        GEvent<MrsPResManager> _returnEvt;
+
+        PartionedMRTKernel *partKernel();
+
+        bool isRunning(AbsRTTask *t);
+
+        /// The owner of r migrates to a running spinner, if needed
+        void help(Resource *r);
+
+        /// Moves the owner t to the processor of the spinner s
+        void moveTo(AbsRTTask *t, AbsRTTask *s);
+
+        void goHome(AbsRTTask *t);
+
+        void onReturn(Event *e);
+    };
+
+    /**
+       \ingroup resman
+
+       FIFO Multiprocessor Locking Protocol (Block et al., 2007, in
+       the FMLP+ variant of Brandenburg, 2014) for long critical
+       sections: a task waiting for a resource suspends, in FIFO
+       order, and the owner is priority boosted: it has a priority
+       higher than any non boosted task, and the boosted tasks are
+       ordered by the time of their request. The boosted priorities
+       are 64 bit, so they do not wrap around for request times up
+       to about 4.6e18 ticks.
+    */
+    class FMLPPlusResManager : public MPResManager {
+    public:
+        FMLPPlusResManager(const std::string &n = "");
+
+    protected:
+        virtual void onGrant(AbsRTTask *t, Resource *r);
+        virtual void onBlock(AbsRTTask *t, Resource *r);
+        virtual void onWakeUp(AbsRTTask *t, Resource *r);
+        virtual void onRelease(AbsRTTask *t, Resource *r);
+    };
+}
+
+#endif
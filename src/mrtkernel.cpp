@@ -16,7 +16,10 @@
 #include <simul.hpp>
 
 #include <cpu.hpp>
+#include <flightrec.hpp>
+#include <governor.hpp>
 #include <mrtkernel.hpp>
+#include <profiler.hpp>
 #include <resmanager.hpp>
 #include <scheduler.hpp>
 #include <task.hpp>
@@ -44,30 +47,34 @@ namespace RTSim {
         : Event(Event::_DEFAULT_PRIORITY + 10), 
           _kernel(k),
           _cpu(c),
-          _task(0)
+          _task(0),
+          _prev(0)
     {
     }
 
     void BeginDispatchMultiEvt::doit()
     {
+        PROFILE_SCOPE("BeginDispatchMultiEvt");
+        FLIGHTREC(FR_BEGIN_DISPATCH, &_kernel, _cpu.getIndex(), 0);
         _kernel.onBeginDispatchMulti(this);
     }
 
     void EndDispatchMultiEvt::doit()
     {
+        PROFILE_SCOPE("EndDispatchMultiEvt");
+        FLIGHTREC(FR_END_DISPATCH, &_kernel, _cpu.getIndex(), 0);
         _kernel.onEndDispatchMulti(this);
     }
 
 
     vector<CPU*> MRTKernel::getProcessors() const
     {
-        vector<CPU*> s;// = new vector<const CPU*>;
+        vector<CPU*> s;
 
         typedef map<CPU *, AbsRTTask *>::const_iterator IT;
-        int j = 0;
 
-        for(IT i = _m_currExe.begin(); i != _m_currExe.end(); i++, j++)
-            s[j] = i->first;
+        for(IT i = _m_currExe.begin(); i != _m_currExe.end(); i++)
+            s.push_back(i->first);
         return s;
     }
 
@@ -112,13 +119,13 @@ namespace RTSim {
 
     MRTKernel::MRTKernel(Scheduler *s, absCPUFactory *fact, int n, 
                          const string& name) 
-        : RTKernel(s,name) , _CPUFactory(fact), _migrationDelay(0)
+        : RTKernel(s,name) , _CPUFactory(fact), _migrationDelay(0), _topology(0)
     { 
         internalConstructor(n);
     }
 
     MRTKernel::MRTKernel(Scheduler *s, int n, const string&name) 
-        : RTKernel(s, name), _migrationDelay(0)
+        : RTKernel(s, name), _migrationDelay(0), _topology(0)
     { 
         _CPUFactory = new uniformCPUFactory();
 
@@ -126,7 +133,7 @@ namespace RTSim {
     }
 
     MRTKernel::MRTKernel(Scheduler *s, const string& name) 
-        : RTKernel(s, name), _migrationDelay(0)
+        : RTKernel(s, name), _migrationDelay(0), _topology(0)
     {
         _CPUFactory = new uniformCPUFactory();
 
@@ -134,7 +141,7 @@ namespace RTSim {
     }
 
 	MRTKernel::MRTKernel(const string& name) 
-        : RTKernel(NULL, name), _migrationDelay(0)
+        : RTKernel(NULL, name), _migrationDelay(0), _topology(0)
     {
         _CPUFactory = new uniformCPUFactory();
 
@@ -143,7 +150,7 @@ namespace RTSim {
 
 
 	MRTKernel::MRTKernel(const string& name, absCPUFactory *cpuFactory) 
-        : RTKernel(NULL, name), _migrationDelay(0), _CPUFactory(cpuFactory)
+        : RTKernel(NULL, name), _CPUFactory(cpuFactory), _migrationDelay(0), _topology(0)
     {
 
         internalConstructor(0);
@@ -163,6 +170,7 @@ namespace RTSim {
         _isContextSwitching[c] = false;
         _beginEvt[c] = new BeginDispatchMultiEvt(*this, *c);
         _endEvt[c] = new EndDispatchMultiEvt(*this, *c);
+        c->addObserver(this);
 
         _sched->addCPU(c);
     }
@@ -197,6 +205,13 @@ namespace RTSim {
         return ret;
     }
 
+    void MRTKernel::onSpeedChange(CPU *c, double oldSpeed, double newSpeed)
+    {
+        map<CPU *, AbsRTTask *>::iterator i = _m_currExe.find(c);
+        if (i != _m_currExe.end() && i->second != NULL)
+            i->second->refreshExec(oldSpeed, newSpeed);
+    }
+
     void MRTKernel::suspend(AbsRTTask *task)
     {
         DBGENTER(_MRTKERNEL_DBG_LEV);
@@ -217,6 +232,7 @@ namespace RTSim {
         DBGENTER(_KERNEL_DBG_LEV);
 
         _sched->insert(t);
+        if (_governor) _governor->onArrival(t);
         
         dispatch();
     }
@@ -230,6 +246,7 @@ namespace RTSim {
         if (p == NULL) 
             throw RTKernelExc("Received a onEnd of a non executing task"); 
 
+        if (_governor) _governor->onEnd(task);
         _sched->extract(task);
         _m_oldExe[task] = p;
         _m_currExe[p] = NULL;
@@ -240,6 +257,7 @@ namespace RTSim {
 
     void MRTKernel::dispatch()
     {
+        PROFILE_SCOPE("MRTKernel::dispatch");
         DBGENTER(_KERNEL_DBG_LEV);
         
         int ncpu = _m_currExe.size();
@@ -312,6 +330,68 @@ namespace RTSim {
             _beginEvt[p]->post(SIMUL.getTime());
     }
 
+    Tick MRTKernel::migrationCost(const AbsRTTask *t, CPU *p)
+    {
+        CPU *old = _m_oldExe[t];
+        if (old == p || old == NULL) return 0;
+
+        Tick c = _topology ? _topology->getMigrationCost(old, p) 
+            : _migrationDelay;
+        _migrationOverhead[t] += c;
+        return c;
+    }
+
+    Tick MRTKernel::getMigrationOverhead(const AbsRTTask *t) const
+    {
+        map<const AbsRTTask *, Tick>::const_iterator i = 
+            _migrationOverhead.find(t);
+        return i != _migrationOverhead.end() ? i->second : Tick(0);
+    }
+
+    void MRTKernel::startSpin(AbsRTTask *t)
+    {
+        DBGENTER(_KERNEL_DBG_LEV);
+
+        if (isSpinning(t)) return;
+        _spinning[t] = true;
+        Task *tt = dynamic_cast<Task *>(t);
+        if (tt) tt->stall();
+    }
+
+    void MRTKernel::endSpin(AbsRTTask *t)
+    {
+        DBGENTER(_KERNEL_DBG_LEV);
+
+        if (!isSpinning(t)) return;
+        _spinning.erase(t);
+        Task *tt = dynamic_cast<Task *>(t);
+        if (tt) tt->resume();
+    }
+
+    bool MRTKernel::isSpinning(const AbsRTTask *t) const
+    {
+        return _spinning.find(t) != _spinning.end();
+    }
+
+    void MRTKernel::scheduleTask(AbsRTTask *t)
+    {
+        t->schedule();
+        if (!isSpinning(t)) return;
+        Task *tt = dynamic_cast<Task *>(t);
+        if (tt) tt->stall();
+    }
+
+    AbsRTTask *MRTKernel::selectTask(CPU *p)
+    {
+        // select the first non dispatched task in the queue
+        AbsRTTask *st = NULL;
+        int i = 0;
+        while ((st = _sched->getTaskN(i)) != NULL) 
+            if (_m_dispatched[st] == NULL) break;
+            else i++;
+        return st;
+    }
+
     void MRTKernel::onBeginDispatchMulti(BeginDispatchMultiEvt* e)
     {
         DBGENTER(_KERNEL_DBG_LEV);
@@ -326,13 +406,10 @@ namespace RTSim {
             _m_currExe[p] = NULL;
             _m_dispatched[dt] = NULL;
             dt->deschedule();
+            _endEvt[p]->setPrevious(dt);
         }
 
-        // select the first non dispatched task in the queue
-        int i = 0;
-        while ((st = _sched->getTaskN(i)) != NULL) 
-            if (_m_dispatched[st] == NULL) break;
-            else i++;
+        st = selectTask(p);
 
         if (st == NULL) {
             DBGPRINT("Nothing to schedule, finishing");
@@ -344,8 +421,7 @@ namespace RTSim {
         _endEvt[p]->setTask(st);
         _isContextSwitching[p] = true;
         Tick overhead (_contextSwitchDelay);
-        if (st != NULL && _m_oldExe[st] != p && _m_oldExe[st] != NULL) 
-            overhead += _migrationDelay;
+        if (st != NULL) overhead += migrationCost(st, p);
         _endEvt[p]->post(SIMUL.getTime() + overhead);        
     }
 
@@ -363,10 +439,13 @@ namespace RTSim {
         DBGPRINT_2("Task: ", taskname(st));
         
         // st could be null (because of an idling processor)
-        if (st) st->schedule();
+        if (st) scheduleTask(st);
 
 	_isContextSwitching[p] = false;
         _sched->notify(st);
+
+        if (_resMng) _resMng->onContextSwitch(p, e->getPrevious(), st);
+        e->setPrevious(NULL);
     }
 
     void MRTKernel::printState()
@@ -396,6 +475,10 @@ namespace RTSim {
         j = _m_oldExe.begin();
         for ( ; j != _m_oldExe.end(); ++j )
             j->second = NULL;
+
+        _migrationOverhead.clear();
+        _spinning.clear();
+        if (_governor) _governor->newRun();
     }
 
     void MRTKernel::endRun()
@@ -18,6 +18,7 @@
 
 #include <kernel.hpp>
 #include <kernevt.hpp>
+#include <topology.hpp>
 
 #define _MRTKERNEL_DBG_LEV "MRTKernel"
 
@@ -59,11 +60,15 @@ namespace RTSim {
         MRTKernel &_kernel;
         CPU &_cpu;
         AbsRTTask *_task;
+        AbsRTTask *_prev;
     public:
         EndDispatchMultiEvt(MRTKernel &k, CPU &c);
         CPU * getCPU() { return &_cpu; }
         void setTask(AbsRTTask *t) {_task = t; }
         AbsRTTask *getTask() { return _task; }
+        /// The task descheduled by the context switch
+        void setPrevious(AbsRTTask *t) {_prev = t; }
+        AbsRTTask *getPrevious() { return _prev; }
         virtual void doit();
     };
 
@@ -104,6 +109,7 @@ namespace RTSim {
     */
     class MRTKernel : public RTKernel {
     protected:
+        friend class EnergyMeter;
 
         /// CPU Factory. Used in one of the constructors.
         absCPUFactory *_CPUFactory;
@@ -134,6 +140,25 @@ namespace RTSim {
         /// RandomVar eventually).
 	Tick  _migrationDelay;
 
+        /// If not NULL, it gives the migration delays
+        Topology *_topology;
+
+        /// Total migration delay of every task
+        std::map<const AbsRTTask *, Tick> _migrationOverhead;
+
+        /// Tasks busy waiting: they keep their processor, but do
+        /// not progress (see startSpin())
+        std::map<const AbsRTTask *, bool> _spinning;
+
+        /// Schedules t, stalled if it is spinning
+        void scheduleTask(AbsRTTask *t);
+
+        /**
+           Returns the migration delay of t if it is dispatched on p,
+           and accounts it.
+         */
+        Tick migrationCost(const AbsRTTask *t, CPU *p);
+
         void internalConstructor(int n);
 
         /**
@@ -146,6 +171,13 @@ namespace RTSim {
         typedef map<CPU *, AbsRTTask *>::iterator ITCPU;
         ITCPU getNextFreeProc(ITCPU s, ITCPU e);
 
+        /**
+           Selects the task to dispatch on p, in the
+           onBeginDispatchMulti(): the first task in the ready queue
+           that is not dispatched yet.
+         */
+        virtual AbsRTTask *selectTask(CPU *p);
+
 		/**
            Needs to know only the name 
          */
@@ -237,10 +269,10 @@ namespace RTSim {
 
         /**
            Returns a vector containing the pointers to the processors.
-           
-           Deprecated, will be removed soon
          */
         std::vector<CPU*> getProcessors() const;
+
+        virtual void onSpeedChange(CPU *c, double oldSpeed, double newSpeed);
         
         /**
            Set the migration delay. This is the overhead to be added
@@ -251,6 +283,36 @@ namespace RTSim {
             _migrationDelay = t;
         }
 
+        /**
+           Sets the topology of the platform: the migration delay
+           depends on the level of the memory hierarchy shared by the
+           previous and the next processor (see
+           Topology::getMigrationCost()), instead of being
+           setMigrationDelay().
+         */
+        void setTopology(Topology *t) { _topology = t; }
+
+        /// Total migration delay of t in this run
+        Tick getMigrationOverhead(const AbsRTTask *t) const;
+
+        /**
+           The task stops progressing, but keeps executing (a busy
+           wait on a lock, so the processor is busy): used by the
+           spin-based resource managers. A spinning task is scheduled
+           and descheduled as usual, so the spin time is busy time
+           for the traces and the energy meters, but it is stalled
+           (see Task::stall()) whenever it gets a processor.
+         */
+        void startSpin(AbsRTTask *t);
+
+        /// The task progresses again, if it holds a processor
+        void endSpin(AbsRTTask *t);
+
+        bool isSpinning(const AbsRTTask *t) const;
+
+        /// The scheduler that holds the task
+        virtual Scheduler *getTaskScheduler(const AbsRTTask *t) { return _sched; }
+
         virtual void newRun();
         virtual void endRun();
         virtual void print();
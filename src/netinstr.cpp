@@ -0,0 +1,117 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <simul.hpp>
+#include <strtoken.hpp>
+
+#include <netinstr.hpp>
+#include <network.hpp>
+#include <task.hpp>
+
+namespace RTSim {
+
+    static Channel *findChannel(const string &name)
+    {
+        Channel *c = dynamic_cast<Channel *>(Entity::_find(name));
+        if (c == NULL)
+            throw parse_util::ParseExc("NetInstr::createInstance",
+                                       "Unknown channel " + name);
+        return c;
+    }
+
+    SendInstr::SendInstr(Task *f, Channel *c, char *n) :
+        Instr(f, n), _ch(c), _endEvt(this)
+    {
+    }
+
+    Instr *SendInstr::createInstance(vector<string> &par)
+    {
+        if (par.size() != 2)
+            throw parse_util::ParseExc("SendInstr::createInstance",
+                                       "Wrong number of arguments");
+        return new SendInstr(dynamic_cast<Task *>(Entity::_find(par[1])),
+                             findChannel(par[0]));
+    }
+
+    void SendInstr::schedule()
+    {
+        _endEvt.post(SIMUL.getTime());
+    }
+
+    void SendInstr::deschedule()
+    {
+        _endEvt.drop();
+    }
+
+    void SendInstr::setTrace(Trace *t)
+    {
+        _endEvt.addTrace(t);
+    }
+
+    void SendInstr::onEnd()
+    {
+        _ch->send(_father);
+        _father->onInstrEnd();
+    }
+
+    void SendInstr::endRun()
+    {
+        _endEvt.drop();
+    }
+
+    ReceiveInstr::ReceiveInstr(Task *f, Channel *c, char *n) :
+        Instr(f, n), _ch(c), _endEvt(this)
+    {
+    }
+
+    Instr *ReceiveInstr::createInstance(vector<string> &par)
+    {
+        if (par.size() != 2)
+            throw parse_util::ParseExc("ReceiveInstr::createInstance",
+                                       "Wrong number of arguments");
+        return new ReceiveInstr(dynamic_cast<Task *>(Entity::_find(par[1])),
+                                findChannel(par[0]));
+    }
+
+    void ReceiveInstr::schedule()
+    {
+        _endEvt.post(SIMUL.getTime());
+    }
+
+    void ReceiveInstr::deschedule()
+    {
+        _endEvt.drop();
+    }
+
+    void ReceiveInstr::setTrace(Trace *t)
+    {
+        _endEvt.addTrace(t);
+    }
+
+    void ReceiveInstr::onEnd()
+    {
+        if (_ch->receive(_father)) {
+            _father->onInstrEnd();
+            return;
+        }
+        // scheduled again at the delivery, it takes the message then
+        _ch->wait(_father);
+        _father->block();
+    }
+
+    void ReceiveInstr::endRun()
+    {
+        _endEvt.drop();
+    }
+
+} // namespace RTSim
@@ -0,0 +1,98 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __NETINSTR_HPP__
+#define __NETINSTR_HPP__
+
+#include <string>
+#include <vector>
+
+#include <event.hpp>
+#include <factory.hpp>
+
+#include <instr.hpp>
+
+namespace RTSim {
+
+    using namespace std;
+    using namespace MetaSim;
+
+    class Channel;
+
+    /**
+       \ingroup instr
+
+       Sends a message on a Channel, in no time; the task goes on
+       executing while the message is transmitted. In the code of a
+       task: send(channel).
+    */
+    class SendInstr : public Instr {
+        Channel *_ch;
+    public:
+        EndInstrEvt _endEvt;
+
+        SendInstr(Task *f, Channel *c, char *n = "");
+
+        static Instr *createInstance(vector<string> &par);
+
+        virtual void schedule();
+        virtual void deschedule();
+        virtual Tick getExecTime() const { return 0; }
+        virtual Tick getDuration() const { return 0; }
+        virtual Tick getWCET() const throw(RandomVar::MaxException)
+        { return 0; }
+        virtual void reset() {}
+        virtual void setTrace(Trace *);
+
+        virtual void onEnd();
+        virtual void newRun() {}
+        virtual void endRun();
+
+        virtual void refreshExec(double, double) {}
+    };
+
+    /**
+       \ingroup instr
+
+       Receives a message from a Channel: if none is there, the task
+       blocks until the next one is delivered. In the code of a task:
+       receive(channel).
+    */
+    class ReceiveInstr : public Instr {
+        Channel *_ch;
+    public:
+        EndInstrEvt _endEvt;
+
+        ReceiveInstr(Task *f, Channel *c, char *n = "");
+
+        static Instr *createInstance(vector<string> &par);
+
+        virtual void schedule();
+        virtual void deschedule();
+        virtual Tick getExecTime() const { return 0; }
+        virtual Tick getDuration() const { return 0; }
+        virtual Tick getWCET() const throw(RandomVar::MaxException)
+        { return 0; }
+        virtual void reset() {}
+        virtual void setTrace(Trace *);
+
+        virtual void onEnd();
+        virtual void newRun() {}
+        virtual void endRun();
+
+        virtual void refreshExec(double, double) {}
+    };
+
+} // namespace RTSim
+
+#endif
@@ -0,0 +1,444 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include <particle.hpp>
+#include <simul.hpp>
+
+#include <network.hpp>
+
+namespace RTSim {
+
+    using namespace std;
+    using namespace MetaSim;
+
+    static string linkName(const string &net, const string &kind, int n)
+    {
+        ostringstream os;
+        os << net << "_" << kind << n;
+        return os.str();
+    }
+
+    //  LINK  **************************************************
+    Link::Link(Network *n, int node, bool fifo, const string &name) :
+        Entity(name), _net(n), _node(node), _fifo(fifo), _queue(), _tx(),
+        _busy(false), _busyTime(0),
+        _startEvt(this, &Link::onStart, Event::_DEFAULT_PRIORITY + 5),
+        _endEvt(this, &Link::onEnd)
+    {
+    }
+
+    void Link::enqueue(const Message &m)
+    {
+        _queue.push_back(m);
+        // the arbitration comes after all the sends of this instant
+        if (!_busy && !_startEvt.isInQueue())
+            _startEvt.post(SIMUL.getTime());
+    }
+
+    void Link::onStart(Event *e)
+    {
+        if (_busy || _queue.empty()) return;
+
+        deque<Message>::iterator best = _queue.begin();
+        if (!_fifo)
+            for (deque<Message>::iterator i = _queue.begin();
+                 i != _queue.end(); ++i)
+                if (i->channel->getPriority() <
+                    best->channel->getPriority()) best = i;
+
+        Tick now = SIMUL.getTime();
+        Tick t = _net->nextStart(this, *best, now);
+        if (t > now) {
+            _startEvt.post(t);
+            return;
+        }
+
+        _tx = *best;
+        _queue.erase(best);
+        _busy = true;
+        Tick d = _net->getFrameTime(_tx);
+        _busyTime += d;
+        _endEvt.post(now + d);
+    }
+
+    void Link::onEnd(Event *e)
+    {
+        _busy = false;
+        if (!_queue.empty()) _startEvt.post(SIMUL.getTime());
+        _net->onTransmitted(this, _tx);
+    }
+
+    void Link::newRun()
+    {
+        _queue.clear();
+        _busy = false;
+        _busyTime = 0;
+    }
+
+    void Link::endRun()
+    {
+        _startEvt.drop();
+        _endEvt.drop();
+    }
+
+    //  NETWORK  ***********************************************
+    Network::Network(double bitTime, const string &name) :
+        Entity(name), _bitTime(bitTime), _nodes(), _links()
+    {
+        if (bitTime <= 0) throw NetworkExc("Bit time must be positive");
+    }
+
+    Network::~Network()
+    {
+        for (unsigned i = 0; i < _links.size(); ++i)
+            delete _links[i];
+    }
+
+    int Network::addNode(AbsKernel *k)
+    {
+        map<AbsKernel *, int>::iterator i = _nodes.find(k);
+        if (i != _nodes.end()) return i->second;
+
+        int n = _nodes.size();
+        _nodes[k] = n;
+        onAddNode(n);
+        return n;
+    }
+
+    int Network::getNode(AbsKernel *k) const
+    {
+        map<AbsKernel *, int>::const_iterator i = _nodes.find(k);
+        if (i == _nodes.end())
+            throw NetworkExc("Kernel is not a node of " + getName());
+        return i->second;
+    }
+
+    int Network::srcNode(const Message &m) const
+    {
+        return getNode(m.channel->getSource());
+    }
+
+    int Network::dstNode(const Message &m) const
+    {
+        return getNode(m.channel->getDestination());
+    }
+
+    Tick Network::bits(double n) const
+    {
+        long long d = (long long)ceil(n * _bitTime);
+        return d > 0 ? d : 1;
+    }
+
+    void Network::send(const Message &m)
+    {
+        post(m);
+    }
+
+    void Network::deliver(const Message &m)
+    {
+        m.channel->deliver(m);
+    }
+
+    //  CAN  ***************************************************
+    CANBus::CANBus(double bitTime, const string &name) :
+        Network(bitTime, name)
+    {
+        _links.push_back(new Link(this, -1, false, name + "_bus"));
+    }
+
+    void CANBus::post(const Message &m)
+    {
+        _links[0]->enqueue(m);
+    }
+
+    Tick CANBus::getFrameTime(const Message &m) const
+    {
+        int s = m.channel->getSize();
+        return bits(8 * s + 47 + (34 + 8 * s - 1) / 4);
+    }
+
+    void CANBus::onTransmitted(Link *l, const Message &m)
+    {
+        deliver(m);
+    }
+
+    //  TDMA  **************************************************
+    TDMABus::TDMABus(double bitTime, const string &name) :
+        Network(bitTime, name), _slots(), _cycle(0)
+    {
+    }
+
+    void TDMABus::onAddNode(int n)
+    {
+        _links.push_back(new Link(this, n, false,
+                                  linkName(getName(), "node", n)));
+    }
+
+    void TDMABus::addSlot(AbsKernel *k, Tick length)
+    {
+        if (length <= 0) throw NetworkExc("Empty slot in " + getName());
+
+        Slot s;
+        s.node = addNode(k);
+        s.start = _cycle;
+        s.length = length;
+        _slots.push_back(s);
+        _cycle += length;
+    }
+
+    void TDMABus::post(const Message &m)
+    {
+        int n = srcNode(m);
+        Tick d = getFrameTime(m);
+        bool fits = false;
+        for (unsigned i = 0; i < _slots.size() && !fits; ++i)
+            fits = _slots[i].node == n && _slots[i].length >= d;
+        if (!fits)
+            throw NetworkExc("No slot of " + getName() + " fits the "
+                             "messages of " + m.channel->getName());
+        _links[n]->enqueue(m);
+    }
+
+    Tick TDMABus::getFrameTime(const Message &m) const
+    {
+        return bits(8 * (m.channel->getSize() + 8));
+    }
+
+    Tick TDMABus::nextStart(const Link *l, const Message &m, Tick now)
+    {
+        long long d = (long long)getFrameTime(m);
+        long long t = (long long)now;
+        long long c = (long long)_cycle;
+        long long base = t - t % c;
+
+        // a slot that fits the frame is within the next two cycles
+        for (long long k = 0; k < 2; ++k)
+            for (unsigned i = 0; i < _slots.size(); ++i) {
+                if (_slots[i].node != l->getNode()) continue;
+                long long s = base + k * c + (long long)_slots[i].start;
+                long long e = s + (long long)_slots[i].length;
+                s = max(s, t);
+                if (e - s >= d) return s;
+            }
+        throw NetworkExc("No slot of " + getName() + " fits the frame");
+    }
+
+    void TDMABus::onTransmitted(Link *l, const Message &m)
+    {
+        deliver(m);
+    }
+
+    //  ETHERNET  **********************************************
+    EthernetSwitch::EthernetSwitch(double bitTime, Tick latency, bool fifo,
+                                   const string &name) :
+        Network(bitTime, name), _latency(latency), _fifo(fifo),
+        _up(), _down(), _fabric(),
+        _fabricEvt(this, &EthernetSwitch::onFabric)
+    {
+    }
+
+    void EthernetSwitch::onAddNode(int n)
+    {
+        _up.push_back(new Link(this, n, _fifo, linkName(getName(), "up", n)));
+        _down.push_back(new Link(this, n, _fifo,
+                                 linkName(getName(), "down", n)));
+        _links.push_back(_up.back());
+        _links.push_back(_down.back());
+    }
+
+    void EthernetSwitch::post(const Message &m)
+    {
+        _up[srcNode(m)]->enqueue(m);
+    }
+
+    Tick EthernetSwitch::getFrameTime(const Message &m) const
+    {
+        return bits(8 * (max(m.channel->getSize(), 46) + 38));
+    }
+
+    void EthernetSwitch::onTransmitted(Link *l, const Message &m)
+    {
+        if (l != _up[l->getNode()]) {
+            deliver(m);
+            return;
+        }
+        // the latency is constant, so the fabric is a FIFO
+        Tick t = SIMUL.getTime() + _latency;
+        _fabric.push_back(make_pair(t, m));
+        if (_fabric.size() == 1) _fabricEvt.post(t);
+    }
+
+    void EthernetSwitch::onFabric(Event *e)
+    {
+        Message m = _fabric.front().second;
+        _fabric.pop_front();
+        if (!_fabric.empty()) _fabricEvt.post(_fabric.front().first);
+        _down[dstNode(m)]->enqueue(m);
+    }
+
+    void EthernetSwitch::newRun()
+    {
+        _fabric.clear();
+    }
+
+    void EthernetSwitch::endRun()
+    {
+        _fabricEvt.drop();
+    }
+
+    //  CHANNEL  ***********************************************
+    map<const Task *, Channel::Origin> Channel::_origins;
+
+    Channel::Channel(const string &name, Network *net, AbsKernel *src,
+                     AbsKernel *dst, int size, int priority) :
+        Entity(name), _net(net), _src(src), _dst(dst), _size(size),
+        _priority(priority), _inbox(), _waiting(), _local(), _sent(0),
+        _delivered(0), _maxLatency(0), _sumLatency(0), _stats(),
+        _localEvt(this, &Channel::onLocal)
+    {
+        if (net == NULL) throw NetworkExc("Channel " + name + " has no network");
+        net->addNode(src);
+        net->addNode(dst);
+    }
+
+    void Channel::send(Task *t)
+    {
+        Message m;
+        m.channel = this;
+        m.sent = SIMUL.getTime();
+        m.origin = getOrigin(t, t->getArrival());
+        _sent++;
+        if (_src != _dst) {
+            _net->send(m);
+            return;
+        }
+        // delivered by an event, not from inside the send instruction
+        _local.push_back(m);
+        if (!_localEvt.isInQueue()) _localEvt.post(SIMUL.getTime());
+    }
+
+    bool Channel::receive(Task *t)
+    {
+        if (_inbox.empty()) return false;
+
+        Message m = _inbox.front();
+        _inbox.pop_front();
+
+        map<const Task *, Origin>::iterator i = _origins.find(t);
+        if (i == _origins.end() || i->second.arrival != t->getArrival()) {
+            Origin o;
+            o.arrival = t->getArrival();
+            o.origin = m.origin;
+            _origins[t] = o;
+        }
+        else if (m.origin < i->second.origin) i->second.origin = m.origin;
+        return true;
+    }
+
+    void Channel::wait(Task *t)
+    {
+        _waiting.push_back(t);
+    }
+
+    void Channel::deliver(const Message &m)
+    {
+        Tick l = SIMUL.getTime() - m.sent;
+        _delivered++;
+        if (l > _maxLatency) _maxLatency = l;
+        _sumLatency += double(l);
+        for (unsigned i = 0; i < _stats.size(); ++i)
+            _stats[i]->record(double(l));
+
+        _inbox.push_back(m);
+        if (!_waiting.empty()) {
+            // the receive instruction takes the message when the
+            // task is scheduled again
+            Task *t = _waiting.front();
+            _waiting.pop_front();
+            t->unblock();
+        }
+    }
+
+    void Channel::onLocal(Event *e)
+    {
+        while (!_local.empty()) {
+            Message m = _local.front();
+            _local.pop_front();
+            deliver(m);
+        }
+    }
+
+    double Channel::getMeanLatency() const
+    {
+        return _delivered ? _sumLatency / _delivered : 0;
+    }
+
+    Tick Channel::getOrigin(const Task *t, Tick arrival)
+    {
+        map<const Task *, Origin>::const_iterator i = _origins.find(t);
+        if (i != _origins.end() && i->second.arrival == arrival)
+            return i->second.origin;
+        return arrival;
+    }
+
+    void Channel::newRun()
+    {
+        _inbox.clear();
+        _waiting.clear();
+        _local.clear();
+        _sent = _delivered = 0;
+        _maxLatency = 0;
+        _sumLatency = 0;
+        _origins.clear();
+    }
+
+    void Channel::endRun()
+    {
+        _localEvt.drop();
+    }
+
+    //  END TO END  ********************************************
+    EndToEndDelay::EndToEndDelay(Task *last, const string &name) :
+        Entity(name), _last(last), _count(0), _max(0), _sum(0), _stats()
+    {
+        new Particle<EndEvt, EndToEndDelay>(&last->endEvt, this);
+    }
+
+    double EndToEndDelay::getMean() const
+    {
+        return _count ? _sum / _count : 0;
+    }
+
+    void EndToEndDelay::probe(EndEvt &e)
+    {
+        Task *t = e.getTask();
+        Tick r = SIMUL.getTime() - Channel::getOrigin(t, t->getLastArrival());
+        _count++;
+        if (r > _max) _max = r;
+        _sum += double(r);
+        for (unsigned i = 0; i < _stats.size(); ++i)
+            _stats[i]->record(double(r));
+    }
+
+    void EndToEndDelay::newRun()
+    {
+        _count = 0;
+        _max = 0;
+        _sum = 0;
+    }
+
+} // namespace RTSim
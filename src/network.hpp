@@ -0,0 +1,405 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __NETWORK_HPP__
+#define __NETWORK_HPP__
+
+#include <deque>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <baseexc.hpp>
+#include <basestat.hpp>
+#include <entity.hpp>
+#include <gevent.hpp>
+
+#include <kernel.hpp>
+#include <task.hpp>
+#include <taskevt.hpp>
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    class Channel;
+    class Network;
+
+    class NetworkExc : public BaseExc {
+    public:
+        NetworkExc(const std::string &msg) :
+            BaseExc(msg, "Network", "network.cpp") {}
+    };
+
+    /// A message in transit on a Channel
+    struct Message {
+        Channel *channel;
+        /// Time of the send
+        Tick sent;
+        /// Release of the first job of the distributed transaction
+        Tick origin;
+    };
+
+    /**
+       \ingroup net
+
+       A half-duplex transmission medium of a Network: the messages
+       waiting for it are queued and transmitted one at a time,
+       without preemption. When the link becomes free, the queued
+       message with the highest priority (the lowest value, as the
+       CAN identifiers) is chosen, or the oldest one for FIFO links;
+       the messages sent at the same instant take part in the same
+       arbitration.
+    */
+    class Link : public Entity {
+        Network *_net;
+        int _node;
+        bool _fifo;
+
+        std::deque<Message> _queue;
+        Message _tx;
+        bool _busy;
+        Tick _busyTime;
+
+    public:
+        GEvent<Link> _startEvt;
+        GEvent<Link> _endEvt;
+
+        /// @param node the node that owns the link, or -1
+        Link(Network *n, int node, bool fifo,
+             const std::string &name = "");
+
+        int getNode() const { return _node; }
+
+        void enqueue(const Message &m);
+
+        /// Messages waiting or in transmission
+        unsigned getQueued() const { return _queue.size() + _busy; }
+
+        /// Total time spent transmitting
+        Tick getBusyTime() const { return _busyTime; }
+
+        void onStart(Event *e);
+        void onEnd(Event *e);
+
+        void newRun();
+        void endRun();
+    };
+
+    /**
+       \ingroup net
+
+       Interconnect among the nodes of a distributed system. A node is
+       a kernel (of any kind): the tasks of the system are allocated
+       to kernels as usual, all in the same simulation, and exchange
+       messages on Channels with the send and receive instructions
+       (see SendInstr and ReceiveInstr).
+
+       The derived classes model the medium: how the messages are
+       queued on Links, how long a frame takes and when it can be
+       transmitted. The times are in ticks; the speed of the network
+       is given as the duration of one bit.
+    */
+    class Network : public Entity {
+    protected:
+        double _bitTime;
+        std::map<AbsKernel *, int> _nodes;
+        std::vector<Link *> _links;
+
+        /// Creates the links of a new node
+        virtual void onAddNode(int n) {}
+
+        /// Queues m on the right link
+        virtual void post(const Message &m) = 0;
+
+        /// Time to transmit n bits
+        Tick bits(double n) const;
+
+        /// Passes m to its channel
+        void deliver(const Message &m);
+
+        int srcNode(const Message &m) const;
+        int dstNode(const Message &m) const;
+
+    public:
+        /// @param bitTime duration of one bit, in ticks
+        Network(double bitTime, const std::string &name = "");
+        ~Network();
+
+        /// Adds k as a node (if not already there); returns its index
+        int addNode(AbsKernel *k);
+
+        /// Index of node k; throws a NetworkExc if it is not a node
+        int getNode(AbsKernel *k) const;
+
+        int getNumNodes() const { return _nodes.size(); }
+
+        /// Sends m over the network
+        void send(const Message &m);
+
+        /// Transmission time of the frame of m
+        virtual Tick getFrameTime(const Message &m) const = 0;
+
+        /**
+           Earliest time, not before now, at which the frame of m can
+           start on l; the transmission is then re-arbitrated at that
+           time. By default, now.
+        */
+        virtual Tick nextStart(const Link *l, const Message &m, Tick now)
+        { return now; }
+
+        /// Called by l at the end of the transmission of m
+        virtual void onTransmitted(Link *l, const Message &m) = 0;
+
+        const std::vector<Link *> &getLinks() const { return _links; }
+
+        void newRun() {}
+        void endRun() {}
+    };
+
+    /**
+       \ingroup net
+
+       CAN bus: a single link with priority arbitration on the
+       identifiers (the priority of the channels) and non-preemptive
+       frames. The frame of a message of s bytes (standard format,
+       worst-case bit stuffing) is 8s + 47 + floor((34 + 8s - 1) / 4)
+       bits long.
+    */
+    class CANBus : public Network {
+    protected:
+        void post(const Message &m);
+
+    public:
+        CANBus(double bitTime, const std::string &name = "");
+
+        Tick getFrameTime(const Message &m) const;
+        void onTransmitted(Link *l, const Message &m);
+    };
+
+    /**
+       \ingroup net
+
+       Time-triggered bus (TDMA, e.g. the static segment of FlexRay):
+       a cycle of slots, each one owned by a node; a node transmits
+       its messages only within its slots, as long as the whole frame
+       fits in what remains of the slot. Each node queues its messages
+       by priority. A frame of s bytes is 8 (s + 8) bits long
+       (header and trailer of FlexRay).
+
+       \code
+       TDMABus bus(0.1, "flexray");
+       bus.addSlot(&node1, 50);
+       bus.addSlot(&node2, 50);
+       \endcode
+    */
+    class TDMABus : public Network {
+        struct Slot {
+            int node;
+            Tick start;
+            Tick length;
+        };
+        std::vector<Slot> _slots;
+        Tick _cycle;
+
+    protected:
+        void onAddNode(int n);
+        void post(const Message &m);
+
+    public:
+        TDMABus(double bitTime, const std::string &name = "");
+
+        /// Appends to the cycle a slot of node k
+        void addSlot(AbsKernel *k, Tick length);
+
+        Tick getCycle() const { return _cycle; }
+
+        Tick getFrameTime(const Message &m) const;
+        Tick nextStart(const Link *l, const Message &m, Tick now);
+        void onTransmitted(Link *l, const Message &m);
+    };
+
+    /**
+       \ingroup net
+
+       Switched Ethernet: every node has a full-duplex link to a
+       store-and-forward switch. A message is transmitted on the
+       uplink of its source, crosses the switch in a constant latency
+       and is queued on the downlink of its destination. The queues
+       are FIFO, or by priority (as IEEE 802.1p) if so requested. A
+       frame of s bytes is 8 (max(s, 46) + 38) bits long, with the
+       headers, the preamble and the interframe gap.
+    */
+    class EthernetSwitch : public Network {
+        Tick _latency;
+        bool _fifo;
+        std::vector<Link *> _up;
+        std::vector<Link *> _down;
+        std::deque<std::pair<Tick, Message> > _fabric;
+
+    protected:
+        void onAddNode(int n);
+        void post(const Message &m);
+
+    public:
+        GEvent<EthernetSwitch> _fabricEvt;
+
+        EthernetSwitch(double bitTime, Tick latency, bool fifo = true,
+                       const std::string &name = "");
+
+        Tick getFrameTime(const Message &m) const;
+        void onTransmitted(Link *l, const Message &m);
+
+        void onFabric(Event *e);
+
+        void newRun();
+        void endRun();
+    };
+
+    /**
+       \ingroup net
+
+       A stream of messages of the same size from a source node to a
+       destination node. The messages sent by SendInstr are
+       transmitted on the network and queued on the channel until a
+       ReceiveInstr takes them; a task receiving on an empty channel
+       blocks until a message arrives. Messages between tasks of the
+       same node are not transmitted: they are delivered at the same
+       instant, by an event that follows the send.
+
+       The channel measures the latency of its messages, from the
+       send to the delivery.
+    */
+    class Channel : public Entity {
+        Network *_net;
+        AbsKernel *_src;
+        AbsKernel *_dst;
+        int _size;
+        int _priority;
+
+        std::deque<Message> _inbox;
+        std::deque<Task *> _waiting;
+        /// Messages between tasks of the same node, to deliver now
+        std::deque<Message> _local;
+
+        unsigned long _sent;
+        unsigned long _delivered;
+        Tick _maxLatency;
+        double _sumLatency;
+        std::vector<BaseStat *> _stats;
+
+        struct Origin {
+            Tick arrival;
+            Tick origin;
+        };
+        /// Transaction of the current job of every receiving task
+        static std::map<const Task *, Origin> _origins;
+
+    public:
+        GEvent<Channel> _localEvt;
+
+        /**
+           @param size payload of the messages, in bytes
+           @param priority identifier of the messages (the lower, the
+                  more urgent)
+        */
+        Channel(const std::string &name, Network *net, AbsKernel *src,
+                AbsKernel *dst, int size, int priority = 0);
+
+        Network *getNetwork() const { return _net; }
+        AbsKernel *getSource() const { return _src; }
+        AbsKernel *getDestination() const { return _dst; }
+        int getSize() const { return _size; }
+        int getPriority() const { return _priority; }
+
+        /// Sends a message on behalf of the current job of t
+        void send(Task *t);
+
+        /**
+           Takes the oldest message for the current job of t; returns
+           false if there is none.
+        */
+        bool receive(Task *t);
+
+        /// t is blocked until the next message
+        void wait(Task *t);
+
+        /// Called by the network at the delivery of m
+        void deliver(const Message &m);
+
+        void onLocal(Event *e);
+
+        unsigned long getSent() const { return _sent; }
+        unsigned long getDelivered() const { return _delivered; }
+        unsigned getPending() const { return _inbox.size(); }
+        Tick getMaxLatency() const { return _maxLatency; }
+        double getMeanLatency() const;
+
+        /// Records every latency also on s
+        void addLatencyStat(BaseStat *s) { _stats.push_back(s); }
+
+        /**
+           Release of the first job of the transaction that the job of
+           t released at the given time belongs to: the oldest origin
+           of the messages the job has received, or its own release.
+        */
+        static Tick getOrigin(const Task *t, Tick arrival);
+
+        void newRun();
+        void endRun();
+    };
+
+    /**
+       \ingroup stat
+
+       End-to-end (holistic) response time of a distributed
+       transaction: from the release of the first job, on whatever
+       node, to the completion of the job of the last task that
+       received the data, through any number of channels and tasks.
+
+       \code
+       CANBus can(2, "can");
+       Channel c("speed", &can, &ecu1, &ecu2, 8, 0x10);
+       sensor.insertCode("fixed(2);send(speed);");
+       control.insertCode("receive(speed);fixed(3);");
+       EndToEndDelay e2e(&control, "e2e");
+       \endcode
+    */
+    class EndToEndDelay : public Entity {
+        Task *_last;
+        unsigned long _count;
+        Tick _max;
+        double _sum;
+        std::vector<BaseStat *> _stats;
+
+    public:
+        EndToEndDelay(Task *last, const std::string &name = "");
+
+        /// Records every response time also on s
+        void addStat(BaseStat *s) { _stats.push_back(s); }
+
+        unsigned long getCount() const { return _count; }
+        Tick getMax() const { return _max; }
+        double getMean() const;
+
+        void probe(EndEvt &e);
+
+        void newRun();
+        void endRun() {}
+    };
+
+} // namespace RTSim
+
+#endif
@@ -24,6 +24,7 @@
 #include <edfsched.hpp>
 #include "TaskAllocation.hpp"
 #include <periodicservervm.hpp>
+#include <timepartitionvm.hpp>
 #include <virtualmachine.hpp>
 
 
@@ -185,7 +186,7 @@ namespace RTSim {
 
         _taskSchedulerMap[task]->extract(task);
         CPU *p = getProcessor(task);
-        if (p != NULL){
+        if (p != NULL && _m_currExe[p] == task){
             task->deschedule();
 
             _m_currExe[p] = NULL;
@@ -200,6 +201,61 @@ namespace RTSim {
         
         MRTKernel::dispatch(_taskCPUMap[t]);
     }
+
+    void PartionedMRTKernel::activate(AbsRTTask *t)
+    {
+        _taskSchedulerMap[t]->insert(t);
+    }
+
+    void PartionedMRTKernel::dispatch()
+    {
+        DBGENTER(_KERNEL_DBG_LEV);
+
+        // only the processors whose first task is not dispatched
+        map<CPU *, Scheduler *>::iterator i;
+        for (i = _cpuSchedulerMap.begin(); i != _cpuSchedulerMap.end(); ++i) {
+            AbsRTTask *f = i->second->getFirst();
+            if (f != _m_currExe[i->first] && 
+                (f == NULL || _m_dispatched[f] != i->first))
+                MRTKernel::dispatch(i->first);
+        }
+    }
+
+    void PartionedMRTKernel::migrate(AbsRTTask *t, CPU *to)
+    {
+        DBGENTER(_KERNEL_DBG_LEV);
+
+        if (!_cpuSchedulerMap.count(to))
+            throw UndefinedCPUException("The given CPU does not belong to the kernel");
+
+        CPU *from = _taskCPUMap[t];
+        if (from == to) return;
+
+        Scheduler *s = _taskSchedulerMap[t];
+        bool ready = s->find(t)->isActive();
+        if (ready) s->extract(t);
+        if (_m_currExe[from] == t) {
+            t->deschedule();
+            _m_currExe[from] = NULL;
+            _m_oldExe[t] = from;
+        }
+        if (_m_dispatched[t] == from) {
+            _m_dispatched[t] = NULL;
+            _endEvt[from]->setTask(NULL);
+        }
+
+        _taskCPUMap[t] = to;
+        _taskSchedulerMap[t] = _cpuSchedulerMap[to];
+        if (ready) _cpuSchedulerMap[to]->insert(t);
+
+        MRTKernel::dispatch(from);
+        MRTKernel::dispatch(to);
+    }
+
+    Scheduler *PartionedMRTKernel::getTaskScheduler(const AbsRTTask *t)
+    {
+        return _taskSchedulerMap[t];
+    }
 	
 	void PartionedMRTKernel::onBeginDispatchMulti(BeginDispatchMultiEvt* e)
     {
@@ -213,6 +269,7 @@ namespace RTSim {
             _m_currExe[p] = NULL;
             _m_dispatched[dt] = NULL;
             dt->deschedule();
+            _endEvt[p]->setPrevious(dt);
         }
 
         // select the first non dispatched task in the queue
@@ -251,10 +308,13 @@ namespace RTSim {
         DBGPRINT_2("Task: ", taskname(st));
         
         // st could be null (because of an idling processor)
-        if (st) st->schedule();
+        if (st) scheduleTask(st);
 
 		_isContextSwitching[p] = false;
         _cpuSchedulerMap[p]->notify(st);
+
+        if (_resMng) _resMng->onContextSwitch(p, e->getPrevious(), st);
+        e->setPrevious(NULL);
     }
 	
 
@@ -293,6 +353,7 @@ namespace RTSim {
         for ( ; j != _m_oldExe.end(); ++j )
             j->second = NULL;
         _m_oldExe.clear();
+        _spinning.clear();
     }
 
     void PartionedMRTKernel::endRun()
@@ -362,6 +423,27 @@ namespace RTSim {
         addTask(*implementation, "");
     }
 
+    void PartionedMRTKernel::addVM(TimePartitionVM &VM)
+    {
+        VM.validate();
+
+        const map<string, PartitionServer *> &parts = VM.getPartitions();
+        map<string, PartitionServer *>::const_iterator i;
+        for (i = parts.begin(); i != parts.end(); ++i) {
+            int index = VM.getCPU(i->first);
+            CPU *cpu = NULL;
+            map<CPU *, Scheduler *>::iterator c;
+            for (c = _cpuSchedulerMap.begin(); c != _cpuSchedulerMap.end(); ++c)
+                if (c->first->getIndex() == index) cpu = c->first;
+            if (!cpu)
+                throw UndefinedCPUException("The CPU of partition " + i->first +
+                                            " does not belong to the kernel");
+
+            _taskCPUMap[i->second] = cpu;
+            addTask(*i->second, "0", cpu);
+        }
+    }
+
     map<const AbsRTTask *, CPU *> PartionedMRTKernel::getTaskCPUMap() const
     {
         return _taskCPUMap;
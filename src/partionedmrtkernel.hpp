@@ -249,6 +249,30 @@ namespace RTSim {
         */
         void onArrival(AbsRTTask *t);
 
+        /**
+            Inherited from RTKernel, inserts the task in its scheduler
+            (without dispatching)
+        */
+        void activate(AbsRTTask *t);
+
+        /**
+            Dispatches every processor whose first task is not the
+            one executing (for instance, after a resource manager
+            suspended or activated tasks)
+        */
+        virtual void dispatch();
+        using MRTKernel::dispatch;
+
+        /**
+            Moves a task to another processor, with its scheduler: the
+            task must have a model in the scheduler of the
+            destination. Used by the resource managers (see
+            MrsPResManager); both processors are dispatched.
+        */
+        void migrate(AbsRTTask *t, CPU *to);
+
+        virtual Scheduler *getTaskScheduler(const AbsRTTask *t);
+
         /**
             Inherited from MRTKernel, this function handles the event "start of a context switch on a mp platform"
         */
@@ -303,6 +327,13 @@ namespace RTSim {
         */
         void addVM(PeriodicServerVM &VM);
 
+        /**
+        * Add the partitions of a TimePartitionVM, each one on the
+        * CPU of its windows (CPU i of the table is the CPU with
+        * index i)
+        */
+        void addVM(TimePartitionVM &VM);
+
         /**
         * Returns the Task-CPU Map
         */
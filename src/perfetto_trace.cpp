@@ -0,0 +1,528 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <cmath>
+#include <cstring>
+
+#include <simul.hpp>
+#include <cpu.hpp>
+#include <perfetto_trace.hpp>
+#include <profiler.hpp>
+
+namespace RTSim {
+
+    using namespace std;
+    using namespace MetaSim;
+
+    /*
+      Field numbers of the messages of perfetto/trace/trace_packet.proto
+      and perfetto/trace/track_event/ that are used here.
+    */
+    enum {
+        TRACE_PACKET = 1,
+
+        PKT_TIMESTAMP = 8,
+        PKT_SEQUENCE_ID = 10,
+        PKT_TRACK_EVENT = 11,
+        PKT_INTERNED_DATA = 12,
+        PKT_SEQUENCE_FLAGS = 13,
+        PKT_TRACK_DESCRIPTOR = 60,
+
+        EVT_TYPE = 9,
+        EVT_NAME_IID = 10,
+        EVT_TRACK_UUID = 11,
+        EVT_DOUBLE_COUNTER_VALUE = 44,
+
+        DESC_UUID = 1,
+        DESC_NAME = 2,
+        DESC_PROCESS = 3,
+        DESC_PARENT_UUID = 5,
+        DESC_COUNTER = 8,
+
+        PROC_PID = 1,
+        PROC_NAME = 6,
+
+        INTERNED_EVENT_NAMES = 2,
+        NAME_IID = 1,
+        NAME_NAME = 2
+    };
+
+    enum {
+        TYPE_SLICE_BEGIN = 1,
+        TYPE_SLICE_END = 2,
+        TYPE_INSTANT = 3,
+        TYPE_COUNTER = 4
+    };
+
+    enum {
+        SEQ_INCREMENTAL_STATE_CLEARED = 1,
+        SEQ_NEEDS_INCREMENTAL_STATE = 2
+    };
+
+    static const unsigned SEQUENCE_ID = 1;
+
+    /*
+      Track uuids: the kind of track in the upper 32 bits, the id of
+      the cpu/task/server in the lower ones.
+    */
+    enum {
+        TRK_CPUS = 1, TRK_TASKS, TRK_SERVERS,
+        TRK_CPU, TRK_SPEED, TRK_TASK, TRK_SERVER, TRK_BUDGET
+    };
+
+    static inline unsigned long long uuid(int kind, long long id)
+    {
+        return ((unsigned long long)kind << 32) | (unsigned)(id + 1);
+    }
+
+    //  PROTOBUF ENCODING  *************************************
+    static inline void putVarint(string &s, unsigned long long v)
+    {
+        while (v >= 0x80) {
+            s += char((v & 0x7f) | 0x80);
+            v >>= 7;
+        }
+        s += char(v);
+    }
+
+    static inline void putUint(string &s, int field, unsigned long long v)
+    {
+        putVarint(s, (field << 3) | 0);
+        putVarint(s, v);
+    }
+
+    static inline void putBytes(string &s, int field, const string &v)
+    {
+        putVarint(s, (field << 3) | 2);
+        putVarint(s, v.size());
+        s += v;
+    }
+
+    static inline void putDouble(string &s, int field, double d)
+    {
+        unsigned long long v;
+        memcpy(&v, &d, sizeof(v));
+        putVarint(s, (field << 3) | 1);
+        for (int i = 0; i < 8; ++i, v >>= 8) s += char(v & 0xff);
+    }
+
+    //  TRACE  *************************************************
+    PerfettoTrace::PerfettoTrace(const string &name, double ns_per_tick,
+                                 size_t bufsize) :
+        _filter(0), _ns_per_tick(ns_per_tick), _bufsize(bufsize),
+        _time(0), _first(true)
+    {
+        fd.clear();
+        fd.open(name.c_str(), ios::out | ios::binary);
+        _out.reserve(_bufsize + 4096);
+
+        process(uuid(TRK_CPUS, 0), 1, "CPUs");
+        process(uuid(TRK_TASKS, 0), 2, "Tasks");
+        process(uuid(TRK_SERVERS, 0), 3, "Servers");
+    }
+
+    PerfettoTrace::~PerfettoTrace()
+    {
+        flush();
+        fd.close();
+    }
+
+    void PerfettoTrace::flush()
+    {
+        fd.write(_out.data(), _out.size());
+        fd.flush();
+        _out.clear();
+    }
+
+    //  UTILITY FUNCTIONS  *************************************
+
+    /*
+      Wraps _body (and the names interned meanwhile) in a TracePacket
+      and appends it to the output buffer.
+    */
+    void PerfettoTrace::packet(int field, bool timestamp)
+    {
+        _pkt.clear();
+        if (timestamp)
+            putUint(_pkt, PKT_TIMESTAMP, (unsigned long long)
+                    ((long long)_time * _ns_per_tick));
+        putUint(_pkt, PKT_SEQUENCE_ID, SEQUENCE_ID);
+        if (!_interned.empty()) {
+            putBytes(_pkt, PKT_INTERNED_DATA, _interned);
+            _interned.clear();
+        }
+        // the first packet resets the interning state of the sequence
+        putUint(_pkt, PKT_SEQUENCE_FLAGS, _first ?
+                SEQ_INCREMENTAL_STATE_CLEARED | SEQ_NEEDS_INCREMENTAL_STATE :
+                SEQ_NEEDS_INCREMENTAL_STATE);
+        _first = false;
+        putBytes(_pkt, field, _body);
+
+        putBytes(_out, TRACE_PACKET, _pkt);
+        if (_out.size() >= _bufsize) flush();
+    }
+
+    unsigned long long PerfettoTrace::iid(const string &name)
+    {
+        map<string, unsigned long long>::iterator i = _iids.find(name);
+        if (i != _iids.end()) return i->second;
+
+        unsigned long long id = _iids.size() + 1;
+        _iids[name] = id;
+
+        string en;
+        putUint(en, NAME_IID, id);
+        putBytes(en, NAME_NAME, name);
+        putBytes(_interned, INTERNED_EVENT_NAMES, en);
+        return id;
+    }
+
+    void PerfettoTrace::process(unsigned long long id, int pid,
+                                const string &name)
+    {
+        string proc;
+        putUint(proc, PROC_PID, pid);
+        putBytes(proc, PROC_NAME, name);
+
+        _body.clear();
+        putUint(_body, DESC_UUID, id);
+        putBytes(_body, DESC_PROCESS, proc);
+        packet(PKT_TRACK_DESCRIPTOR, false);
+        _tracks.insert(id);
+    }
+
+    void PerfettoTrace::track(unsigned long long id, unsigned long long parent,
+                              const string &name, bool counter)
+    {
+        _body.clear();
+        putUint(_body, DESC_UUID, id);
+        putBytes(_body, DESC_NAME, name);
+        putUint(_body, DESC_PARENT_UUID, parent);
+        if (counter) putBytes(_body, DESC_COUNTER, string());
+        packet(PKT_TRACK_DESCRIPTOR, false);
+        _tracks.insert(id);
+    }
+
+    void PerfettoTrace::cpuTrack(int cpu)
+    {
+        if (_tracks.count(uuid(TRK_CPU, cpu))) return;
+
+        string name = cpu >= 0 ? "CPU " + to_string(cpu) : string("CPU");
+        track(uuid(TRK_CPU, cpu), uuid(TRK_CPUS, 0), name);
+        track(uuid(TRK_SPEED, cpu), uuid(TRK_CPUS, 0),
+              name + " speed", true);
+    }
+
+    void PerfettoTrace::taskTrack(const Task *t)
+    {
+        if (_tracks.count(uuid(TRK_TASK, t->getID()))) return;
+        track(uuid(TRK_TASK, t->getID()), uuid(TRK_TASKS, 0), t->getName());
+    }
+
+    void PerfettoTrace::serverTrack(const Server *s)
+    {
+        if (_tracks.count(uuid(TRK_SERVER, s->getID()))) return;
+        track(uuid(TRK_SERVER, s->getID()), uuid(TRK_SERVERS, 0),
+              s->getName());
+        track(uuid(TRK_BUDGET, s->getID()), uuid(TRK_SERVERS, 0),
+              s->getName() + " budget", true);
+    }
+
+    void PerfettoTrace::event(int type, unsigned long long track,
+                              const string &name)
+    {
+        _body.clear();
+        putUint(_body, EVT_TYPE, type);
+        putUint(_body, EVT_TRACK_UUID, track);
+        if (!name.empty()) putUint(_body, EVT_NAME_IID, iid(name));
+        packet(PKT_TRACK_EVENT);
+    }
+
+    void PerfettoTrace::counter(unsigned long long track, double value)
+    {
+        _body.clear();
+        putUint(_body, EVT_TYPE, TYPE_COUNTER);
+        putUint(_body, EVT_TRACK_UUID, track);
+        putDouble(_body, EVT_DOUBLE_COUNTER_VALUE, value);
+        packet(PKT_TRACK_EVENT);
+    }
+
+    /*
+      The slices of the CPU tracks are opened and closed here, so that
+      they stay balanced whatever the order of the events of the
+      kernel is.
+    */
+    void PerfettoTrace::beginJob(int cpu, const Task *t)
+    {
+        endJob(t);
+        map<int, const Task *>::iterator i = _running.find(cpu);
+        if (i != _running.end()) endJob(i->second);
+
+        cpuTrack(cpu);
+        event(TYPE_SLICE_BEGIN, uuid(TRK_CPU, cpu), t->getName());
+        _running[cpu] = t;
+        _taskCPU[t] = cpu;
+    }
+
+    void PerfettoTrace::endJob(const Task *t)
+    {
+        map<const Task *, int>::iterator i = _taskCPU.find(t);
+        if (i == _taskCPU.end()) return;
+
+        event(TYPE_SLICE_END, uuid(TRK_CPU, i->second), string());
+        _running.erase(i->second);
+        _taskCPU.erase(i);
+    }
+
+    void PerfettoTrace::budget(const TraceRecord &r)
+    {
+        counter(uuid(TRK_BUDGET, r.entity), double(r.arg1));
+    }
+
+    /*
+      The records of the server events carry the current budget of
+      the server (the budget for the servers without replenishments).
+    */
+    template<class E>
+    static TraceRecord serverRecord(int code, E &e)
+    {
+        Server *s = e.getServer();
+        ReplenishmentServer *rs = dynamic_cast<ReplenishmentServer *>(s);
+        Tick b = rs ? rs->getCurrentBudget() : s->getBudget();
+        return traceRecord(code, s, e.getCPU(), b);
+    }
+
+    //  TASK EVENTS  *******************************************
+    void PerfettoTrace::probe(ArrEvt &e)
+    {
+        PROFILE_SCOPE("PerfettoTrace::probe");
+        TraceRecord r = traceRecord(FR_ARRIVAL, e.getTask(), e.getCPU());
+        TRACE_WRITE(PerfettoTrace, writeArrival, r);
+    }
+
+    void PerfettoTrace::writeArrival(const TraceRecord &r)
+    {
+        const Task *t = static_cast<const Task *>(r.obj);
+        _time = r.time;
+        taskTrack(t);
+        event(TYPE_INSTANT, uuid(TRK_TASK, t->getID()), "arrival");
+    }
+
+    void PerfettoTrace::probe(EndEvt &e)
+    {
+        PROFILE_SCOPE("PerfettoTrace::probe");
+        TraceRecord r = traceRecord(FR_END, e.getTask(), e.getCPU());
+        TRACE_WRITE(PerfettoTrace, writeEnd, r);
+    }
+
+    void PerfettoTrace::writeEnd(const TraceRecord &r)
+    {
+        const Task *t = static_cast<const Task *>(r.obj);
+        _time = r.time;
+        endJob(t);
+        taskTrack(t);
+        event(TYPE_INSTANT, uuid(TRK_TASK, t->getID()), "end");
+    }
+
+    void PerfettoTrace::probe(SchedEvt &e)
+    {
+        PROFILE_SCOPE("PerfettoTrace::probe");
+        Task *t = e.getTask();
+        // the speed of the CPU, in millionths (-1: unknown)
+        CPU *c = t->getCPU();
+        long long speed = c ? llround(c->getSpeed() * 1e6) : -1;
+        TraceRecord r = traceRecord(FR_SCHED, t, e.getCPU(), speed);
+        TRACE_WRITE(PerfettoTrace, writeSched, r);
+    }
+
+    void PerfettoTrace::writeSched(const TraceRecord &r)
+    {
+        const Task *t = static_cast<const Task *>(r.obj);
+        _time = r.time;
+        beginJob(r.cpu, t);
+        if (r.arg1 >= 0) speed(r.cpu, r.arg1);
+    }
+
+    /// Writes the speed counter of the CPU, if the speed has changed
+    void PerfettoTrace::speed(int cpu, long long millionths)
+    {
+        double s = millionths / 1e6;
+        map<int, double>::iterator i = _speed.find(cpu);
+        if (i != _speed.end() && i->second == s) return;
+
+        _speed[cpu] = s;
+        cpuTrack(cpu);
+        counter(uuid(TRK_SPEED, cpu), s);
+    }
+
+    //  CPU EVENTS  ********************************************
+    void PerfettoTrace::onSpeedChange(CPU *c, double oldSpeed,
+                                      double newSpeed)
+    {
+        PROFILE_SCOPE("PerfettoTrace::onSpeedChange");
+        TraceRecord r = {SIMUL.getTime(), -1, 0, c->getIndex(),
+                         llround(newSpeed * 1e6), 0, c, 0};
+        TRACE_WRITE(PerfettoTrace, writeSpeed, r);
+    }
+
+    void PerfettoTrace::writeSpeed(const TraceRecord &r)
+    {
+        _time = r.time;
+        speed(r.cpu, r.arg1);
+    }
+
+    void PerfettoTrace::probe(DeschedEvt &e)
+    {
+        PROFILE_SCOPE("PerfettoTrace::probe");
+        TraceRecord r = traceRecord(FR_DESCHED, e.getTask(), e.getCPU());
+        TRACE_WRITE(PerfettoTrace, writeDesched, r);
+    }
+
+    void PerfettoTrace::writeDesched(const TraceRecord &r)
+    {
+        _time = r.time;
+        endJob(static_cast<const Task *>(r.obj));
+    }
+
+    void PerfettoTrace::probe(DeadEvt &e)
+    {
+        PROFILE_SCOPE("PerfettoTrace::probe");
+        TraceRecord r = traceRecord(FR_DLINE_MISS, e.getTask(), e.getCPU());
+        TRACE_WRITE(PerfettoTrace, writeDeadline, r);
+    }
+
+    void PerfettoTrace::writeDeadline(const TraceRecord &r)
+    {
+        const Task *t = static_cast<const Task *>(r.obj);
+        _time = r.time;
+        taskTrack(t);
+        event(TYPE_INSTANT, uuid(TRK_TASK, t->getID()), "deadline miss");
+    }
+
+    //  SERVER EVENTS  *****************************************
+    void PerfettoTrace::probe(ServerScheduledEvt &e)
+    {
+        PROFILE_SCOPE("PerfettoTrace::probe");
+        TraceRecord r = serverRecord(FR_SRV_SCHED, e);
+        TRACE_WRITE(PerfettoTrace, writeServerSched, r);
+    }
+
+    void PerfettoTrace::writeServerSched(const TraceRecord &r)
+    {
+        const Server *s = static_cast<const Server *>(r.obj);
+        _time = r.time;
+        serverTrack(s);
+        if (!_srvRunning.insert(s).second)
+            event(TYPE_SLICE_END, uuid(TRK_SERVER, s->getID()), string());
+        event(TYPE_SLICE_BEGIN, uuid(TRK_SERVER, s->getID()),
+              r.cpu >= 0 ? "running on CPU " + to_string(r.cpu) :
+              string("running"));
+        budget(r);
+    }
+
+    void PerfettoTrace::probe(ServerDescheduledEvt &e)
+    {
+        PROFILE_SCOPE("PerfettoTrace::probe");
+        TraceRecord r = serverRecord(FR_SRV_DESCHED, e);
+        TRACE_WRITE(PerfettoTrace, writeServerDesched, r);
+    }
+
+    void PerfettoTrace::writeServerDesched(const TraceRecord &r)
+    {
+        const Server *s = static_cast<const Server *>(r.obj);
+        _time = r.time;
+        serverTrack(s);
+        if (_srvRunning.erase(s))
+            event(TYPE_SLICE_END, uuid(TRK_SERVER, s->getID()), string());
+        budget(r);
+    }
+
+    void PerfettoTrace::probe(ServerBudgetExhaustedEvt &e)
+    {
+        PROFILE_SCOPE("PerfettoTrace::probe");
+        TraceRecord r = serverRecord(FR_SRV_EXHAUSTED, e);
+        TRACE_WRITE(PerfettoTrace, writeExhausted, r);
+    }
+
+    void PerfettoTrace::writeExhausted(const TraceRecord &r)
+    {
+        const Server *s = static_cast<const Server *>(r.obj);
+        _time = r.time;
+        serverTrack(s);
+        event(TYPE_INSTANT, uuid(TRK_SERVER, s->getID()), "budget exhausted");
+        budget(r);
+    }
+
+    void PerfettoTrace::probe(ServerRechargingEvt &e)
+    {
+        PROFILE_SCOPE("PerfettoTrace::probe");
+        TraceRecord r = serverRecord(FR_SRV_RECHARGING, e);
+        TRACE_WRITE(PerfettoTrace, writeBudget, r);
+    }
+
+    void PerfettoTrace::probe(ServerReplenishmentEvt &e)
+    {
+        PROFILE_SCOPE("PerfettoTrace::probe");
+        TraceRecord r = serverRecord(FR_SRV_REPLENISH, e);
+        TRACE_WRITE(PerfettoTrace, writeBudget, r);
+    }
+
+    void PerfettoTrace::writeBudget(const TraceRecord &r)
+    {
+        _time = r.time;
+        serverTrack(static_cast<const Server *>(r.obj));
+        budget(r);
+    }
+
+    void PerfettoTrace::probe(ServerDMissEvt &e)
+    {
+        PROFILE_SCOPE("PerfettoTrace::probe");
+        TraceRecord r = serverRecord(FR_SRV_DMISS, e);
+        TRACE_WRITE(PerfettoTrace, writeServerDeadline, r);
+    }
+
+    void PerfettoTrace::writeServerDeadline(const TraceRecord &r)
+    {
+        const Server *s = static_cast<const Server *>(r.obj);
+        _time = r.time;
+        serverTrack(s);
+        event(TYPE_INSTANT, uuid(TRK_SERVER, s->getID()), "deadline miss");
+    }
+
+    void PerfettoTrace::attachToTask(Task *t)
+    {
+        new Particle<ArrEvt, PerfettoTrace>(&t->arrEvt, this);
+        new Particle<EndEvt, PerfettoTrace>(&t->endEvt, this);
+        new Particle<SchedEvt, PerfettoTrace>(&t->schedEvt, this);
+        new Particle<DeschedEvt, PerfettoTrace>(&t->deschedEvt, this);
+        new Particle<DeadEvt, PerfettoTrace>(&t->deadEvt, this);
+    }
+
+    void PerfettoTrace::attachToServer(Server *s)
+    {
+        new Particle<ServerBudgetExhaustedEvt, PerfettoTrace>(&s->_bandExEvt, this);
+        new Particle<ServerRechargingEvt, PerfettoTrace>(&s->_rechargingEvt, this);
+        new Particle<ServerDMissEvt, PerfettoTrace>(&s->_dlineMissEvt, this);
+        new Particle<ServerScheduledEvt, PerfettoTrace>(&s->_schedEvt, this);
+        new Particle<ServerDescheduledEvt, PerfettoTrace>(&s->_deschedEvt, this);
+        ReplenishmentServer *rs = dynamic_cast<ReplenishmentServer *>(s);
+        if (rs)
+            new Particle<ServerReplenishmentEvt, PerfettoTrace>(&rs->_replEvt, this);
+    }
+
+    void PerfettoTrace::attachToCPU(CPU *c)
+    {
+        c->addObserver(this);
+    }
+
+} // namespace RTSim
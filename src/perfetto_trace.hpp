@@ -0,0 +1,165 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __PERFETTO_TRACE_HPP__
+#define __PERFETTO_TRACE_HPP__
+
+#include <fstream>
+#include <map>
+#include <set>
+#include <string>
+
+#include <basetype.hpp>
+#include <event.hpp>
+#include <particle.hpp>
+
+#include <cpu.hpp>
+#include <task.hpp>
+#include <tracefilter.hpp>
+#include <replenishmentserver.hpp>
+#include <serverevt.hpp>
+
+namespace RTSim {
+
+    /**
+       \ingroup trace
+
+       Trace sink that writes the Perfetto protobuf trace format, which
+       can be opened offline with ui.perfetto.dev (or processed with
+       trace_processor).
+
+       The trace contains:
+       - one track per CPU, with a slice for every execution of a
+         task and a counter with the speed of the CPU;
+       - one track per task, with instant events for arrivals, ends,
+         and deadline misses;
+       - one track per server, with a slice for every execution of
+         the server and a counter with its current budget.
+
+       Event names are interned, so every name is written only once
+       in the file. The output is buffered and the size of a record
+       is usually around 20 bytes, so that traces of 10^8 events
+       stay manageable.
+
+       Usage is the same of the other traces: attach the tasks and
+       the servers to the trace, e.g.:
+
+       \code
+       PerfettoTrace ptrace("trace.pftrace");
+       ptrace.attachToTask(&t1);
+       ptrace.attachToServer(&s1);
+       ptrace.attachToCPU(kern.getProcessors()[0]);
+       \endcode
+
+       The speed counter of a CPU is written when a task is scheduled
+       on it; if the CPU is attached, also at every change of speed,
+       when it happens (e.g. in the middle of a job, by a Governor).
+    */
+    class PerfettoTrace : public CPUObserver {
+    public:
+        /**
+           @param name the file name
+           @param ns_per_tick how many nanoseconds a tick lasts
+           @param bufsize size of the output buffer, in bytes
+        */
+        PerfettoTrace(const std::string &name, double ns_per_tick = 1000,
+                      size_t bufsize = 1 << 20);
+
+        ~PerfettoTrace();
+
+        void probe(ArrEvt &e);
+        void probe(EndEvt &e);
+        void probe(SchedEvt &e);
+        void probe(DeschedEvt &e);
+        void probe(DeadEvt &e);
+
+        void probe(ServerScheduledEvt &e);
+        void probe(ServerDescheduledEvt &e);
+        void probe(ServerBudgetExhaustedEvt &e);
+        void probe(ServerRechargingEvt &e);
+        void probe(ServerReplenishmentEvt &e);
+        void probe(ServerDMissEvt &e);
+
+        void attachToTask(Task *t);
+        void attachToServer(Server *s);
+        void attachToCPU(CPU *c);
+
+        void onSpeedChange(CPU *c, double oldSpeed, double newSpeed);
+
+        /// Writes the buffered packets to the file
+        void flush();
+
+        /// Filters the traced events (null: no filter)
+        void setFilter(TraceFilter *f) { _filter = f; }
+
+    private:
+        std::ofstream fd;
+        TraceFilter *_filter;
+        double _ns_per_tick;
+        size_t _bufsize;
+
+        /// time of the record being written
+        Tick _time;
+
+        // output buffer, packet and payload under construction
+        std::string _out;
+        std::string _pkt;
+        std::string _body;
+        std::string _interned;
+        bool _first;
+
+        std::map<std::string, unsigned long long> _iids;
+        std::set<unsigned long long> _tracks;
+
+        // task running on each CPU track, and CPU of each task
+        std::map<int, const Task *> _running;
+        std::map<const Task *, int> _taskCPU;
+        std::map<int, double> _speed;
+        std::set<const Server *> _srvRunning;
+
+        unsigned long long iid(const std::string &name);
+
+        void track(unsigned long long uuid, unsigned long long parent,
+                   const std::string &name, bool counter = false);
+        void process(unsigned long long uuid, int pid,
+                     const std::string &name);
+
+        void cpuTrack(int cpu);
+        void taskTrack(const Task *t);
+        void serverTrack(const Server *s);
+
+        void event(int type, unsigned long long uuid,
+                   const std::string &name);
+        void counter(unsigned long long uuid, double value);
+        void packet(int field, bool timestamp = true);
+
+        void beginJob(int cpu, const Task *t);
+        void endJob(const Task *t);
+        void budget(const TraceRecord &r);
+        void speed(int cpu, long long millionths);
+
+        void writeArrival(const TraceRecord &r);
+        void writeEnd(const TraceRecord &r);
+        void writeSched(const TraceRecord &r);
+        void writeSpeed(const TraceRecord &r);
+        void writeDesched(const TraceRecord &r);
+        void writeDeadline(const TraceRecord &r);
+        void writeServerSched(const TraceRecord &r);
+        void writeServerDesched(const TraceRecord &r);
+        void writeExhausted(const TraceRecord &r);
+        void writeBudget(const TraceRecord &r);
+        void writeServerDeadline(const TraceRecord &r);
+    };
+}
+
+#endif
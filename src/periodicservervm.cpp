@@ -39,7 +39,7 @@ void PeriodicServerVM::createFromQP(string name, Tick budget, Tick period, bool
     _budget = budget;
     _period = period;
     int factor = (highestPriority) ? 1 : 2;
-    _bandwidth = ((int)period / (int)budget);
+    _bandwidth = double(budget) / double(period);
     _maxDelay = (factor * ((int)period - (int)budget));
 }
 
@@ -0,0 +1,318 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <climits>
+
+#include <simul.hpp>
+
+#include <abskernel.hpp>
+#include <pipresman.hpp>
+#include <resource.hpp>
+#include <task.hpp>
+#include <waitinstr.hpp>
+
+namespace RTSim {
+
+    using namespace std;
+    using namespace MetaSim;
+
+    /// ceiling of a resource with no known users
+    static const Tick NO_CEILING = INT_MAX;
+
+    PIPResManager::PIPResManager(const string &n, Protocol p) :
+        ResManager(n), _protocol(p), _taskNodes(), _lockNodes()
+    {
+    }
+
+    PIPResManager::~PIPResManager()
+    {
+    }
+
+    void PIPResManager::addResource(const string &name, int n)
+    {
+        ResManager::addResource(name, n);
+        Resource *r = _res.back();
+        if (r->total() != 1)
+            throw PIPResManagerExc("Only single unit resources are supported");
+
+        LockNode l = {r, NO_CEILING, NULL, NULL, NULL};
+        _lockNodes[r] = l;
+    }
+
+    PIPResManager::TaskNode *PIPResManager::node(AbsRTTask *t)
+    {
+        map<AbsRTTask *, TaskNode>::iterator i = _taskNodes.find(t);
+        if (i != _taskNodes.end()) return &i->second;
+
+        // first use of an unregistered task
+        TaskModel *m = _sched->find(t);
+        if (m == NULL) throw PIPResManagerExc("Cannot find task model!");
+
+        TaskNode n = {t, m, m->getPriority(), m->getPriority(), NULL, NULL,
+                      NULL, NULL, 0, 0, 0, 0};
+        return &(_taskNodes[t] = n);
+    }
+
+    const PIPResManager::TaskNode *PIPResManager::node(AbsRTTask *t) const
+    {
+        map<AbsRTTask *, TaskNode>::const_iterator i = _taskNodes.find(t);
+        return i == _taskNodes.end() ? NULL : &i->second;
+    }
+
+    PIPResManager::LockNode *PIPResManager::lockNode(Resource *r)
+    {
+        map<Resource *, LockNode>::iterator i = _lockNodes.find(r);
+        if (i == _lockNodes.end())
+            throw PIPResManagerExc("Resource not managed by " + getName());
+        return &i->second;
+    }
+
+    PIPResManager::LockNode *PIPResManager::lockNode(const string &res)
+    {
+        return lockNode(dynamic_cast<Resource *>(Entity::_find(res)));
+    }
+
+    void PIPResManager::ceilingsFromTask(AbsRTTask *t)
+    {
+        TaskNode *n = node(t);
+
+        Task *task = dynamic_cast<Task *>(t);
+        if (task == NULL)
+            throw PIPResManagerExc("ceilingsFromTask argument must be a Task");
+
+        const vector<Instr *> &instrs = task->getInstrQueue();
+        for (unsigned i = 0; i < instrs.size(); ++i) {
+            WaitInstr *w = dynamic_cast<WaitInstr *>(instrs[i]);
+            if (w == NULL) continue;
+            LockNode *l = lockNode(w->getResource());
+            if (n->base < l->ceiling) l->ceiling = n->base;
+        }
+    }
+
+    void PIPResManager::setCeiling(const string &res, Tick prio)
+    {
+        lockNode(res)->ceiling = prio;
+    }
+
+    Tick PIPResManager::getCeiling(const string &res)
+    {
+        return lockNode(res)->ceiling;
+    }
+
+    Tick PIPResManager::getEffectivePriority(AbsRTTask *t)
+    {
+        return node(t)->prio;
+    }
+
+    Tick PIPResManager::getBlockingTime(AbsRTTask *t) const
+    {
+        const TaskNode *n = node(t);
+        return n ? n->blockTotal : Tick(0);
+    }
+
+    Tick PIPResManager::getMaxBlockingTime(AbsRTTask *t) const
+    {
+        const TaskNode *n = node(t);
+        return n ? n->blockMax : Tick(0);
+    }
+
+    unsigned long PIPResManager::getBlockingCount(AbsRTTask *t) const
+    {
+        const TaskNode *n = node(t);
+        return n ? n->blockCount : 0;
+    }
+
+    Tick PIPResManager::inherited(TaskNode *t)
+    {
+        Tick p = t->base;
+        for (LockNode *l = t->held; l != NULL; l = l->nextHeld) {
+            if (_protocol == IPCP && l->ceiling < p) p = l->ceiling;
+            if (l->waiters != NULL && l->waiters->prio < p)
+                p = l->waiters->prio;
+        }
+        return p;
+    }
+
+    void PIPResManager::setPriority(TaskNode *t, Tick p)
+    {
+        DBGPRINT_4("Priority of ", taskname(t->task), " is now ", p);
+
+        // a queued task is moved to its new position
+        bool queued = t->model->isActive();
+        AbsRTTask *exe = _sched->_currExe;
+        if (queued) _sched->extract(t->task);
+        t->model->changePriority(p);
+        t->prio = p;
+        if (queued) _sched->insert(t->task);
+        _sched->_currExe = exe;
+    }
+
+    void PIPResManager::enqueue(TaskNode *t, LockNode *l)
+    {
+        // after the waiters of the same priority
+        TaskNode **p = &l->waiters;
+        while (*p != NULL && (*p)->prio <= t->prio) p = &(*p)->nextWaiter;
+        t->nextWaiter = *p;
+        *p = t;
+        t->waitingOn = l;
+    }
+
+    void PIPResManager::dequeue(TaskNode *t, LockNode *l)
+    {
+        TaskNode **p = &l->waiters;
+        while (*p != t) p = &(*p)->nextWaiter;
+        *p = t->nextWaiter;
+        t->nextWaiter = NULL;
+        t->waitingOn = NULL;
+    }
+
+    void PIPResManager::propagate(TaskNode *t)
+    {
+        while (t != NULL) {
+            Tick p = inherited(t);
+            if (p == t->prio) return;
+            setPriority(t, p);
+
+            LockNode *l = t->waitingOn;
+            if (l == NULL) return;
+            dequeue(t, l);
+            enqueue(t, l);
+            t = l->owner;
+        }
+    }
+
+    PIPResManager::LockNode *PIPResManager::blocker(TaskNode *t, LockNode *l)
+    {
+        if (l->owner == t)
+            throw PIPResManagerExc("Resource " + l->res->getName() +
+                                   " already held by " + taskname(t->task));
+        if (l->owner != NULL) return l;
+        if (_protocol != PCP) return NULL;
+
+        // the system ceiling, among the locks of the other tasks
+        LockNode *b = NULL;
+        map<Resource *, LockNode>::iterator i;
+        for (i = _lockNodes.begin(); i != _lockNodes.end(); ++i) {
+            LockNode *x = &i->second;
+            if (x->owner == NULL || x->owner == t) continue;
+            if (x->ceiling <= t->prio && (b == NULL || x->ceiling < b->ceiling))
+                b = x;
+        }
+        return b;
+    }
+
+    void PIPResManager::grant(TaskNode *t, LockNode *l)
+    {
+        l->owner = t;
+        l->nextHeld = t->held;
+        t->held = l;
+        t->wants = NULL;
+        l->res->lock(t->task);
+        propagate(t);
+    }
+
+    bool PIPResManager::request(AbsRTTask *t, Resource *r, int n)
+    {
+        DBGENTER(_PIPRESMAN_DBG_LEV);
+
+        TaskNode *tn = node(t);
+        LockNode *l = lockNode(r);
+
+        LockNode *b = blocker(tn, l);
+        if (b == NULL) {
+            grant(tn, l);
+            return true;
+        }
+
+        DBGPRINT(taskname(t) << " blocked on " << b->res->getName());
+
+        tn->wants = l;
+        tn->blockedSince = SIMUL.getTime();
+        tn->blockCount++;
+        _kernel->suspend(t);
+
+        enqueue(tn, b);
+        propagate(b->owner);
+        return false;
+    }
+
+    void PIPResManager::release(AbsRTTask *t, Resource *r, int n)
+    {
+        DBGENTER(_PIPRESMAN_DBG_LEV);
+
+        TaskNode *tn = node(t);
+        LockNode *l = lockNode(r);
+        if (l->owner != tn)
+            throw PIPResManagerExc("Resource " + r->getName() +
+                                   " released by a task that does not hold it");
+
+        LockNode **p = &tn->held;
+        while (*p != l) p = &(*p)->nextHeld;
+        *p = l->nextHeld;
+        l->nextHeld = NULL;
+        l->owner = NULL;
+        r->unlock();
+
+        // the waiters try again, in priority order: the first one
+        // gets the lock (unless a ceiling prevents it), the others
+        // block on the new owner
+        TaskNode *w = l->waiters;
+        l->waiters = NULL;
+        while (w != NULL) {
+            TaskNode *next = w->nextWaiter;
+            w->nextWaiter = NULL;
+            w->waitingOn = NULL;
+
+            LockNode *b = blocker(w, w->wants);
+            if (b == NULL) {
+                Tick d = SIMUL.getTime() - w->blockedSince;
+                w->blockTotal += d;
+                if (d > w->blockMax) w->blockMax = d;
+                grant(w, w->wants);
+                _kernel->activate(w->task);
+            }
+            else {
+                enqueue(w, b);
+                propagate(b->owner);
+            }
+            w = next;
+        }
+
+        propagate(tn);
+    }
+
+    void PIPResManager::newRun()
+    {
+        map<AbsRTTask *, TaskNode>::iterator i;
+        for (i = _taskNodes.begin(); i != _taskNodes.end(); ++i) {
+            TaskNode &n = i->second;
+            if (n.prio != n.base) n.model->changePriority(n.base);
+            n.prio = n.base;
+            n.held = n.waitingOn = n.wants = NULL;
+            n.nextWaiter = NULL;
+            n.blockedSince = n.blockTotal = n.blockMax = 0;
+            n.blockCount = 0;
+        }
+
+        map<Resource *, LockNode>::iterator j;
+        for (j = _lockNodes.begin(); j != _lockNodes.end(); ++j) {
+            j->second.owner = NULL;
+            j->second.nextHeld = NULL;
+            j->second.waiters = NULL;
+        }
+    }
+
+    void PIPResManager::endRun()
+    {
+    }
+}
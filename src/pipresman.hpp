@@ -0,0 +1,161 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __PIPRESMAN_HPP__
+#define __PIPRESMAN_HPP__
+
+#include <map>
+
+#include <resmanager.hpp>
+
+#define _PIPRESMAN_DBG_LEV  "pipresman"
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    class PIPResManagerExc : public BaseExc {
+    public:
+        PIPResManagerExc(const string &msg) :
+            BaseExc(msg, "PIPResManager", "pipresman.cpp") {}
+    };
+
+    /**
+       \ingroup resman
+
+       Priority inheritance and priority ceiling protocols for
+       fixed priority schedulers, with nested locks and transitive
+       inheritance.
+
+       Every task and every resource has a node, allocated when it
+       is registered: the node of a task links the locks it holds,
+       the node of a lock links its waiters in priority order, and
+       a blocked task points to the lock it waits for. The effective
+       priority of a task is the highest among its base priority,
+       the first waiter of every lock it holds and, with IPCP, the
+       ceilings of those locks; when it changes, it is propagated
+       along the chain of owners. No memory is allocated while
+       locking and unlocking.
+
+       - PIP: the owner inherits the priority of the tasks it blocks.
+       - PCP: as PIP, but a task can lock a free resource only if
+         its priority is higher than the ceilings of all the locks
+         held by other tasks; otherwise it blocks on the lock with
+         the highest ceiling.
+       - IPCP: a task takes the ceiling of a resource as soon as it
+         locks it.
+
+       Ceilings are the highest base priority of the users of each
+       resource, collected by ceilingsFromTask() from the wait
+       instructions of the tasks (or set with setCeiling()). Lower
+       numbers mean higher priorities, as in FPScheduler.
+
+       For every task, the manager records the time spent blocked on
+       resources (the blocking that IPCP imposes without suspending
+       the task is not counted).
+    */
+    class PIPResManager : public ResManager {
+    public:
+        typedef enum {PIP, PCP, IPCP} Protocol;
+
+        PIPResManager(const std::string &n = "", Protocol p = PIP);
+        ~PIPResManager();
+
+        virtual void addResource(const std::string &name, int n=1);
+
+        /**
+           Registers the task (which must be already in the kernel)
+           with its current priority as base priority, and raises
+           the ceilings of the resources it uses.
+        */
+        void ceilingsFromTask(AbsRTTask *t);
+
+        void setCeiling(const std::string &res, Tick prio);
+        Tick getCeiling(const std::string &res);
+
+        Protocol getProtocol() const { return _protocol; }
+
+        Tick getEffectivePriority(AbsRTTask *t);
+
+        /// @name Blocking statistics
+        /// @{
+        Tick getBlockingTime(AbsRTTask *t) const;
+        Tick getMaxBlockingTime(AbsRTTask *t) const;
+        unsigned long getBlockingCount(AbsRTTask *t) const;
+        /// @}
+
+        void newRun();
+        void endRun();
+
+    protected:
+        virtual bool request(AbsRTTask *t, Resource *r, int n=1);
+        virtual void release(AbsRTTask *t, Resource *r, int n=1);
+
+    private:
+        struct LockNode;
+
+        struct TaskNode {
+            AbsRTTask *task;
+            TaskModel *model;
+            Tick base;
+            Tick prio;
+            /// first of the held locks
+            LockNode *held;
+            /// the lock blocking the task, and the one it requested
+            LockNode *waitingOn;
+            LockNode *wants;
+            /// next in the wait queue of waitingOn
+            TaskNode *nextWaiter;
+
+            Tick blockedSince;
+            Tick blockTotal;
+            Tick blockMax;
+            unsigned long blockCount;
+        };
+
+        struct LockNode {
+            Resource *res;
+            Tick ceiling;
+            TaskNode *owner;
+            /// next in the held list of the owner
+            LockNode *nextHeld;
+            /// first waiter (highest priority)
+            TaskNode *waiters;
+        };
+
+        Protocol _protocol;
+
+        std::map<AbsRTTask *, TaskNode> _taskNodes;
+        std::map<Resource *, LockNode> _lockNodes;
+
+        TaskNode *node(AbsRTTask *t);
+        const TaskNode *node(AbsRTTask *t) const;
+        LockNode *lockNode(Resource *r);
+        LockNode *lockNode(const std::string &res);
+
+        /// The lock that prevents t from locking l, or NULL
+        LockNode *blocker(TaskNode *t, LockNode *l);
+
+        void grant(TaskNode *t, LockNode *l);
+        void enqueue(TaskNode *t, LockNode *l);
+        void dequeue(TaskNode *t, LockNode *l);
+
+        Tick inherited(TaskNode *t);
+        void setPriority(TaskNode *t, Tick p);
+
+        /// Recomputes the priority of t and of the owners it waits for
+        void propagate(TaskNode *t);
+    };
+}
+
+#endif
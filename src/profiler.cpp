@@ -0,0 +1,156 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <profiler.hpp>
+
+#ifdef RTSIM_PROFILING
+
+#include <algorithm>
+#include <iomanip>
+
+#include <simul.hpp>
+
+namespace RTSim {
+
+    using namespace std;
+    using namespace MetaSim;
+
+    // Maximum number of activity samples kept: when exceeded, adjacent
+    // samples are merged and the window is doubled
+    static const size_t _MAX_SAMPLES = 1024;
+
+    ProfileScope *ProfileScope::_current = 0;
+
+    static bool cmpTotal(const ProfileSlot *a, const ProfileSlot *b)
+    {
+        return a->total > b->total;
+    }
+
+    Profiler &Profiler::instance()
+    {
+        static Profiler *p = new Profiler();
+        return *p;
+    }
+
+    Profiler::Profiler() :
+        Entity("Profiler"), _start(clock::now()), _events(0),
+        _handlerTime(0), _window(1000), _baseWindow(1000), _topN(20),
+        _queueProbe(0), _os(&cerr)
+    {
+    }
+
+    ProfileSlot *Profiler::slot(const string &name)
+    {
+        for (unsigned i = 0; i < _slots.size(); ++i)
+            if (_slots[i]->name == name) return _slots[i];
+
+        _slots.push_back(new ProfileSlot(name));
+        return _slots.back();
+    }
+
+    void Profiler::onEvent(unsigned long long ns)
+    {
+        _events++;
+        _handlerTime += ns;
+
+        Tick t = SIMUL.getTime();
+        if (_samples.empty() || t >= _samples.back().time + _window) {
+            if (_samples.size() == _MAX_SAMPLES) {
+                for (size_t i = 0; i < _MAX_SAMPLES / 2; ++i) {
+                    ProfileSample s = _samples[2 * i];
+                    s.events += _samples[2 * i + 1].events;
+                    s.wall += _samples[2 * i + 1].wall;
+                    s.queue = max(s.queue, _samples[2 * i + 1].queue);
+                    _samples[i] = s;
+                }
+                _samples.resize(_MAX_SAMPLES / 2);
+                _window = _window * 2;
+            }
+            ProfileSample s;
+            s.time = t - t % _window;
+            s.events = 0;
+            s.wall = 0;
+            s.queue = _queueProbe ? _queueProbe() : -1;
+            _samples.push_back(s);
+        }
+        _samples.back().events++;
+        _samples.back().wall += ns;
+    }
+
+    void Profiler::report(ostream &os) const
+    {
+        double elapsed = chrono::duration_cast<chrono::nanoseconds>(
+            clock::now() - _start).count();
+
+        os << "==== RTSim profile at time " << SIMUL.getTime()
+           << " ====" << endl;
+        os << "events processed : " << _events << endl;
+        os << "wall-clock time  : " << elapsed / 1e9 << " s" << endl;
+        os << "in handlers      : " << _handlerTime / 1e9 << " s" << endl;
+        if (elapsed > 0)
+            os << "events/second    : " << _events / (elapsed / 1e9) << endl;
+
+        vector<ProfileSlot *> sorted(_slots);
+        sort(sorted.begin(), sorted.end(), cmpTotal);
+
+        os << endl << left << setw(40) << "handler"
+           << right << setw(12) << "calls"
+           << setw(14) << "total(ms)" << setw(14) << "self(ms)"
+           << setw(12) << "ns/call" << endl;
+        for (unsigned i = 0; i < sorted.size() && i < _topN; ++i) {
+            const ProfileSlot *s = sorted[i];
+            if (s->count == 0) break;
+            os << left << setw(40) << s->name
+               << right << setw(12) << s->count
+               << setw(14) << s->total / 1e6
+               << setw(14) << s->self / 1e6
+               << setw(12) << s->total / s->count << endl;
+        }
+
+        os << endl << "activity every " << _window << " ticks" << endl;
+        os << setw(14) << "time" << setw(12) << "events"
+           << setw(14) << "wall(ms)";
+        if (_queueProbe) os << setw(12) << "queue";
+        os << endl;
+        for (unsigned i = 0; i < _samples.size(); ++i) {
+            const ProfileSample &s = _samples[i];
+            os << setw(14) << s.time << setw(12) << s.events
+               << setw(14) << s.wall / 1e6;
+            if (_queueProbe) os << setw(12) << s.queue;
+            os << endl;
+        }
+        os << left;
+    }
+
+    void Profiler::newRun()
+    {
+        for (unsigned i = 0; i < _slots.size(); ++i) {
+            _slots[i]->count = 0;
+            _slots[i]->total = 0;
+            _slots[i]->self = 0;
+        }
+        _samples.clear();
+        _events = 0;
+        _handlerTime = 0;
+        _window = _baseWindow;
+        _start = clock::now();
+    }
+
+    void Profiler::endRun()
+    {
+        report(*_os);
+    }
+
+} // namespace RTSim
+
+#endif // RTSIM_PROFILING
@@ -0,0 +1,185 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __PROFILER_HPP__
+#define __PROFILER_HPP__
+
+/**
+   Self-profiling of the simulator.
+
+   When the library is compiled with RTSIM_PROFILING defined (cmake
+   -DRTSIM_PROFILING=ON), every event handler of the library and the
+   probes of the traces and statistics are wrapped in a
+   PROFILE_SCOPE(), which counts the invocations and measures the
+   wall-clock time spent in them. At the end of every run (i.e. in
+   SIMUL.endSingleRun()) a report is printed with the number of events
+   processed per second, the handlers sorted by cumulative cost and the
+   activity of the simulator over (simulated) time.
+
+   When RTSIM_PROFILING is not defined, PROFILE_SCOPE() expands to
+   nothing and the Profiler class is not even compiled, so profiling
+   costs nothing.
+*/
+#ifdef RTSIM_PROFILING
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <entity.hpp>
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    /**
+       Accumulated statistics of a single profiled handler.
+    */
+    struct ProfileSlot {
+        std::string name;
+        unsigned long long count;
+        /// wall-clock time spent in the handler, callees included (ns)
+        unsigned long long total;
+        /// wall-clock time spent in the handler, callees excluded (ns)
+        unsigned long long self;
+
+        ProfileSlot(const std::string &n) :
+            name(n), count(0), total(0), self(0) {}
+    };
+
+    /**
+       A sample of the simulator activity, taken every
+       Profiler::setSampleWindow() simulated ticks.
+    */
+    struct ProfileSample {
+        Tick time;
+        unsigned long long events;
+        unsigned long long wall;
+        long queue;
+    };
+
+    /**
+       The profiler. It is an Entity, so that the report is printed
+       by endRun(), and it is created on first use by instance().
+    */
+    class Profiler : public Entity {
+    public:
+        typedef std::chrono::steady_clock clock;
+        typedef long (*QueueProbe)();
+
+        static Profiler &instance();
+
+        /// Returns the slot for a handler, creating it if needed
+        ProfileSlot *slot(const std::string &name);
+
+        /**
+           Called by the ProfileScope of every event handler;
+           updates the activity samples.
+        */
+        void onEvent(unsigned long long ns);
+
+        /// Simulated ticks between two activity samples (default 1000)
+        void setSampleWindow(Tick w) { _window = _baseWindow = w; }
+
+        /// Number of handlers listed in the report (default 20)
+        void setTopN(unsigned n) { _topN = n; }
+
+        /**
+           MetaSim does not export the size of its event queue:
+           whoever has access to it can install a function that
+           returns it, and it will be sampled with the activity.
+        */
+        void setQueueProbe(QueueProbe p) { _queueProbe = p; }
+
+        /// Sets the stream where the report is printed (default cerr)
+        void setOutput(std::ostream &os) { _os = &os; }
+
+        void report(std::ostream &os) const;
+
+        void newRun();
+        void endRun();
+
+    private:
+        Profiler();
+
+        std::vector<ProfileSlot *> _slots;
+        std::vector<ProfileSample> _samples;
+
+        clock::time_point _start;
+        unsigned long long _events;
+        unsigned long long _handlerTime;
+
+        Tick _window;
+        Tick _baseWindow;
+        unsigned _topN;
+        QueueProbe _queueProbe;
+        std::ostream *_os;
+    };
+
+    /**
+       Measures the lifetime of a block and accounts it to a slot.
+       Scopes nest: the time of the inner scopes is subtracted from
+       the self time of the outer one. Only the outermost scope is
+       counted as a processed event.
+    */
+    class ProfileScope {
+    public:
+        ProfileScope(ProfileSlot *s) :
+            _slot(s), _parent(_current), _children(0),
+            _start(Profiler::clock::now())
+        {
+            _current = this;
+        }
+
+        ~ProfileScope()
+        {
+            unsigned long long ns =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    Profiler::clock::now() - _start).count();
+            _slot->count++;
+            _slot->total += ns;
+            _slot->self += ns - _children;
+            _current = _parent;
+            if (_parent) _parent->_children += ns;
+            else Profiler::instance().onEvent(ns);
+        }
+
+    private:
+        ProfileSlot *_slot;
+        ProfileScope *_parent;
+        unsigned long long _children;
+        Profiler::clock::time_point _start;
+
+        static ProfileScope *_current;
+    };
+
+} // namespace RTSim
+
+#define _PROFILE_CAT2(a, b) a##b
+#define _PROFILE_CAT(a, b) _PROFILE_CAT2(a, b)
+
+/// Profiles the enclosing block under the given name
+#define PROFILE_SCOPE(name)                                             \
+    static RTSim::ProfileSlot *_PROFILE_CAT(_prof_slot_, __LINE__) =    \
+        RTSim::Profiler::instance().slot(name);                         \
+    RTSim::ProfileScope _PROFILE_CAT(_prof_scope_, __LINE__)            \
+        (_PROFILE_CAT(_prof_slot_, __LINE__))
+
+#else
+
+#define PROFILE_SCOPE(name)
+
+#endif // RTSIM_PROFILING
+
+#endif
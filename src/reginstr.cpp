@@ -18,6 +18,7 @@
 #include <schedinstr.hpp>
 #include <waitinstr.hpp>
 #include <suspend_instr.hpp>
+#include <netinstr.hpp>
 
 namespace RTSim {
 
@@ -35,6 +36,9 @@ namespace RTSim {
 
     const Instr::BASE_KEY_TYPE SuspendName("suspend");
 
+    const Instr::BASE_KEY_TYPE SendName("send");
+    const Instr::BASE_KEY_TYPE ReceiveName("receive");
+
     /** 
         This namespace should never be used by the user. Contains
         functions to initialize the abstract factory that builds
@@ -68,6 +72,12 @@ namespace RTSim {
 
         static registerInFactory<Instr, SuspendInstr, Instr::BASE_KEY_TYPE>
         registerSuspend(SuspendName);
+
+        static registerInFactory<Instr, SendInstr, Instr::BASE_KEY_TYPE>
+        registerSend(SendName);
+
+        static registerInFactory<Instr, ReceiveInstr, Instr::BASE_KEY_TYPE>
+        registerReceive(ReceiveName);
     }
 
     void __reginstr_init() {}
@@ -5,6 +5,7 @@ namespace RTSim {
     void __reginstr_init();
     void __regsched_init();
     void __regtask_init();
+    void __regserver_init();
 }
 
 #endif
@@ -18,6 +18,7 @@
 #include <fpsched.hpp>
 #include <edfsched.hpp>
 #include <rrsched.hpp>
+#include <fairsched.hpp>
 
 namespace RTSim {
 
@@ -25,6 +26,7 @@ namespace RTSim {
     const string FPName("FPSched");
     const string EDFName("EDFSched");
     const string RRName("RRSched");
+    const string FairName("FairSched");
 
     /** 
         This namespace should never be used by the user. Contains
@@ -44,6 +46,9 @@ namespace RTSim {
 
         static registerInFactory<Scheduler, RRScheduler, string>
         registerrr(RRName);
+
+        static registerInFactory<Scheduler, FairScheduler, string>
+        registerfair(FairName);
     }
 
     void __regsched_init() {}
@@ -0,0 +1,51 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <string>
+
+#include <factory.hpp>
+
+#include <deferrableserver.hpp>
+#include <tbserver.hpp>
+#include <reginstr.hpp>
+
+namespace RTSim {
+
+    using namespace std;
+
+    const string DeferrableServerName("DeferrableServer");
+    const string TBSName("TotalBandwidthServer");
+    const string TBStarName("TBStarServer");
+
+    /**
+       This namespace should not be visible, and in any case, users
+       should never access objects of this namefile. This is used just
+       for initialization of the objects needed for the abstract
+       factory that creates servers, e.g.
+       FACT(Server).create("DeferrableServer", {"2", "5", "ds"}).
+    */
+    namespace __server_stub
+    {
+        static registerInFactory<Server, DeferrableServer, string>
+        registerDS(DeferrableServerName);
+
+        static registerInFactory<Server, TotalBandwidthServer, string>
+        registerTBS(TBSName);
+
+        static registerInFactory<Server, TBStarServer, string>
+        registerTBStar(TBStarName);
+    }
+
+    void __regserver_init() {}
+
+} // namespace RTSim
@@ -17,7 +17,7 @@
 #include <server.hpp>
 #include <serverevt.hpp>
 #include <capacitytimer.hpp>
-#include <list>
+#include <ringbuffer.hpp>
 
 //#define _SERVER_DBG_LEV "repl_server"
 
@@ -51,14 +51,18 @@ namespace RTSim {
         /// at time t the budget should be replenished by b.
         typedef std::pair<Tick, Tick> repl_t;
 
+        /// queues of replenishments, on ring buffers so that the
+        /// steady state does not allocate
+        typedef RingBuffer<repl_t> repl_queue_t;
+
         /// queue of replenishments
         /// all times are in the future!
-        std::list<repl_t> repl_queue;
+        repl_queue_t repl_queue;
 
         /// at the replenishment time, the replenishment is moved
         /// from the repl_queue to the capacity_queue, so
         /// all times are in the past.
-        std::list<repl_t> capacity_queue;
+        repl_queue_t capacity_queue;
 
         CapacityTimer vtime;
 
@@ -90,6 +90,16 @@ namespace RTSim {
          */
         void release(AbsRTTask *t, const std::string &name, int n=1);
 
+        /**
+         * Called by the multiprocessor kernels at the end of every
+         * context switch on c, from prev (NULL if the processor was
+         * idle) to next (NULL if it becomes idle). This
+         * implementation does nothing.
+         *
+         * @see MrsPResManager
+         */
+        virtual void onContextSwitch(CPU *c, AbsRTTask *prev, AbsRTTask *next) {}
+
         /*
          * Function called to specify that task t uses the resource called
          * name. This function is not necessary in simple resource managers,
@@ -0,0 +1,103 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __RINGBUFFER_HPP__
+#define __RINGBUFFER_HPP__
+
+#include <cstddef>
+#include <vector>
+
+namespace RTSim {
+
+    /**
+       \ingroup util
+
+       A FIFO queue on a circular buffer, with the subset of the
+       interface of std::list used by the servers (push_back,
+       pop_front, front, back and forward iteration). The storage is
+       allocated at construction (or with reserve()), so pushing and
+       popping never allocate as long as the queue does not exceed
+       its capacity; if it does, the capacity is doubled.
+    */
+    template <class T>
+    class RingBuffer {
+        std::vector<T> _buf;
+        std::size_t _head;
+        std::size_t _size;
+
+        std::size_t pos(std::size_t i) const
+        { return (_head + i) % _buf.size(); }
+
+    public:
+        class iterator {
+            RingBuffer *_r;
+            std::size_t _i;
+        public:
+            iterator(RingBuffer *r = 0, std::size_t i = 0) : _r(r), _i(i) {}
+
+            T &operator*() const { return _r->_buf[_r->pos(_i)]; }
+            T *operator->() const { return &**this; }
+
+            iterator &operator++() { ++_i; return *this; }
+            iterator operator++(int) { iterator t = *this; ++_i; return t; }
+
+            bool operator==(const iterator &o) const
+            { return _r == o._r && _i == o._i; }
+            bool operator!=(const iterator &o) const { return !(*this == o); }
+        };
+
+        explicit RingBuffer(std::size_t capacity = 16) :
+            _buf(capacity > 0 ? capacity : 1), _head(0), _size(0) {}
+
+        std::size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+        bool full() const { return _size == _buf.size(); }
+        std::size_t capacity() const { return _buf.size(); }
+
+        /// Makes room for at least n elements
+        void reserve(std::size_t n)
+        {
+            if (n <= _buf.size()) return;
+            std::vector<T> b(n);
+            for (std::size_t i = 0; i < _size; ++i) b[i] = _buf[pos(i)];
+            _buf.swap(b);
+            _head = 0;
+        }
+
+        T &front() { return _buf[_head]; }
+        const T &front() const { return _buf[_head]; }
+        T &back() { return _buf[pos(_size - 1)]; }
+        const T &back() const { return _buf[pos(_size - 1)]; }
+
+        void push_back(const T &e)
+        {
+            if (full()) reserve(2 * _buf.size());
+            _buf[pos(_size)] = e;
+            _size++;
+        }
+
+        void pop_front()
+        {
+            _head = pos(1);
+            _size--;
+        }
+
+        void clear() { _head = _size = 0; }
+
+        iterator begin() { return iterator(this, 0); }
+        iterator end() { return iterator(this, _size); }
+    };
+
+} // namespace RTSim
+
+#endif
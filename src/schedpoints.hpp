@@ -4,7 +4,9 @@
 #include <vector>
 #include <map>
 
+#include <flightrec.hpp>
 #include <supervisor.hpp>
+#include <profiler.hpp>
 #include <sporadicserver.hpp>
 
 namespace RTSim {
@@ -76,7 +78,11 @@ namespace RTSim {
         public:
             ChangeBudgetEvt(SchedPoint *s1, Server *s2, double b) :
                 Event(), sp(s1), ss(s2), budget(b) {}
-            virtual void doit() { sp->onChangeBudget(this); }
+            virtual void doit() {
+                PROFILE_SCOPE("SchedPoint::ChangeBudgetEvt");
+                FLIGHTREC(FR_BUDGET_CHANGE, ss, budget, 0);
+                sp->onChangeBudget(this);
+            }
             Server *getServer() { return ss; }
             Tick getBudget() { return budget; }
         };
@@ -0,0 +1,422 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <algorithm>
+#include <sstream>
+
+#include "schedtable.hpp"
+
+namespace RTSim {
+
+    using namespace std;
+
+    ScheduleTable::ScheduleTable(Tick hyperperiod) :
+        _hyperperiod(hyperperiod), _tasks(), _slots()
+    {
+        if (hyperperiod <= 0)
+            throw ScheduleTableExc("The hyperperiod must be positive");
+    }
+
+    int ScheduleTable::addTask(const string &name)
+    {
+        if (findTask(name) >= 0)
+            throw ScheduleTableExc("Task " + name + " already in the table");
+        _tasks.push_back(name);
+        return _tasks.size() - 1;
+    }
+
+    int ScheduleTable::findTask(const string &name) const
+    {
+        for (unsigned i = 0; i < _tasks.size(); ++i)
+            if (_tasks[i] == name) return i;
+        return -1;
+    }
+
+    void ScheduleTable::addSlot(Tick start, Tick length, int task, bool last)
+    {
+        if (task < 0 || task >= (int)_tasks.size())
+            throw ScheduleTableExc("Slot of an unknown task");
+        if (start < 0 || start >= _hyperperiod || length <= 0 ||
+            length > _hyperperiod)
+            throw ScheduleTableExc("Slot not in the hyperperiod");
+        if (!_slots.empty()) {
+            if (_slots.back().start + _slots.back().length > start)
+                throw ScheduleTableExc("Slots out of order or overlapping");
+            // a slot that wraps around must end before the first one
+            if (start + length - _hyperperiod > _slots.front().start)
+                throw ScheduleTableExc("Slot wraps around over the first one");
+        }
+
+        TTSlot s = {start, length, task, last};
+        _slots.push_back(s);
+    }
+
+    void ScheduleTable::exportC(ostream &os, const string &name) const
+    {
+        string up(name);
+        transform(up.begin(), up.end(), up.begin(), ::toupper);
+
+        os << "/* Schedule table generated by rtlib */" << endl << endl;
+        os << "#define " << up << "_HYPERPERIOD " << _hyperperiod << "UL"
+           << endl;
+        os << "#define " << up << "_NTASKS " << _tasks.size() << endl;
+        os << "#define " << up << "_NSLOTS " << _slots.size() << endl << endl;
+
+        os << "static const char *const " << name << "_tasks["
+           << up << "_NTASKS] = {" << endl;
+        for (unsigned i = 0; i < _tasks.size(); ++i)
+            os << "    \"" << _tasks[i] << "\""
+               << (i + 1 < _tasks.size() ? "," : "") << endl;
+        os << "};" << endl << endl;
+
+        os << "static const struct " << name << "_slot {" << endl
+           << "    unsigned long start;" << endl
+           << "    unsigned long length;" << endl
+           << "    int task;" << endl
+           << "} " << name << "[" << up << "_NSLOTS] = {" << endl;
+        for (unsigned i = 0; i < _slots.size(); ++i)
+            os << "    {" << _slots[i].start << "UL, " << _slots[i].length
+               << "UL, " << _slots[i].task << "}"
+               << (i + 1 < _slots.size() ? "," : "") << endl;
+        os << "};" << endl;
+    }
+
+    /*----------------------------------------------------*/
+
+    TableSynthesizer::TableSynthesizer() :
+        _tasks(), _prec(), _jobs(), _hyper(0), _window(0),
+        _nodes(0), _maxNodes(0), _order(), _finish()
+    {
+    }
+
+    int TableSynthesizer::findTask(const string &name) const
+    {
+        for (unsigned i = 0; i < _tasks.size(); ++i)
+            if (_tasks[i].name == name) return i;
+        return -1;
+    }
+
+    void TableSynthesizer::addTask(const string &name, Tick wcet, Tick period,
+                                   Tick deadline, Tick offset)
+    {
+        if (findTask(name) >= 0)
+            throw ScheduleTableExc("Task " + name + " already defined");
+        if (wcet <= 0 || period <= 0 || deadline < 0 || offset < 0)
+            throw ScheduleTableExc("Wrong parameters for task " + name);
+
+        TaskParams p = {name, wcet, period,
+                        deadline == 0 ? period : deadline, offset};
+        _tasks.push_back(p);
+    }
+
+    void TableSynthesizer::addPrecedence(const string &before,
+                                         const string &after)
+    {
+        int b = findTask(before);
+        int a = findTask(after);
+        if (b < 0 || a < 0)
+            throw ScheduleTableExc("Precedence between unknown tasks");
+        if (_tasks[a].period != _tasks[b].period)
+            throw ScheduleTableExc("Precedence between tasks with "
+                                   "different periods");
+        _prec.push_back(make_pair(b, a));
+    }
+
+    static long long gcd(long long a, long long b)
+    {
+        while (b) {
+            long long r = a % b;
+            a = b;
+            b = r;
+        }
+        return a;
+    }
+
+    Tick TableSynthesizer::getHyperperiod() const
+    {
+        long long h = 1;
+        for (unsigned i = 0; i < _tasks.size(); ++i) {
+            long long p = (long long)_tasks[i].period;
+            h = h / gcd(h, p) * p;
+        }
+        return Tick(h);
+    }
+
+    void TableSynthesizer::makeJobs(bool cyclic)
+    {
+        if (_tasks.empty()) throw ScheduleTableExc("No tasks");
+
+        _hyper = getHyperperiod();
+        _jobs.clear();
+
+        // the first multiple of H after the largest offset plus H
+        long long h = (long long)_hyper, omax = 0;
+        for (unsigned i = 0; i < _tasks.size(); ++i)
+            omax = max(omax, (long long)_tasks[i].offset);
+        _window = Tick(((omax + h - 1) / h + 1) * h);
+
+        // index of the first job, and number of jobs, of every task
+        vector<int> first(_tasks.size()), count(_tasks.size());
+        for (unsigned i = 0; i < _tasks.size(); ++i) {
+            first[i] = _jobs.size();
+            const TaskParams &p = _tasks[i];
+            Tick o = p.offset;
+            Tick end = _window + _hyper;
+            if (cyclic) {
+                o = Tick((long long)p.offset % (long long)p.period);
+                end = o + _hyper;
+            }
+            for (Tick r = o; r < end; r += p.period) {
+                Job j;
+                j.task = i;
+                j.release = r;
+                j.deadline = r + p.deadline;
+                j.cost = p.wcet;
+                _jobs.push_back(j);
+            }
+            count[i] = _jobs.size() - first[i];
+        }
+
+        for (unsigned k = 0; k < _prec.size(); ++k) {
+            int b = _prec[k].first, a = _prec[k].second;
+            int n = min(count[a], count[b]);
+            for (int j = 0; j < n; ++j)
+                _jobs[first[a] + j].preds.push_back(first[b] + j);
+        }
+    }
+
+    ScheduleTable *TableSynthesizer::makeTable() const
+    {
+        ScheduleTable *t = new ScheduleTable(_hyper);
+        for (unsigned i = 0; i < _tasks.size(); ++i)
+            t->addTask(_tasks[i].name);
+        return t;
+    }
+
+    vector<vector<long long> >
+    TableSynthesizer::state(const vector<Piece> &pieces, Tick t) const
+    {
+        vector<Tick> left(_jobs.size());
+        vector<bool> running(_jobs.size(), false);
+        for (unsigned j = 0; j < _jobs.size(); ++j) left[j] = _jobs[j].cost;
+        for (unsigned i = 0; i < pieces.size(); ++i) {
+            const Piece &p = pieces[i];
+            if (p.start >= t) continue;
+            left[p.job] -= min(p.end, t) - p.start;
+            if (p.end > t) running[p.job] = true;
+        }
+
+        vector<vector<long long> > s;
+        for (unsigned j = 0; j < _jobs.size(); ++j) {
+            if (_jobs[j].release >= t || left[j] == 0) continue;
+            vector<long long> v;
+            v.push_back(_jobs[j].task);
+            v.push_back((long long)(t - _jobs[j].release));
+            v.push_back((long long)left[j]);
+            v.push_back(running[j] ? 1 : 0);
+            s.push_back(v);
+        }
+        sort(s.begin(), s.end());
+        return s;
+    }
+
+    ScheduleTable *TableSynthesizer::synthesizeEDF(bool preemptive)
+    {
+        makeJobs(false);
+
+        vector<Piece> pieces;
+        vector<Tick> left(_jobs.size());
+        vector<bool> done(_jobs.size(), false);
+        for (unsigned j = 0; j < _jobs.size(); ++j) left[j] = _jobs[j].cost;
+
+        unsigned completed = 0;
+        Tick t = 0;
+        while (completed < _jobs.size()) {
+            // the ready job with the earliest deadline, and the next release
+            int best = -1;
+            Tick next = -1;
+            for (unsigned j = 0; j < _jobs.size(); ++j) {
+                if (done[j]) continue;
+                if (_jobs[j].release > t) {
+                    if (next < 0 || _jobs[j].release < next)
+                        next = _jobs[j].release;
+                    continue;
+                }
+                bool ready = true;
+                for (unsigned k = 0; k < _jobs[j].preds.size(); ++k)
+                    if (!done[_jobs[j].preds[k]]) ready = false;
+                if (ready && (best < 0 ||
+                              _jobs[j].deadline < _jobs[best].deadline))
+                    best = j;
+            }
+
+            if (best < 0) {
+                if (next < 0)
+                    throw ScheduleTableExc("Cyclic precedence constraints");
+                t = next;
+                continue;
+            }
+
+            Tick end = t + left[best];
+            if (preemptive && next >= 0 && next < end) end = next;
+
+            if (!pieces.empty() && pieces.back().job == best &&
+                pieces.back().end == t)
+                pieces.back().end = end;
+            else {
+                Piece p = {t, end, best};
+                pieces.push_back(p);
+            }
+
+            left[best] -= end - t;
+            t = end;
+            if (left[best] == 0) {
+                done[best] = true;
+                completed++;
+                if (t > _jobs[best].deadline) {
+                    stringstream s;
+                    s << "Task " << _tasks[_jobs[best].task].name
+                      << " misses its deadline at " << _jobs[best].deadline;
+                    throw ScheduleTableExc(s.str());
+                }
+            }
+        }
+        // the jobs released from W on repeat the ones of [W - H, W)
+        if (state(pieces, _window) != state(pieces, _window + _hyper))
+            throw ScheduleTableExc("The schedule does not repeat "
+                                   "in the feasibility interval");
+
+        // the last piece of every job is the last slot
+        vector<bool> last(pieces.size(), false);
+        vector<bool> seen(_jobs.size(), false);
+        for (int i = pieces.size() - 1; i >= 0; --i)
+            if (!seen[pieces[i].job]) {
+                seen[pieces[i].job] = true;
+                last[i] = true;
+            }
+
+        // the pieces in [W, W + H), moved to [0, H)
+        vector<TTSlot> slots;
+        bool across = false;
+        Tick wend = _window + _hyper;
+        for (unsigned i = 0; i < pieces.size(); ++i) {
+            Tick s = max(pieces[i].start, _window);
+            Tick e = min(pieces[i].end, wend);
+            if (s >= e) continue;
+            if (pieces[i].start < _window) across = true;
+            TTSlot x = {s - _window, e - s, _jobs[pieces[i].job].task,
+                        last[i] && pieces[i].end <= wend};
+            slots.push_back(x);
+        }
+
+        // the job executing at W + H continues at W: the last slot
+        // wraps around, and takes the place of the first one
+        if (across && slots.size() > 1 &&
+            slots.back().start + slots.back().length == _hyper &&
+            slots.back().task == slots.front().task) {
+            slots.back().length += slots.front().length;
+            slots.back().last = slots.front().last;
+            slots.erase(slots.begin());
+        }
+
+        ScheduleTable *table = makeTable();
+        for (unsigned i = 0; i < slots.size(); ++i)
+            table->addSlot(slots[i].start, slots[i].length,
+                           slots[i].task, slots[i].last);
+        return table;
+    }
+
+    bool TableSynthesizer::search(unsigned depth, Tick t, vector<bool> &done)
+    {
+        if (depth == _jobs.size()) return true;
+        if (++_nodes > _maxNodes) return false;
+
+        // the table repeats every H from the start of the first job
+        Tick first = -1;
+        if (depth > 0) first = _finish[_order[0]] - _jobs[_order[0]].cost;
+
+        // bound: every job left must still fit before its deadline
+        for (unsigned j = 0; j < _jobs.size(); ++j)
+            if (!done[j] && max(t, _jobs[j].release) + _jobs[j].cost >
+                _jobs[j].deadline)
+                return false;
+
+        // candidates, by earliest deadline first
+        vector<int> cand;
+        for (unsigned j = 0; j < _jobs.size(); ++j) {
+            if (done[j]) continue;
+            bool ready = true;
+            for (unsigned k = 0; k < _jobs[j].preds.size(); ++k)
+                if (!done[_jobs[j].preds[k]]) ready = false;
+            if (ready) cand.push_back(j);
+        }
+        for (unsigned i = 1; i < cand.size(); ++i)
+            for (unsigned k = i; k > 0 &&
+                     _jobs[cand[k]].deadline < _jobs[cand[k - 1]].deadline; --k)
+                swap(cand[k], cand[k - 1]);
+
+        for (unsigned i = 0; i < cand.size(); ++i) {
+            int j = cand[i];
+            Tick start = max(t, _jobs[j].release);
+            for (unsigned k = 0; k < _jobs[j].preds.size(); ++k)
+                start = max(start, _finish[_jobs[j].preds[k]]);
+            Tick end = start + _jobs[j].cost;
+            if (end > _jobs[j].deadline) continue;
+            if (end - _hyper > (depth > 0 ? first : start)) continue;
+
+            done[j] = true;
+            _finish[j] = end;
+            _order[depth] = j;
+            if (search(depth + 1, end, done)) return true;
+            done[j] = false;
+            if (_nodes > _maxNodes) return false;
+        }
+        return false;
+    }
+
+    ScheduleTable *TableSynthesizer::synthesizeSearch(unsigned long maxNodes)
+    {
+        makeJobs(true);
+
+        _nodes = 0;
+        _maxNodes = maxNodes;
+        _order.assign(_jobs.size(), -1);
+        _finish.assign(_jobs.size(), 0);
+        vector<bool> done(_jobs.size(), false);
+
+        if (!search(0, 0, done)) {
+            if (_nodes > _maxNodes)
+                throw ScheduleTableExc("No table found within the node limit");
+            throw ScheduleTableExc("The task set has no non-preemptive table");
+        }
+
+        // the jobs that start after H go to the beginning of the table
+        vector<TTSlot> slots, wrapped;
+        for (unsigned i = 0; i < _order.size(); ++i) {
+            const Job &j = _jobs[_order[i]];
+            TTSlot s = {_finish[_order[i]] - j.cost, j.cost, j.task, true};
+            if (s.start >= _hyper) {
+                s.start -= _hyper;
+                wrapped.push_back(s);
+            }
+            else
+                slots.push_back(s);
+        }
+        slots.insert(slots.begin(), wrapped.begin(), wrapped.end());
+
+        ScheduleTable *table = makeTable();
+        for (unsigned i = 0; i < slots.size(); ++i)
+            table->addSlot(slots[i].start, slots[i].length, slots[i].task);
+        return table;
+    }
+}
@@ -0,0 +1,197 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __SCHEDTABLE_HPP__
+#define __SCHEDTABLE_HPP__
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <baseexc.hpp>
+#include <simul.hpp>
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    /**
+       Exception thrown when a schedule table cannot be built, or is
+       not well formed.
+    */
+    class ScheduleTableExc : public BaseExc {
+    public:
+        ScheduleTableExc(const string &msg) :
+            BaseExc(msg, "ScheduleTable", "schedtable.cpp") {}
+    };
+
+    /**
+       A slot of a schedule table: the task with the given index
+       executes in [start, start + length). The last slot of every
+       job is marked: if the job has not completed at its end, the
+       job overran its budget.
+    */
+    struct TTSlot {
+        Tick start;
+        Tick length;
+        int task;
+        bool last;
+    };
+
+    /**
+       A static schedule table, that repeats every hyperperiod. The
+       tasks are identified by their index in the table, and named
+       for the TTKernel and for the export.
+    */
+    class ScheduleTable {
+        Tick _hyperperiod;
+        std::vector<std::string> _tasks;
+        std::vector<TTSlot> _slots;
+
+    public:
+        ScheduleTable(Tick hyperperiod);
+
+        /// Adds a task and returns its index
+        int addTask(const std::string &name);
+
+        /**
+           Adds a slot; the slots must be added in order of start
+           time and must not overlap. The start must be in the
+           hyperperiod, but the last slot may wrap around: it
+           continues at the beginning of the next hyperperiod, before
+           the start of the first slot.
+        */
+        void addSlot(Tick start, Tick length, int task, bool last = true);
+
+        Tick getHyperperiod() const { return _hyperperiod; }
+
+        const std::vector<TTSlot> &getSlots() const { return _slots; }
+        unsigned getSize() const { return _slots.size(); }
+
+        int getTaskNumber() const { return _tasks.size(); }
+        const std::string &getTaskName(int i) const { return _tasks[i]; }
+
+        /// The index of the task, or -1
+        int findTask(const std::string &name) const;
+
+        /**
+           Writes the table as C declarations: the hyperperiod, the
+           task names and an array of {start, length, task} slots,
+           all prefixed by name.
+        */
+        void exportC(std::ostream &os, const std::string &name) const;
+    };
+
+    /**
+       Builds schedule tables offline over the hyperperiod of a set
+       of periodic tasks, either by simulating EDF (preemptive or
+       not) or by a depth-first search over the orders of the jobs
+       (non-preemptive), which finds a table whenever one exists
+       within the given number of nodes.
+
+       The tasks may have offsets, and precedence constraints
+       between tasks with the same period: the k-th job of the
+       successor starts after the k-th job of the predecessor has
+       completed. Every job must complete within its deadline; a job
+       may complete after the end of the hyperperiod, in a slot that
+       wraps around.
+
+       With offsets, EDF is simulated over the feasibility interval
+       [0, W + H), with H the hyperperiod and W the first multiple
+       of H not smaller than the largest offset plus H; the schedule
+       in [W, W + H) repeats every H, and it is the table. The search
+       folds the offsets modulo the periods and looks for a sequence
+       of the jobs of one hyperperiod that fits in H when repeated.
+       In the first hyperperiod, the part of a slot that wraps
+       around belongs to a job that was never released, so the
+       TTKernel does not execute it.
+    */
+    class TableSynthesizer {
+        struct TaskParams {
+            std::string name;
+            Tick wcet;
+            Tick period;
+            Tick deadline;
+            Tick offset;
+        };
+
+        struct Job {
+            int task;
+            Tick release;
+            Tick deadline;
+            Tick cost;
+            std::vector<int> preds;
+        };
+
+        struct Piece {
+            Tick start;
+            Tick end;
+            int job;
+        };
+
+        std::vector<TaskParams> _tasks;
+        std::vector<std::pair<int, int> > _prec;
+
+        std::vector<Job> _jobs;
+        Tick _hyper;
+        /// beginning of the hyperperiod that is folded into the table
+        Tick _window;
+
+        unsigned long _nodes;
+        unsigned long _maxNodes;
+        std::vector<int> _order;
+        std::vector<Tick> _finish;
+
+        int findTask(const std::string &name) const;
+        /**
+           Jobs released in one hyperperiod, with the offsets modulo
+           the periods (cyclic), or in the feasibility interval.
+        */
+        void makeJobs(bool cyclic);
+        ScheduleTable *makeTable() const;
+        /// Pending jobs at time t: (task, t - release, left, running)
+        std::vector<std::vector<long long> >
+        state(const std::vector<Piece> &p, Tick t) const;
+        bool search(unsigned depth, Tick t, std::vector<bool> &done);
+
+    public:
+        TableSynthesizer();
+
+        /// Adds a task (deadline 0 means equal to the period)
+        void addTask(const std::string &name, Tick wcet, Tick period,
+                     Tick deadline = 0, Tick offset = 0);
+
+        /// The jobs of after start after the ones of before
+        void addPrecedence(const std::string &before, const std::string &after);
+
+        /// Least common multiple of the periods
+        Tick getHyperperiod() const;
+
+        /**
+           Simulates EDF (ties broken by the order of the tasks) over
+           the feasibility interval and returns the resulting table;
+           throws ScheduleTableExc at the first deadline miss, or if
+           the schedule does not repeat.
+        */
+        ScheduleTable *synthesizeEDF(bool preemptive = true);
+
+        /**
+           Non-preemptive table by a branch and bound search over the
+           orders of the jobs; throws ScheduleTableExc if no table is
+           found after maxNodes nodes.
+        */
+        ScheduleTable *synthesizeSearch(unsigned long maxNodes = 1000000);
+    };
+}
+
+#endif
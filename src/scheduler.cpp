@@ -16,6 +16,7 @@
 #include <scheduler.hpp>
 #include <task.hpp>
 #include <climits>
+#include <cstdlib>
 
 namespace RTSim {
 
@@ -139,7 +140,20 @@ namespace RTSim {
     void Scheduler::changePriority(AbsRTTask* task, const std::string &params) 
         throw(RTSchedExc)
     {
-        
+        TaskModel* model = find(task);
+
+        if (model == NULL)
+            throw RTSchedExc("AbsRTTask not found");
+
+        // a queued task is moved to its new position
+        bool queued = model->isActive();
+        AbsRTTask *exe = _currExe;
+        if (queued) extract(task);
+
+        model->changePriority(atoi(params.c_str()));
+
+        if (queued) insert(task);
+        _currExe = exe;
     }
 
 
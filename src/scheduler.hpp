@@ -205,6 +205,12 @@ namespace RTSim {
 
         int getPriority(AbsRTTask* task) throw(RTSchedExc);
 
+        /**
+         * Changes the priority of a task to the one in params
+         * (an integer, as the model interprets it). A task in
+         * the queue is moved accordingly; the kernel is not
+         * invoked.
+         */
         void changePriority(AbsRTTask* task, const std::string &params) 
             throw(RTSchedExc);
 
@@ -307,6 +313,10 @@ namespace RTSim {
     
         /// @todo change it into ResManager
         friend class PIRManager;
+        friend class BWI;
+        friend class PIPResManager;
+        friend class MPResManager;
+        friend class PartionedMRTKernel;
     };
 
     
@@ -2,6 +2,8 @@
 #include <cassert>
 
 #include <factory.hpp>
+#include <bwi.hpp>
+#include <flightrec.hpp>
 #include <server.hpp>
 #include <partionedmrtkernel.hpp>
 #include <strtoken.hpp>
@@ -28,6 +30,7 @@ namespace RTSim {
         tasks(),
         last_exec_time(0),
         kernel(0),
+        globResManager(0),
         sched_(0),
         currExe_(0),
         _bandExEvt(this),
@@ -38,6 +41,7 @@ namespace RTSim {
         _dispatchEvt(this)
     {
         DBGENTER(_SERVER_DBG_LEV);
+        FlightRecorder::instance().setName(getID(), getName());
         string s_name = parse_util::get_token(s);
         // only for passing to the factory
         vector<string> p = parse_util::split_param(parse_util::get_param(s));
@@ -142,15 +146,52 @@ namespace RTSim {
 	_dispatchEvt.post(SIMUL.getTime());
     }
         
-    CPU *Server::getProcessor(const AbsRTTask *) const
+    CPU *Server::getProcessor(const AbsRTTask *t) const
     {
+        BWI *bwi = dynamic_cast<BWI *>(globResManager);
+        Server *host = bwi ? bwi->getHost(t) : NULL;
+        if (host != NULL && host != this)
+            return host->kernel->getProcessor(host);
         return kernel->getProcessor(this);
     }
 
-    CPU *Server::getOldProcessor(const AbsRTTask *) const
+    CPU *Server::getOldProcessor(const AbsRTTask *t) const
     {
+        BWI *bwi = dynamic_cast<BWI *>(globResManager);
+        Server *host = bwi ? bwi->getHost(t) : NULL;
+        if (host != NULL && host != this)
+            return host->kernel->getOldProcessor(host);
         return kernel->getOldProcessor(this);
     }
+
+    void Server::setGlobalResManager(ResManager *rm)
+    {
+        globResManager = rm;
+        BWI *bwi = dynamic_cast<BWI *>(rm);
+        if (bwi) bwi->addServer(this);
+    }
+
+    bool Server::requestResource(AbsRTTask *t, const string &r, int n)
+        throw(ServerExc)
+    {
+        DBGENTER(_SERVER_DBG_LEV);
+
+        if (globResManager == 0)
+            throw ServerExc("Resource Manager not set!",
+                            "Server::requestResource()");
+        return globResManager->request(t, r, n);
+    }
+
+    void Server::releaseResource(AbsRTTask *t, const string &r, int n)
+        throw(ServerExc)
+    {
+        DBGENTER(_SERVER_DBG_LEV);
+
+        if (globResManager == 0)
+            throw ServerExc("Resource Manager not set!",
+                            "Server::releaseResource()");
+        globResManager->release(t, r, n);
+    }
         
     void Server::onArrival(AbsRTTask *t)
     {
@@ -178,6 +219,15 @@ namespace RTSim {
     {
         DBGENTER(_SERVER_DBG_LEV);
 
+        BWI *bwi = dynamic_cast<BWI *>(globResManager);
+        Server *host = bwi ? bwi->getHost(t) : NULL;
+        if (host != NULL && host != this) {
+            // the task ended while executing in another server
+            sched_->extract(t);
+            bwi->onGuestEnd(host, t);
+            return;
+        }
+
         assert(status == EXECUTING);
         sched_->extract(t);
         currExe_ = NULL;
@@ -293,7 +343,10 @@ namespace RTSim {
         if (newExe != currExe_) {
             if (currExe_ != NULL) currExe_->deschedule();
             currExe_ = newExe;
-            if (currExe_ != NULL) currExe_->schedule();
+            if (currExe_ != NULL) {
+                currExe_->schedule();
+                sched_->notify(currExe_);
+            }
         }
 
         DBGPRINT_2("Now Running: ", taskname(newExe));
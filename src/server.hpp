@@ -87,9 +87,8 @@ namespace RTSim {
         instantiated. See one of the derived classes for more
         information.
 
-        @todo Implement other algorithms, like Sporadic Server
-        (fixed priority and Dynamic priority versions), Deferrable
-        Server, etc. Need to implement TBS as well.
+        @todo Implement the dynamic priority version of the
+        Sporadic Server.
       
         @todo simplify the interface (now it is too fat)
     */
@@ -103,6 +102,8 @@ namespace RTSim {
         friend class ServerDMissEvt;
         friend class ServerRechargingEvt;
         friend class ServerScheduledEvt;
+        friend class BWI;
+        friend class EnergyMeter;
 
         static string status_string[];
     
@@ -277,9 +278,26 @@ namespace RTSim {
             global level (not inside the server, but outside!) 
 
             @todo think about interaction between local and global resman!
+
+            @see BWI
         */
         void setGlobalResManager(ResManager *rm);
 
+        /**
+           Requests a resource to the global resource manager on
+           behalf of a task of the server (see WaitInstr). Returns
+           false if the task has been blocked.
+        */
+        bool requestResource(AbsRTTask *t, const std::string &r, int n = 1)
+            throw(ServerExc);
+
+        /**
+           Releases a resource to the global resource manager on
+           behalf of a task of the server (see SignalInstr).
+        */
+        void releaseResource(AbsRTTask *t, const std::string &r, int n = 1)
+            throw(ServerExc);
+
         /** Inherited from AbsRTTask. Returns the current
             absolute deadline */
         virtual Tick getDeadline() const;
@@ -305,7 +323,10 @@ namespace RTSim {
 
         /** 
             Inherited from AbsKernel. Calls the corresponding
-            function of RTKernel*/
+            function of RTKernel. A task that executes in
+            another server, because of bandwidth inheritance,
+            gets the processor of that server.
+        */
         virtual CPU *getProcessor(const AbsRTTask *) const;
 
         /** 
@@ -387,12 +408,13 @@ namespace RTSim {
         /** 
             Function inherited from AbsRTTask. It refreshes the
             state of the executing task when a change of the
-            CPU speed occurs.  In this class, this function
-            does nothing.
-                    
-            @todo check that this is actually what we expect.
+            CPU speed occurs, by refreshing the task that is
+            executing in the server.
         */ 
-        virtual void refreshExec(double, double) {}
+        virtual void refreshExec(double oldSpeed, double newSpeed)
+        {
+            if (currExe_ != NULL) currExe_->refreshExec(oldSpeed, newSpeed);
+        }
 
         virtual bool isActive() const { return (status != IDLE); }
                 
@@ -11,50 +11,68 @@
  *   (at your option) any later version.                                   *
  *                                                                         *
  ***************************************************************************/
+#include <flightrec.hpp>
 #include <server.hpp>
 #include <serverevt.hpp>
 #include <replenishmentserver.hpp>
+#include <profiler.hpp>
 #include <cstdlib>
 
 namespace RTSim {
     
     void ServerBudgetExhaustedEvt::doit()
     {
+        PROFILE_SCOPE("ServerBudgetExhaustedEvt");
+        FLIGHTREC(FR_SRV_EXHAUSTED, _server, 0, 0);
         _server->onBudgetExhausted(this);
     }
     
     void ServerDMissEvt::doit()
     {
+        PROFILE_SCOPE("ServerDMissEvt");
+        FLIGHTREC(FR_SRV_DMISS, _server, 0, 0);
         _server->onDlineMiss(this);    }
     
     void ServerRechargingEvt::doit()
     {
+        PROFILE_SCOPE("ServerRechargingEvt");
+        FLIGHTREC(FR_SRV_RECHARGING, _server, 0, 0);
         _server->onRecharging(this);
     }
     
     void ServerScheduledEvt::doit()
     {
+        PROFILE_SCOPE("ServerScheduledEvt");
+        FLIGHTREC(FR_SRV_SCHED, _server, _cpu, 0);
         _server->onSched(this);
     }
     
     void ServerDescheduledEvt::doit()
     {
+        PROFILE_SCOPE("ServerDescheduledEvt");
+        FLIGHTREC(FR_SRV_DESCHED, _server, _cpu, 0);
         _server->onDesched(this);
     }
 
     void ServerDispatchEvt::doit()
     {
+        PROFILE_SCOPE("ServerDispatchEvt");
+        FLIGHTREC(FR_SRV_DISPATCH, _server, 0, 0);
         _server->onDispatch(this);
     }
 
     void ServerIdleEvt::doit()
     {
+        PROFILE_SCOPE("ServerIdleEvt");
+        FLIGHTREC(FR_SRV_IDLE, _server, 0, 0);
         ReplenishmentServer *rServ = dynamic_cast<ReplenishmentServer *> (_server);
         rServ->onIdle(this);
     }
 
     void ServerReplenishmentEvt::doit()
     {
+        PROFILE_SCOPE("ServerReplenishmentEvt");
+        FLIGHTREC(FR_SRV_REPLENISH, _server, 0, 0);
         ReplenishmentServer *rServ = dynamic_cast<ReplenishmentServer *> (_server);
         rServ->onReplenishment(this);
     }
@@ -4,7 +4,9 @@
 #include <vector>
 #include <map>
 #include <sporadicserver.hpp>
+#include <flightrec.hpp>
 #include <supervisor.hpp>
+#include <profiler.hpp>
 
 #define _SPARE_POT_DBG_LEV  "SparePot"
 
@@ -122,7 +124,11 @@ namespace RTSim {
         public:
             ChangeBudgetEvt(SparePot *s1, SporadicServer *s2, Tick b) :
                 Event(EndEvt::_END_EVT_PRIORITY + 4), sp(s1), ss(s2), budget(b) {}
-            virtual void doit() { sp->onChangeBudget(this); }
+            virtual void doit() {
+                PROFILE_SCOPE("SparePot::ChangeBudgetEvt");
+                FLIGHTREC(FR_BUDGET_CHANGE, ss, budget, 0);
+                sp->onChangeBudget(this);
+            }
             SporadicServer *getServer() { return ss; }
             Tick getBudget() { return budget; }
         };
@@ -1,6 +1,8 @@
 #include "sporadicserver.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <string>
 
 namespace RTSim {
 
@@ -8,7 +10,15 @@ namespace RTSim {
 
     SporadicServer::SporadicServer(Tick q, Tick p, const std::string &name,
                                    const std::string &s) :
-        ReplenishmentServer(name, s, q, p)
+        ReplenishmentServer(name, s, q, p),
+        max_repl(0),
+        coalesced(0),
+        bg_sched(0),
+        bg_prio(0),
+        fg_prio(0),
+        background(false),
+        init_budget(q),
+        budget_policy(REFILL)
     {
         DBGENTER(_SERVER_DBG_LEV);
         DBGPRINT(s);
@@ -21,7 +31,9 @@ namespace RTSim {
         Server::newRun();
         _replEvt.drop();
         _idleEvt.drop();
-        cap = Q;
+        restore_priority();
+        cap = init_budget;
+        coalesced = 0;
         last_time = 0;
         recharging_time = 0;
         status = IDLE;
@@ -50,8 +62,13 @@ namespace RTSim {
         assert (status == IDLE);
 
         status = READY;
-        cap = Q;
+        if (budget_policy == REFILL) {
+            cap = Q;
+            restore_priority();
+        }
         vtime.set_value(SIMUL.getTime());
+        // in background nothing is consumed
+        if (background) return;
         // prepare a replenishment (partial)
         prepare_replenishment(SIMUL.getTime());
         DBGPRINT_2("Inserting replenishment at", repl_queue.back().first);
@@ -61,9 +78,10 @@ namespace RTSim {
     {
         DBGENTER(_SERVER_DBG_LEV);
         status = READY;
+        _idleEvt.drop();
+        if (background) return;
         // prepare a replenishment (partial)
         prepare_replenishment(SIMUL.getTime());
-        _idleEvt.drop();
         DBGPRINT_2("Inserting replenishment at", repl_queue.back().first);
     }
 
@@ -75,6 +93,8 @@ namespace RTSim {
 
         last_time = SIMUL.getTime();
 
+        if (background) return;
+
         vtime.start((double)P/double(Q));
 
         DBGPRINT_2("Last time is: ", last_time);
@@ -87,6 +107,7 @@ namespace RTSim {
         DBGENTER(_SERVER_DBG_LEV);
 
         status = READY;
+        if (background) return;
         
         cap = cap - (SIMUL.getTime() - last_time);
         _bandExEvt.drop();
@@ -100,7 +121,7 @@ namespace RTSim {
 
         DBGPRINT("Status: " << status_string[status]);
 
-        if (status == EXECUTING) {
+        if (status == EXECUTING && !background) {
             cap = cap - (SIMUL.getTime() - last_time);
             _bandExEvt.drop();
             repl_queue.back().second += SIMUL.getTime() - last_time;
@@ -153,6 +174,11 @@ namespace RTSim {
             last_time = SIMUL.getTime();
             status = READY;
         }
+        else if (bg_sched) {
+            // executes at low priority until the next replenishment
+            enter_background();
+            status = READY;
+        }
         else {
             status = RECHARGING;
         }
@@ -193,6 +219,7 @@ namespace RTSim {
             DBGPRINT_3("There are ", repl_queue.size(), 
                        " elements in the repl_queue");
             check_repl();
+            restore_priority();
 
             if (sched_->getFirst() != NULL) {
                 recharging_ready();
@@ -204,6 +231,20 @@ namespace RTSim {
                 sched_->notify(NULL);
             }
         }
+        else if (background) {
+            // back to the normal priority, with the new budget
+            cap = cap + repl_queue.front().second;
+            repl_queue.pop_front();
+            check_repl();
+            restore_priority();
+            prepare_replenishment(SIMUL.getTime());
+            if (status == EXECUTING) {
+                last_time = SIMUL.getTime();
+                vtime.start((double)P/double(Q));
+                _bandExEvt.post(last_time + cap);
+            }
+            kernelDispatch();
+        }
         else if (status == READY || status == EXECUTING) {
             repl_t r = repl_queue.front();
             repl_queue.pop_front();
@@ -217,6 +258,20 @@ namespace RTSim {
 
     void SporadicServer::prepare_replenishment(const Tick &t)
     {
+        if (max_repl > 0 && repl_queue.size() >= unsigned(max_repl)) {
+            // coalesced into the last one, never anticipated
+            repl_t &last = repl_queue.back();
+            if (last.first < t + P) {
+                last.first = t + P;
+                if (repl_queue.size() == 1 && _replEvt.isInQueue()) {
+                    _replEvt.drop();
+                    _replEvt.post(last.first);
+                }
+            }
+            coalesced++;
+            return;
+        }
+
         repl_t r;
         r.first = t + P;
         r.second = 0; // still don't know...
@@ -298,7 +353,7 @@ namespace RTSim {
             DBGVAR(delta);
 
             // if there is some delta left, reduce the capacity queue
-            list<repl_t>::iterator i= capacity_queue.begin();
+            repl_queue_t::iterator i= capacity_queue.begin();
             while (delta > 0 && i!=capacity_queue.end()) {
                 Tick x = min(delta, i->second);
                 i->second -= x;
@@ -364,6 +419,35 @@ namespace RTSim {
         }
         return ret;    
     }
+    void SporadicServer::setMaxRepl(int n)
+    {
+        max_repl = n;
+        if (n > 0) {
+            repl_queue.reserve(n);
+            capacity_queue.reserve(n);
+        }
+    }
+
+    void SporadicServer::setBackground(Scheduler *s, int low)
+    {
+        bg_sched = s;
+        bg_prio = low;
+    }
+
+    void SporadicServer::enter_background()
+    {
+        fg_prio = bg_sched->getPriority(this);
+        bg_sched->changePriority(this, std::to_string(bg_prio));
+        background = true;
+    }
+
+    void SporadicServer::restore_priority()
+    {
+        if (!background) return;
+        bg_sched->changePriority(this, std::to_string(fg_prio));
+        background = false;
+    }
+
  Tick SporadicServer::changeQ(const Tick &n)
 {
   Q=n;
@@ -8,10 +8,53 @@ namespace RTSim {
     
     using namespace MetaSim;
     
+    /**
+        @ingroup server
+
+        Sporadic Server: the budget consumed from the time the
+        server becomes active is replenished one period later.
+
+        The POSIX SCHED_SPORADIC parameters are also supported:
+        - setMaxRepl() limits the pending replenishments
+          (sched_ss_max_repl); when they are that many, the budget
+          consumed later is coalesced into the last one, which is
+          postponed accordingly;
+        - setBackground() sets a low priority (sched_ss_low_priority)
+          at which the server keeps executing, without consuming
+          budget, when its budget is exhausted, until the next
+          replenishment; the priority is changed on the scheduler
+          of the kernel of the server;
+        - setInitBudget() sets the budget at the start
+          (sched_ss_init_budget), and setBudgetPolicy() whether the
+          budget is refilled every time the server becomes active
+          after being idle (REFILL, the default) or is only given
+          by the replenishments (KEEP, as POSIX).
+    */
     class SporadicServer : public ReplenishmentServer {
     public:
+        typedef enum { REFILL, KEEP } budget_policy_t;
+
         SporadicServer(Tick q, Tick p, const std::string &name,
                        const std::string &sched = "FIFOSched");
+
+        /// Limits the pending replenishments to n (0: no limit)
+        void setMaxRepl(int n);
+        int getMaxRepl() const { return max_repl; }
+
+        /// Replenishments merged into a previous one
+        unsigned long getCoalesced() const { return coalesced; }
+
+        /**
+           Enables the background mode: the server goes to
+           priority low on s, the scheduler of its kernel, when
+           its budget is exhausted.
+        */
+        void setBackground(Scheduler *s, int low);
+        bool inBackground() const { return background; }
+
+        void setInitBudget(Tick b) { init_budget = b; }
+        void setBudgetPolicy(budget_policy_t p) { budget_policy = p; }
+        budget_policy_t getBudgetPolicy() const { return budget_policy; }
         
         void newRun();
         void endRun();
@@ -58,7 +101,22 @@ namespace RTSim {
         void prepare_replenishment(const Tick &t);
         
         void check_repl();
-        
+
+    private:
+        int max_repl;
+        unsigned long coalesced;
+
+        Scheduler *bg_sched;
+        int bg_prio;
+        int fg_prio;
+        bool background;
+
+        Tick init_budget;
+        budget_policy_t budget_policy;
+
+        void enter_background();
+        /// back to the normal priority, without budget changes
+        void restore_priority();
     };
 }
 
@@ -20,6 +20,10 @@
 #include <strtoken.hpp>
 
 #include <abskernel.hpp>
+#include <cachemodel.hpp>
+#include <membus.hpp>
+#include <flightrec.hpp>
+#include <exeinstr.hpp>
 #include <instr.hpp>
 #include <task.hpp>
 
@@ -49,10 +53,13 @@ namespace RTSim {
 	  _lastSched(0),
 	  _dl(0), _rdl(rdl),
 	  feedback(NULL),
+	  _scaling(), _cache(NULL), _cacheDelay(0), _bus(NULL),
+	  _contention(1),
 	  arrEvt(this), endEvt(this), schedEvt(this),
 	  deschedEvt(this), fakeArrEvt(this), killEvt(this), 
 	  deadEvt(this, false, false)
     {
+        FlightRecorder::instance().setName(getID(), getName());
     }
     
     void Task::newRun(void)
@@ -62,6 +69,8 @@ namespace RTSim {
         } else throw EmptyTask();
         
 	state = TSK_IDLE;
+        _cacheDelay = 0;
+        _contention = 1;
         while (chkBuffArrival()) unbuffArrival();
         
         lastArrival = arrival = phase;
@@ -214,6 +223,19 @@ namespace RTSim {
         }
     }
     
+    double Task::getExecCycles() const
+    {
+        ConstInstrIterator last = instrQueue.end();
+        if (isActive()) last = ConstInstrIterator(actInstr) + 1;
+
+        double c = 0;
+        for (ConstInstrIterator i = instrQueue.begin(); i != last; ++i) {
+            const ExecInstr *e = dynamic_cast<const ExecInstr *>(*i);
+            if (e) c += e->getExecCycles();
+        }
+        return c;
+    }
+    
     Tick Task::getBuffArrival()
     {
         Tick time = arrQueue.front();
@@ -326,6 +348,8 @@ namespace RTSim {
                  << cpu_index);
         
         endEvt.setCPU(cpu_index);
+        if (_cache) _cache->onDeschedule(this, getCPU());
+        if (_bus) _bus->onDeschedule(this);
         _kernel->onEnd(this);
 	state = TSK_IDLE;
         
@@ -387,6 +411,8 @@ namespace RTSim {
                  << cpu_index);
         
         endEvt.setCPU(cpu_index);
+        if (_cache) _cache->onDeschedule(this, getCPU());
+        if (_bus) _bus->onDeschedule(this);
         _kernel->onEnd(this);
         state = TSK_IDLE;
         
@@ -428,6 +454,9 @@ namespace RTSim {
         
 	state = TSK_EXEC;
         
+        if (_cache) _cacheDelay += _cache->onSchedule(this, getCPU());
+        if (_bus) _bus->onSchedule(this, getCPU());
+
         (*actInstr)->schedule();
         
         // from Task ...
@@ -455,10 +484,26 @@ namespace RTSim {
         endEvt.drop();
         
         (*actInstr)->deschedule();
+        if (_cache) _cache->onDeschedule(this, getOldCPU());
+        if (_bus) _bus->onDeschedule(this);
         
 	state = TSK_READY;
     }
     
+    void Task::stall()
+    {
+        DBGENTER(_TASK_DBG_LEV);
+
+        if (isExecuting()) (*actInstr)->deschedule();
+    }
+
+    void Task::resume()
+    {
+        DBGENTER(_TASK_DBG_LEV);
+
+        if (isExecuting()) (*actInstr)->schedule();
+    }
+    
     void Task::onInstrEnd()
     {
         DBGENTER(_TASK_DBG_LEV);
@@ -507,6 +552,16 @@ namespace RTSim {
         arrEvt.post(t);
     }
     
+    Tick Task::getRemainingCost()
+    {
+        Tick c = 0;
+        for (InstrList::iterator i = actInstr; i != instrQueue.end(); ++i) {
+            ExecInstr *e = dynamic_cast<ExecInstr *>(*i);
+            if (e) c += e->getRemainingCost();
+        }
+        return c;
+    }
+
     Tick Task::getWCET() const
     {
         Tick tt = 0;
@@ -584,11 +639,32 @@ namespace RTSim {
         
         return _kernel->getOldProcessor(this);
     }
+
+    void Task::setContention(double f)
+    {
+        if (f == _contention) return;
+
+        double old = _contention;
+        _contention = f;
+        if (isExecuting()) {
+            // the instruction has progressed at the old rate up to now
+            double s = getCPU()->getSpeed();
+            (*actInstr)->refreshExec(s * old / f, s);
+        }
+    }
+
+    double Task::getScaling(CPU *c) const
+    {
+        map<string, double>::const_iterator i = _scaling.find(c->getType());
+        if (i != _scaling.end()) return i->second;
+        return c->getScaling();
+    }
     
     void Task::refreshExec(double oldSpeed, double newSpeed)
     {
         DBGENTER(_TASK_DBG_LEV);
-        (*actInstr)->refreshExec(oldSpeed, newSpeed);
+        if (isExecuting())
+            (*actInstr)->refreshExec(oldSpeed, newSpeed);
         
     }
     
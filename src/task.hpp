@@ -14,6 +14,9 @@
 #ifndef __TASK_HPP__
 #define __TASK_HPP__
 
+#include <map>
+#include <string>
+
 /* Headers from MetaSim */
 #include <entity.hpp>
 #include <gevent.hpp>
@@ -35,6 +38,8 @@ namespace RTSim {
     /* Forward declaration... */
     class Instr;
     class InstrExc;
+    class CacheDelayModel;
+    class MemoryBus;
 
     // Task states
     typedef enum { TSK_IDLE, TSK_READY, TSK_EXEC, TSK_BLOCKED } task_state;
@@ -99,6 +104,21 @@ namespace RTSim {
 
         AbstractFeedbackModule *feedback;
 
+        /// Execution time factors, per type of core
+        std::map<std::string, double> _scaling;
+
+        /// Cache-related delays
+        CacheDelayModel *_cache;
+
+        /// Delay not charged to an ExecInstr yet
+        double _cacheDelay;
+
+        /// Shared memory bus
+        MemoryBus *_bus;
+
+        /// Fraction of the speed left by the memory contention
+        double _contention;
+
     public:
         // Events need to be public to avoid an excessive fat interface.
         // Rhis is especially true when considering the probing mechanism
@@ -309,6 +329,18 @@ namespace RTSim {
         */ 
         void killInstance() throw(TaskNotActive, TaskNotExecuting);
 
+        /**
+            Busy wait: the task keeps executing on its processor, but
+            its current instruction stops progressing until resume()
+            (see MRTKernel::startSpin()). No event is generated, so
+            the kernel, the traces and the energy meters still see
+            the task running.
+        */
+        void stall();
+
+        /// The current instruction progresses again (see stall())
+        void resume();
+
         
         /**
             This method permits to select the behaviour of the task when a 
@@ -377,6 +409,17 @@ namespace RTSim {
         /** Returns the executed time of the last (or current) instance */
         Tick getExecTime() const;
 
+        /** Returns the work done by the last (or current) instance,
+            in ticks at full speed: unlike getExecTime(), it does not
+            depend on the speed changes during the instance. */
+        double getExecCycles() const;
+
+        /** Returns the actual execution time still needed by the
+            current instance, at full speed (the cost of the
+            instance at its arrival); the durations of the
+            instructions not yet started are drawn in advance. */
+        Tick getRemainingCost();
+
 	Tick getMinIAT() const { return Tick(int_time->getMinimum());}
 
         virtual Tick getLastSched() {return _lastSched;}
@@ -470,6 +513,57 @@ namespace RTSim {
         */
         CPU *getOldCPU() const;
 
+        /**
+            Sets the factor by which the execution time of this task
+            is multiplied on the cores of the given type (see
+            CPU::setType()). For example, a task that takes 1.8 times
+            longer on a LITTLE core than on a big core has
+            setScaling("LITTLE", 1.8).
+        */
+        void setScaling(const std::string &coreType, double factor)
+        {
+            _scaling[coreType] = factor;
+        }
+
+        /**
+            Returns the execution time factor of this task on the CPU
+            c: the one set for its type, or the default of the CPU.
+        */
+        double getScaling(CPU *c) const;
+
+        /**
+            Sets the model of the cache-related delays of this task
+            (see CacheDelayModel::addTask()).
+        */
+        void setCacheModel(CacheDelayModel *m) { _cache = m; }
+
+        /**
+            Returns the cache-related delay accumulated when the task
+            has been scheduled, and clears it. Called by the ExecInstr
+            that resumes, which adds it to its remaining execution.
+        */
+        double takeCacheDelay()
+        {
+            double d = _cacheDelay;
+            _cacheDelay = 0;
+            return d;
+        }
+
+        /**
+            Sets the memory bus of this task (see
+            MemoryBus::addTask()).
+        */
+        void setMemoryBus(MemoryBus *b) { _bus = b; }
+
+        /**
+            Sets the fraction of the speed of the CPU at which the
+            task progresses, because of the memory contention, and
+            moves the end of the executing instruction.
+        */
+        void setContention(double f);
+
+        double getContention() const { return _contention; }
+
         /** 
             Parse and insert instructions into this task. The input string
             must be a sequence of instructions separated by a
@@ -18,42 +18,60 @@
  */
 #include <task.hpp>
 #include <taskevt.hpp>
+#include <profiler.hpp>
+#include <flightrec.hpp>
 #include <cstdlib>
 
 namespace RTSim {
     
     void ArrEvt::doit()
     {
+        PROFILE_SCOPE("ArrEvt");
+        FLIGHTREC(FR_ARRIVAL, _task, 0, 0);
         _task->onArrival(this);
     }
     
     void EndEvt::doit()
     {
+        PROFILE_SCOPE("EndEvt");
+        FLIGHTREC(FR_END, _task, _task->getArrival(), 0);
         _task->onEndInstance(this);
     }
     
     void KillEvt::doit()
     {
+        PROFILE_SCOPE("KillEvt");
+        FLIGHTREC(FR_KILL, _task, 0, 0);
         _task->onKill(this);
     }
     
     void SchedEvt::doit()
     {
+        PROFILE_SCOPE("SchedEvt");
+        FLIGHTREC(FR_SCHED, _task, _cpu, 0);
         _task->onSched(this);
     }
     
     void DeschedEvt::doit()
     {
+        PROFILE_SCOPE("DeschedEvt");
+        FLIGHTREC(FR_DESCHED, _task, _cpu, 0);
         _task->onDesched(this);
     }
     
     void FakeArrEvt::doit()
     {
+        PROFILE_SCOPE("FakeArrEvt");
+        FLIGHTREC(FR_FAKE_ARRIVAL, _task, 0, 0);
         _task->onFakeArrival(this);
     }
     
     void DeadEvt::doit()
     {
+        PROFILE_SCOPE("DeadEvt");
+        FLIGHTREC(FR_DLINE_MISS, _task, _task->getDeadline(),
+                  _task->getArrival());
+        FlightRecorder::instance().onDeadlineMiss(_abort);
         if (_abort)
         {
             cout << "Simulation aborted!!!" << endl;
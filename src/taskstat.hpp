@@ -21,6 +21,7 @@
 #include <basestat.hpp>
 
 #include <task.hpp>
+#include <profiler.hpp>
 
 namespace RTSim {
 
@@ -60,6 +61,7 @@ namespace RTSim {
         PreemptionStat(string name = "") : Measure(name) {};
  
         void probe(const DeschedEvt &e) {
+            PROFILE_SCOPE("TaskStat::probe");
             if (e.getLastTime() != schedTime) {
                 descTime = e.getLastTime();
                 count ++;
@@ -69,6 +71,7 @@ namespace RTSim {
         }
 
         void probe(const SchedEvt &e) {
+            PROFILE_SCOPE("TaskStat::probe");
             if (e.getLastTime() != descTime) 
                 schedTime = e.getLastTime();
             else count --;
@@ -77,6 +80,7 @@ namespace RTSim {
         }
 
         void probe(const EndEvt &e) {
+            PROFILE_SCOPE("TaskStat::probe");
             Measure::record(count);
             count = 0;
         }
@@ -111,6 +115,7 @@ namespace RTSim {
 
         void probe(const SchedEvt &se)
             {
+                PROFILE_SCOPE("TaskStat::probe");
                 if (SIMUL.getTime() < _transitory) return;
                 if (se.getTime() == descTime && se.getTask()->getID() == idDesched)
                     record(-1);
@@ -118,6 +123,7 @@ namespace RTSim {
 
         void probe(const DeschedEvt &de)
             {
+                PROFILE_SCOPE("TaskStat::probe");
                 if (SIMUL.getTime() < _transitory) return;
                 descTime = SIMUL.getTime();
                 idDesched = de.getTask()->getID();
@@ -154,6 +160,7 @@ namespace RTSim {
 
         void probe(const EndEvt &ee) 
             {
+                PROFILE_SCOPE("TaskStat::probe");
                 if (ee.getLastTime() < Measure::_transitory) return;
                 Task *t = ee.getTask();
                 Measure::record(ee.getLastTime() - t->getLastArrival());
@@ -180,6 +187,7 @@ namespace RTSim {
 
         void probe(const EndEvt &ee)
             {
+                PROFILE_SCOPE("TaskStat::probe");
                 if (ee.getLastTime() < Measure::_transitory) return;
 
                 Task *t = ee.getTask();
@@ -212,6 +220,7 @@ namespace RTSim {
 
         void probe(const EndEvt &ee) 
             {
+                PROFILE_SCOPE("TaskStat::probe");
                 if (ee.getLastTime() < Measure::_transitory) return;
 
                 Task *t = (Task *)ee.getTask();
@@ -240,6 +249,7 @@ namespace RTSim {
     
         void probe(const EndEvt &ee)
             {
+                PROFILE_SCOPE("TaskStat::probe");
                 if (ee.getLastTime() < Measure::_transitory) return;
 
                 Task *t = (Task *)ee.getTask();
@@ -267,6 +277,7 @@ namespace RTSim {
 
         void probe(const EndEvt &ee)
             {
+                PROFILE_SCOPE("TaskStat::probe");
                 if (ee.getLastTime() < _transitory) return;
 
                 Task *task = (Task *) ee.getTask();
@@ -294,7 +305,10 @@ namespace RTSim {
     public:
         MissCount(string name = "") : StatCount(name) {};
 
-        void probe(const DeadEvt &e) {record(1.0);}
+        void probe(const DeadEvt &e) {
+            PROFILE_SCOPE("TaskStat::probe");
+            record(1.0);
+        }
 
         void attachToTask(Task *t) 
             {
@@ -322,6 +336,7 @@ namespace RTSim {
 
         virtual void probe(const MetaSim::GEvent<Timer> &e)
             {
+                PROFILE_SCOPE("TaskStat::probe");
                 Measure::record(cpu->getCurrentPowerConsumption() / 
                                 cpu->getMaxPowerConsumption());
             }
@@ -342,6 +357,7 @@ namespace RTSim {
 
         virtual void probe(const MetaSim::GEvent<Timer> &e)
             {
+                PROFILE_SCOPE("TaskStat::probe");
                 record(ConsumedPower<Measure>::cpu->getCurrentPowerSaving());
             }
 
@@ -0,0 +1,232 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+
+#include <strtoken.hpp>
+
+#include "tbserver.hpp"
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    TotalBandwidthServer::TotalBandwidthServer(double u, const std::string &name,
+                                               const std::string &s) :
+        Server(name, s),
+        Us(u),
+        last_dline(0),
+        dlines()
+    {
+        DBGENTER(_SERVER_DBG_LEV);
+        if (u <= 0 || u > 1)
+            throw ServerExc("Bandwidth out of (0, 1]", "TotalBandwidthServer");
+    }
+
+    TotalBandwidthServer *
+    TotalBandwidthServer::createInstance(vector<string> &par)
+    {
+        if (par.size() < 2)
+            throw parse_util::ParseExc("TotalBandwidthServer::createInstance",
+                                       "Wrong number of arguments");
+        double u = atof(par[0].c_str());
+        if (par.size() > 2) return new TotalBandwidthServer(u, par[1], par[2]);
+        return new TotalBandwidthServer(u, par[1]);
+    }
+
+    Tick TotalBandwidthServer::assignDeadline(Tick c)
+    {
+        Tick r = SIMUL.getTime();
+        return max(r, last_dline) + Tick::ceil(double(c) / Us);
+    }
+
+    void TotalBandwidthServer::onArrival(AbsRTTask *t)
+    {
+        DBGENTER(_SERVER_DBG_LEV);
+
+        Task *tt = dynamic_cast<Task *>(t);
+        Tick c = tt ? tt->getRemainingCost() : t->getMaxExecutionTime();
+
+        last_dline = assignDeadline(c);
+        dlines.push_back(last_dline);
+        DBGPRINT_4("Job of cost ", c, " gets deadline ", last_dline);
+
+        Server::onArrival(t);
+    }
+
+    void TotalBandwidthServer::onEnd(AbsRTTask *t)
+    {
+        DBGENTER(_SERVER_DBG_LEV);
+
+        dlines.pop_front();
+        Server::onEnd(t);
+
+        // the next job has a later deadline: EDF must see it
+        if (!dlines.empty() && dlines.front() != abs_dline)
+            updateDeadline();
+    }
+
+    void TotalBandwidthServer::updateDeadline()
+    {
+        DBGENTER(_SERVER_DBG_LEV);
+
+        // no more dispatching until the kernel schedules the server
+        if (status == EXECUTING) {
+            _dispatchEvt.drop();
+            executing_ready();
+        }
+        kernel->suspend(this);
+        kernelDispatch();
+
+        setAbsDead(dlines.front());
+        DBGPRINT_2("New deadline ", abs_dline);
+        kernel->onArrival(this);
+    }
+
+    void TotalBandwidthServer::newRun()
+    {
+        Server::newRun();
+        last_dline = 0;
+        dlines.clear();
+    }
+
+    void TotalBandwidthServer::endRun()
+    {
+    }
+
+    void TotalBandwidthServer::idle_ready()
+    {
+        DBGENTER(_SERVER_DBG_LEV);
+        assert(status == IDLE);
+        status = READY;
+        setAbsDead(dlines.front());
+    }
+
+    void TotalBandwidthServer::releasing_ready()
+    {
+        assert(false); // never releasing: the deadlines keep the lag
+    }
+
+    void TotalBandwidthServer::ready_executing()
+    {
+        status = EXECUTING;
+    }
+
+    void TotalBandwidthServer::executing_ready()
+    {
+        status = READY;
+    }
+
+    void TotalBandwidthServer::executing_releasing()
+    {
+        status = IDLE;
+    }
+
+    void TotalBandwidthServer::releasing_idle()
+    {
+        assert(false); // never releasing: the deadlines keep the lag
+    }
+
+    void TotalBandwidthServer::executing_recharging()
+    {
+        assert(false); // never recharging: there is no budget
+    }
+
+    void TotalBandwidthServer::recharging_ready()
+    {
+        status = READY;
+    }
+
+    void TotalBandwidthServer::recharging_idle()
+    {
+        status = IDLE;
+    }
+
+    /*----------------------------------------------------*/
+
+    TBStarServer::TBStarServer(double u, const std::string &name,
+                               const std::string &s, int iterations) :
+        TotalBandwidthServer(u, name, s),
+        periodic(),
+        max_iter(iterations)
+    {
+    }
+
+    TBStarServer *TBStarServer::createInstance(vector<string> &par)
+    {
+        if (par.size() < 2)
+            throw parse_util::ParseExc("TBStarServer::createInstance",
+                                       "Wrong number of arguments");
+        double u = atof(par[0].c_str());
+        int it = par.size() > 2 ? atoi(par[2].c_str()) : 0;
+        if (par.size() > 3) return new TBStarServer(u, par[1], par[3], it);
+        return new TBStarServer(u, par[1], "FIFOSched", it);
+    }
+
+    Tick TBStarServer::interference(Tick r, Tick d)
+    {
+        Tick i = 0;
+        for (unsigned k = 0; k < periodic.size(); ++k) {
+            PeriodicTask *p = periodic[k];
+            long long T = (long long)p->getPeriod();
+            long long D = (long long)p->getRelDline();
+
+            // the active job, and the next releases
+            long long next;
+            if (p->isActive()) {
+                if (p->getDeadline() <= d) i += p->getRemainingCost();
+                next = (long long)p->getArrival() + T;
+            }
+            else {
+                long long ph = (long long)p->getPhase();
+                long long t = (long long)r;
+                next = t <= ph ? ph : ph + (t - ph + T - 1) / T * T;
+            }
+
+            for (long long s = next; s < (long long)d; s += T)
+                if (s + D <= (long long)d) i += p->getWCET();
+        }
+        return i;
+    }
+
+    Tick TBStarServer::backlog()
+    {
+        Tick b = 0;
+        for (unsigned k = 0; k < tasks.size(); ++k) {
+            Task *t = dynamic_cast<Task *>(tasks[k]);
+            if (t && t->isActive()) b += t->getRemainingCost();
+        }
+        return b;
+    }
+
+    Tick TBStarServer::assignDeadline(Tick c)
+    {
+        Tick r = SIMUL.getTime();
+        Tick d = TotalBandwidthServer::assignDeadline(c);
+
+        // the job just arrived is already active
+        Tick a = backlog() - c;
+        if (a < 0) a = 0;
+
+        for (int k = 0; max_iter == 0 || k < max_iter; ++k) {
+            // finishing time under EDF with deadline d
+            Tick f = r + c + a + interference(r, d);
+            DBGPRINT_4("TB* iteration: d = ", d, " f = ", f);
+            if (f >= d) break;
+            d = f;
+        }
+        return d;
+    }
+}
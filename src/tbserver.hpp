@@ -0,0 +1,165 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __TBSERVER_HPP__
+#define __TBSERVER_HPP__
+
+#include <deque>
+#include <vector>
+
+#include <rttask.hpp>
+#include <server.hpp>
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    /**
+        @ingroup server
+
+        Total Bandwidth Server (Spuri and Buttazzo, 1996), for EDF
+        kernels: the k-th job that arrives at r_k gets the deadline
+
+            d_k = max(r_k, d_{k-1}) + C_k / U_s
+
+        where C_k is the actual execution time of the job, taken from
+        its ExecInstrs at its arrival (see Task::getRemainingCost()),
+        and U_s the bandwidth of the server. The jobs are served in
+        order of arrival, and the deadline of the server is the one
+        of the job it is serving. There is no budget: the bandwidth
+        is guaranteed by the deadlines.
+    */
+    class TotalBandwidthServer : public Server {
+    protected:
+        double Us;
+
+        /// Deadline of the last job that arrived
+        Tick last_dline;
+
+        /// Deadlines of the jobs in the server
+        std::deque<Tick> dlines;
+
+        /// Deadline of a job of cost c arriving now
+        virtual Tick assignDeadline(Tick c);
+
+        /**
+           The server takes the deadline of the next job: it is
+           suspended and inserted again in the kernel, so that EDF
+           sees the new deadline.
+        */
+        void updateDeadline();
+
+    public:
+        TotalBandwidthServer(double u, const std::string &name,
+                             const std::string &sched = "FIFOSched");
+
+        /// Parameters: bandwidth, name[, scheduler]
+        static TotalBandwidthServer *createInstance(vector<string> &par);
+
+        double getBandwidth() const { return Us; }
+
+        /// No budget: returns 0
+        virtual Tick getBudget() const { return 0; }
+        /// No period: returns 0
+        virtual Tick getPeriod() const { return 0; }
+
+        /// No budget: nothing changes
+        Tick changeBudget(const Tick &n) { return SIMUL.getTime(); }
+
+        /// The deadline of the last job that arrived
+        virtual double getVirtualTime() { return double(last_dline); }
+
+        void onArrival(AbsRTTask *t);
+        void onEnd(AbsRTTask *t);
+
+        void newRun();
+        void endRun();
+
+    protected:
+
+        /// from idle to active contending (new work to do)
+        virtual void idle_ready();
+
+        /// from active non contending to active contending (more work)
+        virtual void releasing_ready();
+
+        /// from active contending to executing (dispatching)
+        virtual void ready_executing();
+
+        /// from executing to active contenting (preemption)
+        virtual void executing_ready();
+
+        /// from executing to active non contending (no more work)
+        virtual void executing_releasing();
+
+        /// from active non contending to idle (no lag)
+        virtual void releasing_idle();
+
+        /// never recharging: there is no budget to exhaust
+        virtual void executing_recharging();
+
+        /// from recharging to active contending (budget recharged)
+        virtual void recharging_ready();
+
+        /// from recharging to idle (nothing remains to be done)
+        virtual void recharging_idle();
+    };
+
+    /**
+        @ingroup server
+
+        TB* (Buttazzo and Sensini, 1999): the optimal version of the
+        TBS. Starting from the deadline of the TBS, the deadline d of
+        a job arrived at r_k is shortened iteratively to the finishing
+        time that the job would have under EDF with that deadline,
+
+            d = r_k + C_k + I_a(r_k) + I_p(r_k, d)
+
+        where I_a(r_k) is the remaining execution of the jobs already
+        in the server, which have earlier deadlines, and I_p(r_k, d)
+        is the interference of the periodic tasks: the remaining
+        execution of their active jobs with deadline before d, and the
+        WCETs of their future jobs released and with deadline before
+        d. The iterations stop when the deadline does not change, or
+        after the given maximum (0 for no maximum).
+
+        As in the TBS, the cost of the aperiodic jobs is their
+        remaining execution, not a WCET: the deadline is the exact
+        finishing time only when the jobs execute what they declare.
+
+        The periodic tasks of the kernel must be registered with
+        addPeriodicTask().
+    */
+    class TBStarServer : public TotalBandwidthServer {
+        std::vector<PeriodicTask *> periodic;
+        int max_iter;
+
+        Tick interference(Tick r, Tick d);
+        Tick backlog();
+
+    protected:
+        virtual Tick assignDeadline(Tick c);
+
+    public:
+        TBStarServer(double u, const std::string &name,
+                     const std::string &sched = "FIFOSched",
+                     int iterations = 0);
+
+        /// Parameters: bandwidth, name[, iterations[, scheduler]]
+        static TBStarServer *createInstance(vector<string> &par);
+
+        void addPeriodicTask(PeriodicTask *t) { periodic.push_back(t); }
+    };
+}
+
+#endif
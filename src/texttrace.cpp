@@ -1,10 +1,11 @@
 #include <texttrace.hpp>
+#include <profiler.hpp>
 
 namespace RTSim {
         using namespace std;
         using namespace MetaSim;
 
-        TextTrace::TextTrace(const string& name)
+        TextTrace::TextTrace(const string& name) : _filter(0)
 		{
 
             fd.open(name.c_str());
@@ -19,80 +20,168 @@ namespace RTSim {
 
 		void TextTrace::probe(ArrEvt& e)
 		{
+			PROFILE_SCOPE("TextTrace::probe");
 			Task* tt = e.getTask();
-            fd << "[Time:" << SIMUL.getTime() << "]\t";  
+			TraceRecord r = traceRecord(FR_ARRIVAL, tt, e.getCPU(),
+			                            tt->getArrival());
+			TRACE_WRITE(TextTrace, writeArrival, r);
+		}
+
+		void TextTrace::writeArrival(const TraceRecord &r)
+		{
+			const Task* tt = static_cast<const Task*>(r.obj);
+            fd << "[Time:" << r.time << "]\t";  
             fd << tt->getName() << " arrived at " 
-            << tt->getArrival() << endl;                
+            << r.arg1 << endl;                
 		}
 
 		void TextTrace::probe(EndEvt& e)
 		{
+			PROFILE_SCOPE("TextTrace::probe");
 			Task* tt = e.getTask();
-			fd << "[Time:" << SIMUL.getTime() << "]\t";
+			TraceRecord r = traceRecord(FR_END, tt, e.getCPU(),
+			                            tt->getArrival());
+			TRACE_WRITE(TextTrace, writeEnd, r);
+		}
+
+		void TextTrace::writeEnd(const TraceRecord &r)
+		{
+			const Task* tt = static_cast<const Task*>(r.obj);
+			fd << "[Time:" << r.time << "]\t";
 			fd << tt->getName()<<" ended, its arrival was " 
-				<< tt->getArrival() << endl;
+				<< r.arg1 << endl;
 		}
 
 		void TextTrace::probe(SchedEvt& e)
 		{
+			PROFILE_SCOPE("TextTrace::probe");
 			Task* tt = e.getTask();
-			fd << "[Time:" << SIMUL.getTime() << "]\t";  
-			fd << tt->getName()<<" scheduled on CPU #"<< e.getCPU() <<"; its arrival was " 
-				<< tt->getArrival() << endl; 
+			TraceRecord r = traceRecord(FR_SCHED, tt, e.getCPU(),
+			                            tt->getArrival());
+			TRACE_WRITE(TextTrace, writeSched, r);
+		}
+
+		void TextTrace::writeSched(const TraceRecord &r)
+		{
+			const Task* tt = static_cast<const Task*>(r.obj);
+			fd << "[Time:" << r.time << "]\t";  
+			fd << tt->getName()<<" scheduled on CPU #"<< r.cpu <<"; its arrival was " 
+				<< r.arg1 << endl; 
 		}
 
 		void TextTrace::probe(DeschedEvt& e)
 		{
+			PROFILE_SCOPE("TextTrace::probe");
 			Task* tt = e.getTask();
-			fd << "[Time:" << SIMUL.getTime() << "]\t";  
-			fd << tt->getName()<<" descheduled from CPU #"<< e.getCPU() <<";its arrival was " 
-				<< tt->getArrival() << endl;
+			TraceRecord r = traceRecord(FR_DESCHED, tt, e.getCPU(),
+			                            tt->getArrival());
+			TRACE_WRITE(TextTrace, writeDesched, r);
+		}
+
+		void TextTrace::writeDesched(const TraceRecord &r)
+		{
+			const Task* tt = static_cast<const Task*>(r.obj);
+			fd << "[Time:" << r.time << "]\t";  
+			fd << tt->getName()<<" descheduled from CPU #"<< r.cpu <<";its arrival was " 
+				<< r.arg1 << endl;
 		}
 
 		void TextTrace::probe(DeadEvt& e)
 		{
+			PROFILE_SCOPE("TextTrace::probe");
 			Task* tt = e.getTask();
-			fd << "[Time:" << SIMUL.getTime() << "]\t";  
+			TraceRecord r = traceRecord(FR_DLINE_MISS, tt, e.getCPU(),
+			                            tt->getArrival());
+			TRACE_WRITE(TextTrace, writeDeadline, r);
+		}
+
+		void TextTrace::writeDeadline(const TraceRecord &r)
+		{
+			const Task* tt = static_cast<const Task*>(r.obj);
+			fd << "[Time:" << r.time << "]\t";  
 			fd << tt->getName()<<" missed its arrival was " 
-               << tt->getArrival() << endl;
+               << r.arg1 << endl;
         }
 
         void TextTrace::probe(ServerBudgetExhaustedEvt &e)
         {
-            Server* s = e.getServer();
-            fd << "[Time:" << SIMUL.getTime() << "]\t";
+            PROFILE_SCOPE("TextTrace::probe");
+            TraceRecord r = traceRecord(FR_SRV_EXHAUSTED, e.getServer(),
+                                        e.getCPU());
+            TRACE_WRITE(TextTrace, writeBudgetExhausted, r);
+        }
+
+        void TextTrace::writeBudgetExhausted(const TraceRecord &r)
+        {
+            const Server* s = static_cast<const Server*>(r.obj);
+            fd << "[Time:" << r.time << "]\t";
             fd << s->getName() <<" exhausts the budget " << endl;
         }
 
         void TextTrace::probe(ServerRechargingEvt &e)
         {
-            Server* s = e.getServer();
-            fd << "[Time:" << SIMUL.getTime() << "]\t";
+            PROFILE_SCOPE("TextTrace::probe");
+            TraceRecord r = traceRecord(FR_SRV_RECHARGING, e.getServer(),
+                                        e.getCPU());
+            TRACE_WRITE(TextTrace, writeRecharging, r);
+        }
+
+        void TextTrace::writeRecharging(const TraceRecord &r)
+        {
+            const Server* s = static_cast<const Server*>(r.obj);
+            fd << "[Time:" << r.time << "]\t";
             fd << s->getName() <<" recharges its budget" << endl;
         }
 
         void TextTrace::probe(ServerScheduledEvt &e)
         {
+            PROFILE_SCOPE("TextTrace::probe");
             Server* s = e.getServer();
-            fd << "[Time:" << SIMUL.getTime() << "]\t";
-            fd << s->getName() <<" scheduled on CPU #"<< e.getCPU() <<"; its arrival was "
-               << s->getArrival() << endl;
+            TraceRecord r = traceRecord(FR_SRV_SCHED, s, e.getCPU(),
+                                        s->getArrival());
+            TRACE_WRITE(TextTrace, writeServerSched, r);
+        }
+
+        void TextTrace::writeServerSched(const TraceRecord &r)
+        {
+            const Server* s = static_cast<const Server*>(r.obj);
+            fd << "[Time:" << r.time << "]\t";
+            fd << s->getName() <<" scheduled on CPU #"<< r.cpu <<"; its arrival was "
+               << r.arg1 << endl;
         }
 
         void TextTrace::probe(ServerDescheduledEvt &e)
         {
+            PROFILE_SCOPE("TextTrace::probe");
             Server* s = e.getServer();
-            fd << "[Time:" << SIMUL.getTime() << "]\t";
-            fd << s->getName() <<" descheduled from CPU #"<< e.getCPU() <<"; its arrival was "
-               << s->getArrival() << endl;
+            TraceRecord r = traceRecord(FR_SRV_DESCHED, s, e.getCPU(),
+                                        s->getArrival());
+            TRACE_WRITE(TextTrace, writeServerDesched, r);
+        }
+
+        void TextTrace::writeServerDesched(const TraceRecord &r)
+        {
+            const Server* s = static_cast<const Server*>(r.obj);
+            fd << "[Time:" << r.time << "]\t";
+            fd << s->getName() <<" descheduled from CPU #"<< r.cpu <<"; its arrival was "
+               << r.arg1 << endl;
         }
 
         void TextTrace::probe(ServerReplenishmentEvt &e)
         {
+            PROFILE_SCOPE("TextTrace::probe");
             ReplenishmentServer* s = e.getServer();
-            fd << "[Time:" << SIMUL.getTime() << "]\t";
+            TraceRecord r = traceRecord(FR_SRV_REPLENISH, s, e.getCPU(),
+                                        s->getCurrentBudget(), s->getBudget());
+            TRACE_WRITE(TextTrace, writeReplenishment, r);
+        }
+
+        void TextTrace::writeReplenishment(const TraceRecord &r)
+        {
+            const Server* s = static_cast<const Server*>(r.obj);
+            fd << "[Time:" << r.time << "]\t";
             fd << s->getName() <<" has a replenishment; The current budget is "
-               << s->getCurrentBudget() << "(the total is " << s->getBudget() << ")"
+               << r.arg1 << "(the total is " << r.arg2 << ")"
                <<endl;
         }
 
@@ -120,7 +209,7 @@ namespace RTSim {
             attachToServer(VM->getImplementation());
         }
     
-        VirtualTrace::VirtualTrace(map<string, int> *r)
+        VirtualTrace::VirtualTrace(map<string, int> *r) : _filter(0)
         {
             results = r;
         }
@@ -132,8 +221,17 @@ namespace RTSim {
     
         void VirtualTrace::probe(EndEvt& e)
         {
+            PROFILE_SCOPE("VirtualTrace::probe");
             Task* tt = e.getTask();
-            auto tmp_wcrt = SIMUL.getTime() - tt->getArrival();
+            TraceRecord r = traceRecord(FR_END, tt, e.getCPU(),
+                                        tt->getArrival());
+            TRACE_WRITE(VirtualTrace, writeEnd, r);
+        }
+
+        void VirtualTrace::writeEnd(const TraceRecord &r)
+        {
+            const Task* tt = static_cast<const Task*>(r.obj);
+            auto tmp_wcrt = r.time - Tick(r.arg1);
             
             if ((*results)[tt->getName()] < tmp_wcrt)
             {
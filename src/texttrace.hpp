@@ -23,6 +23,7 @@
 #include <event.hpp>
 #include <particle.hpp>
 #include <trace.hpp>
+#include <tracefilter.hpp>
 
 #include <rttask.hpp>
 #include <taskevt.hpp>
@@ -38,10 +39,25 @@ namespace RTSim {
     class TextTrace {
     protected:
         ofstream fd;
+        TraceFilter *_filter;
+
+        void writeArrival(const TraceRecord &r);
+        void writeEnd(const TraceRecord &r);
+        void writeSched(const TraceRecord &r);
+        void writeDesched(const TraceRecord &r);
+        void writeDeadline(const TraceRecord &r);
+        void writeBudgetExhausted(const TraceRecord &r);
+        void writeRecharging(const TraceRecord &r);
+        void writeServerSched(const TraceRecord &r);
+        void writeServerDesched(const TraceRecord &r);
+        void writeReplenishment(const TraceRecord &r);
     public:
         TextTrace(const string& name);
         
         ~TextTrace();
+
+        /// Filters the traced events (null: no filter)
+        void setFilter(TraceFilter *f) { _filter = f; }
         
         void probe(ArrEvt& e);
         
@@ -73,11 +89,17 @@ namespace RTSim {
     
     class VirtualTrace {
         map<string, int> *results;
+        TraceFilter *_filter;
+
+        void writeEnd(const TraceRecord &r);
     public:
         
         VirtualTrace(map<string, int> *r);
         
         ~VirtualTrace();
+
+        /// Filters the traced events (null: no filter)
+        void setFilter(TraceFilter *f) { _filter = f; }
         
         void probe(EndEvt& e);
         
@@ -0,0 +1,367 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <algorithm>
+#include <cassert>
+#include <sstream>
+
+#include <strtoken.hpp>
+
+#include "timepartitionvm.hpp"
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    PartitionServer::PartitionServer(const std::string &name, Tick frame,
+                                     const std::string &s) :
+        Server(name, s),
+        _frame(frame),
+        _windows(),
+        _inWindow(false),
+        _cur(0),
+        _frameStart(0),
+        _jobs(0),
+        _minResp(0),
+        _maxResp(0),
+        _sumResp(0),
+        _overheadTime(0),
+        _stats(),
+        _winStartEvt(this, &PartitionServer::onWindowStart,
+                     Event::_DEFAULT_PRIORITY - 1),
+        _winEndEvt(this, &PartitionServer::onWindowEnd,
+                   Event::_DEFAULT_PRIORITY + 4)
+    {
+        DBGENTER(_SERVER_DBG_LEV);
+        dline = frame;
+    }
+
+    void PartitionServer::addWindow(Tick start, Tick end, Tick overhead)
+    {
+        Window w = {start, end, overhead};
+        _windows.push_back(w);
+    }
+
+    Tick PartitionServer::getBudget() const
+    {
+        Tick b = 0;
+        for (unsigned i = 0; i < _windows.size(); ++i)
+            b += _windows[i].end - _windows[i].start - _windows[i].overhead;
+        return b;
+    }
+
+    double PartitionServer::getMeanResponseTime() const
+    {
+        return _jobs ? _sumResp / _jobs : 0;
+    }
+
+    void PartitionServer::postWindowStart()
+    {
+        const Window &w = _windows[_cur];
+        _winStartEvt.post(_frameStart + w.start + w.overhead);
+    }
+
+    void PartitionServer::onArrival(AbsRTTask *t)
+    {
+        DBGENTER(_SERVER_DBG_LEV);
+
+        if (status == IDLE && !_inWindow) {
+            // wait for the next window
+            sched_->insert(t);
+            status = RECHARGING;
+        }
+        else Server::onArrival(t);
+    }
+
+    void PartitionServer::onEnd(AbsRTTask *t)
+    {
+        DBGENTER(_SERVER_DBG_LEV);
+
+        Tick r = SIMUL.getTime() - t->getArrival();
+        if (_jobs == 0 || r < _minResp) _minResp = r;
+        if (r > _maxResp) _maxResp = r;
+        _sumResp += double(r);
+        _jobs++;
+        for (unsigned i = 0; i < _stats.size(); ++i)
+            _stats[i]->record(double(r));
+
+        Server::onEnd(t);
+    }
+
+    void PartitionServer::onWindowStart(Event *e)
+    {
+        DBGENTER(_SERVER_DBG_LEV);
+
+        const Window &w = _windows[_cur];
+        Tick end = _frameStart + w.end;
+
+        _inWindow = true;
+        _overheadTime += w.overhead;
+        setAbsDead(end);
+        _winEndEvt.post(end);
+
+        if (status == RECHARGING) onRecharging(e);
+        DBGPRINT_2("Status is now ", status_string[status]);
+    }
+
+    void PartitionServer::onWindowEnd(Event *e)
+    {
+        DBGENTER(_SERVER_DBG_LEV);
+
+        _inWindow = false;
+        if (++_cur == _windows.size()) {
+            _cur = 0;
+            _frameStart += _frame;
+        }
+        postWindowStart();
+
+        if (status == EXECUTING) {
+            _bandExEvt.drop();
+            onBudgetExhausted(e);
+        }
+        else if (status == READY) {
+            // not dispatched in time: it leaves the ready queue
+            kernel->suspend(this);
+            kernelDispatch();
+            status = RECHARGING;
+        }
+        DBGPRINT_2("Status is now ", status_string[status]);
+    }
+
+    void PartitionServer::newRun()
+    {
+        Server::newRun();
+        _inWindow = false;
+        _cur = 0;
+        _frameStart = 0;
+        _jobs = 0;
+        _minResp = 0;
+        _maxResp = 0;
+        _sumResp = 0;
+        _overheadTime = 0;
+        _winStartEvt.drop();
+        _winEndEvt.drop();
+        if (!_windows.empty()) postWindowStart();
+    }
+
+    void PartitionServer::endRun()
+    {
+        _winStartEvt.drop();
+        _winEndEvt.drop();
+    }
+
+    void PartitionServer::idle_ready()
+    {
+        DBGENTER(_SERVER_DBG_LEV);
+        assert(status == IDLE && _inWindow);
+        status = READY;
+    }
+
+    void PartitionServer::releasing_ready()
+    {
+        assert(false); // never releasing: no lag to wait for
+    }
+
+    void PartitionServer::ready_executing()
+    {
+        status = EXECUTING;
+    }
+
+    void PartitionServer::executing_ready()
+    {
+        status = READY;
+    }
+
+    void PartitionServer::executing_releasing()
+    {
+        status = IDLE;
+    }
+
+    void PartitionServer::releasing_idle()
+    {
+        assert(false); // never releasing: no lag to wait for
+    }
+
+    void PartitionServer::executing_recharging()
+    {
+        status = RECHARGING;
+    }
+
+    void PartitionServer::recharging_ready()
+    {
+        status = READY;
+    }
+
+    void PartitionServer::recharging_idle()
+    {
+        status = IDLE;
+    }
+
+    /*----------------------------------------------------*/
+
+    TimePartitionVM::TimePartitionVM(const std::string &name, Tick frame,
+                                     Tick overhead) :
+        _frame(frame),
+        _overhead(overhead),
+        _table(),
+        _partitions(),
+        _cpus(),
+        _valid(false)
+    {
+        setName(name);
+        if (frame <= 0)
+            throw TimePartitionExc("The major frame must be positive");
+    }
+
+    TimePartitionVM::~TimePartitionVM()
+    {
+        std::map<std::string, PartitionServer *>::iterator i;
+        for (i = _partitions.begin(); i != _partitions.end(); ++i)
+            delete i->second;
+    }
+
+    PartitionServer *TimePartitionVM::addPartition(const std::string &name,
+                                                   const std::string &sched)
+    {
+        if (_partitions.count(name))
+            throw TimePartitionExc("Partition " + name + " already defined");
+
+        PartitionServer *p = new PartitionServer(getName() + "." + name,
+                                                 _frame, sched);
+        _partitions[name] = p;
+        _valid = false;
+        return p;
+    }
+
+    void TimePartitionVM::addWindow(int cpu, Tick offset, Tick length,
+                                    const std::string &partition)
+    {
+        Entry e = {cpu, offset, length, partition};
+        _table.push_back(e);
+        _valid = false;
+    }
+
+    static bool entryBefore(const TimePartitionVM::Entry &a,
+                            const TimePartitionVM::Entry &b)
+    {
+        if (a.cpu != b.cpu) return a.cpu < b.cpu;
+        return a.offset < b.offset;
+    }
+
+    void TimePartitionVM::validate()
+    {
+        if (_valid) return;
+
+        std::vector<Entry> t(_table);
+        std::sort(t.begin(), t.end(), entryBefore);
+
+        _cpus.clear();
+        for (unsigned i = 0; i < t.size(); ++i) {
+            std::stringstream w;
+            w << "Window (" << t[i].cpu << ", " << t[i].offset << ", "
+              << t[i].length << ", " << t[i].partition << "): ";
+
+            if (!_partitions.count(t[i].partition))
+                throw TimePartitionExc(w.str() + "unknown partition");
+            if (t[i].cpu < 0)
+                throw TimePartitionExc(w.str() + "negative CPU");
+            if (t[i].offset < 0 || t[i].length <= 0 ||
+                t[i].offset + t[i].length > _frame)
+                throw TimePartitionExc(w.str() + "not in the major frame");
+            if (i > 0 && t[i - 1].cpu == t[i].cpu &&
+                t[i - 1].offset + t[i - 1].length > t[i].offset)
+                throw TimePartitionExc(w.str() + "overlaps with the previous one");
+
+            std::map<std::string, int>::iterator c = _cpus.find(t[i].partition);
+            if (c == _cpus.end()) _cpus[t[i].partition] = t[i].cpu;
+            else if (c->second != t[i].cpu)
+                throw TimePartitionExc(w.str() + "partition on more than one CPU");
+        }
+
+        // the windows of every CPU, with the switch overheads
+        std::map<std::string, std::vector<PartitionServer::Window> > ws;
+        unsigned first = 0;
+        while (first < t.size()) {
+            unsigned last = first;
+            while (last + 1 < t.size() && t[last + 1].cpu == t[first].cpu)
+                ++last;
+
+            for (unsigned i = first; i <= last; ++i) {
+                const Entry &prev = t[i == first ? last : i - 1];
+                Tick prev_end = prev.offset + prev.length;
+                if (i == first) prev_end -= _frame;
+                bool same = prev.partition == t[i].partition &&
+                    prev_end == t[i].offset;
+
+                std::vector<PartitionServer::Window> &v = ws[t[i].partition];
+                if (same && i != first) {
+                    // adjacent windows of the same partition are one window
+                    v.back().end = t[i].offset + t[i].length;
+                    continue;
+                }
+
+                Tick o = same ? Tick(0) : _overhead;
+                if (t[i].length <= o) {
+                    std::stringstream w;
+                    w << "Window (" << t[i].cpu << ", " << t[i].offset << ", "
+                      << t[i].length << ", " << t[i].partition
+                      << "): not longer than the switch overhead";
+                    throw TimePartitionExc(w.str());
+                }
+                PartitionServer::Window x = {t[i].offset,
+                                             t[i].offset + t[i].length, o};
+                v.push_back(x);
+            }
+            first = last + 1;
+        }
+
+        std::map<std::string, PartitionServer *>::iterator p;
+        for (p = _partitions.begin(); p != _partitions.end(); ++p) {
+            if (!_cpus.count(p->first))
+                throw TimePartitionExc("Partition " + p->first + " has no windows");
+            p->second->clearWindows();
+            std::vector<PartitionServer::Window> &v = ws[p->first];
+            for (unsigned i = 0; i < v.size(); ++i)
+                p->second->addWindow(v[i].start, v[i].end, v[i].overhead);
+        }
+
+        _valid = true;
+    }
+
+    PartitionServer *TimePartitionVM::getPartition(const std::string &name) const
+    {
+        std::map<std::string, PartitionServer *>::const_iterator i =
+            _partitions.find(name);
+        return i == _partitions.end() ? NULL : i->second;
+    }
+
+    int TimePartitionVM::getCPU(const std::string &partition) const
+    {
+        std::map<std::string, int>::const_iterator i = _cpus.find(partition);
+        if (i == _cpus.end())
+            throw TimePartitionExc("Partition " + partition + " has no CPU");
+        return i->second;
+    }
+
+    void TimePartitionVM::addTask(AbsRTTask &task, const string &params)
+    {
+        std::string name = parse_util::get_token(params);
+        std::string p;
+        if (params.find('(') != std::string::npos)
+            p = parse_util::get_param(params);
+
+        PartitionServer *s = getPartition(name);
+        if (!s) throw TimePartitionExc("Unknown partition " + name);
+        s->addTask(task, p);
+    }
+}
@@ -0,0 +1,240 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __TIMEPARTITIONVM_HPP__
+#define __TIMEPARTITIONVM_HPP__
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <basestat.hpp>
+#include <gevent.hpp>
+
+#include <server.hpp>
+#include <virtualmachine.hpp>
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    /**
+       Exception thrown by TimePartitionVM when the schedule table is
+       not well formed.
+    */
+    class TimePartitionExc : public BaseExc {
+    public:
+        TimePartitionExc(const string &msg) :
+            BaseExc(msg, "TimePartitionVM", "timepartitionvm.cpp") {}
+    };
+
+    /**
+        @ingroup server
+
+        A partition of a TimePartitionVM: a server that can execute
+        only inside its windows of the major frame, and is not
+        eligible outside of them. The tasks of the partition are
+        scheduled by its own inner scheduler. The deadline of the
+        server is the end of the current window.
+
+        The server also measures the response times of the jobs of
+        its tasks; the jitter is the difference between the largest
+        and the smallest response time.
+
+        The windows are set by the TimePartitionVM from its schedule
+        table, so this class is not meant to be used alone.
+    */
+    class PartitionServer : public Server {
+    public:
+        /// A window: [start, end) within the major frame
+        struct Window {
+            Tick start;
+            Tick end;
+            /// Switch overhead at the beginning of the window
+            Tick overhead;
+        };
+
+    private:
+        Tick _frame;
+        std::vector<Window> _windows;
+
+        bool _inWindow;
+        unsigned _cur;
+        Tick _frameStart;
+
+        unsigned long _jobs;
+        Tick _minResp;
+        Tick _maxResp;
+        double _sumResp;
+        Tick _overheadTime;
+        std::vector<BaseStat *> _stats;
+
+        void postWindowStart();
+
+    public:
+        GEvent<PartitionServer> _winStartEvt;
+        GEvent<PartitionServer> _winEndEvt;
+
+        PartitionServer(const std::string &name, Tick frame,
+                        const std::string &sched = "FIFOSched");
+
+        /// Adds a window; the windows must be added in order
+        void addWindow(Tick start, Tick end, Tick overhead);
+        void clearWindows() { _windows.clear(); }
+        const std::vector<Window> &getWindows() const { return _windows; }
+
+        bool isInWindow() const { return _inWindow; }
+
+        /// The time of the major frame reserved to the partition
+        virtual Tick getBudget() const;
+        /// The major frame
+        virtual Tick getPeriod() const { return _frame; }
+
+        /// The schedule table is static: nothing changes
+        Tick changeBudget(const Tick &n) { return SIMUL.getTime(); }
+
+        virtual double getVirtualTime() { return double(SIMUL.getTime()); }
+
+        void onArrival(AbsRTTask *t);
+        void onEnd(AbsRTTask *t);
+
+        void onWindowStart(Event *e);
+        void onWindowEnd(Event *e);
+
+        unsigned long getJobs() const { return _jobs; }
+        Tick getMaxResponseTime() const { return _maxResp; }
+        Tick getMinResponseTime() const { return _minResp; }
+        double getMeanResponseTime() const;
+        /// Largest minus smallest response time
+        Tick getJitter() const { return _jobs ? _maxResp - _minResp : Tick(0); }
+        /// Time lost in partition switches so far
+        Tick getOverheadTime() const { return _overheadTime; }
+
+        /// Records every response time also on s
+        void addResponseTimeStat(BaseStat *s) { _stats.push_back(s); }
+
+        void newRun();
+        void endRun();
+
+    protected:
+
+        /// from idle to active contending (new work to do)
+        virtual void idle_ready();
+
+        /// from active non contending to active contending (more work)
+        virtual void releasing_ready();
+
+        /// from active contending to executing (dispatching)
+        virtual void ready_executing();
+
+        /// from executing to active contenting (preemption)
+        virtual void executing_ready();
+
+        /// from executing to active non contending (no more work)
+        virtual void executing_releasing();
+
+        /// from active non contending to idle (no lag)
+        virtual void releasing_idle();
+
+        /// from executing to recharging (end of the window)
+        virtual void executing_recharging();
+
+        /// from recharging to active contending (a window starts)
+        virtual void recharging_ready();
+
+        /// from recharging to idle (nothing remains to be done)
+        virtual void recharging_idle();
+    };
+
+    /**
+        A virtual machine implemented with static time partitioning,
+        as in ARINC-653: every CPU follows a schedule table of
+        windows (offset, length, partition) that repeats every major
+        frame. Every partition has its own inner scheduler and is
+        allowed to execute only in its windows.
+
+        Switching from one partition to another costs a constant
+        overhead, charged at the beginning of the window of the
+        partition switched to; two adjacent windows of the same
+        partition do not pay it.
+
+        The table is checked by validate(), which is called by the
+        kernels when the VM is added (see RTKernel::addVM() and
+        PartionedMRTKernel::addVM()): the windows must lie in the
+        major frame, must not overlap on the same CPU, must be longer
+        than the overhead they pay, and every partition must have
+        windows on exactly one CPU.
+
+        The tasks are added with the partition name as parameter,
+        followed by the parameters for the inner scheduler, e.g.
+        addTask(t, "P1(3)").
+    */
+    class TimePartitionVM : public VirtualMachine {
+    public:
+        struct Entry {
+            int cpu;
+            Tick offset;
+            Tick length;
+            std::string partition;
+        };
+
+    private:
+        Tick _frame;
+        Tick _overhead;
+        std::vector<Entry> _table;
+        std::map<std::string, PartitionServer *> _partitions;
+        std::map<std::string, int> _cpus;
+        bool _valid;
+
+    public:
+        /**
+           @param frame the major frame
+           @param overhead the cost of a partition switch
+        */
+        TimePartitionVM(const std::string &name, Tick frame,
+                        Tick overhead = 0);
+        ~TimePartitionVM();
+
+        /// Creates a partition with its own scheduler
+        PartitionServer *addPartition(const std::string &name,
+                                      const std::string &sched = "FIFOSched");
+
+        /// Adds a window to the schedule table of a CPU
+        void addWindow(int cpu, Tick offset, Tick length,
+                       const std::string &partition);
+
+        /**
+           Checks the schedule table and sets the windows of the
+           partitions; throws TimePartitionExc if it is not well
+           formed.
+        */
+        void validate();
+
+        /// The partition with the given name, or NULL
+        PartitionServer *getPartition(const std::string &name) const;
+
+        /// The CPU of a partition (after validate())
+        int getCPU(const std::string &partition) const;
+
+        const std::map<std::string, PartitionServer *> &getPartitions() const
+        { return _partitions; }
+
+        Tick getMajorFrame() const { return _frame; }
+        Tick getOverhead() const { return _overhead; }
+
+        /// The parameters are: partition(inner scheduler parameters)
+        virtual void addTask(AbsRTTask &task, const string &params);
+    };
+}
+
+#endif
@@ -13,6 +13,7 @@
  ***************************************************************************/
 #include <timer.hpp>
 #include <simul.hpp>
+#include <profiler.hpp>
 
 namespace RTSim {
 
@@ -34,6 +35,7 @@ namespace RTSim {
     }
 
     void Timer::onTrigger(MetaSim::Event *) {
+	PROFILE_SCOPE("Timer");
 	//DBGENTER(_TIMER_DBG_LEV);
 
 	_triggerEvt.drop();
@@ -0,0 +1,97 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <topology.hpp>
+
+namespace RTSim {
+
+    using namespace std;
+    using namespace MetaSim;
+
+    Topology::Topology() : _cpus(), _matrix()
+    {
+        for (int l = 0; l < NUM_LEVELS; ++l) {
+            _cost[l] = 0;
+            _reload[l] = 1;
+        }
+    }
+
+    void Topology::addCPU(CPU *c, int l2, int l3, int node)
+    {
+        Place p;
+        p.l2 = l2;
+        p.l3 = l3;
+        p.node = node;
+        _cpus[c] = p;
+    }
+
+    const Topology::Place &Topology::place(CPU *c) const
+    {
+        map<CPU *, Place>::const_iterator i = _cpus.find(c);
+        if (i == _cpus.end())
+            throw TopologyExc("CPU " + c->getName() + " not in the topology");
+        return i->second;
+    }
+
+    int Topology::getDomain(CPU *c, Level l) const
+    {
+        const Place &p = place(c);
+        switch (l) {
+        case SHARED_L2: return p.l2;
+        case SHARED_L3: return p.l3;
+        case SAME_NODE: return p.node;
+        default: throw TopologyExc("No domain at this level");
+        }
+    }
+
+    Topology::Level Topology::getLevel(CPU *a, CPU *b) const
+    {
+        if (a == b) return SAME_CPU;
+
+        const Place &pa = place(a);
+        const Place &pb = place(b);
+        if (pa.l2 == pb.l2) return SHARED_L2;
+        if (pa.l3 == pb.l3) return SHARED_L3;
+        if (pa.node == pb.node) return SAME_NODE;
+        return REMOTE;
+    }
+
+    void Topology::setMigrationCost(Level l, Tick cost)
+    {
+        _cost[l] = cost;
+    }
+
+    void Topology::setMigrationCost(CPU *from, CPU *to, Tick cost)
+    {
+        _matrix[make_pair(from, to)] = cost;
+    }
+
+    Tick Topology::getMigrationCost(CPU *from, CPU *to) const
+    {
+        map<pair<CPU *, CPU *>, Tick>::const_iterator i =
+            _matrix.find(make_pair(from, to));
+        if (i != _matrix.end()) return i->second;
+        return _cost[getLevel(from, to)];
+    }
+
+    void Topology::setReloadFactor(Level l, double f)
+    {
+        _reload[l] = f;
+    }
+
+    double Topology::getReloadFactor(Level l) const
+    {
+        return _reload[l];
+    }
+
+} // namespace RTSim
@@ -0,0 +1,108 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __TOPOLOGY_HPP__
+#define __TOPOLOGY_HPP__
+
+#include <map>
+#include <string>
+#include <utility>
+
+#include <baseexc.hpp>
+#include <basetype.hpp>
+
+#include <cpu.hpp>
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    class TopologyExc : public BaseExc {
+    public:
+        TopologyExc(const std::string &msg) :
+            BaseExc(msg, "Topology", "topology.cpp") {}
+    };
+
+    /**
+       \ingroup kernels
+
+       Memory hierarchy of a multiprocessor platform: every CPU
+       belongs to an L2 cluster, an L3 cluster and a NUMA node,
+       identified by integers. Two CPUs are as close as the first
+       level they share.
+
+       The cost of migrating a task from one CPU to another depends
+       on this level (setMigrationCost(Level, Tick)), unless it is
+       given explicitly for the pair (setMigrationCost(CPU*, CPU*,
+       Tick)); MRTKernel::setTopology() uses it in place of the
+       scalar migration delay. The reload factors are used by the
+       CacheDelayModel.
+
+       \code
+       Topology topo;
+       // 4 cores, L2 shared by pairs, one L3, one node
+       for (int i = 0; i < 4; ++i) topo.addCPU(cpus[i], i / 2, 0, 0);
+       topo.setMigrationCost(Topology::SHARED_L2, 1);
+       topo.setMigrationCost(Topology::SHARED_L3, 5);
+       kern.setTopology(&topo);
+       \endcode
+    */
+    class Topology {
+    public:
+        typedef enum {
+            SAME_CPU = 0,
+            SHARED_L2,
+            SHARED_L3,
+            SAME_NODE,
+            REMOTE,
+            NUM_LEVELS
+        } Level;
+
+        Topology();
+
+        void addCPU(CPU *c, int l2, int l3, int node);
+
+        /// Identifier of the L2 or L3 cluster or node of c
+        int getDomain(CPU *c, Level l) const;
+
+        /// The first level shared by a and b
+        Level getLevel(CPU *a, CPU *b) const;
+
+        void setMigrationCost(Level l, Tick cost);
+        void setMigrationCost(CPU *from, CPU *to, Tick cost);
+        Tick getMigrationCost(CPU *from, CPU *to) const;
+
+        /**
+           Fraction of the working set of a task that has to be
+           reloaded from memory when it migrates to a CPU with which
+           the previous one only shares the level l (1 by default).
+        */
+        void setReloadFactor(Level l, double f);
+        double getReloadFactor(Level l) const;
+
+    private:
+        struct Place {
+            int l2, l3, node;
+        };
+
+        std::map<CPU *, Place> _cpus;
+        Tick _cost[NUM_LEVELS];
+        double _reload[NUM_LEVELS];
+        std::map<std::pair<CPU *, CPU *>, Tick> _matrix;
+
+        const Place &place(CPU *c) const;
+    };
+
+} // namespace RTSim
+
+#endif
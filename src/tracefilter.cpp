@@ -0,0 +1,98 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <tracefilter.hpp>
+
+namespace RTSim {
+
+    using namespace std;
+    using namespace MetaSim;
+
+    TraceFilter::TraceFilter(const string &name) :
+        Entity(name), _windows(), _entities(), _cpus(), _mask(~0ULL),
+        _sampling(1), _count(0), _trigCode(-1), _pre(0), _post(0),
+        _triggered(false), _trigTime(0), _kept(), _keptMask(0), _keptHead(0)
+    {
+    }
+
+    void TraceFilter::addWindow(Tick start, Tick end)
+    {
+        _windows.push_back(make_pair(start, end));
+    }
+
+    void TraceFilter::setTrigger(int code, Tick pre, Tick post,
+                                 size_t maxKept)
+    {
+        _trigCode = code;
+        _pre = pre;
+        _post = post;
+
+        size_t size = 1;
+        while (size < maxKept) size <<= 1;
+        _kept.assign(size, Kept());
+        _keptMask = size - 1;
+        _keptHead = 0;
+    }
+
+    bool TraceFilter::accept(int code, int entity, int cpu) const
+    {
+        if (!(_mask & bit(code))) return false;
+
+        if (!_windows.empty()) {
+            Tick t = SIMUL.getTime();
+            bool in = false;
+            for (unsigned i = 0; i < _windows.size() && !in; ++i)
+                in = _windows[i].first <= t && t < _windows[i].second;
+            if (!in) return false;
+        }
+
+        if (!_entities.empty() && entity >= 0 &&
+            _entities.find(entity) == _entities.end())
+            return false;
+
+        if (!_cpus.empty() && cpu >= 0 && _cpus.find(cpu) == _cpus.end())
+            return false;
+
+        return true;
+    }
+
+    void TraceFilter::trigger()
+    {
+        if (_triggered) return;
+        _triggered = true;
+        _trigTime = SIMUL.getTime();
+
+        // the oldest records first
+        unsigned long long i = 0;
+        if (_keptHead > _kept.size()) i = _keptHead - _kept.size();
+        for (; i < _keptHead; ++i) {
+            const Kept &k = _kept[i & _keptMask];
+            if (k.rec.time + _pre < _trigTime) continue;
+            k.render(k.sink, k.rec);
+        }
+        _keptHead = 0;
+    }
+
+    void TraceFilter::newRun()
+    {
+        _count = 0;
+        _triggered = false;
+        _trigTime = 0;
+        _keptHead = 0;
+    }
+
+    void TraceFilter::endRun()
+    {
+    }
+
+} // namespace RTSim
@@ -0,0 +1,276 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __TRACEFILTER_HPP__
+#define __TRACEFILTER_HPP__
+
+#include <set>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include <entity.hpp>
+#include <event.hpp>
+#include <simul.hpp>
+
+#include <flightrec.hpp>
+#include <instr.hpp>
+#include <replenishmentserver.hpp>
+#include <server.hpp>
+#include <serverevt.hpp>
+#include <task.hpp>
+#include <taskevt.hpp>
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    /**
+       \ingroup trace
+
+       A traced event, stored by value: the event objects are reused
+       by the simulator, so a sink that renders an event later (see
+       TraceFilter::setTrigger()) must not read them. The fields that
+       change from an event to the next (time, CPU, arrival time,
+       budget, ...) are copied in the record; obj points to the task,
+       the server or the instruction of the event, which are not
+       reused, and is read only for names and constant attributes.
+    */
+    struct TraceRecord {
+        Tick time;
+        /// id of the task or server, -1 if none
+        int entity;
+        /// code of the flight recorder (FR_*), 0 if none
+        int code;
+        /// CPU of the event, -1 if not bound to a CPU
+        int cpu;
+        long long arg1;
+        long long arg2;
+        const void *obj;
+        /// dynamic type of the event, only for the generic probes
+        const std::type_info *type;
+    };
+
+    /// Record of an event of a task, at the current time
+    inline TraceRecord traceRecord(int code, const Task *t, int cpu = -1,
+                                   long long a1 = 0, long long a2 = 0)
+    {
+        TraceRecord r = {SIMUL.getTime(), t->getID(), code, cpu, a1, a2, t, 0};
+        return r;
+    }
+
+    /// Record of an event of a server, at the current time
+    inline TraceRecord traceRecord(int code, const Server *s, int cpu = -1,
+                                   long long a1 = 0, long long a2 = 0)
+    {
+        TraceRecord r = {SIMUL.getTime(), s->getID(), code, cpu, a1, a2, s, 0};
+        return r;
+    }
+
+    /// Record of an event of an instruction (entity: its task)
+    inline TraceRecord traceRecord(int code, const Instr *i, int cpu = -1,
+                                   long long a1 = 0, long long a2 = 0)
+    {
+        TraceRecord r = {SIMUL.getTime(), i->getTask()->getID(), code, cpu,
+                         a1, a2, i, 0};
+        return r;
+    }
+
+    /**
+       \ingroup trace
+
+       Filter in front of the trace sinks (TextTrace, JSONTrace,
+       PerfettoTrace, JavaTrace, ...). A sink with a filter (see the
+       setFilter() method of the sinks) copies every event in a
+       TraceRecord and checks it against the filter before formatting
+       anything, so the events that are filtered out cost a few
+       stores and comparisons.
+
+       An event passes if all the conditions are met:
+       - the current time is in one of the time windows (addWindow());
+       - the event belongs to one of the selected tasks and servers
+         (addTask(), addServer());
+       - the event happens on one of the selected CPUs (addCPU());
+         events that are not bound to a CPU, like arrivals, are not
+         filtered by CPU;
+       - the type of the event is enabled (enable(), disable(),
+         setMask()); types are the codes of the flight recorder
+         (FR_ARRIVAL, FR_SCHED, ...), code 0 is used for the events
+         without a code (wait, signal, system ceiling, ...);
+       - it is one of every n events (setSampling()).
+       An empty set of windows, tasks or CPUs means no condition.
+
+       In trigger mode (setTrigger()) the events are not traced until
+       the trigger condition is met: an event with the trigger code
+       that passes the filter, e.g. a FR_DLINE_MISS, or a call to
+       trigger(). Meanwhile, the records of the events are kept in a
+       ring preallocated by setTrigger(), like the one of the
+       FlightRecorder, and the ones of the last pre ticks are
+       rendered by their sinks when the trigger fires.
+
+       The filter is an Entity, so its state (sampling counter,
+       trigger, ring) is reset at the beginning of every run.
+
+       \code
+       TraceFilter f;
+       f.addWindow(500000000, 500100000);
+       f.addTask(&t1);
+       f.setTrigger(FR_DLINE_MISS, 10000);
+
+       JSONTrace jtrace("trace.json");
+       jtrace.setFilter(&f);
+       jtrace.attachToTask(&t1);
+       \endcode
+    */
+    class TraceFilter : public Entity {
+    public:
+        TraceFilter(const std::string &name = "TraceFilter");
+
+        /// Adds a window [start, end) of traced time
+        void addWindow(Tick start, Tick end);
+
+        void addTask(const Task *t) { _entities.insert(t->getID()); }
+        void addServer(const Server *s) { _entities.insert(s->getID()); }
+        void addCPU(int cpu) { _cpus.insert(cpu); }
+
+        /// Enables the events with the given code
+        void enable(int code) { _mask |= bit(code); }
+        /// Disables the events with the given code
+        void disable(int code) { _mask &= ~bit(code); }
+        /// Sets the mask of the enabled codes (bit i for code i)
+        void setMask(unsigned long long m) { _mask = m; }
+
+        /// Traces one of every n events (1: all of them)
+        void setSampling(unsigned n) { _sampling = n > 0 ? n : 1; }
+
+        /**
+           Enables the trigger mode.
+
+           @param code code of the event that fires the trigger
+           @param pre length of the window before the trigger that is
+                  traced anyway
+           @param post length of the window traced after the trigger
+                  (0: until the end of the run)
+           @param maxKept maximum number of records kept in the ring
+                  (rounded up to a power of two)
+        */
+        void setTrigger(int code, Tick pre, Tick post = 0,
+                        size_t maxKept = 1 << 16);
+
+        /// Fires the trigger
+        void trigger();
+
+        bool isTriggered() const { return _triggered; }
+
+        /**
+           Filters the record of an event for a sink, which renders
+           it with its method W if the result is true.
+        */
+        template<class Sink, void (Sink::*W)(const TraceRecord &)>
+        bool pass(Sink *s, const TraceRecord &r)
+        {
+            if (!accept(r.code, r.entity, r.cpu)) return false;
+
+            if (_trigCode >= 0) {
+                if (!_triggered) {
+                    if (r.code == _trigCode) {
+                        trigger();
+                        return true;
+                    }
+                    if (!sample()) return false;
+                    keep(s, r, &render<Sink, W>);
+                    return false;
+                }
+                if (_post > 0 && r.time >= _trigTime + _post)
+                    return false;
+            }
+            return sample();
+        }
+
+        void newRun();
+        void endRun();
+
+    private:
+        typedef void (*Render)(void *sink, const TraceRecord &r);
+
+        struct Kept {
+            TraceRecord rec;
+            void *sink;
+            Render render;
+        };
+
+        std::vector<std::pair<Tick, Tick> > _windows;
+        std::set<int> _entities;
+        std::set<int> _cpus;
+        unsigned long long _mask;
+
+        unsigned _sampling;
+        unsigned _count;
+
+        int _trigCode;
+        Tick _pre;
+        Tick _post;
+        bool _triggered;
+        Tick _trigTime;
+
+        /// ring of the kept records
+        std::vector<Kept> _kept;
+        size_t _keptMask;
+        unsigned long long _keptHead;
+
+        static unsigned long long bit(int code)
+        {
+            return 1ULL << (code >= 0 && code < 64 ? code : 0);
+        }
+
+        bool accept(int code, int entity, int cpu) const;
+
+        bool sample()
+        {
+            if (_sampling == 1) return true;
+            if (++_count < _sampling) return false;
+            _count = 0;
+            return true;
+        }
+
+        void keep(void *sink, const TraceRecord &r, Render f)
+        {
+            Kept &k = _kept[_keptHead & _keptMask];
+            k.rec = r;
+            k.sink = sink;
+            k.render = f;
+            _keptHead++;
+        }
+
+        template<class Sink, void (Sink::*W)(const TraceRecord &)>
+        static void render(void *sink, const TraceRecord &r)
+        {
+            (static_cast<Sink *>(sink)->*W)(r);
+        }
+    };
+
+} // namespace RTSim
+
+/**
+   Renders the record r with the method W of the sink (of class
+   Sink), unless the filter of the sink (_filter, may be null) drops
+   it or keeps it for later.
+*/
+#define TRACE_WRITE(Sink, W, r)                                         \
+    do {                                                                \
+        if (!_filter || _filter->pass<Sink, &Sink::W>(this, r))         \
+            W(r);                                                       \
+    } while (0)
+
+#endif
@@ -9,6 +9,8 @@ namespace RTSim {
      *
      * This class exports a periodic trace of the power saved by the CPU.
      * The trace is saved on a file called "power.txt" every 10 msec.
+     * The power is sampled, so the averages are approximate: see
+     * EnergyMeter for an exact accounting that posts no events.
      */
     class TracePowerConsumption:
         public PeriodicTimer, public TraceAscii
@@ -0,0 +1,146 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <task.hpp>
+
+#include "ttkernel.hpp"
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    TTScheduler::TTScheduler(const ScheduleTable *table) :
+        _table(table), _byIndex(), _slotTask(-1)
+    {
+    }
+
+    void TTScheduler::addTask(AbsRTTask *t, const std::string &p)
+    {
+        int i = _table->findTask(p);
+        if (i < 0) throw RTSchedExc("Task " + p + " not in the schedule table");
+        if (_byIndex.count(i))
+            throw RTSchedExc("Task " + p + " already added");
+
+        _byIndex[i] = t;
+        enqueueModel(new TTModel(t, i));
+    }
+
+    AbsRTTask *TTScheduler::getTableTask(int index) const
+    {
+        std::map<int, AbsRTTask *>::const_iterator i = _byIndex.find(index);
+        return i == _byIndex.end() ? NULL : i->second;
+    }
+
+    AbsRTTask *TTScheduler::getFirst()
+    {
+        AbsRTTask *t = getTableTask(_slotTask);
+        if (t == NULL) return NULL;
+
+        TaskModel *m = find(t);
+        return m && m->isActive() ? t : NULL;
+    }
+
+    void TTScheduler::newRun()
+    {
+        Scheduler::newRun();
+        _slotTask = -1;
+    }
+
+    /*----------------------------------------------------*/
+
+    TTKernel::TTKernel(const ScheduleTable *table, const std::string &name,
+                       CPU *c) :
+        RTKernel(new TTScheduler(table), name, c),
+        _table(table),
+        _cur(0),
+        _frameStart(0),
+        _overruns(),
+        _taskOverruns(),
+        _slotStartEvt(this, &TTKernel::onSlotStart, Event::_DEFAULT_PRIORITY + 10),
+        _slotEndEvt(this, &TTKernel::onSlotEnd, Event::_DEFAULT_PRIORITY + 10)
+    {
+        _ttsched = dynamic_cast<TTScheduler *>(_sched);
+    }
+
+    TTKernel::~TTKernel()
+    {
+        delete _ttsched;
+    }
+
+    Tick TTKernel::slotStart(unsigned i) const
+    {
+        return _frameStart + _table->getSlots()[i].start;
+    }
+
+    void TTKernel::onSlotStart(Event *e)
+    {
+        DBGENTER(_KERNEL_DBG_LEV);
+
+        const TTSlot &s = _table->getSlots()[_cur];
+        _ttsched->setSlotTask(s.task);
+        _slotEndEvt.post(slotStart(_cur) + s.length);
+        dispatch();
+    }
+
+    void TTKernel::onSlotEnd(Event *e)
+    {
+        DBGENTER(_KERNEL_DBG_LEV);
+
+        const TTSlot &s = _table->getSlots()[_cur];
+        AbsRTTask *t = _ttsched->getTableTask(s.task);
+
+        // the task ended at the same time, if it could: its end
+        // event comes before this one
+        if (s.last && t != NULL && t->isActive()) {
+            Overrun o = {t, SIMUL.getTime()};
+            _overruns.push_back(o);
+            _taskOverruns[t]++;
+            DBGPRINT_2("Overrun of ", taskname(t));
+        }
+
+        _ttsched->setSlotTask(-1);
+        dispatch();
+
+        if (++_cur == _table->getSize()) {
+            _cur = 0;
+            _frameStart += _table->getHyperperiod();
+        }
+        _slotStartEvt.post(slotStart(_cur));
+    }
+
+    unsigned long TTKernel::getOverrunCount(AbsRTTask *t) const
+    {
+        std::map<AbsRTTask *, unsigned long>::const_iterator i =
+            _taskOverruns.find(t);
+        return i == _taskOverruns.end() ? 0 : i->second;
+    }
+
+    void TTKernel::newRun()
+    {
+        RTKernel::newRun();
+        _cur = 0;
+        _frameStart = 0;
+        _overruns.clear();
+        _taskOverruns.clear();
+        _slotStartEvt.drop();
+        _slotEndEvt.drop();
+        if (_table->getSize() > 0) _slotStartEvt.post(slotStart(0));
+    }
+
+    void TTKernel::endRun()
+    {
+        RTKernel::endRun();
+        _slotStartEvt.drop();
+        _slotEndEvt.drop();
+    }
+}
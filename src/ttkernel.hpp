@@ -0,0 +1,128 @@
+/***************************************************************************
+    begin                : 2026-10-19
+    copyright            : (C) 2026 Davide Kirchner
+    email                : davide.kirchner@yahoo.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __TTKERNEL_HPP__
+#define __TTKERNEL_HPP__
+
+#include <map>
+#include <vector>
+
+#include <gevent.hpp>
+
+#include <kernel.hpp>
+#include <schedtable.hpp>
+#include <scheduler.hpp>
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    /**
+       \ingroup sched
+
+       The scheduler of a TTKernel: the only task that can be
+       selected is the one of the current slot of the table, if it
+       is ready.
+    */
+    class TTScheduler : public Scheduler {
+        class TTModel : public TaskModel {
+            int _index;
+        public:
+            TTModel(AbsRTTask *t, int i) : TaskModel(t), _index(i) {}
+            Tick getPriority() { return _index; }
+            void changePriority(Tick p) {}
+            int getIndex() const { return _index; }
+        };
+
+        const ScheduleTable *_table;
+        std::map<int, AbsRTTask *> _byIndex;
+        int _slotTask;
+
+    public:
+        TTScheduler(const ScheduleTable *table);
+
+        /// The parameter is the name of the task in the table
+        void addTask(AbsRTTask *t, const std::string &p);
+        void removeTask(AbsRTTask *t) {}
+
+        /// Selects the task of the current slot (-1: none)
+        void setSlotTask(int index) { _slotTask = index; }
+
+        /// The task of the table with the given index, or NULL
+        AbsRTTask *getTableTask(int index) const;
+
+        AbsRTTask *getFirst();
+
+        void newRun();
+    };
+
+    /**
+       \ingroup kernels
+
+       A time-triggered kernel: the tasks execute only in the slots
+       of a static ScheduleTable (see TableSynthesizer), that is
+       repeated every hyperperiod. The tasks keep arriving on their
+       own; a task that is not ready at the beginning of its slot
+       can execute in the rest of it, and a slot whose task has
+       completed stays idle.
+
+       If the job of a task has not completed at the end of its last
+       slot, the job has overrun: its ExecInstrs took more than the
+       table reserved. The overrun is recorded, and the job can
+       continue only in the following slots of the task.
+
+       The tasks are added with their name in the table as
+       parameter.
+    */
+    class TTKernel : public RTKernel {
+    public:
+        struct Overrun {
+            AbsRTTask *task;
+            Tick time;
+        };
+
+    private:
+        const ScheduleTable *_table;
+        TTScheduler *_ttsched;
+
+        unsigned _cur;
+        Tick _frameStart;
+
+        std::vector<Overrun> _overruns;
+        std::map<AbsRTTask *, unsigned long> _taskOverruns;
+
+        Tick slotStart(unsigned i) const;
+
+    public:
+        GEvent<TTKernel> _slotStartEvt;
+        GEvent<TTKernel> _slotEndEvt;
+
+        TTKernel(const ScheduleTable *table,
+                 const std::string &name = "", CPU *c = NULL);
+        ~TTKernel();
+
+        const ScheduleTable *getTable() const { return _table; }
+
+        void onSlotStart(Event *e);
+        void onSlotEnd(Event *e);
+
+        const std::vector<Overrun> &getOverruns() const { return _overruns; }
+        unsigned long getOverrunCount() const { return _overruns.size(); }
+        unsigned long getOverrunCount(AbsRTTask *t) const;
+
+        void newRun();
+        void endRun();
+    };
+}
+
+#endif
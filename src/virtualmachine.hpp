@@ -26,6 +26,7 @@ namespace RTSim{
         Possible implementations of a VM should derive this class, that is
         quite general to be compatible with both VMs implemented as
         periodic server and static time partioning
+        (see PeriodicServerVM and TimePartitionVM)
 
         @author Casini Daniel
     */
@@ -14,6 +14,7 @@
 #include <simul.hpp>
 
 #include <kernel.hpp>
+#include <server.hpp>
 #include <task.hpp>
 #include <waitinstr.hpp>
 
@@ -66,10 +67,11 @@ namespace RTSim {
         _father->onInstrEnd();
 
         RTKernel *k = dynamic_cast<RTKernel *>(_father->getKernel());
+        Server *s = dynamic_cast<Server *>(_father->getKernel());
 
-        if (k == NULL) throw BaseExc("Kernel not found!");
-
-        k->requestResource(_father, _res, _numberOfRes);
+        if (k != NULL) k->requestResource(_father, _res, _numberOfRes);
+        else if (s != NULL) s->requestResource(_father, _res, _numberOfRes);
+        else throw BaseExc("Kernel not found!");
 
         _waitEvt.process();
     }
@@ -120,12 +122,11 @@ namespace RTSim {
         _father->onInstrEnd();        
 
         RTKernel *k = dynamic_cast<RTKernel *>(_father->getKernel());
+        Server *s = dynamic_cast<Server *>(_father->getKernel());
 
-        if (k == 0) {
-            throw BaseExc("SignalInstr has no kernel set!");
-        }
-        
-        else k->releaseResource(_father, _res, _numberOfRes); 
+        if (k != 0) k->releaseResource(_father, _res, _numberOfRes);
+        else if (s != 0) s->releaseResource(_father, _res, _numberOfRes);
+        else throw BaseExc("SignalInstr has no kernel set!");
     }
 
 }
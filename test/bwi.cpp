@@ -0,0 +1,94 @@
+#include "catch.hpp"
+#include <rttask.hpp>
+#include <cbserver.hpp>
+#include <kernel.hpp>
+#include <edfsched.hpp>
+#include <bwi.hpp>
+
+using namespace MetaSim;
+using namespace RTSim;
+
+TEST_CASE("BWI: the owner executes in the server of the blocked task")
+{
+    PeriodicTask t1(20, 20, 0, "TaskA");
+    t1.insertCode("wait(R);fixed(4);signal(R);");
+    t1.setAbort(false);
+
+    PeriodicTask t2(20, 20, 1, "TaskB");
+    t2.insertCode("wait(R);fixed(1);signal(R);");
+    t2.setAbort(false);
+
+    EDFScheduler sched;
+    RTKernel kern(&sched);
+
+    BWI bwi("BWI");
+    bwi.addResource("R");
+
+    CBServer serv1(2, 10, 10, true, "server1", "FIFOSched");
+    serv1.addTask(t1);
+    serv1.setGlobalResManager(&bwi);
+    CBServer serv2(6, 12, 12, true, "server2", "FIFOSched");
+    serv2.addTask(t2);
+    serv2.setGlobalResManager(&bwi);
+
+    kern.addTask(serv1);
+    kern.addTask(serv2);
+
+    SIMUL.initSingleRun();
+
+    // serv1 exhausts its budget while TaskA holds R
+    SIMUL.run_to(2);
+    REQUIRE(t1.getExecTime() == 2);
+    REQUIRE(serv1.getStatus() == RECHARGING);
+
+    // TaskB blocks, and TaskA completes inside serv2
+    SIMUL.run_to(3);
+    REQUIRE(bwi.isBlocked(&t2));
+    REQUIRE(t1.getExecTime() == 3);
+    REQUIRE(t2.getExecTime() == 0);
+
+    SIMUL.run_to(5);
+    REQUIRE(!bwi.isBlocked(&t2));
+    REQUIRE(t2.getExecTime() == 1);
+    REQUIRE(serv1.get_remaining_budget() == 0);
+    REQUIRE(serv2.get_remaining_budget() == 3);
+
+    SIMUL.endSingleRun();
+}
+
+TEST_CASE("BWI: deadlock detection")
+{
+    PeriodicTask t1(20, 20, 0, "TaskA");
+    t1.insertCode("wait(R1);fixed(2);wait(R2);fixed(1);signal(R2);signal(R1);");
+    t1.setAbort(false);
+
+    PeriodicTask t2(20, 20, 1, "TaskB");
+    t2.insertCode("wait(R2);fixed(3);wait(R1);fixed(1);signal(R1);signal(R2);");
+    t2.setAbort(false);
+
+    EDFScheduler sched;
+    RTKernel kern(&sched);
+
+    BWI bwi("BWI");
+    bwi.addResource("R1");
+    bwi.addResource("R2");
+
+    CBServer serv1(5, 10, 10, true, "server1", "FIFOSched");
+    serv1.addTask(t1);
+    serv1.setGlobalResManager(&bwi);
+    CBServer serv2(5, 5, 5, true, "server2", "FIFOSched");
+    serv2.addTask(t2);
+    serv2.setGlobalResManager(&bwi);
+
+    kern.addTask(serv1);
+    kern.addTask(serv2);
+
+    SIMUL.initSingleRun();
+
+    // TaskB blocks on R1 at 4, then TaskA (inside serv2) on R2
+    SIMUL.run_to(4);
+    REQUIRE(bwi.isBlocked(&t2));
+    REQUIRE_THROWS_AS(SIMUL.run_to(6), const BWIExc &);
+
+    SIMUL.endSingleRun();
+}
@@ -0,0 +1,100 @@
+#include "catch.hpp"
+#include <vector>
+#include <rttask.hpp>
+#include <chain.hpp>
+#include <kernel.hpp>
+#include <fpsched.hpp>
+
+using namespace MetaSim;
+using namespace RTSim;
+
+TEST_CASE("Cause-effect chain: implicit communication")
+{
+    PeriodicTask a(10, 10, 0, "Producer");
+    a.insertCode("fixed(2);");
+    a.setAbort(false);
+
+    PeriodicTask b(20, 20, 0, "Consumer");
+    b.insertCode("fixed(3);");
+    b.setAbort(false);
+
+    FPScheduler sched;
+    RTKernel kern(&sched);
+    kern.addTask(a, "2");
+    kern.addTask(b, "1");
+
+    ChainManager cm;
+    cm.addWrite(&a, "x");
+    cm.addRead(&b, "x");
+    std::vector<Task *> tasks;
+    tasks.push_back(&a);
+    tasks.push_back(&b);
+    CauseEffectChain *c = cm.addChain("chain", tasks);
+
+    SIMUL.initSingleRun();
+
+    // the consumer runs first at 0 and reads nothing
+    SIMUL.run_to(4);
+    REQUIRE(c->getOutputs() == 0);
+
+    // the producer reads at 10 and writes at 12; the consumer reads
+    // at 20 (before the producer runs) and writes at 23
+    SIMUL.run_to(24);
+    REQUIRE(c->getOutputs() == 1);
+    REQUIRE(c->getMaxDataAge() == 13);
+
+    // the sample of 30, output at 43; the reaction goes from the
+    // previous sample, 10
+    SIMUL.run_to(44);
+    REQUIRE(c->getOutputs() == 2);
+    REQUIRE(c->getMaxDataAge() == 13);
+    REQUIRE(c->getMeanDataAge() == 13);
+    REQUIRE(c->getMaxReactionTime() == 33);
+
+    SIMUL.endSingleRun();
+}
+
+TEST_CASE("Cause-effect chain: LET")
+{
+    PeriodicTask a(10, 10, 0, "Producer");
+    a.insertCode("fixed(2);");
+    a.setAbort(false);
+
+    PeriodicTask b(20, 20, 0, "Consumer");
+    b.insertCode("fixed(3);");
+    b.setAbort(false);
+
+    FPScheduler sched;
+    RTKernel kern(&sched);
+    kern.addTask(a, "2");
+    kern.addTask(b, "1");
+
+    ChainManager cm;
+    cm.addWrite(&a, "x");
+    cm.addRead(&b, "x");
+    cm.setSemantics(&a, ChainManager::LET);
+    cm.setSemantics(&b, ChainManager::LET);
+    std::vector<Task *> tasks;
+    tasks.push_back(&a);
+    tasks.push_back(&b);
+    CauseEffectChain *c = cm.addChain("chain", tasks);
+
+    SIMUL.initSingleRun();
+
+    // the job of A released at 10 publishes at 20, before the
+    // release of B, which publishes at 40
+    SIMUL.run_to(39);
+    REQUIRE(c->getOutputs() == 0);
+
+    SIMUL.run_to(41);
+    REQUIRE(c->getOutputs() == 1);
+    REQUIRE(c->getMaxDataAge() == 30);
+
+    // B released at 40 reads the sample of 30, published at 40
+    SIMUL.run_to(61);
+    REQUIRE(c->getOutputs() == 2);
+    REQUIRE(c->getMeanDataAge() == 30);
+    REQUIRE(c->getMaxReactionTime() == 50);
+
+    SIMUL.endSingleRun();
+}
@@ -0,0 +1,132 @@
+#include "catch.hpp"
+#include <dagtask.hpp>
+#include <mrtkernel.hpp>
+#include <edfsched.hpp>
+#include <load.hpp>
+
+using namespace MetaSim;
+using namespace RTSim;
+
+TEST_CASE("DAG: fork-join on two processors")
+{
+    EDFScheduler sched;
+    MRTKernel kern(&sched, 2);
+
+    DAGTask dag(new DeltaVar(20), 20, 0, "dag");
+    Task *a = dag.addNode("fixed(2);");
+    Task *b = dag.addNode("fixed(4);");
+    Task *c = dag.addNode("fixed(3);");
+    Task *d = dag.addNode("fixed(1);");
+    dag.addEdge(a, b);
+    dag.addEdge(a, c);
+    dag.addEdge(b, d);
+    dag.addEdge(c, d);
+    dag.addTo(&kern);
+
+    REQUIRE_THROWS_AS(dag.addEdge(d, a), const DAGExc &);
+    REQUIRE(dag.getWCET() == 10);
+    REQUIRE(dag.getCriticalPath() == 7);
+
+    SIMUL.initSingleRun();
+
+    SIMUL.run_to(1);
+    REQUIRE(a->getExecTime() == 1);
+    REQUIRE(b->getExecTime() == 0);
+
+    // the two branches execute in parallel
+    SIMUL.run_to(4);
+    REQUIRE(a->getExecTime() == 2);
+    REQUIRE(b->getExecTime() == 2);
+    REQUIRE(c->getExecTime() == 2);
+    REQUIRE(d->getExecTime() == 0);
+
+    // the sink starts when the longest branch completes, at 6
+    SIMUL.run_to(8);
+    REQUIRE(b->getExecTime() == 4);
+    REQUIRE(c->getExecTime() == 3);
+    REQUIRE(d->getExecTime() == 1);
+    REQUIRE(dag.getJobs() == 1);
+    REQUIRE(dag.getLastResponseTime() == 7);
+    REQUIRE(dag.getDeadlineMisses() == 0);
+
+    SIMUL.endSingleRun();
+}
+
+TEST_CASE("DAG: federated scheduling")
+{
+    // C = 19, L = 7, D = 10: ceil((19 - 7) / (10 - 7)) = 4 processors
+    DAGTask heavy(new DeltaVar(10), 10, 0, "heavy");
+    Task *a = heavy.addNode("fixed(2);");
+    Task *b = heavy.addNode("fixed(4);");
+    Task *c = heavy.addNode("fixed(4);");
+    Task *d = heavy.addNode("fixed(4);");
+    Task *e = heavy.addNode("fixed(4);");
+    Task *f = heavy.addNode("fixed(1);");
+    heavy.addEdge(a, b);
+    heavy.addEdge(a, c);
+    heavy.addEdge(a, d);
+    heavy.addEdge(a, e);
+    heavy.addEdge(b, f);
+    heavy.addEdge(c, f);
+    heavy.addEdge(d, f);
+    heavy.addEdge(e, f);
+
+    REQUIRE(heavy.getWCET() == 19);
+    REQUIRE(heavy.getCriticalPath() == 7);
+
+    DAGTask light(new DeltaVar(20), 20, 0, "light");
+    Task *l1 = light.addNode("fixed(2);");
+    Task *l2 = light.addNode("fixed(3);");
+    light.addEdge(l1, l2);
+
+    SECTION("not enough processors") {
+        FederatedScheduling fed(4);
+        fed.addTask(&heavy);
+        fed.addTask(&light);
+        REQUIRE_THROWS_AS(fed.allocate(), const DAGExc &);
+    }
+
+    SECTION("allocation") {
+        FederatedScheduling fed(6);
+        fed.addTask(&heavy);
+        fed.addTask(&light);
+        fed.allocate();
+
+        REQUIRE(fed.getKernels().size() == 2);
+        REQUIRE(fed.getKernel(&heavy)->getProcessors().size() == 4);
+        REQUIRE(fed.getKernel(&light)->getProcessors().size() == 2);
+
+        SIMUL.initSingleRun();
+
+        // the four branches execute in parallel on the dedicated
+        // processors
+        SIMUL.run_to(9);
+        REQUIRE(b->getExecTime() == 4);
+        REQUIRE(e->getExecTime() == 4);
+        REQUIRE(heavy.getJobs() == 1);
+        REQUIRE(heavy.getLastResponseTime() == 7);
+        REQUIRE(light.getJobs() == 1);
+        REQUIRE(light.getLastResponseTime() == 5);
+
+        SIMUL.endSingleRun();
+    }
+}
+
+TEST_CASE("DAG: generator")
+{
+    RandomTaskSetFactory ts(4, 1.5, new ConstIATGen(20, 100, 20, 10),
+                            new ConstCTGen, new DlineEquPeriodDTGen);
+
+    RandomDAGGen gen(3, 6, 0.5);
+    std::vector<DAGTask *> dags = gen.generate(ts);
+
+    REQUIRE(dags.size() == 4);
+    for (unsigned i = 0; i < dags.size(); ++i) {
+        // the WCETs of the nodes sum to the computation time
+        REQUIRE(dags[i]->getWCET() == ts.getAvgCT(i));
+        REQUIRE(dags[i]->getRelDline() == ts.getDeadline(i));
+        REQUIRE(dags[i]->getNodes().size() <= 6);
+        REQUIRE(dags[i]->getCriticalPath() <= dags[i]->getWCET());
+        delete dags[i];
+    }
+}
@@ -0,0 +1,52 @@
+#include "catch.hpp"
+#include <rttask.hpp>
+#include <deferrableserver.hpp>
+#include <kernel.hpp>
+#include <fpsched.hpp>
+
+using namespace MetaSim;
+using namespace RTSim;
+
+TEST_CASE("Deferrable Server: budget preserved and replenished")
+{
+    PeriodicTask t1(10, 10, 0, "TaskA");
+    t1.insertCode("fixed(4);");
+    t1.setAbort(false);
+
+    PeriodicTask aper(20, 20, 2, "Aperiodic");
+    aper.insertCode("fixed(3);");
+    aper.setAbort(false);
+
+    FPScheduler sched;
+    RTKernel kern(&sched);
+
+    DeferrableServer serv(2, 5, "server", "FIFOSched");
+    serv.addTask(aper);
+
+    kern.addTask(serv, "1");
+    kern.addTask(t1, "2");
+
+    SIMUL.initSingleRun();
+
+    SIMUL.run_to(4);
+    REQUIRE(aper.getExecTime() == 2);
+    REQUIRE(t1.getExecTime() == 2);
+    REQUIRE(serv.getStatus() == RECHARGING);
+    REQUIRE(serv.get_remaining_budget() == 0);
+
+    SIMUL.run_to(6);
+    REQUIRE(aper.getExecTime() == 3);
+    REQUIRE(serv.getStatus() == IDLE);
+    REQUIRE(serv.get_remaining_budget() == 1);
+
+    SIMUL.run_to(7);
+    REQUIRE(t1.getExecTime() == 4);
+
+    SIMUL.run_to(8);
+    REQUIRE(serv.get_remaining_budget() == 1);
+
+    SIMUL.run_to(11);
+    REQUIRE(serv.get_remaining_budget() == 2);
+
+    SIMUL.endSingleRun();
+}
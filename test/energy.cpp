@@ -0,0 +1,64 @@
+#include "catch.hpp"
+#include <rttask.hpp>
+#include <cbserver.hpp>
+#include <kernel.hpp>
+#include <fpsched.hpp>
+#include <energy.hpp>
+
+using namespace MetaSim;
+using namespace RTSim;
+
+TEST_CASE("EnergyMeter: every task of the kernel is attached")
+{
+    CPU cpu("cpu");
+    FPScheduler sched;
+    RTKernel kern(&sched, "", &cpu);
+
+    PeriodicTask t1(10, 10, 0, "Task1");
+    t1.insertCode("fixed(2);");
+
+    PeriodicTask t2(10, 10, 0, "Task2");
+    t2.insertCode("fixed(3);");
+    CBServer serv(4, 10, 10, true, "serv", "FIFOSched");
+    serv.addTask(t2);
+
+    kern.addTask(t1, "1");
+    kern.addTask(serv, "2");
+
+    EnergyMeter meter;
+    meter.addCPU(&cpu, 1, 10);
+    meter.attachToKernel(&kern);
+
+    SIMUL.initSingleRun();
+    SIMUL.run_to(10);
+    SIMUL.endSingleRun();
+
+    // busy in [0, 5), idle in [5, 10)
+    REQUIRE(meter.getTaskEnergy(&t1) == 20);
+    REQUIRE(meter.getTaskEnergy(&t2) == 30);
+    REQUIRE(meter.getServerEnergy(&serv) == 30);
+    REQUIRE(meter.getTotalEnergy() == 55);
+}
+
+TEST_CASE("EnergyMeter: a task that is not attached throws")
+{
+    CPU cpu("cpu");
+    FPScheduler sched;
+    RTKernel kern(&sched, "", &cpu);
+
+    PeriodicTask t1(10, 10, 0, "Task1");
+    t1.insertCode("fixed(2);");
+    kern.addTask(t1, "1");
+
+    EnergyMeter meter;
+    meter.addCPU(&cpu, 1, 10);
+    meter.attachToKernel(&kern);
+
+    PeriodicTask t2(10, 10, 0, "Late");
+    t2.insertCode("fixed(3);");
+    kern.addTask(t2, "2");
+
+    SIMUL.initSingleRun();
+    REQUIRE_THROWS_AS(SIMUL.run_to(10), const EnergyMeterExc &);
+    SIMUL.endSingleRun();
+}
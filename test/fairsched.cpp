@@ -0,0 +1,127 @@
+#include "catch.hpp"
+#include <cmath>
+#include <rttask.hpp>
+#include <cbserver.hpp>
+#include <kernel.hpp>
+#include <fpsched.hpp>
+#include <fairsched.hpp>
+
+using namespace MetaSim;
+using namespace RTSim;
+
+TEST_CASE("FairSched: CPU share follows the nice weights")
+{
+    PeriodicTask t0(1000, 1000, 0, "Nice0");
+    t0.insertCode("fixed(1000);");
+    PeriodicTask t1(1000, 1000, 0, "Nice5");
+    t1.insertCode("fixed(1000);");
+
+    FairScheduler sched(24, 3, 4);
+    RTKernel kern(&sched);
+    kern.addTask(t0, "0");
+    kern.addTask(t1, "5");
+
+    REQUIRE(sched.getWeight(&t0) == 1024);
+    REQUIRE(sched.getWeight(&t1) == 335);
+
+    SIMUL.initSingleRun();
+    SIMUL.run_to(240);
+
+    // 1024 / (1024 + 335) of the time, within a slice
+    Tick total = t0.getExecTime() + t1.getExecTime();
+    REQUIRE(total == 240);
+    REQUIRE(t0.getExecTime() > 170);
+    REQUIRE(t0.getExecTime() < 195);
+    double diff = sched.getVruntime(&t0) - sched.getVruntime(&t1);
+    REQUIRE(fabs(diff) < 24);
+
+    SIMUL.endSingleRun();
+}
+
+TEST_CASE("FairSched: a sleeper preempts on wakeup")
+{
+    PeriodicTask ta(200, 200, 0, "Hog");
+    ta.insertCode("fixed(100);");
+    PeriodicTask tb(30, 30, 10, "Sleeper");
+    tb.insertCode("fixed(1);");
+
+    FairScheduler sched(24, 3, 4);
+    RTKernel kern(&sched);
+    kern.addTask(ta, "0");
+    kern.addTask(tb, "0");
+
+    SIMUL.initSingleRun();
+
+    // a new task has no credit: it waits for the end of the slice
+    SIMUL.run_to(20);
+    REQUIRE(ta.getExecTime() == 20);
+    REQUIRE(tb.getExecTime() == 0);
+
+    // after sleeping, it is far enough behind to preempt (the
+    // execution time of the Sleeper is the one of the job at 40)
+    SIMUL.run_to(41);
+    REQUIRE(ta.getExecTime() == 39);
+    REQUIRE(tb.getExecTime() == 1);
+
+    SIMUL.endSingleRun();
+}
+
+TEST_CASE("FairSched: EEVDF requests of minimum granularity")
+{
+    PeriodicTask t0(1000, 1000, 0, "Task0");
+    t0.insertCode("fixed(1000);");
+    PeriodicTask t1(1000, 1000, 0, "Task1");
+    t1.insertCode("fixed(1000);");
+
+    FairScheduler sched(24, 3, 4, true);
+    RTKernel kern(&sched);
+    kern.addTask(t0, "0");
+    kern.addTask(t1, "0");
+
+    SIMUL.initSingleRun();
+
+    SIMUL.run_to(4);
+    REQUIRE(t0.getExecTime() == 3);
+    REQUIRE(t1.getExecTime() == 1);
+
+    SIMUL.run_to(12);
+    REQUIRE(t0.getExecTime() == 6);
+    REQUIRE(t1.getExecTime() == 6);
+    double lag = sched.getLag(&t0) + sched.getLag(&t1);
+    REQUIRE(fabs(lag) < 1e-6);
+
+    SIMUL.endSingleRun();
+}
+
+TEST_CASE("FairSched: background class in a fixed priority kernel")
+{
+    PeriodicTask rt(10, 10, 0, "RealTime");
+    rt.insertCode("fixed(2);");
+
+    PeriodicTask f0(1000, 1000, 0, "Fair0");
+    f0.insertCode("fixed(1000);");
+    PeriodicTask f1(1000, 1000, 0, "Fair1");
+    f1.insertCode("fixed(1000);");
+
+    FPScheduler sched;
+    RTKernel kern(&sched);
+
+    CBServer serv(1000, 1000, 1000, true, "fair", "FairSched(24,3,4)");
+    serv.addTask(f0, "0");
+    serv.addTask(f1, "0");
+
+    kern.addTask(rt, "1");
+    kern.addTask(serv, "10");
+
+    SIMUL.initSingleRun();
+    SIMUL.run_to(99);
+
+    // the job at 90 is complete, and 10 jobs took 20 ticks
+    REQUIRE(rt.getExecTime() == 2);
+    Tick total = f0.getExecTime() + f1.getExecTime();
+    REQUIRE(total == 79);
+    REQUIRE(f0.getExecTime() > 28);
+    REQUIRE(f1.getExecTime() > 28);
+
+    SIMUL.endSingleRun();
+}
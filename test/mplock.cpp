@@ -0,0 +1,163 @@
+#include "catch.hpp"
+#include <rttask.hpp>
+#include <cpu.hpp>
+#include <partionedmrtkernel.hpp>
+#include <fpsched.hpp>
+#include <mpresman.hpp>
+#include <mpanalysis.hpp>
+
+using namespace MetaSim;
+using namespace RTSim;
+
+TEST_CASE("MSRP: non preemptive FIFO spinning")
+{
+    PeriodicTask t1(20, 20, 0, "Task1");
+    t1.insertCode("fixed(1);wait(R);fixed(3);signal(R);fixed(1);");
+    t1.setAbort(false);
+
+    PeriodicTask t2(20, 20, 0, "Task2");
+    t2.insertCode("fixed(2);wait(R);fixed(1);signal(R);");
+    t2.setAbort(false);
+
+    PeriodicTask t3(20, 20, 3, "Task3");
+    t3.insertCode("fixed(1);");
+    t3.setAbort(false);
+
+    CPU c0("cpu0"), c1("cpu1");
+    FPScheduler s0, s1;
+    PartionedMRTKernel kern("kern");
+    kern.addCPU(&c0, &s0);
+    kern.addCPU(&c1, &s1);
+
+    kern.addTask(t1, "1", &c0);
+    kern.addTask(t2, "1", &c1);
+    kern.addTask(t3, "0", &c1);
+
+    MSRPResManager rm("MSRP");
+    rm.addResource("R");
+    kern.setResManager(&rm);
+
+    SIMUL.initSingleRun();
+
+    // Task2 spins from 2, and Task3 cannot preempt it: the spin
+    // keeps cpu1 busy, but Task2 does not progress
+    SIMUL.run_to(3);
+    REQUIRE(rm.isWaiting(&t2));
+    REQUIRE(kern.getTask(&c1) == &t2);
+    REQUIRE(t2.isExecuting());
+    REQUIRE(t2.getExecTime() == 2);
+    REQUIRE(t3.getExecTime() == 0);
+
+    SIMUL.run_to(6);
+    REQUIRE(t2.getExecTime() == 3);
+    REQUIRE(t3.getExecTime() == 1);
+    REQUIRE(rm.getWaitTime(&t2) == 2);
+
+    MPBlockingAnalysis a(MPBlockingAnalysis::MSRP);
+    int i1 = a.addTask(0, 1, 5, 20);
+    int i2 = a.addTask(1, 1, 3, 20);
+    int i3 = a.addTask(1, 0, 1, 20);
+    a.addCriticalSection(i1, "R", 3);
+    a.addCriticalSection(i2, "R", 1);
+
+    REQUIRE(a.getRequestBound(i2, "R") == 3);
+    REQUIRE(rm.getMaxWaitTime(&t2) <= a.getRequestBound(i2, "R"));
+    REQUIRE(a.getLocalBlocking(i3) == 4);
+    REQUIRE(a.getResponseTime(i3) == 5);
+    REQUIRE(a.isSchedulable());
+
+    SIMUL.endSingleRun();
+}
+
+TEST_CASE("MrsP: a preempted owner migrates to the spinner")
+{
+    PeriodicTask tl(20, 20, 0, "Low");
+    tl.insertCode("wait(R);fixed(4);signal(R);");
+    tl.setAbort(false);
+
+    PeriodicTask th(20, 20, 1, "High");
+    th.insertCode("fixed(5);");
+    th.setAbort(false);
+
+    PeriodicTask ts(20, 20, 2, "Spinner");
+    ts.insertCode("wait(R);fixed(1);signal(R);");
+    ts.setAbort(false);
+
+    CPU c0("cpu0"), c1("cpu1");
+    FPScheduler s0, s1;
+    PartionedMRTKernel kern("kern");
+    kern.addCPU(&c0, &s0);
+    kern.addCPU(&c1, &s1);
+
+    kern.addTask(tl, "2", &c0);
+    kern.addTask(th, "1", &c0);
+    kern.addTask(ts, "1", &c1);
+
+    MrsPResManager rm("MrsP");
+    rm.addResource("R");
+    kern.setResManager(&rm);
+    rm.ceilingsFromTask(&tl);
+    rm.ceilingsFromTask(&ts);
+    REQUIRE(rm.getCeiling("R", &c0) == 2);
+    REQUIRE(rm.getCeiling("R", &c1) == 1);
+
+    SIMUL.initSingleRun();
+
+    // Low is preempted at 1, and executes on cpu1 from 2
+    SIMUL.run_to(4);
+    REQUIRE(rm.getMigrationCount(&tl) == 1);
+    REQUIRE(kern.getTask(&c1) == &tl);
+    REQUIRE(tl.getExecTime() == 3);
+    REQUIRE(ts.getExecTime() == 0);
+
+    SIMUL.run_to(6);
+    REQUIRE(ts.getExecTime() == 1);
+    REQUIRE(rm.getWaitTime(&ts) == 3);
+    REQUIRE(kern.getProcessor(&tl) == &c0);
+
+    SIMUL.endSingleRun();
+}
+
+TEST_CASE("FMLP+: FIFO suspension and priority boosting")
+{
+    PeriodicTask ta(20, 20, 0, "TaskA");
+    ta.insertCode("wait(R);fixed(3);signal(R);fixed(1);");
+    ta.setAbort(false);
+
+    PeriodicTask tb(20, 20, 1, "TaskB");
+    tb.insertCode("wait(R);fixed(1);signal(R);");
+    tb.setAbort(false);
+
+    PeriodicTask tc(20, 20, 0, "TaskC");
+    tc.insertCode("fixed(2);");
+    tc.setAbort(false);
+
+    CPU c0("cpu0"), c1("cpu1");
+    FPScheduler s0, s1;
+    PartionedMRTKernel kern("kern");
+    kern.addCPU(&c0, &s0);
+    kern.addCPU(&c1, &s1);
+
+    kern.addTask(ta, "1", &c0);
+    kern.addTask(tb, "1", &c1);
+    kern.addTask(tc, "2", &c1);
+
+    FMLPPlusResManager rm("FMLP");
+    rm.addResource("R");
+    kern.setResManager(&rm);
+
+    SIMUL.initSingleRun();
+
+    // TaskB suspends at 1, and TaskC executes in the meantime
+    SIMUL.run_to(2);
+    REQUIRE(rm.isWaiting(&tb));
+    REQUIRE(tc.getExecTime() == 2);
+    REQUIRE(tb.getExecTime() == 0);
+
+    SIMUL.run_to(5);
+    REQUIRE(tb.getExecTime() == 1);
+    REQUIRE(rm.getWaitTime(&tb) == 2);
+    REQUIRE(rm.getOwner("R") == NULL);
+
+    SIMUL.endSingleRun();
+}
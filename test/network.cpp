@@ -0,0 +1,185 @@
+#include "catch.hpp"
+#include <rttask.hpp>
+#include <network.hpp>
+#include <kernel.hpp>
+#include <edfsched.hpp>
+#include <fpsched.hpp>
+
+using namespace MetaSim;
+using namespace RTSim;
+
+TEST_CASE("Network: CAN arbitration")
+{
+    EDFScheduler sched1, sched2;
+    RTKernel k1(&sched1, "node1");
+    RTKernel k2(&sched2, "node2");
+
+    // 1 byte: 8 + 47 + 10 bits, 9 ticks
+    CANBus can(0.125, "can");
+    Channel lo("lo", &can, &k1, &k2, 1, 0x20);
+    Channel hi("hi", &can, &k1, &k2, 1, 0x10);
+
+    PeriodicTask s(100, 100, 0, "Sender");
+    s.insertCode("fixed(1);send(lo);send(hi);");
+    s.setAbort(false);
+
+    PeriodicTask r(100, 100, 0, "Receiver");
+    r.insertCode("receive(hi);fixed(2);");
+    r.setAbort(false);
+
+    k1.addTask(s);
+    k2.addTask(r);
+
+    EndToEndDelay e2e(&r, "e2e");
+
+    REQUIRE(can.getFrameTime(Message{&hi, 0, 0}) == 9);
+
+    SIMUL.initSingleRun();
+
+    // both sent at 1: hi wins the arbitration
+    SIMUL.run_to(9);
+    REQUIRE(hi.getSent() == 1);
+    REQUIRE(lo.getSent() == 1);
+    REQUIRE(hi.getDelivered() == 0);
+
+    SIMUL.run_to(11);
+    REQUIRE(hi.getDelivered() == 1);
+    REQUIRE(hi.getMaxLatency() == 9);
+    REQUIRE(lo.getDelivered() == 0);
+
+    SIMUL.run_to(20);
+    REQUIRE(lo.getDelivered() == 1);
+    REQUIRE(lo.getMaxLatency() == 18);
+    REQUIRE(lo.getPending() == 1);
+
+    // released at 0 on node1, completed at 12 on node2
+    REQUIRE(e2e.getCount() == 1);
+    REQUIRE(e2e.getMax() == 12);
+
+    SIMUL.endSingleRun();
+}
+
+TEST_CASE("Network: TDMA slots")
+{
+    EDFScheduler sched1, sched2;
+    RTKernel k1(&sched1, "node1");
+    RTKernel k2(&sched2, "node2");
+
+    // 2 bytes: 80 bits, 10 ticks
+    TDMABus bus(0.125, "tdma");
+    bus.addSlot(&k1, 12);
+    bus.addSlot(&k2, 12);
+    Channel ab("ab", &bus, &k1, &k2, 2);
+    Channel ba("ba", &bus, &k2, &k1, 2);
+
+    REQUIRE(bus.getCycle() == 24);
+
+    PeriodicTask s1(100, 100, 0, "Sender1");
+    s1.insertCode("fixed(3);send(ab);");
+    s1.setAbort(false);
+
+    PeriodicTask s2(100, 100, 0, "Sender2");
+    s2.insertCode("fixed(3);send(ba);");
+    s2.setAbort(false);
+
+    k1.addTask(s1);
+    k2.addTask(s2);
+
+    SIMUL.initSingleRun();
+
+    // node2 waits for its slot, at 12
+    SIMUL.run_to(23);
+    REQUIRE(ba.getDelivered() == 1);
+    REQUIRE(ba.getMaxLatency() == 19);
+    REQUIRE(ab.getDelivered() == 0);
+
+    // the frame does not fit in the rest of the slot of node1 at 3:
+    // it waits for the slot of the next cycle, at 24
+    SIMUL.run_to(33);
+    REQUIRE(ab.getDelivered() == 0);
+
+    SIMUL.run_to(35);
+    REQUIRE(ab.getDelivered() == 1);
+    REQUIRE(ab.getMaxLatency() == 31);
+
+    SIMUL.endSingleRun();
+}
+
+TEST_CASE("Network: Ethernet switch")
+{
+    EDFScheduler sched1, sched2;
+    RTKernel k1(&sched1, "node1");
+    RTKernel k2(&sched2, "node2");
+
+    // 10 bytes, padded to 46: 672 bits, 11 ticks
+    EthernetSwitch sw(0.015625, 5, true, "eth");
+    Channel c("c", &sw, &k1, &k2, 10);
+
+    PeriodicTask s(100, 100, 0, "Sender");
+    s.insertCode("fixed(1);send(c);");
+    s.setAbort(false);
+
+    PeriodicTask r(100, 100, 0, "Receiver");
+    r.insertCode("receive(c);fixed(2);");
+    r.setAbort(false);
+
+    k1.addTask(s);
+    k2.addTask(r);
+
+    EndToEndDelay e2e(&r, "e2e");
+
+    SIMUL.initSingleRun();
+
+    // uplink in [1, 12), switch until 17, downlink in [17, 28)
+    SIMUL.run_to(20);
+    REQUIRE(c.getDelivered() == 0);
+    REQUIRE(sw.getLinks()[0]->getBusyTime() == 11);
+
+    SIMUL.run_to(31);
+    REQUIRE(c.getDelivered() == 1);
+    REQUIRE(c.getMaxLatency() == 27);
+    REQUIRE(sw.getLinks()[3]->getBusyTime() == 11);
+    REQUIRE(e2e.getCount() == 1);
+    REQUIRE(e2e.getMax() == 30);
+
+    SIMUL.endSingleRun();
+}
+
+TEST_CASE("Network: same node")
+{
+    FPScheduler sched;
+    RTKernel k(&sched, "node");
+
+    CANBus can(0.125, "can");
+    Channel loc("loc", &can, &k, &k, 1);
+
+    PeriodicTask s(100, 100, 0, "Sender");
+    s.insertCode("fixed(2);send(loc);fixed(3);");
+    s.setAbort(false);
+
+    PeriodicTask r(100, 100, 0, "Receiver");
+    r.insertCode("receive(loc);fixed(1);");
+    r.setAbort(false);
+
+    k.addTask(r, "1");
+    k.addTask(s, "2");
+
+    EndToEndDelay e2e(&r, "e2e");
+
+    SIMUL.initSingleRun();
+
+    // delivered at 2 without the bus: the receiver preempts the
+    // sender
+    SIMUL.run_to(4);
+    REQUIRE(loc.getDelivered() == 1);
+    REQUIRE(loc.getMaxLatency() == 0);
+    REQUIRE(can.getLinks()[0]->getBusyTime() == 0);
+    REQUIRE(r.getExecTime() == 1);
+    REQUIRE(s.getExecTime() == 3);
+    REQUIRE(e2e.getMax() == 3);
+
+    SIMUL.run_to(7);
+    REQUIRE(s.getExecTime() == 5);
+
+    SIMUL.endSingleRun();
+}
@@ -0,0 +1,55 @@
+#include "catch.hpp"
+#include <rttask.hpp>
+#include <kernel.hpp>
+#include <fpsched.hpp>
+#include <pipresman.hpp>
+
+using namespace MetaSim;
+using namespace RTSim;
+
+TEST_CASE("PIP: transitive inheritance through nested locks")
+{
+    PeriodicTask tl(20, 20, 0, "Low");
+    tl.insertCode("wait(R1);fixed(4);signal(R1);");
+    tl.setAbort(false);
+
+    PeriodicTask tm(20, 20, 1, "Medium");
+    tm.insertCode("wait(R2);fixed(1);wait(R1);fixed(1);signal(R1);signal(R2);");
+    tm.setAbort(false);
+
+    PeriodicTask th(20, 20, 3, "High");
+    th.insertCode("wait(R2);fixed(1);signal(R2);");
+    th.setAbort(false);
+
+    FPScheduler sched;
+    RTKernel kern(&sched);
+
+    kern.addTask(tl, "3");
+    kern.addTask(tm, "2");
+    kern.addTask(th, "1");
+
+    PIPResManager rm("PIP");
+    rm.addResource("R1");
+    rm.addResource("R2");
+    kern.setResManager(&rm);
+
+    SIMUL.initSingleRun();
+
+    // Medium waits for Low, High for Medium: Low inherits from High
+    SIMUL.run_to(4);
+    REQUIRE(rm.getEffectivePriority(&tm) == 1);
+    REQUIRE(rm.getEffectivePriority(&tl) == 1);
+    REQUIRE(tl.getExecTime() == 3);
+    REQUIRE(th.getExecTime() == 0);
+
+    SIMUL.run_to(7);
+    REQUIRE(rm.getEffectivePriority(&tl) == 3);
+    REQUIRE(rm.getEffectivePriority(&tm) == 2);
+    REQUIRE(th.getExecTime() == 1);
+
+    REQUIRE(rm.getBlockingTime(&tm) == 3);
+    REQUIRE(rm.getBlockingTime(&th) == 3);
+    REQUIRE(rm.getBlockingCount(&tl) == 0);
+
+    SIMUL.endSingleRun();
+}
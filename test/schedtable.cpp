@@ -0,0 +1,177 @@
+#include "catch.hpp"
+#include <sstream>
+#include <rttask.hpp>
+#include <schedtable.hpp>
+#include <ttkernel.hpp>
+
+using namespace MetaSim;
+using namespace RTSim;
+
+TEST_CASE("Schedule table: EDF with offsets")
+{
+    TableSynthesizer ts;
+    ts.addTask("A", 2, 4, 0, 1);
+    ts.addTask("B", 3, 8);
+
+    REQUIRE(ts.getHyperperiod() == 8);
+
+    ScheduleTable *t = ts.synthesizeEDF();
+    const std::vector<TTSlot> &s = t->getSlots();
+
+    REQUIRE(t->getHyperperiod() == 8);
+    REQUIRE(s.size() == 4);
+    REQUIRE(s[0].start == 0);
+    REQUIRE(s[0].length == 1);
+    REQUIRE(t->getTaskName(s[0].task) == "B");
+    REQUIRE(!s[0].last);
+    REQUIRE(s[1].start == 1);
+    REQUIRE(s[1].length == 2);
+    REQUIRE(t->getTaskName(s[1].task) == "A");
+    REQUIRE(s[1].last);
+    REQUIRE(s[2].start == 3);
+    REQUIRE(s[2].length == 2);
+    REQUIRE(t->getTaskName(s[2].task) == "B");
+    REQUIRE(s[2].last);
+    REQUIRE(s[3].start == 5);
+    REQUIRE(s[3].length == 2);
+    REQUIRE(t->getTaskName(s[3].task) == "A");
+    REQUIRE(s[3].last);
+
+    delete t;
+}
+
+TEST_CASE("Schedule table: wrapped last slot")
+{
+    TableSynthesizer ts;
+    ts.addTask("A", 3, 6, 0, 4);
+
+    ScheduleTable *t = ts.synthesizeEDF();
+    const std::vector<TTSlot> &s = t->getSlots();
+
+    // the job released at 4 completes at 7, i.e. at 1 of the next
+    // hyperperiod
+    REQUIRE(s.size() == 1);
+    REQUIRE(s[0].start == 4);
+    REQUIRE(s[0].length == 3);
+    REQUIRE(s[0].last);
+
+    delete t;
+
+    ScheduleTable table(10);
+    table.addTask("A");
+    table.addTask("B");
+    table.addSlot(2, 3, 0);
+    table.addSlot(8, 4, 1);
+    REQUIRE(table.getSize() == 2);
+
+    ScheduleTable bad(10);
+    bad.addTask("A");
+    bad.addTask("B");
+    bad.addSlot(2, 3, 0);
+    REQUIRE_THROWS_AS(bad.addSlot(8, 5, 1), const ScheduleTableExc &);
+    REQUIRE_THROWS_AS(bad.addSlot(4, 2, 1), const ScheduleTableExc &);
+}
+
+TEST_CASE("Schedule table: search")
+{
+    TableSynthesizer ts;
+    ts.addTask("A", 1, 4, 1, 1);
+    ts.addTask("B", 2, 4);
+
+    // non-preemptive EDF starts B at 0, and A misses its deadline
+    REQUIRE_THROWS_AS(ts.synthesizeEDF(false), const ScheduleTableExc &);
+
+    // the search leaves the processor idle until A arrives
+    ScheduleTable *t = ts.synthesizeSearch();
+    const std::vector<TTSlot> &s = t->getSlots();
+
+    REQUIRE(t->getHyperperiod() == 4);
+    REQUIRE(s.size() == 2);
+    REQUIRE(s[0].start == 1);
+    REQUIRE(s[0].length == 1);
+    REQUIRE(t->getTaskName(s[0].task) == "A");
+    REQUIRE(s[1].start == 2);
+    REQUIRE(s[1].length == 2);
+    REQUIRE(t->getTaskName(s[1].task) == "B");
+
+    delete t;
+}
+
+TEST_CASE("Schedule table: exportC")
+{
+    TableSynthesizer ts;
+    ts.addTask("A", 2, 4);
+    ts.addTask("B", 3, 8);
+
+    ScheduleTable *t = ts.synthesizeEDF();
+    std::ostringstream os;
+    t->exportC(os, "tab");
+
+    REQUIRE(os.str() ==
+            "/* Schedule table generated by rtlib */\n"
+            "\n"
+            "#define TAB_HYPERPERIOD 8UL\n"
+            "#define TAB_NTASKS 2\n"
+            "#define TAB_NSLOTS 4\n"
+            "\n"
+            "static const char *const tab_tasks[TAB_NTASKS] = {\n"
+            "    \"A\",\n"
+            "    \"B\"\n"
+            "};\n"
+            "\n"
+            "static const struct tab_slot {\n"
+            "    unsigned long start;\n"
+            "    unsigned long length;\n"
+            "    int task;\n"
+            "} tab[TAB_NSLOTS] = {\n"
+            "    {0UL, 2UL, 0},\n"
+            "    {2UL, 2UL, 1},\n"
+            "    {4UL, 2UL, 0},\n"
+            "    {6UL, 1UL, 1}\n"
+            "};\n");
+
+    delete t;
+}
+
+TEST_CASE("TTKernel: overrun")
+{
+    ScheduleTable table(10);
+    table.addTask("A");
+    table.addTask("B");
+    table.addSlot(0, 2, 0);
+    table.addSlot(2, 3, 1);
+
+    PeriodicTask a(20, 20, 0, "A");
+    a.insertCode("fixed(3);");
+    a.setAbort(false);
+
+    PeriodicTask b(10, 10, 0, "B");
+    b.insertCode("fixed(2);");
+    b.setAbort(false);
+
+    TTKernel kern(&table);
+    kern.addTask(a, "A");
+    kern.addTask(b, "B");
+
+    SIMUL.initSingleRun();
+
+    SIMUL.run_to(5);
+    REQUIRE(a.getExecTime() == 2);
+    REQUIRE(b.getExecTime() == 2);
+    REQUIRE(kern.getOverrunCount() == 1);
+    REQUIRE(kern.getOverruns()[0].task == &a);
+    REQUIRE(kern.getOverruns()[0].time == 2);
+    REQUIRE(kern.getOverrunCount(&a) == 1);
+    REQUIRE(kern.getOverrunCount(&b) == 0);
+
+    // A completes in its slot of the next hyperperiod
+    SIMUL.run_to(12);
+    REQUIRE(a.getExecTime() == 3);
+    REQUIRE(b.getExecTime() == 0);
+
+    SIMUL.run_to(15);
+    REQUIRE(b.getExecTime() == 2);
+    REQUIRE(kern.getOverrunCount() == 1);
+
+    SIMUL.endSingleRun();
+}
@@ -0,0 +1,168 @@
+#include "catch.hpp"
+#include <rttask.hpp>
+#include <sporadicserver.hpp>
+#include <ringbuffer.hpp>
+#include <kernel.hpp>
+#include <fpsched.hpp>
+
+using namespace MetaSim;
+using namespace RTSim;
+
+TEST_CASE("Sporadic Server: coalesced replenishment")
+{
+    PeriodicTask aper(30, 30, 0, "Aperiodic1");
+    aper.insertCode("fixed(1);");
+    aper.setAbort(false);
+
+    PeriodicTask aper2(30, 30, 3, "Aperiodic2");
+    aper2.insertCode("fixed(1);");
+    aper2.setAbort(false);
+
+    FPScheduler sched;
+    RTKernel kern(&sched);
+
+    SporadicServer serv(3, 10, "server", "FIFOSched");
+    serv.setMaxRepl(1);
+    serv.addTask(aper);
+    serv.addTask(aper2);
+
+    kern.addTask(serv, "1");
+
+    SIMUL.initSingleRun();
+
+    // the budget consumed from 3 goes into the replenishment of
+    // the activation at 0, which is postponed to 3 + 10
+    SIMUL.run_to(5);
+    REQUIRE(aper2.getExecTime() == 1);
+    REQUIRE(serv.getCoalesced() == 1);
+    REQUIRE(serv._replEvt.getTime() == 13);
+    REQUIRE(serv.getCurrentBudget() == 1);
+
+    SIMUL.run_to(12);
+    REQUIRE(serv.getCurrentBudget() == 1);
+
+    SIMUL.run_to(14);
+    REQUIRE(serv.getCurrentBudget() == 3);
+    REQUIRE(serv.getStatus() == IDLE);
+
+    SIMUL.endSingleRun();
+}
+
+TEST_CASE("Sporadic Server: background execution")
+{
+    PeriodicTask t1(12, 12, 0, "TaskA");
+    t1.insertCode("fixed(4);");
+    t1.setAbort(false);
+
+    PeriodicTask aper(30, 30, 0, "Aperiodic");
+    aper.insertCode("fixed(7);");
+    aper.setAbort(false);
+
+    FPScheduler sched;
+    RTKernel kern(&sched);
+
+    SporadicServer serv(2, 10, "server", "FIFOSched");
+    serv.setBackground(&sched, 10);
+    serv.addTask(aper);
+
+    kern.addTask(serv, "1");
+    kern.addTask(t1, "2");
+
+    SIMUL.initSingleRun();
+
+    SIMUL.run_to(4);
+    REQUIRE(aper.getExecTime() == 2);
+    REQUIRE(t1.getExecTime() == 2);
+    REQUIRE(serv.inBackground());
+    REQUIRE(sched.getPriority(&serv) == 10);
+
+    // below TaskA, without consuming budget
+    SIMUL.run_to(8);
+    REQUIRE(t1.getExecTime() == 4);
+    REQUIRE(aper.getExecTime() == 4);
+    REQUIRE(serv.getCurrentBudget() == 0);
+
+    // the replenishment at 10 restores the priority
+    SIMUL.run_to(11);
+    REQUIRE(aper.getExecTime() == 7);
+    REQUIRE(!serv.inBackground());
+    REQUIRE(sched.getPriority(&serv) == 1);
+    REQUIRE(serv.getCurrentBudget() == 1);
+
+    SIMUL.endSingleRun();
+}
+
+TEST_CASE("Sporadic Server: initial budget")
+{
+    PeriodicTask aper(30, 30, 0, "Aperiodic");
+    aper.insertCode("fixed(2);");
+    aper.setAbort(false);
+
+    FPScheduler sched;
+    RTKernel kern(&sched);
+
+    SporadicServer serv(4, 10, "server", "FIFOSched");
+    serv.setInitBudget(1);
+    serv.addTask(aper);
+
+    kern.addTask(serv, "1");
+
+    SECTION("REFILL") {
+        SIMUL.initSingleRun();
+
+        // the budget is refilled at the first activation
+        SIMUL.run_to(3);
+        REQUIRE(aper.getExecTime() == 2);
+        REQUIRE(serv.getCurrentBudget() == 2);
+
+        SIMUL.endSingleRun();
+    }
+
+    SECTION("KEEP") {
+        serv.setBudgetPolicy(SporadicServer::KEEP);
+
+        SIMUL.initSingleRun();
+
+        SIMUL.run_to(3);
+        REQUIRE(aper.getExecTime() == 1);
+        REQUIRE(serv.getCurrentBudget() == 0);
+        REQUIRE(serv.getStatus() == RECHARGING);
+
+        SIMUL.run_to(11);
+        REQUIRE(aper.getExecTime() == 2);
+
+        SIMUL.endSingleRun();
+    }
+}
+
+TEST_CASE("RingBuffer: growth past capacity")
+{
+    RingBuffer<int> r(2);
+    r.push_back(1);
+    r.push_back(2);
+    r.pop_front();
+    r.push_back(3);
+    REQUIRE(r.full());
+    REQUIRE(r.capacity() == 2);
+
+    // the elements wrap around: they keep their order when the
+    // buffer doubles
+    r.push_back(4);
+    REQUIRE(r.capacity() == 4);
+    REQUIRE(r.size() == 3);
+    REQUIRE(r.front() == 2);
+    REQUIRE(r.back() == 4);
+
+    int expected = 2;
+    for (RingBuffer<int>::iterator i = r.begin(); i != r.end(); ++i)
+        REQUIRE(*i == expected++);
+
+    r.pop_front();
+    r.pop_front();
+    r.push_back(5);
+    r.push_back(6);
+    REQUIRE(r.capacity() == 4);
+    REQUIRE(r.size() == 3);
+    REQUIRE(r.front() == 4);
+    REQUIRE(r.back() == 6);
+}
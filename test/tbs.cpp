@@ -0,0 +1,90 @@
+#include "catch.hpp"
+#include <rttask.hpp>
+#include <tbserver.hpp>
+#include <kernel.hpp>
+#include <edfsched.hpp>
+
+using namespace MetaSim;
+using namespace RTSim;
+
+TEST_CASE("TBS algorithm")
+{
+    PeriodicTask t1(6, 6, 0, "TaskA");
+    t1.insertCode("fixed(3);");
+    t1.setAbort(false);
+
+    PeriodicTask aper(30, 30, 1, "Aperiodic1");
+    aper.insertCode("fixed(2);");
+    aper.setAbort(false);
+
+    PeriodicTask aper2(30, 30, 2, "Aperiodic2");
+    aper2.insertCode("fixed(1);");
+    aper2.setAbort(false);
+
+    EDFScheduler sched;
+    RTKernel kern(&sched);
+
+    TotalBandwidthServer serv(0.5, "server", "FIFOSched");
+    serv.addTask(aper);
+    serv.addTask(aper2);
+
+    kern.addTask(t1);
+    kern.addTask(serv);
+
+    SIMUL.initSingleRun();
+
+    SIMUL.run_to(3);
+    REQUIRE(aper.getExecTime() == 2);
+    REQUIRE(serv.getDeadline() == 5);
+    REQUIRE(t1.getExecTime() == 1);
+
+    SIMUL.run_to(5);
+    REQUIRE(t1.getExecTime() == 3);
+    REQUIRE(aper2.getExecTime() == 0);
+    REQUIRE(serv.getDeadline() == 7);
+
+    SIMUL.run_to(6);
+    REQUIRE(aper2.getExecTime() == 1);
+
+    SIMUL.endSingleRun();
+}
+
+TEST_CASE("TB* algorithm")
+{
+    PeriodicTask t1(6, 6, 0, "TaskA");
+    t1.insertCode("fixed(3);");
+    t1.setAbort(false);
+
+    PeriodicTask aper(30, 30, 1, "Aperiodic1");
+    aper.insertCode("fixed(2);");
+    aper.setAbort(false);
+
+    PeriodicTask aper2(30, 30, 2, "Aperiodic2");
+    aper2.insertCode("fixed(1);");
+    aper2.setAbort(false);
+
+    EDFScheduler sched;
+    RTKernel kern(&sched);
+
+    TBStarServer serv(0.5, "server", "FIFOSched");
+    serv.addTask(aper);
+    serv.addTask(aper2);
+    serv.addPeriodicTask(&t1);
+
+    kern.addTask(t1);
+    kern.addTask(serv);
+
+    SIMUL.initSingleRun();
+
+    SIMUL.run_to(2);
+    REQUIRE(serv.getDeadline() == 3);
+
+    SIMUL.run_to(4);
+    REQUIRE(aper2.getExecTime() == 1);
+    REQUIRE(t1.getExecTime() == 1);
+
+    SIMUL.run_to(6);
+    REQUIRE(t1.getExecTime() == 3);
+
+    SIMUL.endSingleRun();
+}
@@ -0,0 +1,87 @@
+#include "catch.hpp"
+#include <rttask.hpp>
+#include <kernel.hpp>
+#include <edfsched.hpp>
+#include <governor.hpp>
+
+using namespace MetaSim;
+using namespace RTSim;
+
+TEST_CASE("ccEDF governor: speed change rescales the running job")
+{
+    double V[] = {1, 1};
+    int F[] = {500, 1000};
+    CPU cpu("cpu", 2, V, F);
+
+    EDFScheduler sched;
+    RTKernel kern(&sched, "", &cpu);
+    CCEDFGovernor gov;
+    kern.setGovernor(&gov);
+
+    PeriodicTask t1(10, 10, 0, "TaskA");
+    t1.insertCode("fixed(2);");
+    t1.setAbort(false);
+
+    PeriodicTask t2(10, 10, 1, "TaskB");
+    t2.insertCode("fixed(4);");
+    t2.setAbort(false);
+
+    kern.addTask(t1);
+    kern.addTask(t2);
+
+    SIMUL.initSingleRun();
+
+    // U = 0.2: half speed
+    SIMUL.run_to(0);
+    REQUIRE(cpu.getSpeed() == 0.5);
+
+    // U = 0.6: full speed, the rest of TaskA takes 1.5 ticks
+    SIMUL.run_to(2);
+    REQUIRE(cpu.getSpeed() == 1);
+    REQUIRE(t1.isActive());
+
+    SIMUL.run_to(3);
+    REQUIRE(!t1.isActive());
+    REQUIRE(t1.getExecCycles() == 2);
+    REQUIRE(t2.getExecTime() == 0);
+
+    SIMUL.run_to(7);
+    REQUIRE(!t2.isActive());
+
+    SIMUL.endSingleRun();
+}
+
+TEST_CASE("ccEDF governor: cycles of a job across a speed drop")
+{
+    double V[] = {1, 1};
+    int F[] = {500, 1000};
+    CPU cpu("cpu", 2, V, F);
+
+    EDFScheduler sched;
+    RTKernel kern(&sched, "", &cpu);
+    CCEDFGovernor gov;
+    kern.setGovernor(&gov);
+
+    PeriodicTask t1(20, 20, 0, "TaskA");
+    t1.insertCode("fixed(11);");
+    kern.addTask(t1);
+
+    SIMUL.initSingleRun();
+
+    // U = 0.55: full speed, 6 cycles in 6 ticks
+    SIMUL.run_to(6);
+    REQUIRE(cpu.getSpeed() == 1);
+    REQUIRE(t1.getExecCycles() == 6);
+
+    // the other 5 cycles take 10 ticks at half speed
+    cpu.setSpeed(0.5);
+    SIMUL.run_to(17);
+    REQUIRE(!t1.isActive());
+    REQUIRE(t1.getExecTime() == 16);
+    REQUIRE(t1.getExecCycles() == 11);
+
+    // the job did its whole WCET: U stays 0.55
+    REQUIRE(cpu.getSpeed() == 1);
+
+    SIMUL.endSingleRun();
+}
@@ -0,0 +1,52 @@
+#include "catch.hpp"
+#include <minplus.hpp>
+
+using namespace MetaSim;
+using namespace RTSim;
+
+TEST_CASE("Min-plus curves: bounds of a periodic demand")
+{
+    Curve alpha = Curve::staircase(10, 2, 100);
+    REQUIRE(alpha(1) == 2);
+    REQUIRE(alpha(10) == 2);
+    REQUIRE(alpha(11) == 4);
+
+    Curve cpu = Curve::cpuService(1.0, 100);
+    REQUIRE(Curve::hDeviation(alpha, cpu) == 2);
+    REQUIRE(Curve::vDeviation(alpha, cpu) == 2);
+
+    // blackout of 2(P - Q) = 6 before the first unit of budget
+    Curve server = Curve::serverService(2, 5, 100);
+    REQUIRE(server(6) == 0);
+    REQUIRE(server(8) == 2);
+    REQUIRE(Curve::hDeviation(alpha, server) == 8);
+
+    Curve a = Curve::rateLatency(1, 2, 100);
+    Curve b = Curve::rateLatency(1, 3, 100);
+    Curve c = Curve::convolve(a, b);
+    REQUIRE(c(5) == 0);
+    REQUIRE(c(10) == 5);
+
+    std::vector<Tick> trace;
+    trace.push_back(0);
+    trace.push_back(1);
+    trace.push_back(10);
+    Curve t = Curve::fromTrace(trace, 20);
+    REQUIRE(t(1) == 1);
+    REQUIRE(t(2) == 2);
+    REQUIRE(t(11) == 3);
+}
+
+TEST_CASE("Min-plus curves: operands with different horizons")
+{
+    // g is still flat after the horizon of f
+    Curve f = Curve::affine(0.5, 1, 4);
+    Curve g = Curve::rateLatency(1, 10, 100);
+
+    Curve d = Curve::deconvolve(f, g);
+    REQUIRE(d.getHorizon() == 100);
+    REQUIRE(d(0) == 6);
+    REQUIRE(d(2) == 7);
+    REQUIRE(Curve::vDeviation(f, g) == 6.5);
+    REQUIRE(Curve::hDeviation(f, g) == 12);
+}
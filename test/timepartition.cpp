@@ -0,0 +1,151 @@
+#include "catch.hpp"
+#include <rttask.hpp>
+#include <timepartitionvm.hpp>
+#include <kernel.hpp>
+#include <fpsched.hpp>
+
+using namespace MetaSim;
+using namespace RTSim;
+
+TEST_CASE("TimePartitionVM: table validation")
+{
+    TimePartitionVM vm("vm", 10, 2);
+    vm.addPartition("P1");
+    vm.addPartition("P2");
+
+    SECTION("unknown partition") {
+        vm.addWindow(0, 0, 4, "P1");
+        vm.addWindow(0, 5, 4, "P3");
+        REQUIRE_THROWS_AS(vm.validate(), const TimePartitionExc &);
+    }
+
+    SECTION("window not in the major frame") {
+        vm.addWindow(0, 0, 4, "P1");
+        vm.addWindow(0, 8, 3, "P2");
+        REQUIRE_THROWS_AS(vm.validate(), const TimePartitionExc &);
+    }
+
+    SECTION("overlapping windows") {
+        vm.addWindow(0, 0, 4, "P1");
+        vm.addWindow(0, 3, 4, "P2");
+        REQUIRE_THROWS_AS(vm.validate(), const TimePartitionExc &);
+    }
+
+    SECTION("partition on two CPUs") {
+        vm.addWindow(0, 0, 4, "P1");
+        vm.addWindow(1, 4, 4, "P1");
+        vm.addWindow(0, 5, 4, "P2");
+        REQUIRE_THROWS_AS(vm.validate(), const TimePartitionExc &);
+    }
+
+    SECTION("window not longer than the overhead") {
+        vm.addWindow(0, 0, 4, "P1");
+        vm.addWindow(0, 4, 2, "P2");
+        REQUIRE_THROWS_AS(vm.validate(), const TimePartitionExc &);
+    }
+
+    SECTION("partition without windows") {
+        vm.addWindow(0, 0, 4, "P1");
+        REQUIRE_THROWS_AS(vm.validate(), const TimePartitionExc &);
+    }
+
+    SECTION("adjacent windows") {
+        vm.addWindow(0, 0, 2, "P1");
+        vm.addWindow(0, 2, 2, "P1");
+        vm.addWindow(0, 4, 3, "P2");
+        vm.validate();
+
+        // one window, that pays the overhead once
+        PartitionServer *p1 = vm.getPartition("P1");
+        REQUIRE(p1->getWindows().size() == 1);
+        REQUIRE(p1->getWindows()[0].start == 0);
+        REQUIRE(p1->getWindows()[0].end == 4);
+        REQUIRE(p1->getBudget() == 2);
+    }
+
+    SECTION("valid table") {
+        vm.addWindow(0, 0, 4, "P1");
+        vm.addWindow(0, 4, 3, "P2");
+        vm.validate();
+        REQUIRE(vm.getCPU("P1") == 0);
+        REQUIRE(vm.getPartition("P2")->getBudget() == 1);
+    }
+}
+
+TEST_CASE("TimePartitionVM: windows and overheads")
+{
+    PeriodicTask a(20, 20, 0, "TaskA");
+    a.insertCode("fixed(6);");
+    a.setAbort(false);
+
+    PeriodicTask b1(10, 10, 0, "TaskB1");
+    b1.insertCode("fixed(1);");
+    b1.setAbort(false);
+
+    PeriodicTask b2(10, 10, 0, "TaskB2");
+    b2.insertCode("fixed(1);");
+    b2.setAbort(false);
+
+    FPScheduler sched;
+    RTKernel kern(&sched);
+
+    TimePartitionVM vm("vm", 10, 1);
+    PartitionServer *p1 = vm.addPartition("P1");
+    PartitionServer *p2 = vm.addPartition("P2", "FPSched");
+
+    vm.addWindow(0, 0, 4, "P1");
+    vm.addWindow(0, 4, 4, "P2");
+    vm.addWindow(0, 8, 2, "P1");
+
+    vm.addTask(a, "P1");
+    vm.addTask(b1, "P2(1)");
+    vm.addTask(b2, "P2(2)");
+
+    kern.addVM(vm);
+
+    // the window at 0 follows the one at 8 of the previous frame:
+    // no switch overhead
+    const std::vector<PartitionServer::Window> &w1 = p1->getWindows();
+    REQUIRE(w1.size() == 2);
+    REQUIRE(w1[0].start == 0);
+    REQUIRE(w1[0].end == 4);
+    REQUIRE(w1[0].overhead == 0);
+    REQUIRE(w1[1].start == 8);
+    REQUIRE(w1[1].end == 10);
+    REQUIRE(w1[1].overhead == 1);
+    REQUIRE(p1->getBudget() == 5);
+
+    const std::vector<PartitionServer::Window> &w2 = p2->getWindows();
+    REQUIRE(w2.size() == 1);
+    REQUIRE(w2[0].overhead == 1);
+    REQUIRE(p2->getBudget() == 3);
+
+    SIMUL.initSingleRun();
+
+    SIMUL.run_to(8);
+    REQUIRE(a.getExecTime() == 4);
+    REQUIRE(b1.getExecTime() == 1);
+    REQUIRE(b2.getExecTime() == 1);
+    REQUIRE(p2->getOverheadTime() == 1);
+
+    // B1 runs in [5, 6) and B2 in [6, 7), after the overhead
+    REQUIRE(p2->getJobs() == 2);
+    REQUIRE(p2->getMinResponseTime() == 6);
+    REQUIRE(p2->getMaxResponseTime() == 7);
+    REQUIRE(p2->getJitter() == 1);
+    REQUIRE(p2->getMeanResponseTime() == 6.5);
+
+    // A runs in [9, 10) and goes on at 10 without overhead
+    SIMUL.run_to(12);
+    REQUIRE(a.getExecTime() == 6);
+    REQUIRE(p1->getJobs() == 1);
+    REQUIRE(p1->getMaxResponseTime() == 11);
+    REQUIRE(p1->getOverheadTime() == 1);
+
+    SIMUL.run_to(18);
+    REQUIRE(p2->getJobs() == 4);
+    REQUIRE(p2->getJitter() == 1);
+    REQUIRE(p2->getOverheadTime() == 2);
+
+    SIMUL.endSingleRun();
+}